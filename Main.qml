@@ -7,22 +7,47 @@ import utils
 Window {
     width: 1920
     height: 1080
-    visible: true
+    // DRIVER_PRESENTATION=fullscreen: no compositor copy between our swap and the screen
+    visibility: presentationMode.fullscreen ? Window.FullScreen : Window.Windowed
     title: qsTr("Driver App")
+    // Shows when the frame governor hides the background
+    color: "#1a1a1a"
 
+    // The photo is 5472x3648. The software backend redraws the part under every
+    // changed item from it, so there it is decoded once at window size and each
+    // partial repaint is a plain copy instead of a smooth downscale
     Image {
         id: bg
         source: "resources/bg.jpg"
         anchors.fill: parent
+        sourceSize: renderProfile.software ? Qt.size(width, height) : undefined
+        // First decoration to go when frames run over budget (FrameGovernor)
+        visible: frameGovernor.background
+        smooth: frameGovernor.smoothing
     }
 
-    VideoScreen{
+    // Normal video view, or the A/B pipeline comparison when it is enabled
+    // (only one of them may receive on the video port)
+    Loader {
         id: video
         anchors.top: parent.top
         anchors.topMargin: 10
         anchors.horizontalCenter: parent.horizontalCenter
+        sourceComponent: pipelineComparison.enabled ? comparisonView : videoScreen
+    }
+
+    Component {
+        id: videoScreen
 
-        Component.onCompleted: console.log("done")
+        VideoScreen {
+            Component.onCompleted: console.log("done")
+        }
+    }
+
+    Component {
+        id: comparisonView
+
+        PipelineComparisonView {}
     }
 
     WheelInput{
@@ -74,6 +99,15 @@ Window {
         onClicked: popUp.open()
     }
 
+    // Write the rolling trace capture (DRIVER_TRACE=1) to trace-<time>.json
+    Shortcut {
+        sequence: "F9"
+        onActivated: {
+            var path = tracing.dump()
+            console.log(path.length > 0 ? "Trace written to " + path : "Trace dump failed")
+        }
+    }
+
     Component.onCompleted: {
         popUp.open()
     }
@@ -0,0 +1,162 @@
+import QtQuick
+import QtQuick.Layouts
+
+// Live performance numbers over the video (toggle with F3 in VideoScreen).
+// Everything comes from the performanceStats context object, which samples
+// at 4 Hz only while this overlay is visible.
+Rectangle {
+    id: hud
+
+    // Values past these turn amber/red so degradation stands out at a glance
+    property real fpsWarn: 25
+    property real frameAgeWarnMs: 50
+    property real rttWarnMs: 50
+    property real swapWarnMs: 33
+    property real threadCpuWarn: 45
+    // Busiest threads listed (CPU % of one core / run-queue wait %)
+    property int threadRows: 4
+
+    readonly property bool statsAvailable: typeof performanceStats !== "undefined" && performanceStats !== null
+    readonly property bool presentationAvailable: typeof presentationMode !== "undefined" && presentationMode !== null
+    // Software profile: share of the window repainted per frame (1 Hz)
+    readonly property bool repaintAvailable: typeof renderProfile !== "undefined" && renderProfile !== null
+                                             && renderProfile.software
+
+    width: layout.implicitWidth + 20
+    height: layout.implicitHeight + 16
+    color: typeof frameGovernor === "undefined" || frameGovernor.translucency ? "#cc101010" : "#101010"
+    border.color: "#444"
+    border.width: 1
+    radius: 5
+
+    onVisibleChanged: if (statsAvailable) performanceStats.running = visible
+    Component.onCompleted: if (statsAvailable) performanceStats.running = visible
+
+    function fmt(value, digits) {
+        return value < 0 ? "-" : value.toFixed(digits)
+    }
+
+    function level(value, warn) {
+        if (value < 0) return "#aaa"
+        if (value > warn * 2) return "red"
+        if (value > warn) return "orange"
+        return "lime"
+    }
+
+    component StatRow: RowLayout {
+        property string label
+        property string value
+        property color valueColor: "white"
+
+        spacing: 12
+        Text {
+            text: label
+            color: "#aaa"
+            font.pixelSize: 11
+            font.family: "monospace"
+            Layout.preferredWidth: 90
+        }
+        Text {
+            text: value
+            color: valueColor
+            font.pixelSize: 11
+            font.family: "monospace"
+            horizontalAlignment: Text.AlignRight
+            Layout.preferredWidth: 110
+        }
+    }
+
+    ColumnLayout {
+        id: layout
+        anchors.centerIn: parent
+        spacing: 2
+
+        StatRow {
+            label: "video fps"
+            value: statsAvailable ? hud.fmt(performanceStats.videoFps, 1) : "-"
+            valueColor: statsAvailable && performanceStats.videoFps < hud.fpsWarn ? "orange" : "lime"
+        }
+        StatRow {
+            label: "frame age"
+            value: statsAvailable ? hud.fmt(performanceStats.frameAgeMs, 1) + " ms" : "-"
+            valueColor: statsAvailable ? hud.level(performanceStats.frameAgeMs, hud.frameAgeWarnMs) : "#aaa"
+        }
+        StatRow {
+            label: "decode"
+            value: statsAvailable ? hud.fmt(performanceStats.decodeMs, 1) + " ms" : "-"
+        }
+        StatRow {
+            label: "drops"
+            value: statsAvailable ? performanceStats.droppedFrames + " (" + hud.fmt(performanceStats.dropRate, 1) + "/s)" : "-"
+            valueColor: statsAvailable && performanceStats.dropRate > 0 ? "orange" : "white"
+        }
+        StatRow {
+            label: "gui queue"
+            value: statsAvailable ? "" + performanceStats.handoffQueueDepth : "-"
+        }
+        StatRow {
+            label: "control rtt"
+            value: statsAvailable ? hud.fmt(performanceStats.controlRttMs, 1) + " ms" : "-"
+            valueColor: statsAvailable ? hud.level(performanceStats.controlRttMs, hud.rttWarnMs) : "#aaa"
+        }
+        StatRow {
+            label: "send rate"
+            value: statsAvailable ? hud.fmt(performanceStats.sendRateHz, 0) + " Hz" : "-"
+        }
+        StatRow {
+            label: "input"
+            value: statsAvailable ? hud.fmt(performanceStats.inputRateHz, 0) + " Hz ±"
+                                    + hud.fmt(performanceStats.inputJitterMs, 1) + " ms" : "-"
+        }
+        StatRow {
+            label: "gui frame"
+            value: statsAvailable ? hud.fmt(performanceStats.guiFrameMs, 1) + " / "
+                                    + hud.fmt(performanceStats.guiFrameMaxMs, 1) + " ms" : "-"
+        }
+        StatRow {
+            label: "render"
+            value: statsAvailable ? hud.fmt(performanceStats.renderMs, 1) + " / "
+                                    + hud.fmt(performanceStats.renderMaxMs, 1) + " ms" : "-"
+        }
+        StatRow {
+            visible: typeof frameGovernor !== "undefined"
+            label: "ui effects"
+            value: typeof frameGovernor !== "undefined" ? frameGovernor.levelName + " " + hud.fmt(frameGovernor.frameCostMs, 1)
+                                                          + "/" + hud.fmt(frameGovernor.budgetMs, 1) + " ms" : "-"
+            valueColor: typeof frameGovernor !== "undefined" && frameGovernor.level > 0 ? "orange" : "lime"
+        }
+        StatRow {
+            visible: hud.presentationAvailable
+            label: "swap"
+            value: hud.presentationAvailable ? hud.fmt(presentationMode.swapLatencyMs, 1) + " ms" : "-"
+            valueColor: hud.presentationAvailable ? hud.level(presentationMode.swapLatencyMs, hud.swapWarnMs) : "#aaa"
+        }
+        StatRow {
+            visible: hud.presentationAvailable
+            label: "present"
+            value: hud.presentationAvailable ? (presentationMode.fullscreen ? "full" : "win")
+                                               + " vsync " + presentationMode.vsync : "-"
+        }
+        StatRow {
+            visible: hud.repaintAvailable
+            label: "repainted"
+            value: hud.repaintAvailable ? hud.fmt(renderProfile.dirtyPercent, 0) + "% full "
+                                          + hud.fmt(renderProfile.fullRepaintPercent, 0) + "%" : "-"
+            valueColor: hud.repaintAvailable && !renderProfile.partialUpdates ? "orange" : "lime"
+        }
+        StatRow {
+            visible: statsAvailable && performanceStats.threadMonitor.supported
+            label: "process cpu"
+            value: statsAvailable ? hud.fmt(performanceStats.threadMonitor.processCpuPercent, 0) + " %" : "-"
+        }
+        Repeater {
+            model: statsAvailable ? performanceStats.threadMonitor.threads.slice(0, hud.threadRows) : []
+            delegate: StatRow {
+                required property var modelData
+                label: modelData.name.length > 12 ? modelData.name.substring(0, 11) + "~" : modelData.name
+                value: hud.fmt(modelData.cpuPercent, 0) + "% w" + hud.fmt(modelData.waitPercent, 0) + "%"
+                valueColor: hud.level(modelData.cpuPercent, hud.threadCpuWarn)
+            }
+        }
+    }
+}
@@ -0,0 +1,204 @@
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+
+/* ========================================================================
+ * A/B PIPELINE COMPARISON
+ * ========================================================================
+ * Shows two pipeline configurations decoding the same RTP packets side by
+ * side, with their latency, CPU and drop statistics. Enabled with
+ * DRIVER_AB_COMPARE=1 (chains from DRIVER_AB_CHAIN_A / DRIVER_AB_CHAIN_B).
+ */
+Item {
+    id: root
+
+    implicitWidth: 1400
+    implicitHeight: 720
+
+    // One side of the comparison: video plus its statistics
+    component ComparisonPane: Item {
+        id: pane
+
+        property string label
+        property string provider
+        property var receiver
+        property var stats
+        property string chain
+
+        function number(value, decimals) {
+            return value !== undefined ? value.toFixed(decimals) : "-"
+        }
+
+        Rectangle {
+            anchors.fill: parent
+            color: "black"
+        }
+
+        Image {
+            anchors.fill: parent
+            fillMode: Image.PreserveAspectFit
+            cache: false
+            asynchronous: true
+            source: pane.receiver ? "image://" + pane.provider + "/" + pane.receiver.currentFrame : ""
+        }
+
+        Rectangle {
+            anchors.top: parent.top
+            anchors.left: parent.left
+            anchors.margins: 10
+            width: statsColumn.implicitWidth + 20
+            height: statsColumn.implicitHeight + 20
+            color: "#2a2a2a"
+            border.color: "#444"
+            border.width: 1
+            radius: 5
+            opacity: 0.8
+
+            Column {
+                id: statsColumn
+                anchors.centerIn: parent
+                spacing: 2
+
+                Text {
+                    text: pane.label + ": " + (pane.chain.length > 0 ? pane.chain : "built-in chain")
+                    color: "lime"
+                    font.pixelSize: 12
+                    font.bold: true
+                    width: Math.min(implicitWidth, pane.width - 40)
+                    elide: Text.ElideRight
+                }
+                Text {
+                    text: "FPS: " + pane.number(pane.stats.fps, 1) + " (decoded " + pane.number(pane.stats.decodedFps, 1) + ")"
+                    color: "white"
+                    font.pixelSize: 11
+                }
+                Text {
+                    text: "Dropped: " + (pane.stats.dropped !== undefined ? pane.stats.dropped : "-")
+                          + "/s (total " + (pane.stats.totalDropped !== undefined ? pane.stats.totalDropped : "-") + ")"
+                    color: "white"
+                    font.pixelSize: 11
+                }
+                Text {
+                    text: "RX→appsink: " + pane.number(pane.stats.rxToAppsinkMs, 2)
+                          + " ms (max " + pane.number(pane.stats.rxToAppsinkMaxMs, 2) + ")"
+                    color: "white"
+                    font.pixelSize: 11
+                }
+                Text {
+                    text: "RX→GUI: " + pane.number(pane.stats.rxToGuiMs, 2) + " ms"
+                    color: "white"
+                    font.pixelSize: 11
+                }
+                Text {
+                    text: "CPU: " + pane.number(pane.stats.cpuPercent, 1) + " %"
+                    color: "white"
+                    font.pixelSize: 11
+                }
+            }
+        }
+    }
+
+    RowLayout {
+        anchors.fill: parent
+        spacing: 4
+
+        ComparisonPane {
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            label: "A"
+            provider: "videostream_a"
+            receiver: pipelineComparison.receiverA
+            stats: pipelineComparison.statsA
+            chain: pipelineComparison.chainA
+        }
+
+        ComparisonPane {
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            label: "B"
+            provider: "videostream_b"
+            receiver: pipelineComparison.receiverB
+            stats: pipelineComparison.statsB
+            chain: pipelineComparison.chainB
+        }
+    }
+
+    // Export buttons
+    Row {
+        anchors.bottom: parent.bottom
+        anchors.horizontalCenter: parent.horizontalCenter
+        anchors.margins: 10
+        spacing: 10
+
+        Repeater {
+            model: ["json", "csv"]
+
+            Button {
+                id: exportButton
+                required property string modelData
+                width: 110
+                height: 30
+                enabled: pipelineComparison.running
+
+                contentItem: Text {
+                    text: "Export " + exportButton.modelData.toUpperCase()
+                    color: exportButton.hovered ? "lime" : "white"
+                    font.pixelSize: 11
+                    horizontalAlignment: Text.AlignHCenter
+                    verticalAlignment: Text.AlignVCenter
+                }
+
+                background: Rectangle {
+                    color: exportButton.pressed ? "#1a1a1a" : (exportButton.hovered ? "#333" : "#2a2a2a")
+                    border.color: exportButton.hovered ? "lime" : "#444"
+                    border.width: 1
+                    radius: 5
+                }
+
+                onClicked: {
+                    var path = pipelineComparison.exportResults(modelData)
+                    messageText.color = path.length > 0 ? "lime" : "orange"
+                    messageText.text = path.length > 0 ? "Saved " + path : "Export failed"
+                    messageHideTimer.restart()
+                }
+            }
+        }
+    }
+
+    Connections {
+        target: pipelineComparison
+
+        function onErrorOccurred(message) {
+            console.log("Comparison Error:", message)
+            messageText.color = "orange"
+            messageText.text = message
+            messageHideTimer.restart()
+        }
+    }
+
+    // Status / error message above the export buttons
+    Text {
+        id: messageText
+        anchors.bottom: parent.bottom
+        anchors.bottomMargin: 50
+        anchors.horizontalCenter: parent.horizontalCenter
+        color: "orange"
+        font.pixelSize: 12
+        visible: text.length > 0
+    }
+
+    Timer {
+        id: messageHideTimer
+        interval: 5000
+        onTriggered: messageText.text = ""
+    }
+
+    // Start on the next event loop pass (same as VideoScreen's startVideo())
+    function startComparison() {
+        console.log("Starting pipeline comparison on port 5000...")
+        pipelineComparison.start(5000)
+    }
+
+    Component.onCompleted: Qt.callLater(startComparison)
+    Component.onDestruction: pipelineComparison.stop()
+}
@@ -0,0 +1,60 @@
+import QtQuick
+
+// Where the car is now, drawn over the (100-200 ms old) video frame: amber dots
+// from where the frame was taken to the predicted current position (ring),
+// blue dots where the current command takes it over the next second. Points
+// come from the pathPredictor context object (toggle with F5 in VideoScreen).
+Item {
+    id: overlay
+
+    // The video Image; the overlay covers its painted (aspect-fit) area
+    property Image image
+
+    readonly property bool available: typeof pathPredictor !== "undefined" && pathPredictor !== null
+    readonly property bool shown: available && pathPredictor.enabled && pathPredictor.valid
+    // Converted to a JS array once per update; the dots index into this copy
+    readonly property var points: available ? pathPredictor.points : []
+
+    x: image ? image.x + (image.width - image.paintedWidth) / 2 : 0
+    y: image ? image.y + (image.height - image.paintedHeight) / 2 : 0
+    width: image ? image.paintedWidth : 0
+    height: image ? image.paintedHeight : 0
+    clip: true
+    visible: shown && image !== null && image.visible
+
+    Repeater {
+        model: overlay.available ? pathPredictor.pointCount : 0
+
+        Rectangle {
+            readonly property bool isNow: index === pathPredictor.nowIndex
+            // x across the image width, y from the vertical center in image widths
+            readonly property point point: overlay.points[index] ?? Qt.point(NaN, NaN)
+
+            visible: !isNaN(point.x)
+            width: isNow ? 16 : 6
+            height: width
+            radius: width / 2
+            x: point.x * overlay.width - width / 2
+            y: overlay.height / 2 + point.y * overlay.width - height / 2
+            color: isNow ? "transparent" : (index < pathPredictor.nowIndex ? "#ffc107" : "#4fc3f7")
+            border.color: "#ffc107"
+            border.width: isNow ? 3 : 0
+        }
+    }
+
+    Text {
+        readonly property point point: overlay.available
+                                       ? (overlay.points[pathPredictor.nowIndex] ?? Qt.point(NaN, NaN))
+                                       : Qt.point(NaN, NaN)
+
+        visible: !isNaN(point.x)
+        x: point.x * overlay.width + 12
+        y: overlay.height / 2 + point.y * overlay.width - height / 2
+        text: overlay.available ? "+" + pathPredictor.horizonMs.toFixed(0) + " ms" : ""
+        color: "#ffc107"
+        font.pixelSize: 12
+        font.family: "monospace"
+        style: Text.Outline
+        styleColor: "black"
+    }
+}
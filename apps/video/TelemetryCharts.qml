@@ -0,0 +1,94 @@
+import QtQuick
+import QtQuick.Layouts
+import driversrc
+
+// Scrolling plots of the last 30 s over the video (toggle with F4 in VideoScreen).
+// Each StripChart is one scene graph node updated in place, so steering and
+// throttle are plotted at their full input rate without repainting the plot.
+Rectangle {
+    id: charts
+
+    property real windowSeconds: 30
+    property int chartWidth: 300
+    property int chartHeight: 48
+
+    readonly property bool controllerAvailable: typeof steeringController !== "undefined" && steeringController !== null
+
+    width: layout.implicitWidth + 20
+    height: layout.implicitHeight + 16
+    color: typeof frameGovernor === "undefined" || frameGovernor.translucency ? "#cc101010" : "#101010"
+    border.color: "#444"
+    border.width: 1
+    radius: 5
+
+    component ChartRow: ColumnLayout {
+        property alias label: labelText.text
+        property alias chart: chartItem
+        property string unit
+        property int digits: 2
+
+        spacing: 2
+        RowLayout {
+            Text {
+                id: labelText
+                color: "#aaa"
+                font.pixelSize: 11
+                font.family: "monospace"
+                Layout.fillWidth: true
+            }
+            Text {
+                text: chartItem.value.toFixed(digits) + unit
+                color: chartItem.color
+                font.pixelSize: 11
+                font.family: "monospace"
+            }
+        }
+        StripChart {
+            id: chartItem
+            windowSeconds: charts.windowSeconds
+            Layout.preferredWidth: charts.chartWidth
+            Layout.preferredHeight: charts.chartHeight
+        }
+    }
+
+    ColumnLayout {
+        id: layout
+        anchors.centerIn: parent
+        spacing: 6
+
+        ChartRow {
+            label: "steering"
+            chart.source: StripChart.Steering
+            chart.controller: charts.controllerAvailable ? steeringController : null
+            chart.minimum: -1
+            chart.maximum: 1
+            chart.color: "deepskyblue"
+        }
+        ChartRow {
+            label: "throttle"
+            chart.source: StripChart.Throttle
+            chart.controller: charts.controllerAvailable ? steeringController : null
+            chart.minimum: -1
+            chart.maximum: 1
+            chart.color: "lime"
+        }
+        ChartRow {
+            label: "control rtt"
+            unit: " ms"
+            digits: 1
+            chart.source: StripChart.ControlRtt
+            chart.minimum: 0
+            chart.maximum: 100
+            chart.color: "orange"
+        }
+        ChartRow {
+            label: "frame age"
+            unit: " ms"
+            digits: 1
+            chart.source: StripChart.FrameAge
+            chart.minimum: 0
+            chart.maximum: 200
+            chart.color: "violet"
+        }
+    }
+}
@@ -6,6 +6,22 @@ Item {
 
     implicitWidth: 1400
     implicitHeight: 720
+    // A shifted frame must not spill over the rest of the window
+    clip: typeof pathPredictor !== "undefined" && pathPredictor.timewarp
+
+    // Performance overlay (F3)
+    property bool hudVisible: false
+    // Steering/throttle/latency plots (F4)
+    property bool chartsVisible: false
+
+    // Effects the frame governor may switch off under load (all on without one)
+    readonly property bool smoothing: typeof frameGovernor === "undefined" || frameGovernor.smoothing
+    readonly property bool translucency: typeof frameGovernor === "undefined" || frameGovernor.translucency
+
+    // Timewarp (F6): the frame turned by the yaw commanded since its capture, in pixels.
+    // A transform of the frame's quad on the GPU; the frame itself is not touched.
+    readonly property real timewarpShift: typeof pathPredictor !== "undefined" && pathPredictor.timewarp
+                                          ? pathPredictor.timewarpShift * videoImage.paintedWidth : 0
 
     Rectangle{
         anchors.fill: parent
@@ -22,19 +38,30 @@ Item {
     // GStreamer RTP/MJPEG Stream Display
     Image {
         id: videoImage
+        objectName: "videoImage"  // Located by driver_harness to time rendering
         anchors.fill: parent
         fillMode: Image.PreserveAspectFit
+        transform: Translate { x: root.timewarpShift }
         cache: false
         asynchronous: true
+        // QPainter's smooth scaling costs more than the frame copy itself (software profile)
+        smooth: root.smoothing && !(typeof renderProfile !== "undefined" && renderProfile.software)
         // Update source when frame changes - the frame ID changes trigger QML to request new image
         source: videoReceiver ? "image://videostream/" + videoReceiver.currentFrame : ""
 
-        // Auto-start stream on component load
-        // IMPORTANT: Use a timer to delay startup until after event loop is running
-        // Starting immediately in Component.onCompleted causes QTimer issues
+        // The next swap shows this frame (swap latency, see PresentationMode)
+        onStatusChanged: {
+            if (status === Image.Ready && typeof presentationMode !== "undefined") {
+                presentationMode.frameLoaded()
+            }
+        }
+
+        // Auto-start stream on component load, deferred to the next event loop pass
+        // (the receiver creates QTimers). If GStreamer is still initializing in the
+        // background the receiver holds the request until it is ready.
         Component.onCompleted: {
             if (videoReceiver) {
-                startupTimer.start()
+                Qt.callLater(root.startVideo)
             }
         }
     }
@@ -84,15 +111,10 @@ Item {
         onTriggered: errorText.visible = false
     }
 
-    // Timer to delay stream startup until event loop is running
-    // This prevents crashes from QTimer creation before event loop starts
-    Timer {
-        id: startupTimer
-        interval: 100  // Wait 100ms for event loop to be ready
-        onTriggered: {
-            console.log("Starting video stream on port 5000...")
-            videoReceiver.startStream(5000)
-        }
+    // Starts the stream on port 5000 (deferred from Component.onCompleted above)
+    function startVideo() {
+        console.log("Starting video stream on port 5000...")
+        videoReceiver.startStream(5000)
     }
 
     // Connection status indicator
@@ -106,7 +128,7 @@ Item {
         border.color: "#444"
         border.width: 1
         radius: 5
-        opacity: 0.8
+        opacity: root.translucency ? 0.8 : 1.0
 
         RowLayout {
             anchors.centerIn: parent
@@ -154,7 +176,8 @@ Item {
     // No connection message
     Text {
         id: noVideoText
-        text: "No Video Stream\n\nWaiting for video on UDP port 5000..."
+        text: "No Video Stream\n\nWaiting for video on UDP port "
+              + (videoReceiver && videoReceiver.port > 0 ? videoReceiver.port : 5000) + "..."
         color: "white"
         font.pixelSize: 32
         horizontalAlignment: Text.AlignHCenter
@@ -162,6 +185,51 @@ Item {
         visible: videoReceiver ? !videoReceiver.isStreaming : true
     }
 
+    // Predicted current position and path of the car over the delayed frame
+    PredictedPathOverlay {
+        image: videoImage
+        transform: Translate { x: root.timewarpShift }  // Stays on the frame's content
+    }
+
+    Shortcut {
+        sequence: "F5"
+        enabled: typeof pathPredictor !== "undefined"
+        onActivated: pathPredictor.enabled = !pathPredictor.enabled
+    }
+
+    Shortcut {
+        sequence: "F6"
+        enabled: typeof pathPredictor !== "undefined"
+        onActivated: pathPredictor.timewarp = !pathPredictor.timewarp
+    }
+
+    // Live fps/latency/RTT numbers for operators; samples only while shown
+    PerformanceHud {
+        anchors.top: parent.top
+        anchors.right: parent.right
+        anchors.margins: 10
+        visible: root.hudVisible
+    }
+
+    Shortcut {
+        sequence: "F3"
+        onActivated: root.hudVisible = !root.hudVisible
+    }
+
+    // Last 30 s of inputs and latencies; not created until first shown
+    Loader {
+        anchors.top: parent.top
+        anchors.left: parent.left
+        anchors.margins: 10
+        active: root.chartsVisible
+        sourceComponent: TelemetryCharts {}
+    }
+
+    Shortcut {
+        sequence: "F4"
+        onActivated: root.chartsVisible = !root.chartsVisible
+    }
+
     // Error message
     Text {
         id: errorText
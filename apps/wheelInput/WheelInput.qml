@@ -1,7 +1,7 @@
 import QtQuick
 import QtQuick.Layouts
 import QtQuick.Controls
-import modules
+import driversrc
 
 Item{
     id: root
@@ -20,17 +20,15 @@ Item{
             spacing: 20
             anchors.horizontalCenter: parent.horizontalCenter
 
-            Wheel{
-                id: wheel
+            // Wheel, pedal and bars in one scene graph item; reads the controller once
+            // per frame instead of binding to every steering/throttle change
+            // (Wheel.qml / Pedal.qml in ui/modules are the former QML version)
+            ControlsView{
+                id: controls
                 Layout.alignment: Qt.AlignVCenter
-                steeringValue: steeringController.steering
-            }
-
-            Pedal{
-                id: throttlePedal
-                Layout.alignment: Qt.AlignVCenter
-                label: "Throttle"
-                value: steeringController.throttle
+                controller: steeringController
+                // Nearest-neighbour wheel rotation when the frame governor sheds smoothing
+                smooth: frameGovernor.smoothing
             }
 
             // Connection status indicator
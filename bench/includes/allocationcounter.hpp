@@ -0,0 +1,57 @@
+/**
+ * @file allocationcounter.hpp
+ * @brief Heap allocation counting for driver_bench (allocation budget checks)
+ *
+ * driver_bench replaces the process allocator entry points: on glibc malloc,
+ * calloc, realloc and the aligned allocators (which also covers operator new
+ * and Qt's containers), elsewhere operator new. Counting is per thread and only while a Scope is
+ * alive, so allocations by other threads (logger, GStreamer) never leak into a
+ * measurement.
+ */
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+namespace AllocationCounter {
+
+struct Counts
+{
+    quint64 allocations = 0;
+    quint64 bytes = 0;
+};
+
+/**
+ * @brief Counts this thread's allocations between construction and counts()
+ */
+class Scope
+{
+public:
+    Scope();
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+    Counts counts() const;
+
+private:
+    Counts m_start;
+    bool m_wasEnabled;
+};
+
+/**
+ * @brief Whether malloc itself is intercepted (false: operator new only)
+ */
+bool interceptsMalloc();
+
+/**
+ * @brief Marks the run as failed; main() then exits with status 1
+ */
+void reportBudgetExceeded();
+bool budgetExceeded();
+
+} // namespace AllocationCounter
+
+#endif // ALLOCATIONCOUNTER_H
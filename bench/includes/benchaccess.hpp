@@ -0,0 +1,79 @@
+/**
+ * @file benchaccess.hpp
+ * @brief Friend access to the private hot paths measured by driver_bench
+ *
+ * The classes under test declare `friend struct BenchAccess;` so the benchmarks
+ * can call exactly the code the app runs, without widening the public API.
+ */
+
+#ifndef BENCHACCESS_H
+#define BENCHACCESS_H
+
+#include <QByteArray>
+#include <QImage>
+#include <memory>
+
+#include "includes/mjpegdecoder.hpp"
+#include "includes/steeringcontroller.hpp"
+#include "includes/videoscreenreciever.hpp"
+#include "includes/steeringcontrollerservice.hpp"
+
+struct BenchAccess
+{
+    // SteeringController
+    static qreal normalizeAxis(SteeringController &controller, int value)
+    {
+        return controller.normalizeAxis(value);
+    }
+
+    // SteeringControllerService
+    static const QByteArray &serializeDataPayload(SteeringControllerService &service)
+    {
+        return service.serializeDataPayload();
+    }
+
+    // Full per-change send: payload, serialization and socket write(s)
+    static void sendSteeringData(SteeringControllerService &service)
+    {
+        service.sendSteeringData();
+    }
+
+    // VideoStreamReceiver: a pipeline context without a GStreamer pipeline is enough
+    // for processNewSample() (no appsrc, so no RX timestamp bookkeeping). It is
+    // installed as the receiver's active pipeline (which owns it from here on), so
+    // the GUI-thread half of the hand-off displays the frames instead of dropping them
+    using StreamPipeline = VideoStreamReceiver::StreamPipeline;
+
+    static StreamPipeline *installStream(VideoStreamReceiver &receiver)
+    {
+        auto stream = std::make_unique<StreamPipeline>();
+        stream->receiver = &receiver;
+        stream->generation = ++receiver.m_pipelineGeneration;
+        receiver.m_active = std::move(stream);
+        return receiver.m_active.get();
+    }
+
+    static void processNewSample(VideoStreamReceiver &receiver, StreamPipeline *stream, GstSample *sample)
+    {
+        receiver.processNewSample(stream, sample);
+    }
+
+    // MjpegDecoder: same path as onReadyRead()
+    static void feedMjpeg(MjpegDecoder &decoder, const char *data, qsizetype size)
+    {
+        decoder.m_buffer.append(data, size);
+        decoder.processBuffer();
+    }
+
+    static void resetMjpeg(MjpegDecoder &decoder)
+    {
+        decoder.m_buffer.clear();
+    }
+
+    static QImage decodeJpeg(MjpegDecoder &decoder, const QByteArray &jpegData)
+    {
+        return decoder.decodeJpeg(jpegData);
+    }
+};
+
+#endif // BENCHACCESS_H
@@ -0,0 +1,65 @@
+/**
+ * @file benchdata.hpp
+ * @brief Synthetic (or recorded) inputs for driver_bench
+ *
+ * Frames are generated rather than checked in: a gradient with a noise layer so
+ * JPEG sizes and decode times are close to real camera footage.
+ */
+
+#ifndef BENCHDATA_H
+#define BENCHDATA_H
+
+#include <QByteArray>
+#include <QImage>
+#include <gst/gst.h>
+
+namespace BenchData {
+
+/**
+ * @struct Resolution
+ * @brief Frame size used as a benchmark argument (index into Resolutions)
+ */
+struct Resolution
+{
+    const char *name;
+    int width;
+    int height;
+};
+
+// 480p, 720p, 1080p - benchmarks take the index as their argument
+extern const Resolution Resolutions[3];
+
+/**
+ * @struct MjpegStream
+ * @brief A multipart/x-mixed-replace body as served by an HTTP MJPEG camera
+ */
+struct MjpegStream
+{
+    QByteArray data;
+    QString source;   ///< File it was loaded from, or "synthetic WxH"
+};
+
+/**
+ * @brief Deterministic RGB888 test frame
+ */
+QImage syntheticFrame(int width, int height, int seed = 0);
+
+/**
+ * @brief JPEG-encoded syntheticFrame()
+ */
+QByteArray syntheticJpeg(int width, int height, int quality = 80, int seed = 0);
+
+/**
+ * @brief Multipart MJPEG stream: the file named by DRIVER_BENCH_MJPEG (e.g. recorded
+ *        with curl from the camera) or, if unset, @p frames synthetic 720p frames
+ */
+const MjpegStream &mjpegStream(int frames = 30);
+
+/**
+ * @brief RGB GstSample as delivered by the appsink (caller unrefs)
+ */
+GstSample *syntheticSample(int width, int height);
+
+} // namespace BenchData
+
+#endif // BENCHDATA_H
@@ -0,0 +1,154 @@
+/**
+ * @file allocationbenchmarks.cpp
+ * @brief Heap allocations per video frame and per control message, with budgets
+ *
+ * Steady-state allocations on the hot paths are what turn into allocator lock
+ * contention and latency spikes, and they creep in silently. These benchmarks
+ * count them (see allocationcounter.hpp) and fail the run - driver_bench exits
+ * with status 1 - when a path goes over its budget. Budgets can be overridden
+ * with DRIVER_BENCH_FRAME_ALLOC_BUDGET / DRIVER_BENCH_CONTROL_ALLOC_BUDGET.
+ */
+
+#include <benchmark/benchmark.h>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTimer>
+#include <QWebSocket>
+#include <QWebSocketServer>
+#include <string>
+#include "includes/allocationcounter.hpp"
+#include "includes/benchaccess.hpp"
+#include "includes/benchdata.hpp"
+
+namespace {
+constexpr int WarmupIterations = 16;
+constexpr int MeasuredIterations = 500;
+constexpr int ControlDrainInterval = 64;
+
+// Allocations per call, averaged over the run.
+// Frame: the QImage wrapping the mapped buffer (its QImageData), the mirrored copy
+// (QImageData + pixels), the queued hand-off (slot object + QMetaCallEvent); the
+// frame ID is rewritten in place.
+constexpr double DefaultFrameBudget = 5.0;
+// Control message: the payload is serialized into reused buffers, so all of these
+// are QWebSocket's - the UTF-8 copy of the text, the frame header, the masked
+// payload and a write buffer chunk - plus 2 for the write buffer growing between drains.
+constexpr double DefaultControlBudget = 6.0;
+
+double budgetFromEnvironment(const char *name, double fallback)
+{
+    bool ok = false;
+    double value = qEnvironmentVariable(name).toDouble(&ok);
+    return ok && value >= 0 ? value : fallback;
+}
+
+void reportAllocations(benchmark::State &state, const AllocationCounter::Counts &counts,
+                       const char *counterName, double budget)
+{
+    double perCall = state.iterations() > 0 ? double(counts.allocations) / state.iterations() : 0.0;
+    double bytesPerCall = state.iterations() > 0 ? double(counts.bytes) / state.iterations() : 0.0;
+    state.counters[counterName] = perCall;
+    state.counters["bytes_per_call"] = bytesPerCall;
+    state.counters["budget"] = budget;
+    if (!AllocationCounter::interceptsMalloc()) {
+        state.SetLabel("operator new only");
+    }
+    if (perCall > budget) {
+        AllocationCounter::reportBudgetExceeded();
+        std::string message = std::string(counterName) + " " + std::to_string(perCall)
+                              + " exceeds budget " + std::to_string(budget);
+        state.SkipWithError(message.c_str());
+    }
+}
+}
+
+// One 720p frame through the appsink callback and its delivery on the GUI thread
+static void BM_FrameAllocations(benchmark::State &state)
+{
+    const BenchData::Resolution &resolution = BenchData::Resolutions[1];
+    VideoStreamReceiver receiver;
+    BenchAccess::StreamPipeline *stream = BenchAccess::installStream(receiver);
+    GstSample *sample = BenchData::syntheticSample(resolution.width, resolution.height);
+
+    // First frames size the caches and image buffers; only steady state counts
+    for (int i = 0; i < WarmupIterations; ++i) {
+        BenchAccess::processNewSample(receiver, stream, sample);
+        QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+    }
+
+    AllocationCounter::Counts total;
+    for (auto _ : state) {
+        AllocationCounter::Scope scope;
+        BenchAccess::processNewSample(receiver, stream, sample);
+        QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+        AllocationCounter::Counts counts = scope.counts();
+        total.allocations += counts.allocations;
+        total.bytes += counts.bytes;
+    }
+
+    reportAllocations(state, total, "allocs_per_frame",
+                      budgetFromEnvironment("DRIVER_BENCH_FRAME_ALLOC_BUDGET", DefaultFrameBudget));
+    gst_sample_unref(sample);
+}
+BENCHMARK(BM_FrameAllocations)->Iterations(MeasuredIterations)->Unit(benchmark::kMicrosecond);
+
+// One control update over a real (loopback) WebSocket; the server side is not counted
+static void BM_ControlAllocations(benchmark::State &state)
+{
+    QWebSocketServer server(QStringLiteral("driver_bench"), QWebSocketServer::NonSecureMode);
+    if (!server.listen(QHostAddress::LocalHost)) {
+        state.SkipWithError("could not listen on localhost");
+        return;
+    }
+    QWebSocket *peer = nullptr;
+    QObject::connect(&server, &QWebSocketServer::newConnection, &server, [&server, &peer]() {
+        peer = server.nextPendingConnection();
+    });
+
+    SteeringController controller;
+    SteeringControllerService service(&controller);
+    QEventLoop loop;
+    QObject::connect(&service, &SteeringControllerService::connected, &loop, &QEventLoop::quit);
+    QTimer::singleShot(5000, &loop, &QEventLoop::quit);
+    service.connectToServer(QStringLiteral("ws://localhost:%1").arg(server.serverPort()));
+    loop.exec();
+    if (!service.isConnected()) {
+        state.SkipWithError("could not connect to the loopback WebSocket server");
+        return;
+    }
+
+    for (int i = 0; i < WarmupIterations; ++i) {
+        BenchAccess::sendSteeringData(service);
+    }
+    QCoreApplication::processEvents();
+
+    AllocationCounter::Counts total;
+    int sinceDrain = 0;
+    for (auto _ : state) {
+        {
+            AllocationCounter::Scope scope;
+            BenchAccess::sendSteeringData(service);
+            AllocationCounter::Counts counts = scope.counts();
+            total.allocations += counts.allocations;
+            total.bytes += counts.bytes;
+        }
+
+        // Let the socket flush and the server consume, untimed and uncounted
+        if (++sinceDrain == ControlDrainInterval) {
+            sinceDrain = 0;
+            state.PauseTiming();
+            QCoreApplication::processEvents();
+            state.ResumeTiming();
+        }
+    }
+
+    reportAllocations(state, total, "allocs_per_message",
+                      budgetFromEnvironment("DRIVER_BENCH_CONTROL_ALLOC_BUDGET", DefaultControlBudget));
+    service.disconnect();
+    if (peer) {
+        peer->close();
+    }
+    QCoreApplication::processEvents();
+}
+BENCHMARK(BM_ControlAllocations)->Iterations(MeasuredIterations)->Unit(benchmark::kMicrosecond);
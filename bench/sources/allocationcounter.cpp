@@ -0,0 +1,176 @@
+/**
+ * @file allocationcounter.cpp
+ * @brief Allocator interposition for driver_bench
+ *
+ * Linked into the driver_bench executable only. On glibc the definitions below
+ * (malloc, calloc, realloc and the aligned variants memalign, posix_memalign,
+ * aligned_alloc) take precedence over libc's for every shared library in the
+ * process and forward to the __libc_* implementations.
+ */
+
+#include "includes/allocationcounter.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+namespace {
+struct ThreadCounts
+{
+    bool enabled;
+    quint64 allocations;
+    quint64 bytes;
+};
+
+// Plain struct in the executable's static TLS block: touching it never allocates
+thread_local ThreadCounts t_counts = { false, 0, 0 };
+
+std::atomic<bool> s_budgetExceeded{false};
+
+inline void countAllocation(size_t size)
+{
+    ThreadCounts &counts = t_counts;
+    if (counts.enabled) {
+        ++counts.allocations;
+        counts.bytes += size;
+    }
+}
+}
+
+#if defined(__GLIBC__)
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *pointer);
+
+void *malloc(size_t size) noexcept
+{
+    countAllocation(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) noexcept
+{
+    countAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) noexcept
+{
+    countAllocation(size);
+    return __libc_realloc(pointer, size);
+}
+
+void *memalign(size_t alignment, size_t size) noexcept
+{
+    countAllocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+// Same argument check as glibc's: a power of two multiple of sizeof(void *)
+int posix_memalign(void **pointer, size_t alignment, size_t size) noexcept
+{
+    if (alignment == 0 || alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    countAllocation(size);
+    void *result = __libc_memalign(alignment, size);
+    if (!result) {
+        return ENOMEM;
+    }
+    *pointer = result;
+    return 0;
+}
+
+void *aligned_alloc(size_t alignment, size_t size) noexcept
+{
+    countAllocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+void free(void *pointer) noexcept
+{
+    __libc_free(pointer);
+}
+}
+
+#else
+
+// No portable malloc interposition: count operator new (Qt containers are missed)
+void *operator new(size_t size)
+{
+    countAllocation(size);
+    if (void *pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    countAllocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, size_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { std::free(pointer); }
+
+#endif
+
+namespace AllocationCounter {
+
+Scope::Scope()
+    : m_start{ t_counts.allocations, t_counts.bytes }
+    , m_wasEnabled(t_counts.enabled)
+{
+    t_counts.enabled = true;
+}
+
+Scope::~Scope()
+{
+    t_counts.enabled = m_wasEnabled;
+}
+
+Counts Scope::counts() const
+{
+    Counts counts;
+    counts.allocations = t_counts.allocations - m_start.allocations;
+    counts.bytes = t_counts.bytes - m_start.bytes;
+    return counts;
+}
+
+bool interceptsMalloc()
+{
+#if defined(__GLIBC__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void reportBudgetExceeded()
+{
+    s_budgetExceeded.store(true);
+}
+
+bool budgetExceeded()
+{
+    return s_budgetExceeded.load();
+}
+
+} // namespace AllocationCounter
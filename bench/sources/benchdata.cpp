@@ -0,0 +1,106 @@
+/**
+ * @file benchdata.cpp
+ * @brief Synthetic (or recorded) inputs for driver_bench
+ */
+
+#include "includes/benchdata.hpp"
+#include <QBuffer>             // In-memory JPEG encoding
+#include <QDebug>
+#include <QFile>               // Recorded MJPEG stream
+#include <cstring>
+#include <gst/video/video.h>   // GstVideoInfo for appsink-compatible caps and strides
+
+namespace BenchData {
+
+const Resolution Resolutions[3] = {
+    { "480p", 640, 480 },
+    { "720p", 1280, 720 },
+    { "1080p", 1920, 1080 },
+};
+
+QImage syntheticFrame(int width, int height, int seed)
+{
+    QImage image(width, height, QImage::Format_RGB888);
+
+    // Smooth gradient (like sky and road) plus low-amplitude noise (like sensor
+    // noise and texture); pure gradients compress unrealistically well
+    quint32 state = 0x9e3779b9u ^ static_cast<quint32>(seed);
+    for (int y = 0; y < height; ++y) {
+        uchar *line = image.scanLine(y);
+        for (int x = 0; x < width; ++x) {
+            state = state * 1664525u + 1013904223u;
+            int noise = static_cast<int>((state >> 24) & 0x1f) - 16;
+            line[x * 3 + 0] = static_cast<uchar>(qBound(0, (x * 255) / width + noise, 255));
+            line[x * 3 + 1] = static_cast<uchar>(qBound(0, (y * 255) / height + noise, 255));
+            line[x * 3 + 2] = static_cast<uchar>(qBound(0, ((x + y + seed * 8) & 0xff) + noise, 255));
+        }
+    }
+    return image;
+}
+
+QByteArray syntheticJpeg(int width, int height, int quality, int seed)
+{
+    QByteArray jpeg;
+    QBuffer buffer(&jpeg);
+    buffer.open(QIODevice::WriteOnly);
+    syntheticFrame(width, height, seed).save(&buffer, "JPEG", quality);
+    return jpeg;
+}
+
+const MjpegStream &mjpegStream(int frames)
+{
+    static MjpegStream stream = [frames]() {
+        MjpegStream result;
+
+        QString path = qEnvironmentVariable("DRIVER_BENCH_MJPEG");
+        if (!path.isEmpty()) {
+            QFile file(path);
+            if (file.open(QIODevice::ReadOnly)) {
+                result.data = file.readAll();
+                result.source = path;
+                return result;
+            }
+            qWarning() << "[BenchData::mjpegStream] Cannot read" << path << "- using synthetic frames";
+        }
+
+        // Same framing as a multipart/x-mixed-replace HTTP camera
+        const Resolution &resolution = Resolutions[1];
+        for (int i = 0; i < frames; ++i) {
+            QByteArray jpeg = syntheticJpeg(resolution.width, resolution.height, 80, i);
+            result.data += "--frame\r\nContent-Type: image/jpeg\r\nContent-Length: ";
+            result.data += QByteArray::number(jpeg.size());
+            result.data += "\r\n\r\n";
+            result.data += jpeg;
+            result.data += "\r\n";
+        }
+        result.source = QString("synthetic %1").arg(resolution.name);
+        return result;
+    }();
+    return stream;
+}
+
+GstSample *syntheticSample(int width, int height)
+{
+    // The appsink negotiates video/x-raw,format=RGB; rows are padded to 4 bytes
+    GstVideoInfo info;
+    gst_video_info_set_format(&info, GST_VIDEO_FORMAT_RGB, width, height);
+
+    QImage frame = syntheticFrame(width, height);
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, GST_VIDEO_INFO_SIZE(&info), nullptr);
+    GstMapInfo map;
+    if (gst_buffer_map(buffer, &map, GST_MAP_WRITE)) {
+        int stride = GST_VIDEO_INFO_PLANE_STRIDE(&info, 0);
+        for (int y = 0; y < height; ++y) {
+            std::memcpy(map.data + static_cast<gsize>(y) * stride, frame.constScanLine(y), static_cast<size_t>(width) * 3);
+        }
+        gst_buffer_unmap(buffer, &map);
+    }
+
+    GstCaps *caps = gst_video_info_to_caps(&info);
+    GstSample *sample = gst_sample_new(buffer, caps, nullptr, nullptr);
+    gst_caps_unref(caps);
+    gst_buffer_unref(buffer);
+    return sample;
+}
+
+} // namespace BenchData
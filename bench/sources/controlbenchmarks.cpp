@@ -0,0 +1,41 @@
+/**
+ * @file controlbenchmarks.cpp
+ * @brief Control path: axis normalization and per-tick payload building
+ *
+ * These run on every joystick poll / send tick, so anything that shows up here
+ * is paid at the control rate.
+ */
+
+#include <benchmark/benchmark.h>
+#include "includes/benchaccess.hpp"
+
+static void BM_NormalizeAxis(benchmark::State &state)
+{
+    SteeringController controller;
+    int value = -32768;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(BenchAccess::normalizeAxis(controller, value));
+        // Sweep the whole SDL axis range so clamping branches are exercised
+        value = value == 32767 ? -32768 : value + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NormalizeAxis);
+
+// Everything sendSteeringData() does before the socket write
+static void BM_SerializeDataPayload(benchmark::State &state)
+{
+    SteeringController controller;
+    SteeringControllerService service(&controller);
+    qint64 bytes = 0;
+
+    for (auto _ : state) {
+        const QByteArray &json = BenchAccess::serializeDataPayload(service);
+        benchmark::DoNotOptimize(json.constData());
+        bytes += json.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_SerializeDataPayload);
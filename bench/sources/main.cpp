@@ -0,0 +1,47 @@
+/**
+ * @file main.cpp
+ * @brief driver_bench entry point: driver_bench [--benchmark_* options]
+ *
+ * Writes JSON to stdout by default so runs can be diffed / fed to
+ * Google Benchmark's compare.py; pass --benchmark_format=console to override.
+ */
+
+#include <benchmark/benchmark.h>
+#include <QGuiApplication>
+#include <gst/gst.h>
+#include "includes/allocationcounter.hpp"
+#include "includes/gstplugins.hpp"
+#include <cstring>
+#include <vector>
+
+int main(int argc, char *argv[])
+{
+    // QImage JPEG plugins and queued signal delivery need an application object;
+    // offscreen keeps the run independent of a display
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+    // Same plugin set / registry as the app (DRIVER_GST_PLUGINS)
+    GstPlugins::prepare();
+    gst_init(&argc, &argv);
+    GstPlugins::registerStatic();
+
+    std::vector<char *> args(argv, argv + argc);
+    bool formatGiven = false;
+    for (char *arg : args) {
+        formatGiven = formatGiven || std::strncmp(arg, "--benchmark_format=", 19) == 0;
+    }
+    char jsonFormat[] = "--benchmark_format=json";
+    if (!formatGiven) {
+        args.push_back(jsonFormat);
+    }
+
+    int benchArgc = static_cast<int>(args.size());
+    benchmark::Initialize(&benchArgc, args.data());
+    if (benchmark::ReportUnrecognizedArguments(benchArgc, args.data())) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    // Allocation budgets are regression checks, so make them visible to CI
+    return AllocationCounter::budgetExceeded() ? 1 : 0;
+}
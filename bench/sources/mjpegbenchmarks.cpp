@@ -0,0 +1,63 @@
+/**
+ * @file mjpegbenchmarks.cpp
+ * @brief HTTP MJPEG path: multipart parsing and JPEG decoding
+ *
+ * BM_MjpegProcessBuffer replays a whole multipart stream in network-sized chunks
+ * (argument: chunk size in bytes), which covers marker scanning, buffer
+ * compaction and decoding. BM_DecodeJpeg isolates the decode (argument: index
+ * into BenchData::Resolutions).
+ */
+
+#include <benchmark/benchmark.h>
+#include "includes/benchaccess.hpp"
+#include "includes/benchdata.hpp"
+
+static void BM_MjpegProcessBuffer(benchmark::State &state)
+{
+    const BenchData::MjpegStream &stream = BenchData::mjpegStream();
+    const qsizetype chunkSize = state.range(0);
+    MjpegDecoder decoder;
+
+    // Frame count straight from the decoder, so recorded streams need no metadata
+    int frames = 0;
+    QObject::connect(&decoder, &MjpegDecoder::imageUpdated, [&frames]() { ++frames; });
+    for (qsizetype offset = 0; offset < stream.data.size(); offset += chunkSize) {
+        BenchAccess::feedMjpeg(decoder, stream.data.constData() + offset, qMin(chunkSize, stream.data.size() - offset));
+    }
+    BenchAccess::resetMjpeg(decoder);
+    if (frames == 0) {
+        state.SkipWithError("No JPEG frames found in the MJPEG stream");
+        return;
+    }
+    const int framesPerPass = frames;
+
+    for (auto _ : state) {
+        for (qsizetype offset = 0; offset < stream.data.size(); offset += chunkSize) {
+            BenchAccess::feedMjpeg(decoder, stream.data.constData() + offset, qMin(chunkSize, stream.data.size() - offset));
+        }
+        BenchAccess::resetMjpeg(decoder);
+    }
+
+    state.SetLabel(stream.source.toStdString());
+    state.SetItemsProcessed(state.iterations() * framesPerPass);
+    state.SetBytesProcessed(state.iterations() * stream.data.size());
+}
+// Typical TCP segment, a modest read and a large burst
+BENCHMARK(BM_MjpegProcessBuffer)->Arg(1460)->Arg(16384)->Arg(65536)->Unit(benchmark::kMillisecond);
+
+static void BM_DecodeJpeg(benchmark::State &state)
+{
+    const BenchData::Resolution &resolution = BenchData::Resolutions[state.range(0)];
+    QByteArray jpeg = BenchData::syntheticJpeg(resolution.width, resolution.height);
+    MjpegDecoder decoder;
+
+    for (auto _ : state) {
+        QImage image = BenchAccess::decodeJpeg(decoder, jpeg);
+        benchmark::DoNotOptimize(image.constBits());
+    }
+
+    state.SetLabel(resolution.name);
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * jpeg.size());
+}
+BENCHMARK(BM_DecodeJpeg)->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
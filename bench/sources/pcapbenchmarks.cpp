@@ -0,0 +1,122 @@
+/**
+ * @file pcapbenchmarks.cpp
+ * @brief Ingest + depayload + decode of a recorded capture (DRIVER_BENCH_PCAP)
+ *
+ * Replays the capture as fast as possible into a VideoStreamReceiver appsrc
+ * (external ingest, no sockets) and times until the last frame has come out
+ * of the appsink; pipeline setup and the settle wait are not timed. Field
+ * captures keep their loss and reordering, so this is the regression
+ * benchmark closest to the car. Skipped without DRIVER_BENCH_PCAP;
+ * DRIVER_BENCH_PCAP_PORT selects the video flow in a capture with several.
+ */
+
+#include <benchmark/benchmark.h>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThread>
+#include <memory>
+#include "includes/pcapreplaysource.hpp"
+#include "includes/videoscreenreciever.hpp"
+
+namespace {
+constexpr int BenchPort = 5000;
+// Decoding is done once framesDecoded stops moving for this long after the replay
+constexpr qint64 SettleMs = 200;
+constexpr qint64 MaxDrainMs = 30000;
+
+/**
+ * @brief The capture, loaded once per process
+ */
+PcapReplaySource *loadedCapture(QString *errorMessage)
+{
+    static std::unique_ptr<PcapReplaySource> replay;
+    static QString loadError;
+    static bool attempted = false;
+    if (!attempted) {
+        attempted = true;
+        if (!qEnvironmentVariableIsSet("DRIVER_BENCH_PCAP")) {
+            loadError = "DRIVER_BENCH_PCAP not set";
+        } else {
+            PcapReplaySource::Config config;
+            config.path = qEnvironmentVariable("DRIVER_BENCH_PCAP");
+            config.udpPort = static_cast<quint16>(qEnvironmentVariableIntValue("DRIVER_BENCH_PCAP_PORT"));
+            config.speed = 0.0;
+            config.loops = 1;
+            replay = std::make_unique<PcapReplaySource>();
+            if (!replay->load(config, &loadError)) {
+                replay.reset();
+            }
+        }
+    }
+    *errorMessage = loadError;
+    return replay.get();
+}
+}
+
+static void BM_PcapIngest(benchmark::State &state)
+{
+    QString error;
+    PcapReplaySource *replay = loadedCapture(&error);
+    if (!replay) {
+        state.SkipWithError(error.toUtf8().constData());
+        return;
+    }
+
+    VideoStreamReceiver receiver;
+    receiver.setExternalIngest(true);
+    qint64 framesDecoded = 0;
+    qint64 packets = 0;
+    qint64 bytes = 0;
+
+    for (auto _ : state) {
+        // Fresh pipeline per pass so depayloader/decoder state doesn't carry over
+        receiver.startStream(BenchPort);
+        if (!receiver.isStreaming()) {
+            state.SkipWithError("pipeline did not start");
+            break;
+        }
+        QCoreApplication::processEvents();
+
+        QElapsedTimer waited;
+        waited.start();
+        replay->start([&receiver](const PcapReplaySource::Packet &packet) {
+            receiver.pushExternalPacket(packet);
+        });
+
+        // Keep the GUI side draining while the replay thread pushes
+        qint64 lastDecoded = -1;
+        qint64 stableSinceMs = 0;
+        qint64 lastChangeNs = 0;
+        while (waited.elapsed() < MaxDrainMs) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 1);
+            if (replay->isRunning()) {
+                continue;
+            }
+            qint64 decoded = receiver.pipelineStats().framesDecoded;
+            if (decoded != lastDecoded) {
+                lastDecoded = decoded;
+                stableSinceMs = waited.elapsed();
+                lastChangeNs = waited.nsecsElapsed();
+            } else if (waited.elapsed() - stableSinceMs >= SettleMs) {
+                break;
+            }
+            QThread::msleep(1);
+        }
+
+        state.SetIterationTime(lastChangeNs / 1e9);
+        replay->stop();
+        framesDecoded += receiver.pipelineStats().framesDecoded;
+        packets += replay->stats().packets;
+        bytes += replay->stats().bytes;
+        receiver.stopStream();
+        QCoreApplication::processEvents();
+    }
+
+    state.SetLabel(QString("%1 packets, %2 s capture").arg(replay->packetCount())
+                   .arg(replay->captureDurationS(), 0, 'f', 1).toStdString());
+    state.SetItemsProcessed(packets);
+    state.SetBytesProcessed(bytes);
+    state.counters["frames_decoded"] = benchmark::Counter(double(framesDecoded), benchmark::Counter::kAvgIterations);
+    state.counters["decoded_fps"] = benchmark::Counter(double(framesDecoded), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_PcapIngest)->Unit(benchmark::kMillisecond)->UseManualTime()->Iterations(5);
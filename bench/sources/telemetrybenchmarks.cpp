@@ -0,0 +1,49 @@
+/**
+ * @file telemetrybenchmarks.cpp
+ * @brief Time series store: append at the input rate, chart queries over long windows
+ *
+ * A query must cost O(samples in the window), independent of how much history
+ * the store holds, and appends must stop allocating once the budget is reached.
+ */
+
+#include <benchmark/benchmark.h>
+#include "includes/timeseriesstore.hpp"
+
+namespace {
+constexpr size_t BudgetBytes = 64 * 1024 * 1024;
+constexpr qint64 SampleIntervalUs = 1000;  // 1 kHz input
+constexpr int ChartPoints = 500;
+}
+
+static void BM_TimeSeriesAppend(benchmark::State &state)
+{
+    TimeSeriesStore store(BudgetBytes);
+    int series = store.addSeries("steering");
+    qint64 timeUs = 0;
+
+    for (auto _ : state) {
+        store.append(series, timeUs, float(timeUs % 2000) / 1000.0f - 1.0f);
+        timeUs += SampleIntervalUs;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimeSeriesAppend);
+
+// Arg: window in seconds of a one-hour 1 kHz series, reduced to ChartPoints
+static void BM_TimeSeriesQuery(benchmark::State &state)
+{
+    TimeSeriesStore store(BudgetBytes);
+    int series = store.addSeries("steering");
+    qint64 endUs = 3600LL * 1000000;
+    for (qint64 timeUs = 0; timeUs < endUs; timeUs += SampleIntervalUs) {
+        store.append(series, timeUs, float((timeUs / 1000) % 2000) / 1000.0f - 1.0f);
+    }
+    qint64 windowUs = state.range(0) * 1000000LL;
+
+    for (auto _ : state) {
+        std::vector<TimeSeriesStore::Point> points = store.query(series, endUs - windowUs, endUs, ChartPoints);
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (windowUs / SampleIntervalUs));
+}
+BENCHMARK(BM_TimeSeriesQuery)->Arg(30)->Arg(600)->Arg(3600)->Unit(benchmark::kMicrosecond);
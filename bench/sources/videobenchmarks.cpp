@@ -0,0 +1,38 @@
+/**
+ * @file videobenchmarks.cpp
+ * @brief Appsink hot path: VideoStreamReceiver::processNewSample()
+ *
+ * Runs on the GStreamer streaming thread for every decoded frame (copy, mirror,
+ * latency bookkeeping, hand-off to the GUI thread). Argument: index into
+ * BenchData::Resolutions.
+ */
+
+#include <benchmark/benchmark.h>
+#include <QCoreApplication>
+#include "includes/benchaccess.hpp"
+#include "includes/benchdata.hpp"
+
+static void BM_ProcessNewSample(benchmark::State &state)
+{
+    const BenchData::Resolution &resolution = BenchData::Resolutions[state.range(0)];
+    VideoStreamReceiver receiver;
+    BenchAccess::StreamPipeline *stream = BenchAccess::installStream(receiver);
+    GstSample *sample = BenchData::syntheticSample(resolution.width, resolution.height);
+
+    for (auto _ : state) {
+        BenchAccess::processNewSample(receiver, stream, sample);
+
+        // Each call queues the frame for the GUI thread; deliver it untimed so the
+        // event queue does not grow over the run. The stream is the active one, so
+        // the frame replaces the one on screen, as in the app, instead of being dropped
+        state.PauseTiming();
+        QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+        state.ResumeTiming();
+    }
+
+    state.SetLabel(resolution.name);
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(resolution.width) * resolution.height * 3);
+    gst_sample_unref(sample);
+}
+BENCHMARK(BM_ProcessNewSample)->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
@@ -3,14 +3,26 @@
 
 #include <QObject>
 #include <QtWebSockets/QWebSocket>
+#include <QHostAddress>
+#include <QHostInfo>
+#include <QElapsedTimer>
+#include <QTimer>
 #include <QUrl>
 #include <QJsonObject>
 #include <QJsonDocument>
+#include <QVariantMap>
+#include <array>
+#include <vector>
 #include "../../src/includes/steeringcontroller.hpp"
+#include "../../src/includes/timestampedudpsocket.hpp"
 
 class SteeringControllerService : public QObject
 {
     Q_OBJECT
+    // When enabled every control state is sent over both WebSocket and UDP,
+    // the car applies whichever copy arrives first (dedup by "seq")
+    Q_PROPERTY(bool hedgedDelivery READ hedgedDelivery WRITE setHedgedDelivery NOTIFY hedgedDeliveryChanged)
+    Q_PROPERTY(int udpPort READ udpPort WRITE setUdpPort NOTIFY udpPortChanged)
 public:
     explicit SteeringControllerService(SteeringController * controller, QObject *parent=nullptr);
     ~SteeringControllerService();
@@ -20,27 +32,96 @@ public:
     Q_INVOKABLE void disconnect();
     Q_INVOKABLE bool isConnected() const;
 
-signals: 
+    // hedged delivery
+    bool hedgedDelivery() const { return m_hedgedDelivery; }
+    void setHedgedDelivery(bool enabled);
+    int udpPort() const { return m_udpPort; }
+    void setUdpPort(int port);
+
+    // Per-path win rates and RTTs (ms) for the hedged control channel
+    Q_INVOKABLE QVariantMap hedgeStatistics() const;
+    Q_INVOKABLE void resetHedgeStatistics();
+
+signals:
     void connected();
     void disconnected();
     void errorOccurred(const QString &error);
+    void hedgedDeliveryChanged();
+    void udpPortChanged();
+    void hedgeStatisticsChanged();
+    // Every control message written; sentWallNs is CLOCK_REALTIME like kernel RX stamps
+    void controlSent(double steering, double throttle, qint64 sentWallNs);
 
 private slots:
     void onConnected();
     void onDisconnected();
     void onError(QAbstractSocket::SocketError error);
+    void onTextMessageReceived(const QString &message);
+    void onUdpReadyRead();
+    void onUdpHostLookedUp(const QHostInfo &info);
+    void onHedgeReportTimeout();
 
     void onSteeringDataChanged();
 
 private:
+    friend struct BenchAccess;  // Microbenchmarks (bench/) drive the private hot paths
+
+    enum class Path { WebSocket, Udp };
+
+    // One in-flight control message, indexed by seq % PendingWindow; every send is
+    // tracked so the WebSocket RTT is measured with or without hedging
+    struct PendingSend {
+        qint64 seq = -1;
+        qint64 sentNs = 0;
+        qint64 sentWallNs = 0;  // same clock as kernel RX timestamps
+        qint64 wsRttNs = -1;
+        qint64 udpRttNs = -1;
+        bool hedged = false;    // also sent over UDP; only these count as races
+        bool resolved = false;  // the car reported which copy it applied
+    };
+    static constexpr int PendingWindow = 256;
+    static constexpr int RttWindow = 512;
+
     QWebSocket *m_webSocket;
+    TimestampedUdpSocket *m_udpSocket;
     SteeringController *m_controller;
     bool m_isConnected;
+    bool m_everConnected;  // a later connect counts as a reconnect
     QString m_url;
 
+    bool m_hedgedDelivery;
+    int m_udpPort;
+    QHostAddress m_udpHost;  // IPv4 (the UDP socket is bound to AnyIPv4), null until known
+    int m_udpHostLookupId;   // pending QHostInfo lookup, -1 if none
+    bool m_udpHostMissingLogged;
+    qint64 m_sequence;
+    QByteArray m_sendBuffer;  // serialized control message, reused so sends don't allocate it
+    QString m_sendText;       // the same as text for the WebSocket, reused likewise
+    QElapsedTimer m_clock;
+    QTimer *m_hedgeReportTimer;
+
+    std::array<PendingSend, PendingWindow> m_pending;
+    std::vector<qint64> m_wsRtts;   // ring of recent WebSocket RTTs (ns)
+    std::vector<qint64> m_udpRtts;  // ring of recent UDP RTTs (ns)
+    int m_wsRttIndex;
+    int m_udpRttIndex;
+    qint64 m_hedgedSent;
+    qint64 m_wsWins;
+    qint64 m_udpWins;
+    qint64 m_pairedSamples;
+    qint64 m_pairedDeltaNsSum;  // sum of (wsRtt - udpRtt) over messages acked on both paths
+    // UDP acks split by the kernel RX timestamp: send -> kernel RX is network + car,
+    // kernel RX -> our read is time spent waiting in this process
+    qint64 m_udpStampedAcks;
+    qint64 m_udpWireRttNsSum;
+    qint64 m_udpInProcessNsSum;
+
     //private methods
     void sendSteeringData();
-    QJsonObject createDataPayload() const;
+    const QByteArray &serializeDataPayload();
+    void handleAck(const QJsonObject &ack, Path path, qint64 kernelRxNs = -1, qint64 userRxNs = 0);
+    void recordRtt(std::vector<qint64> &ring, int &index, qint64 rttNs);
+    void setUdpHost(const QHostAddress &address, const QString &source);
 };
 
 #endif // STEERINGCONTROLLERSERVICE_H
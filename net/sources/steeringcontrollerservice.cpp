@@ -1,16 +1,114 @@
 #include "includes/steeringcontrollerservice.hpp"
 #include "../../src/includes/steeringcontroller.hpp"
-#include <QDebug>
+#include "../../src/includes/tracing.hpp"
+#include "../../src/includes/logging.hpp"
+#include "../../src/includes/metrics.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace {
+struct ControlMetrics
+{
+    MetricsRegistry &registry = MetricsRegistry::instance();
+    MetricCounter &wsSent = registry.counter(
+        "driver_control_messages_sent_total", "Control messages sent", "path=\"ws\"");
+    MetricCounter &udpSent = registry.counter(
+        "driver_control_messages_sent_total", "Control messages sent", "path=\"udp\"");
+    MetricCounter &skippedDisconnected = registry.counter(
+        "driver_control_send_skipped_total", "Control changes not sent", "reason=\"disconnected\"");
+    MetricHistogram &wsRtt = registry.histogram(
+        "driver_control_rtt_seconds", "Send to car ack", MetricsRegistry::latencyBuckets(), "path=\"ws\"");
+    MetricHistogram &udpRtt = registry.histogram(
+        "driver_control_rtt_seconds", "Send to car ack", MetricsRegistry::latencyBuckets(), "path=\"udp\"");
+    MetricCounter &connects = registry.counter(
+        "driver_control_connects_total", "WebSocket connections established");
+    MetricCounter &reconnects = registry.counter(
+        "driver_control_reconnects_total", "WebSocket connections after the first");
+    MetricCounter &errors = registry.counter(
+        "driver_control_errors_total", "WebSocket errors");
+    MetricGauge &connected = registry.gauge(
+        "driver_control_connected", "1 while the WebSocket is connected");
+};
+
+ControlMetrics &controlMetrics()
+{
+    static ControlMetrics metrics;
+    return metrics;
+}
+
+// The UDP socket is IPv4; IPv4-mapped IPv6 addresses (e.g. a peer address) are unwrapped
+QHostAddress ipv4Address(const QHostAddress &address)
+{
+    bool ok = false;
+    quint32 ipv4 = address.toIPv4Address(&ok);
+    return ok ? QHostAddress(ipv4) : QHostAddress();
+}
+
+constexpr int SendBufferReserve = 96;  // longest payload: three shortest round-trip numbers and the keys
+
+// Shortest round-trip form, as QJsonDocument writes it; JSON has no NaN or infinity
+void appendNumber(QByteArray &out, double value)
+{
+    char digits[32];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), std::isfinite(value) ? value : 0.0);
+    out.append(digits, result.ptr - digits);
+}
+
+void appendNumber(QByteArray &out, qint64 value)
+{
+    char digits[24];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr - digits);
+}
+}
 
 SteeringControllerService::SteeringControllerService(SteeringController *controller, QObject *parent)
     : QObject(parent)
     , m_webSocket(new QWebSocket(QString(), QWebSocketProtocol::VersionLatest, this))
+    , m_udpSocket(new TimestampedUdpSocket(this))
     , m_controller(controller)
     , m_isConnected(false)
+    , m_everConnected(false)
+    , m_hedgedDelivery(false)
+    , m_udpPort(8766)
+    , m_udpHostLookupId(-1)
+    , m_udpHostMissingLogged(false)
+    , m_sequence(0)
+    , m_hedgeReportTimer(new QTimer(this))
+    , m_wsRtts(RttWindow, -1)
+    , m_udpRtts(RttWindow, -1)
+    , m_wsRttIndex(0)
+    , m_udpRttIndex(0)
+    , m_hedgedSent(0)
+    , m_wsWins(0)
+    , m_udpWins(0)
+    , m_pairedSamples(0)
+    , m_pairedDeltaNsSum(0)
+    , m_udpStampedAcks(0)
+    , m_udpWireRttNsSum(0)
+    , m_udpInProcessNsSum(0)
 {
+    m_clock.start();
+    m_sendBuffer.reserve(SendBufferReserve);
+    m_sendText.reserve(SendBufferReserve);
+    controlMetrics();  // register the series before the first scrape
+
     connect(m_webSocket, &QWebSocket::connected, this, &SteeringControllerService::onConnected);
     connect(m_webSocket, &QWebSocket::disconnected, this, &SteeringControllerService::onDisconnected);
     connect(m_webSocket, &QWebSocket::errorOccurred, this, &SteeringControllerService::onError);
+    connect(m_webSocket, &QWebSocket::textMessageReceived,
+            this, &SteeringControllerService::onTextMessageReceived);
+
+    // Bound to an ephemeral port so the car can ack back to us on the UDP path;
+    // on Linux acks carry kernel RX timestamps
+    connect(m_udpSocket, &TimestampedUdpSocket::readyRead, this, &SteeringControllerService::onUdpReadyRead);
+    if (!m_udpSocket->bind(QHostAddress::AnyIPv4, 0)) {
+        LOG_WARN("SteeringControllerService", "Failed to bind control UDP socket: {}", m_udpSocket->errorString());
+    }
+
+    m_hedgeReportTimer->setInterval(1000);
+    connect(m_hedgeReportTimer, &QTimer::timeout, this, &SteeringControllerService::onHedgeReportTimeout);
 
     if (m_controller) {
         connect(m_controller, &SteeringController::steeringChanged,
@@ -31,18 +129,38 @@ SteeringControllerService::~SteeringControllerService()
 void SteeringControllerService::connectToServer(const QString &url)
 {
     if (m_isConnected) {
-        qWarning() << "Already connected to WebSocket server";
+        LOG_WARN("SteeringControllerService", "Already connected to WebSocket server");
         return;
     }
 
-    qDebug() << "Connecting to WebSocket server:" << url;
+    LOG_DEBUG("SteeringControllerService", "Connecting to WebSocket server: {}", url);
+    m_url = url;
+
+    // UDP goes to the same host as the WebSocket. Literal addresses are used as is;
+    // names are resolved here, and the connected socket's peer address fills in
+    // if the lookup has not finished (or failed) by then.
+    if (m_udpHostLookupId >= 0) {
+        QHostInfo::abortHostLookup(m_udpHostLookupId);
+        m_udpHostLookupId = -1;
+    }
+    m_udpHost.clear();
+    m_udpHostMissingLogged = false;
+    QString host = QUrl(url).host();
+    QHostAddress literal;
+    if (host == "localhost") {
+        setUdpHost(QHostAddress(QHostAddress::LocalHost), "localhost");
+    } else if (literal.setAddress(host)) {
+        setUdpHost(literal, "URL");
+    } else if (!host.isEmpty()) {
+        m_udpHostLookupId = QHostInfo::lookupHost(host, this, &SteeringControllerService::onUdpHostLookedUp);
+    }
     m_webSocket->open(QUrl(url));
 }
 
 void SteeringControllerService::disconnect()
 {
     if (m_webSocket && m_isConnected) {
-        qDebug() << "Disconnecting from WebSocket server";
+        LOG_DEBUG("SteeringControllerService", "Disconnecting from WebSocket server");
         m_webSocket->close();
     }
 }
@@ -52,10 +170,50 @@ bool SteeringControllerService::isConnected() const
     return m_isConnected;
 }
 
+void SteeringControllerService::setHedgedDelivery(bool enabled)
+{
+    if (m_hedgedDelivery == enabled) {
+        return;
+    }
+
+    m_hedgedDelivery = enabled;
+    LOG_DEBUG("SteeringControllerService", "Hedged control delivery {} - UDP port {}", (enabled ? "enabled" : "disabled"), m_udpPort);
+
+    if (enabled) {
+        m_hedgeReportTimer->start();
+    } else {
+        m_hedgeReportTimer->stop();
+    }
+    emit hedgedDeliveryChanged();
+}
+
+void SteeringControllerService::setUdpPort(int port)
+{
+    if (port < 1 || port > 65535) {
+        LOG_WARN("SteeringControllerService", "Invalid UDP control port: {}", port);
+        return;
+    }
+    if (m_udpPort == port) {
+        return;
+    }
+
+    m_udpPort = port;
+    emit udpPortChanged();
+}
+
 void SteeringControllerService::onConnected()
 {
     m_isConnected = true;
-    qDebug() << "WebSocket connected to:" << m_webSocket->requestUrl();
+    controlMetrics().connects.increment();
+    if (m_everConnected) {
+        controlMetrics().reconnects.increment();
+    }
+    m_everConnected = true;
+    controlMetrics().connected.set(1);
+    LOG_DEBUG("SteeringControllerService", "WebSocket connected to: {}", m_webSocket->requestUrl().toString());
+    if (m_udpHost.isNull()) {
+        setUdpHost(m_webSocket->peerAddress(), "WebSocket peer");
+    }
     emit connected();
 
     // Send initial state
@@ -65,14 +223,16 @@ void SteeringControllerService::onConnected()
 void SteeringControllerService::onDisconnected()
 {
     m_isConnected = false;
-    qDebug() << "WebSocket disconnected";
+    controlMetrics().connected.set(0);
+    LOG_DEBUG("SteeringControllerService", "WebSocket disconnected");
     emit disconnected();
 }
 
 void SteeringControllerService::onError(QAbstractSocket::SocketError error)
 {
     QString errorString = m_webSocket->errorString();
-    qWarning() << "WebSocket error:" << error << "-" << errorString;
+    controlMetrics().errors.increment();
+    LOG_WARN("SteeringControllerService", "WebSocket error: {} - {}", error, errorString);
     emit errorOccurred(errorString);
 }
 
@@ -81,6 +241,8 @@ void SteeringControllerService::onSteeringDataChanged()
     // Only send data if connected
     if (m_isConnected) {
         sendSteeringData();
+    } else {
+        controlMetrics().skippedDisconnected.increment();
     }
 }
 
@@ -89,21 +251,247 @@ void SteeringControllerService::sendSteeringData()
     if (!m_controller || !m_isConnected) {
         return;
     }
+    TRACE_SCOPE("sendSteeringData");
 
-    QJsonObject packet = createDataPayload();
-    QJsonDocument doc(packet);
-    QString jsonString = doc.toJson(QJsonDocument::Compact);
-    m_webSocket->sendTextMessage(jsonString);
+    ++m_sequence;
+    const QByteArray &json = serializeDataPayload();
+    qint64 sentWallNs = TimestampedUdpSocket::wallClockNs();
+
+    if (m_hedgedDelivery && m_udpHost.isNull() && !m_udpHostMissingLogged) {
+        LOG_WARN("SteeringControllerService", "No IPv4 address for {} - sending control over WebSocket only",
+                 QUrl(m_url).host());
+        m_udpHostMissingLogged = true;
+    }
+    PendingSend &pending = m_pending[m_sequence % PendingWindow];
+    pending = PendingSend();
+    pending.seq = m_sequence;
+    pending.sentNs = m_clock.nsecsElapsed();
+    pending.sentWallNs = sentWallNs;
+
+    if (m_hedgedDelivery && !m_udpHost.isNull()) {
+        pending.hedged = true;
+        ++m_hedgedSent;
+
+        // UDP first: it has no framing/masking work and no head-of-line blocking
+        m_udpSocket->writeDatagram(json, m_udpHost, static_cast<quint16>(m_udpPort));
+        controlMetrics().udpSent.increment();
+    }
+
+    // The payload is ASCII; QWebSocket encodes the text right away and keeps no reference
+    m_sendText.resize(0);
+    m_sendText.append(QLatin1String(json.constData(), json.size()));
+    m_webSocket->sendTextMessage(m_sendText);
+    controlMetrics().wsSent.increment();
+    emit controlSent(m_controller->steering(), m_controller->throttle(), sentWallNs);
 }
 
-QJsonObject SteeringControllerService::createDataPayload() const
+// Same bytes as QJsonDocument(Compact) of {seq, steering, throttle}, written into the
+// reused m_sendBuffer: a QJsonObject and its serialization cost several allocations per message
+const QByteArray &SteeringControllerService::serializeDataPayload()
 {
-    QJsonObject packet;
-
+    m_sendBuffer.truncate(0);  // keeps the capacity
+    m_sendBuffer.append('{');
     if (m_controller) {
-        packet["steering"] = m_controller->steering();
-        packet["throttle"] = m_controller->throttle();
+        m_sendBuffer.append("\"seq\":");
+        appendNumber(m_sendBuffer, m_sequence);
+        m_sendBuffer.append(",\"steering\":");
+        appendNumber(m_sendBuffer, double(m_controller->steering()));
+        m_sendBuffer.append(",\"throttle\":");
+        appendNumber(m_sendBuffer, double(m_controller->throttle()));
+    }
+    m_sendBuffer.append('}');
+    return m_sendBuffer;
+}
+
+void SteeringControllerService::onTextMessageReceived(const QString &message)
+{
+    QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
+    if (doc.isObject() && doc.object().contains("ack")) {
+        handleAck(doc.object(), Path::WebSocket);
+    }
+}
+
+void SteeringControllerService::onUdpReadyRead()
+{
+    TimestampedDatagram datagram;
+    while (m_udpSocket->readDatagram(datagram)) {
+        QJsonDocument doc = QJsonDocument::fromJson(datagram.data);
+        if (doc.isObject() && doc.object().contains("ack")) {
+            handleAck(doc.object(), Path::Udp, datagram.kernelRxNs, datagram.userRxNs);
+        }
+    }
+}
+
+// The car acks every copy on the path it arrived on; "first" marks the copy it applied
+void SteeringControllerService::handleAck(const QJsonObject &ack, Path path, qint64 kernelRxNs, qint64 userRxNs)
+{
+    qint64 seq = ack["ack"].toInteger(-1);
+    if (seq < 0) {
+        return;
+    }
+
+    PendingSend &pending = m_pending[seq % PendingWindow];
+    if (pending.seq != seq) {
+        return;  // fell out of the tracking window
+    }
+
+    qint64 rttNs = m_clock.nsecsElapsed() - pending.sentNs;
+    if (path == Path::WebSocket) {
+        if (pending.wsRttNs >= 0) return;
+        pending.wsRttNs = rttNs;
+        controlMetrics().wsRtt.observeNs(rttNs);
+        recordRtt(m_wsRtts, m_wsRttIndex, rttNs);
+    } else {
+        if (pending.udpRttNs >= 0) return;
+        pending.udpRttNs = rttNs;
+        controlMetrics().udpRtt.observeNs(rttNs);
+        recordRtt(m_udpRtts, m_udpRttIndex, rttNs);
+
+        if (kernelRxNs >= 0) {
+            ++m_udpStampedAcks;
+            m_udpWireRttNsSum += kernelRxNs - pending.sentWallNs;
+            m_udpInProcessNsSum += userRxNs - kernelRxNs;
+        }
+    }
+
+    // Win rates and path deltas only mean something when both paths raced
+    if (!pending.hedged) {
+        return;
+    }
+
+    if (ack["first"].toBool() && !pending.resolved) {
+        pending.resolved = true;
+        if (path == Path::WebSocket) {
+            ++m_wsWins;
+        } else {
+            ++m_udpWins;
+        }
+    }
+
+    if (pending.wsRttNs >= 0 && pending.udpRttNs >= 0) {
+        ++m_pairedSamples;
+        m_pairedDeltaNsSum += pending.wsRttNs - pending.udpRttNs;
+    }
+}
+
+void SteeringControllerService::onUdpHostLookedUp(const QHostInfo &info)
+{
+    if (info.lookupId() != m_udpHostLookupId) {
+        return;  // superseded by a later connectToServer()
+    }
+    m_udpHostLookupId = -1;
+    if (!m_udpHost.isNull()) {
+        return;  // the WebSocket connected first and its peer address is in use
+    }
+    if (info.error() != QHostInfo::NoError) {
+        LOG_WARN("SteeringControllerService", "Cannot resolve {} for the UDP path: {}",
+                 info.hostName(), info.errorString());
+        return;
+    }
+    for (const QHostAddress &address : info.addresses()) {
+        if (!ipv4Address(address).isNull()) {
+            setUdpHost(address, info.hostName());
+            return;
+        }
+    }
+    LOG_WARN("SteeringControllerService", "{} has no IPv4 address for the UDP path", info.hostName());
+}
+
+void SteeringControllerService::setUdpHost(const QHostAddress &address, const QString &source)
+{
+    m_udpHost = ipv4Address(address);
+    if (m_udpHost.isNull()) {
+        LOG_WARN("SteeringControllerService", "UDP control needs an IPv4 address, {} gave {}",
+                 source, address.toString());
+        return;
+    }
+    LOG_DEBUG("SteeringControllerService", "UDP control to {}:{} (from {})", m_udpHost.toString(), m_udpPort, source);
+}
+
+void SteeringControllerService::recordRtt(std::vector<qint64> &ring, int &index, qint64 rttNs)
+{
+    ring[index] = rttNs;
+    index = (index + 1) % RttWindow;
+}
+
+QVariantMap SteeringControllerService::hedgeStatistics() const
+{
+    // Percentiles over the most recent RttWindow acks of each path
+    auto percentiles = [](const std::vector<qint64> &ring) {
+        std::vector<qint64> samples;
+        samples.reserve(ring.size());
+        for (qint64 rtt : ring) {
+            if (rtt >= 0) samples.push_back(rtt);
+        }
+
+        QVariantMap result;
+        result["samples"] = static_cast<int>(samples.size());
+        if (samples.empty()) {
+            return result;
+        }
+        std::sort(samples.begin(), samples.end());
+        auto at = [&samples](double q) {
+            size_t i = static_cast<size_t>(q * (samples.size() - 1));
+            return samples[i] / 1e6;
+        };
+        result["p50Ms"] = at(0.50);
+        result["p99Ms"] = at(0.99);
+        result["maxMs"] = samples.back() / 1e6;
+        return result;
+    };
+
+    qint64 decided = m_wsWins + m_udpWins;
+
+    QVariantMap stats;
+    stats["enabled"] = m_hedgedDelivery;
+    stats["sent"] = m_hedgedSent;
+    stats["wsWins"] = m_wsWins;
+    stats["udpWins"] = m_udpWins;
+    stats["wsWinRate"] = decided > 0 ? double(m_wsWins) / decided : 0.0;
+    stats["udpWinRate"] = decided > 0 ? double(m_udpWins) / decided : 0.0;
+    stats["unacked"] = m_hedgedSent - decided;
+    // Positive means UDP arrived earlier on average
+    stats["meanWsMinusUdpMs"] = m_pairedSamples > 0
+        ? (double(m_pairedDeltaNsSum) / m_pairedSamples) / 1e6 : 0.0;
+    stats["kernelTimestamps"] = m_udpSocket->hasKernelTimestamps();
+    stats["udpWireRttMeanMs"] = m_udpStampedAcks > 0
+        ? (double(m_udpWireRttNsSum) / m_udpStampedAcks) / 1e6 : 0.0;
+    stats["udpInProcessMeanUs"] = m_udpStampedAcks > 0
+        ? (double(m_udpInProcessNsSum) / m_udpStampedAcks) / 1e3 : 0.0;
+    stats["ws"] = percentiles(m_wsRtts);
+    stats["udp"] = percentiles(m_udpRtts);
+    return stats;
+}
+
+void SteeringControllerService::resetHedgeStatistics()
+{
+    m_pending.fill(PendingSend());
+    std::fill(m_wsRtts.begin(), m_wsRtts.end(), -1);
+    std::fill(m_udpRtts.begin(), m_udpRtts.end(), -1);
+    m_wsRttIndex = 0;
+    m_udpRttIndex = 0;
+    m_hedgedSent = 0;
+    m_wsWins = 0;
+    m_udpWins = 0;
+    m_pairedSamples = 0;
+    m_pairedDeltaNsSum = 0;
+    m_udpStampedAcks = 0;
+    m_udpWireRttNsSum = 0;
+    m_udpInProcessNsSum = 0;
+    emit hedgeStatisticsChanged();
+}
+
+void SteeringControllerService::onHedgeReportTimeout()
+{
+    if (!m_isConnected || m_hedgedSent == 0) {
+        return;
     }
 
-    return packet;
+    QVariantMap stats = hedgeStatistics();
+    LOG_DEBUG("SteeringControllerService",
+              "Hedged delivery: sent {} ws wins {} udp wins {} ws-udp {} ms p99 ws {} ms p99 udp {} ms",
+              stats["sent"].toLongLong(), stats["wsWins"].toLongLong(), stats["udpWins"].toLongLong(),
+              stats["meanWsMinusUdpMs"].toDouble(), stats["ws"].toMap()["p99Ms"].toDouble(),
+              stats["udp"].toMap()["p99Ms"].toDouble());
+    emit hedgeStatisticsChanged();
 }
@@ -0,0 +1,59 @@
+/**
+ * @file controlsview.hpp
+ * @brief Steering wheel, throttle pedal and their bars as one scene graph item
+ *
+ * The QML version (Wheel.qml, Pedal.qml and the progress bars) re-evaluated a
+ * handful of bindings, a Rotation transform and two animations on every
+ * steeringChanged()/throttleChanged(), i.e. at input rate. This item binds to
+ * nothing: input changes only mark it dirty, and updatePaintNode() reads the
+ * controller's snapshot once per rendered frame and moves a transform node and
+ * two rectangles. The wheel and pedal artwork is rasterized once into textures
+ * (again only when the size or device pixel ratio changes).
+ */
+
+#ifndef CONTROLSVIEW_H
+#define CONTROLSVIEW_H
+
+// Qt includes
+#include <QPointer>      // Controller may be destroyed before the item
+#include <QQuickItem>    // Base class for custom scene graph items
+
+class SteeringController;
+
+/**
+ * @class ControlsView
+ * @brief Draws the live controls of a SteeringController (QML: ControlsView { controller: ... })
+ *
+ * Layout, left to right: centered steering bar above the wheel, then the pedal
+ * with its vertical throttle bar. Scales uniformly to the item size; the
+ * implicit size matches the former Wheel + Pedal row.
+ */
+class ControlsView : public QQuickItem
+{
+    Q_OBJECT
+    QML_ELEMENT
+
+    Q_PROPERTY(SteeringController *controller READ controller WRITE setController NOTIFY controllerChanged)
+
+public:
+    explicit ControlsView(QQuickItem *parent = nullptr);
+
+    SteeringController *controller() const { return m_controller; }
+    void setController(SteeringController *controller);
+
+signals:
+    void controllerChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+    void itemChange(ItemChange change, const ItemChangeData &value) override;
+
+private:
+    QPointer<SteeringController> m_controller;
+    QMetaObject::Connection m_steeringConnection;
+    QMetaObject::Connection m_throttleConnection;
+    bool m_artworkDirty;  ///< Re-rasterize on the next updatePaintNode() (size / DPR change)
+};
+
+#endif // CONTROLSVIEW_H
@@ -0,0 +1,124 @@
+/**
+ * @file framegovernor.hpp
+ * @brief Frame-budget governor: sheds decorative UI work when frames run over budget
+ *
+ * A frame that takes too long to sync and render delays the video image and
+ * the control visuals just as much as the background photo, translucent
+ * overlays and smooth scaling drawn in the same pass. The governor watches the
+ * window's per-frame sync + render time against a budget and steps through
+ * levels that switch those decorations off, one at a time, and back on once
+ * there has been headroom for a while. The video item and ControlsView are never
+ * hidden or throttled; only how they are filtered changes.
+ *
+ * QML binds to the flags (smoothing, translucency, background); the HUD sample
+ * interval is applied by main.cpp. DRIVER_FRAME_GOVERNOR=0 pins level 0,
+ * DRIVER_FRAME_BUDGET_MS overrides the budget (default: 75 % of the refresh
+ * interval).
+ */
+
+#ifndef FRAMEGOVERNOR_H
+#define FRAMEGOVERNOR_H
+
+// Qt includes
+#include <QElapsedTimer> // Sync/render pass clock
+#include <QObject>       // Base class for Qt objects with signal/slot support
+#include <QPointer>      // Window may be destroyed before the governor
+#include <QTimer>        // Evaluation window
+
+// Standard library includes
+#include <atomic>        // Frame costs are recorded on the render thread
+
+class MetricGauge;
+class QQuickWindow;
+
+/**
+ * @class FrameGovernor
+ * @brief Degrades non-essential effects under render load, with hysteresis (QML: "frameGovernor")
+ *
+ * Levels (each includes the ones before):
+ * - 0 Full: everything on
+ * - 1 Reduced: HUD refreshes at 1 Hz, no smooth (bilinear) scaling or rotation
+ * - 2 Minimal: overlays drawn opaque instead of translucent
+ * - 3 Bare: background image hidden
+ *
+ * Every 500 ms window of frames is classified: hot when at least 10 % of the
+ * frames were over budget, cool when almost none were and the mean used less
+ * than half of the budget. Two hot windows in a row step one level down, twenty
+ * cool windows (10 s) step one level back up; idle windows count for neither.
+ */
+class FrameGovernor : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool enabled READ isEnabled CONSTANT)                          ///< DRIVER_FRAME_GOVERNOR != 0
+    Q_PROPERTY(int level READ level NOTIFY levelChanged)                      ///< 0 (full) .. 3 (bare)
+    Q_PROPERTY(QString levelName READ levelName NOTIFY levelChanged)
+    Q_PROPERTY(bool smoothing READ smoothing NOTIFY levelChanged)             ///< Bilinear scaling/rotation allowed
+    Q_PROPERTY(bool translucency READ translucency NOTIFY levelChanged)       ///< Translucent overlays allowed
+    Q_PROPERTY(bool background READ background NOTIFY levelChanged)          ///< Background image shown
+    Q_PROPERTY(int hudIntervalMs READ hudIntervalMs NOTIFY levelChanged)      ///< HUD sample interval
+    Q_PROPERTY(double budgetMs READ budgetMs NOTIFY budgetChanged)            ///< Sync + render budget per frame
+    Q_PROPERTY(double frameCostMs READ frameCostMs NOTIFY sampled)            ///< Mean sync + render time, last window
+
+public:
+    enum Level {
+        Full = 0,
+        Reduced,
+        Minimal,
+        Bare
+    };
+    Q_ENUM(Level)
+
+    explicit FrameGovernor(QObject *parent = nullptr);
+
+    /**
+     * @brief Times sync and render passes of @p window; budget from its screen's refresh rate
+     */
+    void trackWindow(QQuickWindow *window);
+
+    bool isEnabled() const { return m_enabled; }
+    int level() const { return m_level; }
+    QString levelName() const;
+    bool smoothing() const { return m_level < Reduced; }
+    bool translucency() const { return m_level < Minimal; }
+    bool background() const { return m_level < Bare; }
+    int hudIntervalMs() const;
+    double budgetMs() const { return m_budgetNs.load(std::memory_order_relaxed) / 1e6; }
+    double frameCostMs() const { return m_frameCostMs; }
+
+signals:
+    void levelChanged();
+    void budgetChanged();
+    void sampled();
+
+private slots:
+    void evaluate();
+    void updateBudget();
+
+private:
+    void setLevel(int level, const char *reason);
+    void onPassDone(qint64 passNs);
+
+    bool m_enabled;
+    double m_budgetOverrideMs;              ///< DRIVER_FRAME_BUDGET_MS, 0 = from the refresh rate
+    QPointer<QQuickWindow> m_window;
+    QElapsedTimer m_clock;
+    QTimer m_timer;
+    MetricGauge *m_levelGauge;
+
+    // Render thread writes, evaluate() exchanges
+    std::atomic<qint64> m_budgetNs;
+    std::atomic<qint64> m_passStartNs;      ///< Start of the current sync or render pass (-1 none)
+    std::atomic<qint64> m_frameSyncNs;      ///< Sync time of the frame being rendered
+    std::atomic<qint64> m_frames;
+    std::atomic<qint64> m_overBudget;
+    std::atomic<qint64> m_costSumNs;
+
+    // GUI thread
+    int m_level;
+    int m_hotWindows;
+    int m_coolWindows;
+    double m_frameCostMs;
+};
+
+#endif // FRAMEGOVERNOR_H
@@ -0,0 +1,43 @@
+/**
+ * @file gstplugins.hpp
+ * @brief Where GStreamer plugins come from (build option DRIVER_GST_PLUGINS)
+ *
+ * gst_init() normally loads the registry of the whole GStreamer install and,
+ * on a cold or stale cache, rescans every plugin in it - seconds on a full
+ * Windows install. The receiver only needs a handful of elements, so the
+ * build can narrow that down:
+ * - system: registry of the install (default, unchanged behaviour)
+ * - private: only the curated plugins, installed next to the app together
+ *   with a registry generated at install time; no rescan at startup
+ * - static: the curated plugins are linked into the executable and
+ *   registered directly; no registry at all
+ */
+
+#ifndef GSTPLUGINS_H
+#define GSTPLUGINS_H
+
+namespace GstPlugins {
+
+/**
+ * @brief Sets up the GStreamer environment for the configured mode; call before gst_init()
+ *
+ * Variables the user has set (GST_REGISTRY, GST_PLUGIN_PATH_1_0, ...) are left
+ * alone, so extra plugins for A/B chains can still be loaded on purpose.
+ */
+void prepare();
+
+/**
+ * @brief Registers the statically linked plugins; call after gst_init()
+ *
+ * Only the first call registers. No-op unless built with DRIVER_GST_PLUGINS=static.
+ */
+void registerStatic();
+
+/**
+ * @brief Configured mode ("system", "private" or "static") for logs
+ */
+const char *mode();
+
+} // namespace GstPlugins
+
+#endif // GSTPLUGINS_H
@@ -0,0 +1,243 @@
+/**
+ * @file logging.hpp
+ * @brief Asynchronous structured logging for the hot paths
+ *
+ * A log call captures its arguments into a fixed-size record and pushes it into
+ * a lock-free ring; a background writer thread formats the records and writes
+ * them to stderr (or DRIVER_LOG_FILE). The calling thread never formats a string
+ * and never blocks on output - if the ring is full the record is dropped and
+ * counted instead.
+ *
+ *   LOG_DEBUG("VideoStreamReceiver::startStream", "Called with port: {}", port);
+ *
+ * Levels below DRIVER_LOG_LEVEL (CMake cache variable, default 1 = debug) are
+ * compiled out entirely, arguments included. The remaining levels are filtered
+ * at runtime with DRIVER_LOG=trace|debug|info|warn|error. Every call site is
+ * rate limited to Logger::MaxPerSecondPerSite lines per second; the next line
+ * it emits reports how many were suppressed.
+ */
+
+#ifndef LOGGING_H
+#define LOGGING_H
+
+// Qt includes
+#include <QByteArray>    // Captured C strings
+#include <QDebug>        // Fallback capture of other Qt types
+#include <QString>       // Captured strings (implicitly shared, no deep copy)
+
+// Standard library includes
+#include <atomic>        // Runtime level, rate limit counters
+#include <type_traits>   // Argument capture dispatch
+#include <utility>
+#include <variant>       // One captured argument
+
+#ifndef DRIVER_LOG_LEVEL
+#define DRIVER_LOG_LEVEL 1
+#endif
+
+/**
+ * @brief One captured log argument; formatted later on the writer thread
+ */
+using LogArg = std::variant<std::monostate, qint64, quint64, double, bool, QString, QByteArray>;
+
+/**
+ * @brief Captures @p value without formatting it where possible
+ */
+template<typename T>
+LogArg toLogArg(T &&value)
+{
+    using D = std::decay_t<T>;
+    if constexpr (std::is_same_v<D, bool>) {
+        return LogArg(value);
+    } else if constexpr (std::is_enum_v<D>) {
+        return LogArg(static_cast<qint64>(value));
+    } else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>) {
+        return LogArg(static_cast<qint64>(value));
+    } else if constexpr (std::is_integral_v<D>) {
+        return LogArg(static_cast<quint64>(value));
+    } else if constexpr (std::is_floating_point_v<D>) {
+        return LogArg(static_cast<double>(value));
+    } else if constexpr (std::is_same_v<D, QString> || std::is_same_v<D, QByteArray>) {
+        return LogArg(std::forward<T>(value));
+    } else if constexpr (std::is_convertible_v<D, const char *>) {
+        // The pointer may not outlive the call (GLib strings, temporaries)
+        const char *text = value;
+        return LogArg(QByteArray(text ? text : "(null)"));
+    } else {
+        // Anything else (QUrl, QStringList, ...) is stringified through QDebug
+        QString text;
+        QDebug(&text).noquote().nospace() << value;
+        return LogArg(std::move(text));
+    }
+}
+
+/**
+ * @class Logger
+ * @brief Process-wide asynchronous log sink; use through the LOG_* macros
+ */
+class Logger
+{
+public:
+    enum Level {
+        Trace = 0,
+        Debug = 1,
+        Info = 2,
+        Warn = 3,
+        Error = 4
+    };
+
+    static constexpr int MaxArgs = 6;
+    static constexpr int MaxPerSecondPerSite = 20;
+
+    /**
+     * @brief A log call as captured on the calling thread
+     */
+    struct Record {
+        qint64 timeMs = 0;            ///< Wall clock, ms since epoch
+        quint64 threadId = 0;
+        int level = Debug;
+        const char *category = "";    ///< String literal
+        const char *format = "";      ///< String literal, "{}" placeholders
+        quint32 suppressed = 0;       ///< Lines this call site dropped before this one
+        int argc = 0;
+        LogArg args[MaxArgs];
+    };
+
+    /**
+     * @brief Runtime filter (levels compiled out by DRIVER_LOG_LEVEL stay out)
+     */
+    static bool enabledFor(Level level) { return level >= s_level.load(std::memory_order_relaxed); }
+    static void setLevel(Level level) { s_level.store(level, std::memory_order_relaxed); }
+
+    /**
+     * @brief Applies DRIVER_LOG and DRIVER_LOG_FILE; call once early in main()
+     */
+    static void configureFromEnvironment();
+
+    /**
+     * @brief Routes qDebug()/qWarning() from code not yet using LOG_* through the ring
+     *
+     * qFatal() is still written synchronously before aborting.
+     */
+    static void installQtMessageHandler();
+
+    /**
+     * @brief Blocks until everything queued so far has been written
+     */
+    static void flush();
+
+    /**
+     * @brief Records dropped because the ring was full (since startup)
+     */
+    static quint64 droppedCount();
+
+    template<typename... Args>
+    static void submit(Level level, const char *category, quint32 suppressed,
+                       const char *format, Args &&...args)
+    {
+        static_assert(sizeof...(Args) <= MaxArgs, "Too many log arguments");
+        Record record;
+        record.level = level;
+        record.category = category;
+        record.format = format;
+        record.suppressed = suppressed;
+        record.argc = static_cast<int>(sizeof...(Args));
+        int index = 0;
+        ((record.args[index++] = toLogArg(std::forward<Args>(args))), ...);
+        (void)index;
+        enqueue(std::move(record));
+    }
+
+    /**
+     * @brief Stamps and pushes a record; drops it if the ring is full
+     */
+    static void enqueue(Record &&record);
+
+    /**
+     * @brief Coarse monotonic clock for the rate limiter
+     */
+    static qint64 monotonicMs();
+
+private:
+    static std::atomic<int> s_level;
+};
+
+/**
+ * @class LogRateLimit
+ * @brief Per call site budget of Logger::MaxPerSecondPerSite lines per second
+ *
+ * Constant-initialized, so the function-local static in each macro expansion
+ * costs no guard variable.
+ */
+class LogRateLimit
+{
+public:
+    constexpr LogRateLimit() = default;
+
+    /**
+     * @brief Claims one line of this second's budget
+     * @param suppressed Set to the lines dropped since the last allowed one
+     */
+    bool allow(quint32 *suppressed)
+    {
+        const qint64 nowMs = Logger::monotonicMs();
+        qint64 windowStart = m_windowStartMs.load(std::memory_order_relaxed);
+        if (nowMs - windowStart >= 1000
+            && m_windowStartMs.compare_exchange_strong(windowStart, nowMs, std::memory_order_relaxed)) {
+            m_count.store(0, std::memory_order_relaxed);
+        }
+        if (m_count.fetch_add(1, std::memory_order_relaxed) < Logger::MaxPerSecondPerSite) {
+            *suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+            return true;
+        }
+        m_suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+private:
+    std::atomic<qint64> m_windowStartMs{0};
+    std::atomic<int> m_count{0};
+    std::atomic<quint32> m_suppressed{0};
+};
+
+#define DRIVER_LOG_AT(level, category, ...)                                       \
+    do {                                                                          \
+        if (Logger::enabledFor(level)) {                                          \
+            static LogRateLimit driverLogLimit_;                                  \
+            quint32 driverLogSuppressed_ = 0;                                     \
+            if (driverLogLimit_.allow(&driverLogSuppressed_)) {                   \
+                Logger::submit(level, category, driverLogSuppressed_, __VA_ARGS__); \
+            }                                                                     \
+        }                                                                         \
+    } while (0)
+
+#define DRIVER_LOG_DISABLED() do {} while (0)
+
+#if DRIVER_LOG_LEVEL <= 0
+#define LOG_TRACE(category, ...) DRIVER_LOG_AT(Logger::Trace, category, __VA_ARGS__)
+#else
+#define LOG_TRACE(category, ...) DRIVER_LOG_DISABLED()
+#endif
+
+#if DRIVER_LOG_LEVEL <= 1
+#define LOG_DEBUG(category, ...) DRIVER_LOG_AT(Logger::Debug, category, __VA_ARGS__)
+#else
+#define LOG_DEBUG(category, ...) DRIVER_LOG_DISABLED()
+#endif
+
+#if DRIVER_LOG_LEVEL <= 2
+#define LOG_INFO(category, ...) DRIVER_LOG_AT(Logger::Info, category, __VA_ARGS__)
+#else
+#define LOG_INFO(category, ...) DRIVER_LOG_DISABLED()
+#endif
+
+#if DRIVER_LOG_LEVEL <= 3
+#define LOG_WARN(category, ...) DRIVER_LOG_AT(Logger::Warn, category, __VA_ARGS__)
+#else
+#define LOG_WARN(category, ...) DRIVER_LOG_DISABLED()
+#endif
+
+// Errors are never compiled out
+#define LOG_ERROR(category, ...) DRIVER_LOG_AT(Logger::Error, category, __VA_ARGS__)
+
+#endif // LOGGING_H
@@ -0,0 +1,156 @@
+/**
+ * @file metrics.hpp
+ * @brief Process-wide counters, gauges and histograms in Prometheus text format
+ *
+ * Metrics are registered once (usually in a constructor) and then updated from
+ * any thread through plain atomics - recording never takes a lock. The registry
+ * only locks to register a metric and to render the exposition text, both off
+ * the hot paths. MetricsServer serves the text on localhost for scraping.
+ *
+ * Registering the same name and labels twice returns the same metric, so
+ * several instances of a class (e.g. two VideoStreamReceivers) share series.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+// Qt includes
+#include <QByteArray>    // Exposition text
+#include <QMutex>        // Registration only
+
+// Standard library includes
+#include <atomic>        // Lock-free metric updates
+#include <memory>
+#include <vector>
+
+/**
+ * @class MetricCounter
+ * @brief Monotonic event count (Prometheus "counter")
+ */
+class MetricCounter
+{
+public:
+    void increment(quint64 by = 1) { m_value.fetch_add(by, std::memory_order_relaxed); }
+    quint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<quint64> m_value{0};
+};
+
+/**
+ * @class MetricGauge
+ * @brief Value that can go up and down (Prometheus "gauge")
+ */
+class MetricGauge
+{
+public:
+    void set(double value) { m_value.store(value, std::memory_order_relaxed); }
+
+    void add(double delta)
+    {
+        double current = m_value.load(std::memory_order_relaxed);
+        while (!m_value.compare_exchange_weak(current, current + delta, std::memory_order_relaxed)) {
+        }
+    }
+
+    double value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> m_value{0.0};
+};
+
+/**
+ * @class MetricHistogram
+ * @brief Distribution of durations over fixed buckets (Prometheus "histogram")
+ *
+ * Observations are in nanoseconds; buckets, sum and exposition are in seconds.
+ */
+class MetricHistogram
+{
+public:
+    explicit MetricHistogram(const std::vector<double> &upperBoundsSeconds);
+
+    void observeNs(qint64 ns)
+    {
+        size_t bucket = 0;
+        while (bucket < m_boundsNs.size() && ns > m_boundsNs[bucket]) {
+            ++bucket;
+        }
+        m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        m_sumNs.fetch_add(ns, std::memory_order_relaxed);
+    }
+
+    size_t bucketCount() const { return m_boundsNs.size(); }     ///< Excluding +Inf
+    qint64 upperBoundNs(size_t bucket) const { return m_boundsNs[bucket]; }
+    quint64 bucketValue(size_t bucket) const { return m_buckets[bucket].load(std::memory_order_relaxed); }  ///< Non-cumulative; index bucketCount() is +Inf
+    qint64 sumNs() const { return m_sumNs.load(std::memory_order_relaxed); }
+    quint64 count() const;                                        ///< All observations
+
+private:
+    std::vector<qint64> m_boundsNs;
+    std::unique_ptr<std::atomic<quint64>[]> m_buckets;
+    std::atomic<qint64> m_sumNs{0};
+};
+
+/**
+ * @class MetricsRegistry
+ * @brief Owns every metric and renders them in the Prometheus text format (0.0.4)
+ *
+ * Metric objects live until the process exits, so references handed out may be
+ * cached freely. Names follow Prometheus conventions (driver_<subsystem>_...,
+ * _total for counters, _seconds for durations); @p labels is the label set
+ * without braces, e.g. `path="ws"`.
+ */
+class MetricsRegistry
+{
+public:
+    static MetricsRegistry &instance();
+
+    MetricCounter &counter(const char *name, const char *help, const char *labels = "");
+    MetricGauge &gauge(const char *name, const char *help, const char *labels = "");
+    MetricHistogram &histogram(const char *name, const char *help,
+                               const std::vector<double> &upperBoundsSeconds, const char *labels = "");
+
+    /**
+     * @brief Looks up an already registered metric (readers such as PerformanceStats)
+     * @return nullptr if nothing is registered under @p name and @p labels yet
+     */
+    const MetricCounter *findCounter(const char *name, const char *labels = "") const;
+    const MetricGauge *findGauge(const char *name, const char *labels = "") const;
+    const MetricHistogram *findHistogram(const char *name, const char *labels = "") const;
+
+    /**
+     * @brief Renders all metrics; safe to call while other threads record
+     */
+    QByteArray exposition() const;
+
+    // Common bucket layouts (seconds)
+    static const std::vector<double> &latencyBuckets();  ///< 100 us .. 1 s
+
+private:
+    MetricsRegistry() = default;
+
+    enum class Type { Counter, Gauge, Histogram };
+
+    struct Series {
+        QByteArray labels;
+        std::unique_ptr<MetricCounter> counter;
+        std::unique_ptr<MetricGauge> gauge;
+        std::unique_ptr<MetricHistogram> histogram;
+    };
+
+    struct Family {
+        QByteArray name;
+        QByteArray help;
+        Type type;
+        std::vector<std::unique_ptr<Series>> series;
+    };
+
+    Series &series(const char *name, const char *help, Type type, const char *labels);
+    const Series *find(const char *name, const char *labels) const;
+
+    mutable QMutex m_mutex;
+    std::vector<std::unique_ptr<Family>> m_families;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,48 @@
+/**
+ * @file metricsserver.hpp
+ * @brief Minimal HTTP endpoint serving MetricsRegistry on localhost
+ *
+ * Answers `GET /metrics` with the Prometheus text format so soak runs can be
+ * scraped by existing tooling. Binds to 127.0.0.1 only and runs on the GUI
+ * thread's event loop; rendering takes the registry lock, never the hot paths'.
+ */
+
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+// Qt includes
+#include <QObject>       // Base class for Qt objects with signal/slot support
+
+class QTcpServer;
+class QTcpSocket;
+
+/**
+ * @class MetricsServer
+ * @brief Serves the metrics exposition over HTTP/1.0 (one request per connection)
+ */
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsServer(QObject *parent = nullptr);
+
+    /**
+     * @brief Starts listening on 127.0.0.1
+     * @param port TCP port (9464 is the conventional exporter port)
+     * @return false if the port could not be bound
+     */
+    bool listen(quint16 port);
+
+    quint16 port() const;
+
+private slots:
+    void onNewConnection();
+
+private:
+    void handleRequest(QTcpSocket *socket);
+
+    QTcpServer *m_server;
+};
+
+#endif // METRICSSERVER_H
@@ -58,6 +58,8 @@ private slots:
     void updateFpsCounter();
 
 private:
+    friend struct BenchAccess;  // Microbenchmarks (bench/) drive the private hot paths
+
     void processBuffer();
     QImage decodeJpeg(const QByteArray &jpegData);
     void setConnected(bool connected);
@@ -0,0 +1,167 @@
+/**
+ * @file pathpredictor.hpp
+ * @brief Predicts where the car is now from the frame on screen and the commands since
+ *
+ * The frame on screen shows the car as it was when the camera captured it,
+ * 100-200 ms ago. Its capture time is estimated from the frame's receive stamp
+ * minus the one-way network latency (half the control RTT) and a camera delay;
+ * the steering/throttle messages sent since then are replayed, each from when
+ * it reached the car, through a kinematic bicycle model. The resulting path is
+ * projected into the camera image, so the overlay shows where the car is now
+ * and where the current command takes it next.
+ *
+ * The car reports no speed or position, so speed is modelled from throttle
+ * too; the vehicle and camera parameters below are estimates to calibrate
+ * against the real car (all from the environment):
+ * - DRIVER_WHEELBASE_M (0.26), DRIVER_MAX_STEER_DEG (25)
+ * - DRIVER_MAX_SPEED_MPS (3.0, at full throttle), DRIVER_SPEED_TAU_MS (400)
+ * - DRIVER_CAMERA_HEIGHT_M (0.25), DRIVER_CAMERA_PITCH_DEG (15, down),
+ *   DRIVER_CAMERA_HFOV_DEG (90), DRIVER_CAMERA_DELAY_MS (capture to first packet, 0)
+ * - DRIVER_ONE_WAY_MS (default: half the measured control RTT)
+ * - DRIVER_PATH_LOOKAHEAD_MS (1000), DRIVER_PATH_PREDICTION=0 starts disabled
+ *
+ * The same prediction drives the optional timewarp: the heading change since
+ * the capture becomes a horizontal shift of the frame, so the picture turns
+ * with the commanded steering between frames (DRIVER_TIMEWARP=1 enables it,
+ * DRIVER_TIMEWARP_MAX_DEG limits the yaw, default 15).
+ */
+
+#ifndef PATHPREDICTOR_H
+#define PATHPREDICTOR_H
+
+// Qt includes
+#include <QObject>       // Base class for Qt objects with signal/slot support
+#include <QPointF>       // Projected points
+#include <QPointer>      // Receiver may be destroyed before the predictor
+#include <QTimer>        // Update and RTT sampling
+#include <QVariantList>  // Projected points for QML
+
+// Standard library includes
+#include <deque>         // Command history
+
+class MetricHistogram;
+class VideoStreamReceiver;
+
+/**
+ * @class PathPredictor
+ * @brief Latency-compensated path of the car in image coordinates (QML: "pathPredictor")
+ *
+ * points holds PointsPerSegment points from the frame's capture to now
+ * (the last one, nowIndex, is the predicted current position) and as many
+ * again over the lookahead. Point x is 0..1 across the image width, y is the
+ * offset from the image's vertical center in image widths (square pixels);
+ * points behind the camera are NaN.
+ */
+class PathPredictor : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool enabled READ isEnabled WRITE setEnabled NOTIFY enabledChanged)
+    Q_PROPERTY(bool valid READ isValid NOTIFY updated)                  ///< A frame with a known receive time is on screen
+    Q_PROPERTY(QVariantList points READ points NOTIFY updated)          ///< QPointF, see class description
+    Q_PROPERTY(int pointCount READ pointCount CONSTANT)
+    Q_PROPERTY(int nowIndex READ nowIndex CONSTANT)                     ///< Index of the predicted current position
+    Q_PROPERTY(double horizonMs READ horizonMs NOTIFY updated)          ///< Capture of the shown frame -> now
+    Q_PROPERTY(double oneWayMs READ oneWayMs NOTIFY updated)            ///< One-way latency in use
+    Q_PROPERTY(double speedMps READ speedMps NOTIFY updated)            ///< Modelled speed now
+    Q_PROPERTY(double yawDeg READ yawDeg NOTIFY updated)                ///< Heading change since the capture (left positive)
+    Q_PROPERTY(bool timewarp READ timewarp WRITE setTimewarp NOTIFY timewarpChanged)
+    Q_PROPERTY(double timewarpShift READ timewarpShift NOTIFY updated)  ///< Frame shift for the yaw, in image widths (0 when off)
+
+public:
+    static constexpr int PointsPerSegment = 12;
+
+    explicit PathPredictor(QObject *parent = nullptr);
+
+    /**
+     * @brief Takes frame receive times from @p receiver (frameChanged())
+     */
+    void setReceiver(VideoStreamReceiver *receiver);
+
+    bool isEnabled() const { return m_enabled; }
+    void setEnabled(bool enabled);
+    bool isValid() const { return m_valid; }
+    QVariantList points() const { return m_points; }
+    int pointCount() const { return 2 * PointsPerSegment; }
+    int nowIndex() const { return PointsPerSegment - 1; }
+    double horizonMs() const { return m_horizonMs; }
+    double oneWayMs() const { return m_oneWayNs / 1e6; }
+    double speedMps() const { return m_speedMps; }
+    double yawDeg() const;
+    bool timewarp() const { return m_timewarp; }
+    void setTimewarp(bool enabled);
+    double timewarpShift() const { return m_timewarpShift; }
+
+public slots:
+    /**
+     * @brief A control message left (connect to SteeringControllerService::controlSent)
+     */
+    void recordCommand(double steering, double throttle, qint64 sentWallNs);
+
+signals:
+    void enabledChanged();
+    void timewarpChanged();
+    void updated();
+
+private slots:
+    void onFrameChanged();
+    void predict();
+    void sampleRtt();
+
+private:
+    struct Command {
+        qint64 sentWallNs;
+        float steering;
+        float throttle;
+    };
+
+    struct Pose {
+        double x = 0.0;        ///< Forward at capture (m)
+        double y = 0.0;        ///< Left at capture (m)
+        double heading = 0.0;  ///< Radians, counter-clockwise
+        double speed = 0.0;    ///< m/s
+    };
+
+    void step(Pose &pose, const Command &command, double dt) const;
+    QPointF project(const Pose &pose) const;
+    void updateTimers();
+    void invalidate();
+
+    // Vehicle and camera model
+    double m_wheelbaseM;
+    double m_maxSteerRad;
+    double m_maxSpeedMps;
+    double m_speedTauS;
+    double m_cameraHeightM;
+    double m_cameraPitchRad;
+    double m_focalScale;         ///< Image widths per unit of tan(angle)
+    qint64 m_cameraDelayNs;
+    qint64 m_oneWayOverrideNs;   ///< DRIVER_ONE_WAY_MS, -1 = from the RTT
+    qint64 m_lookaheadNs;
+    double m_timewarpMaxRad;
+
+    bool m_enabled;                    ///< Path overlay
+    bool m_timewarp;
+    QPointer<VideoStreamReceiver> m_receiver;
+    QTimer m_timer;
+    QTimer m_rttTimer;
+    std::deque<Command> m_commands;    ///< Oldest first
+    qint64 m_frameRxNs;                ///< Receive time of the frame on screen (CLOCK_REALTIME, 0 unknown)
+
+    // Control RTT from the metric histogram (sum/count at the previous sample)
+    const MetricHistogram *m_rttHistogram;
+    qint64 m_rttLastSumNs;
+    quint64 m_rttLastCount;
+    qint64 m_oneWayNs;
+    bool m_oneWayMeasured;             ///< m_oneWayNs comes from acks, not the default
+
+    // Last prediction
+    bool m_valid;
+    QVariantList m_points;
+    double m_horizonMs;
+    double m_speedMps;
+    double m_yawRad;
+    double m_timewarpShift;
+};
+
+#endif // PATHPREDICTOR_H
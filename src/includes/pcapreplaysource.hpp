@@ -0,0 +1,149 @@
+/**
+ * @file pcapreplaysource.hpp
+ * @brief Replays the RTP/UDP payloads of a pcap or pcapng capture
+ *
+ * Field captures carry the real loss, reordering and jitter of the car's
+ * network, which synthetic streams do not. The replay source loads a capture,
+ * keeps the UDP datagrams (optionally only those to one port) and plays them
+ * back at the original timing, scaled, or as fast as possible, either as
+ * datagrams to a loopback port (udpsrc / RtpReceiveEngine ingest, unchanged) or
+ * into a packet sink called on the replay thread.
+ *
+ * Supported: classic pcap (µs and ns timestamps, either byte order) and pcapng
+ * (enhanced and simple packet blocks, per-interface timestamp resolution);
+ * Ethernet (with VLAN tags), Linux cooked (SLL, SLL2), raw IP and BSD loopback
+ * link types; IPv4 and IPv6. IP fragments are skipped.
+ */
+
+#ifndef PCAPREPLAYSOURCE_H
+#define PCAPREPLAYSOURCE_H
+
+// Qt includes
+#include <QByteArray>    // Loaded datagrams
+#include <QString>       // File path, error messages
+
+// Standard library includes
+#include <atomic>        // Statistics and stop flag shared with the replay thread
+#include <thread>        // Replay thread
+#include <vector>        // Packet index
+
+#include "rtpreceiveengine.hpp"  // Packet / PacketSink, shared with live ingest
+
+/**
+ * @class PcapReplaySource
+ * @brief Loads a capture once, then replays it on its own thread
+ *
+ * Typical usage: replay.load({ path, port }, &error), then
+ * replay.startLoopback(receiver.port()). The receiver sees an ordinary UDP
+ * stream, so it can be stopped or switched on the GUI thread at any time.
+ *
+ * A sink runs on the replay thread and must be safe there. Feeding a
+ * VideoStreamReceiver directly (pushExternalPacket()) is only safe where nothing
+ * can stop or switch that receiver while the replay runs, as in the benchmarks;
+ * the app uses the loopback.
+ *
+ * Packets are stamped with the wall-clock time they are replayed (kernelRxNs
+ * and userRxNs), so latency bookkeeping downstream works as for live packets.
+ */
+class PcapReplaySource
+{
+public:
+    using Packet = RtpReceiveEngine::Packet;
+    using PacketSink = RtpReceiveEngine::PacketSink;
+
+    /**
+     * @struct Config
+     * @brief What to load and how to play it back
+     */
+    struct Config
+    {
+        QString path;              ///< .pcap or .pcapng file
+        quint16 udpPort = 0;       ///< Keep only datagrams to this destination port (0 = all UDP)
+        double speed = 1.0;        ///< 1 = original timing, 2 = twice as fast, 0 = as fast as possible
+        int loops = 1;             ///< Passes over the capture (0 = until stop())
+    };
+
+    /**
+     * @struct Stats
+     * @brief Snapshot of the replay counters
+     */
+    struct Stats
+    {
+        qint64 packets = 0;        ///< Datagrams replayed
+        qint64 bytes = 0;          ///< Payload bytes replayed
+        qint64 sendErrors = 0;     ///< Loopback datagrams the socket refused
+        qint64 maxLateNs = 0;      ///< Worst delay behind the capture's schedule
+        int loopsDone = 0;         ///< Completed passes
+    };
+
+    PcapReplaySource();
+    ~PcapReplaySource();
+
+    PcapReplaySource(const PcapReplaySource &) = delete;
+    PcapReplaySource &operator=(const PcapReplaySource &) = delete;
+
+    /**
+     * @brief Reads and indexes the capture (replaces a previous one; stops a replay)
+     * @param errorMessage Filled in on failure
+     * @return false if the file cannot be read or contains no matching UDP datagrams
+     */
+    bool load(const Config &config, QString *errorMessage);
+
+    /**
+     * @brief Replays into @p sink on the replay thread (one call per datagram)
+     */
+    bool start(PacketSink sink);
+
+    /**
+     * @brief Replays as UDP datagrams to 127.0.0.1:@p port
+     */
+    bool startLoopback(quint16 port);
+
+    /**
+     * @brief Stops and joins the replay thread; safe to call when not running
+     */
+    void stop();
+
+    /**
+     * @brief True from start() until all loops were replayed or stop()
+     */
+    bool isRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    int packetCount() const { return static_cast<int>(m_packets.size()); }
+    double captureDurationS() const;
+    Stats stats() const;
+
+private:
+    /**
+     * @brief One datagram in m_payloads
+     */
+    struct CapturedPacket
+    {
+        qint64 timestampNs;        ///< Capture time
+        int offset;                ///< Into m_payloads
+        int size;
+        quint16 port;              ///< UDP destination port
+    };
+
+    bool parsePcap(const QByteArray &file, QString *errorMessage);
+    bool parsePcapng(const QByteArray &file, QString *errorMessage);
+    void addFrame(int linkType, qint64 timestampNs, const char *data, int size);
+    bool launch(PacketSink sink, quint16 loopbackPort);
+    void run(PacketSink sink, quint16 loopbackPort);
+
+    Config m_config;
+    QByteArray m_payloads;                 ///< UDP payloads back to back
+    std::vector<CapturedPacket> m_packets; ///< In capture order
+    qint64 m_skipped;                      ///< Frames that were not matching UDP datagrams
+
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_stopRequested;
+    std::atomic<qint64> m_replayedPackets;
+    std::atomic<qint64> m_replayedBytes;
+    std::atomic<qint64> m_sendErrors;
+    std::atomic<qint64> m_maxLateNs;
+    std::atomic<int> m_loopsDone;
+};
+
+#endif // PCAPREPLAYSOURCE_H
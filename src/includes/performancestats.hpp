@@ -0,0 +1,174 @@
+/**
+ * @file performancestats.hpp
+ * @brief Live aggregate of the hot path metrics for the in-app performance HUD
+ *
+ * Samples MetricsRegistry and the window's frame timing at 4 Hz and exposes the
+ * results as plain properties, so QML bindings re-evaluate four times a second
+ * instead of on every frame or packet. Nothing is sampled while not running.
+ */
+
+#ifndef PERFORMANCESTATS_H
+#define PERFORMANCESTATS_H
+
+// Qt includes
+#include <QElapsedTimer> // Tick and frame interval clock
+#include <QObject>       // Base class for Qt objects with signal/slot support
+#include <QTimer>        // 4 Hz sampling
+
+// Project includes
+#include "threadmonitor.hpp"  // Per-thread CPU / run-queue wait
+
+// Standard library includes
+#include <atomic>        // Render thread -> GUI thread frame timing
+
+class MetricCounter;
+class MetricHistogram;
+class MetricGauge;
+class QQuickWindow;
+
+/**
+ * @class PerformanceStats
+ * @brief One aggregated stats object for all subsystems (exposed to QML as "performanceStats")
+ *
+ * Rates and means cover the last tick (250 ms). Latency means come from the
+ * metric histograms' sum/count deltas, so they match what /metrics reports.
+ */
+class PerformanceStats : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool running READ isRunning WRITE setRunning NOTIFY runningChanged)  ///< Sample at 4 Hz (the HUD sets this while shown)
+
+    // Video
+    Q_PROPERTY(double videoFps READ videoFps NOTIFY updated)              ///< Frames handed to QML per second
+    Q_PROPERTY(double frameAgeMs READ frameAgeMs NOTIFY updated)          ///< Packet RX -> frame handed to QML (mean)
+    Q_PROPERTY(double decodeMs READ decodeMs NOTIFY updated)              ///< Packet RX -> decoded frame in appsink (mean)
+    Q_PROPERTY(qint64 droppedFrames READ droppedFrames NOTIFY updated)    ///< Frames discarded since start
+    Q_PROPERTY(double dropRate READ dropRate NOTIFY updated)              ///< Frames discarded per second
+    Q_PROPERTY(int handoffQueueDepth READ handoffQueueDepth NOTIFY updated)  ///< Decoded frames waiting for the GUI
+
+    // Control and input
+    Q_PROPERTY(double controlRttMs READ controlRttMs NOTIFY updated)      ///< WebSocket RTT (mean, -1 without acks)
+    Q_PROPERTY(double sendRateHz READ sendRateHz NOTIFY updated)          ///< Control messages sent per second
+    Q_PROPERTY(double inputRateHz READ inputRateHz NOTIFY updated)        ///< Joystick polls per second
+    Q_PROPERTY(double inputJitterMs READ inputJitterMs NOTIFY updated)    ///< Smoothed poll interval deviation
+
+    // GUI / render
+    Q_PROPERTY(double guiFrameMs READ guiFrameMs NOTIFY updated)          ///< Mean interval between GUI frames
+    Q_PROPERTY(double guiFrameMaxMs READ guiFrameMaxMs NOTIFY updated)    ///< Longest GUI frame interval
+    Q_PROPERTY(double renderMs READ renderMs NOTIFY updated)              ///< Mean scene graph render pass
+    Q_PROPERTY(double renderMaxMs READ renderMaxMs NOTIFY updated)        ///< Longest render pass
+
+    // Threads (1 Hz, while running or tracing)
+    Q_PROPERTY(ThreadMonitor *threadMonitor READ threadMonitor CONSTANT)
+
+public:
+    explicit PerformanceStats(QObject *parent = nullptr);
+
+    bool isRunning() const { return m_timer.isActive(); }
+    void setRunning(bool running);
+
+    /**
+     * @brief Sample interval (250 ms by default; slowed by the frame governor under load)
+     */
+    void setIntervalMs(int intervalMs);
+
+    /**
+     * @brief Measures GUI frame intervals and render passes of @p window
+     */
+    void trackWindow(QQuickWindow *window);
+
+    double videoFps() const { return m_videoFps; }
+    double frameAgeMs() const { return m_frameAgeMs; }
+    double decodeMs() const { return m_decodeMs; }
+    qint64 droppedFrames() const { return m_droppedFrames; }
+    double dropRate() const { return m_dropRate; }
+    int handoffQueueDepth() const { return m_handoffQueueDepth; }
+    double controlRttMs() const { return m_controlRttMs; }
+    double sendRateHz() const { return m_sendRateHz; }
+    double inputRateHz() const { return m_inputRateHz; }
+    double inputJitterMs() const { return m_inputJitterMs; }
+    double guiFrameMs() const { return m_guiFrameMs; }
+    double guiFrameMaxMs() const { return m_guiFrameMaxMs; }
+    double renderMs() const { return m_renderMs; }
+    double renderMaxMs() const { return m_renderMaxMs; }
+    ThreadMonitor *threadMonitor() { return &m_threadMonitor; }
+
+signals:
+    void runningChanged();
+    void updated();
+
+private slots:
+    void sample();
+    void updateThreadMonitor();
+
+private:
+    /**
+     * @brief Counter value change between two ticks
+     */
+    struct CounterDelta {
+        const char *name;
+        const char *labels;
+        const MetricCounter *counter = nullptr;
+        quint64 last = 0;
+        quint64 take(quint64 *total = nullptr);
+    };
+
+    /**
+     * @brief Mean of the observations a histogram received between two ticks
+     */
+    struct HistogramDelta {
+        const char *name;
+        const char *labels;
+        const MetricHistogram *histogram = nullptr;
+        qint64 lastSumNs = 0;
+        quint64 lastCount = 0;
+        double takeMeanMs();  ///< -1 when nothing was observed
+    };
+
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    ThreadMonitor m_threadMonitor;
+    qint64 m_lastTickNs;
+
+    CounterDelta m_framesDisplayed;
+    CounterDelta m_decodeDrops;
+    CounterDelta m_handoffDrops;
+    CounterDelta m_wsSent;
+    CounterDelta m_polls;
+    HistogramDelta m_rxToAppsink;
+    HistogramDelta m_appsinkToGui;
+    HistogramDelta m_wsRtt;
+    const MetricGauge *m_queueDepthGauge;
+    const MetricGauge *m_inputJitterGauge;
+
+    // GUI frame intervals (GUI thread)
+    qint64 m_lastGuiFrameNs;
+    qint64 m_guiFrameSumNs;
+    qint64 m_guiFrameMaxNs;
+    qint64 m_guiFrameCount;
+
+    // Render passes (render thread writes, sample() exchanges)
+    std::atomic<bool> m_tracking;
+    std::atomic<qint64> m_renderStartNs;
+    std::atomic<qint64> m_renderSumNs;
+    std::atomic<qint64> m_renderMaxNs;
+    std::atomic<qint64> m_renderCount;
+
+    double m_videoFps;
+    double m_frameAgeMs;
+    double m_decodeMs;
+    qint64 m_droppedFrames;
+    double m_dropRate;
+    int m_handoffQueueDepth;
+    double m_controlRttMs;
+    double m_sendRateHz;
+    double m_inputRateHz;
+    double m_inputJitterMs;
+    double m_guiFrameMs;
+    double m_guiFrameMaxMs;
+    double m_renderMs;
+    double m_renderMaxMs;
+};
+
+#endif // PERFORMANCESTATS_H
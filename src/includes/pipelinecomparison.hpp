@@ -0,0 +1,148 @@
+/**
+ * @file pipelinecomparison.hpp
+ * @brief Side-by-side A/B comparison of two video pipeline configurations
+ *
+ * Tuning the decoder chain (queues, decoder element, formats) needs both candidates
+ * to see identical input. PipelineComparison receives the RTP stream once and hands
+ * every packet to two VideoStreamReceivers running different decoder chains, then
+ * samples their latency, CPU and drop counters once per second.
+ */
+
+#ifndef PIPELINECOMPARISON_H
+#define PIPELINECOMPARISON_H
+
+// Qt includes
+#include <QObject>              // Base class for Qt objects with signal/slot support
+#include <QElapsedTimer>        // Sampling interval measurement
+#include <QTimer>               // Once-per-second sampling
+#include <QVariantList>         // Sample history
+#include <QVariantMap>          // Per-side statistics exposed to QML
+
+#include "rtpreceiveengine.hpp"     // Shared packet ingest
+#include "videoscreenreciever.hpp"  // The two pipelines under comparison
+
+/**
+ * @class PipelineComparison
+ * @brief Feeds the same RTP packets into two pipeline configurations and compares them
+ *
+ * Typical usage:
+ * 1. Set chainA / chainB (gst-launch fragments from depayloader to RGB output;
+ *    empty means the built-in chain)
+ * 2. start(port) - both receivers start in external ingest mode, then one
+ *    RtpReceiveEngine binds the port and duplicates every packet into both
+ * 3. Read statsA / statsB (updated every second) or exportResults()
+ *
+ * Per-side statistics (per one-second interval unless noted):
+ * - fps, decodedFps - frames displayed / decoded per second
+ * - framesIn, dropped - complete frames received and frames that never reached the appsink
+ * - rxToAppsinkMs, appsinkToGuiMs, rxToGuiMs - mean latencies from the kernel receive time
+ * - rxToAppsinkMaxMs - worst kernel RX -> appsink latency since start
+ * - cpuPercent - CPU of the pipeline's streaming threads (appsrc thread and the thread
+ *   feeding the appsink; extra queues inside a chain add threads that are not counted)
+ * - totalFramesIn, totalDecoded, totalDropped - since start
+ */
+class PipelineComparison : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool enabled READ isEnabled WRITE setEnabled NOTIFY enabledChanged)     ///< App shows the comparison instead of the normal video view
+    Q_PROPERTY(bool running READ isRunning NOTIFY runningChanged)                      ///< Packets are being received and compared
+    Q_PROPERTY(int port READ port NOTIFY runningChanged)                               ///< Port being compared (0 when stopped)
+    Q_PROPERTY(QString chainA READ chainA WRITE setChainA NOTIFY chainAChanged)        ///< Decoder chain of side A
+    Q_PROPERTY(QString chainB READ chainB WRITE setChainB NOTIFY chainBChanged)        ///< Decoder chain of side B
+    Q_PROPERTY(VideoStreamReceiver *receiverA READ receiverA CONSTANT)                 ///< Pipeline A (frames, status)
+    Q_PROPERTY(VideoStreamReceiver *receiverB READ receiverB CONSTANT)                 ///< Pipeline B (frames, status)
+    Q_PROPERTY(QVariantMap statsA READ statsA NOTIFY statsChanged)                     ///< Latest statistics of side A
+    Q_PROPERTY(QVariantMap statsB READ statsB NOTIFY statsChanged)                     ///< Latest statistics of side B
+
+public:
+    explicit PipelineComparison(QObject *parent = nullptr);
+    ~PipelineComparison();
+
+    bool isEnabled() const { return m_enabled; }
+    void setEnabled(bool enabled);
+
+    bool isRunning() const { return m_engine.isRunning(); }
+    int port() const { return m_port; }
+
+    QString chainA() const { return m_a.receiver->decoderChain(); }
+    void setChainA(const QString &chain);
+    QString chainB() const { return m_b.receiver->decoderChain(); }
+    void setChainB(const QString &chain);
+
+    VideoStreamReceiver *receiverA() const { return m_a.receiver; }
+    VideoStreamReceiver *receiverB() const { return m_b.receiver; }
+
+    QVariantMap statsA() const { return m_a.stats; }
+    QVariantMap statsB() const { return m_b.stats; }
+
+    /**
+     * @brief Starts both pipelines and the shared receiver on a port
+     * @param port UDP port the RTP stream arrives on
+     * @return false if a pipeline could not start or the port could not be bound
+     */
+    Q_INVOKABLE bool start(int port);
+
+    /**
+     * @brief Stops the shared receiver and both pipelines; safe when not running
+     */
+    Q_INVOKABLE void stop();
+
+    /**
+     * @brief Writes the per-second samples and a run summary to the working directory
+     * @param format "json" (samples plus summary) or "csv" (one row per side per second)
+     * @return Path of the written file, empty on failure
+     */
+    Q_INVOKABLE QString exportResults(const QString &format) const;
+
+signals:
+    void enabledChanged();
+    void runningChanged();
+    void chainAChanged();
+    void chainBChanged();
+    void statsChanged();
+    void errorOccurred(const QString &message);
+
+private slots:
+    /**
+     * @brief Computes the last interval's statistics for both sides
+     */
+    void onSampleTimeout();
+
+private:
+    /**
+     * @struct Side
+     * @brief One pipeline under comparison and its last counter snapshot
+     */
+    struct Side
+    {
+        QString label;                            ///< "A" or "B"
+        VideoStreamReceiver *receiver = nullptr;  ///< Owned through QObject parenting
+        VideoStreamReceiver::PipelineStats last;  ///< Counters at the previous sample
+        QVariantMap stats;                        ///< Statistics of the last interval
+    };
+
+    /**
+     * @brief Turns the counter delta since the previous sample into statistics
+     */
+    static QVariantMap sampleSide(Side &side, double intervalS);
+
+    /**
+     * @brief Whole-run figures of one side, from its cumulative counters
+     */
+    QVariantMap summary(const Side &side) const;
+
+    Side m_a;
+    Side m_b;
+    RtpReceiveEngine m_engine;    ///< Receives the stream once for both sides
+    bool m_feedBFirst;            ///< Alternates push order so neither side is always first (engine thread only)
+    bool m_enabled;
+    int m_port;                   ///< Port being compared, 0 when stopped
+    int m_samplesPort;            ///< Port m_samples were recorded on (kept after stop() for export)
+    QTimer *m_sampleTimer;
+    QElapsedTimer m_clock;        ///< Started by start()
+    qint64 m_lastSampleNs;        ///< m_clock time of the previous sample
+    QVariantList m_samples;       ///< Per-second history of both sides (bounded)
+};
+
+#endif // PIPELINECOMPARISON_H
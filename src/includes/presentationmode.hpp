@@ -0,0 +1,114 @@
+/**
+ * @file presentationmode.hpp
+ * @brief How frames reach the screen: fullscreen/compositor bypass, swap interval, render loop
+ *
+ * A normal desktop window is composited: the compositor copies each frame into
+ * its own and shows that one or two refreshes later. A fullscreen, opaque
+ * window that asks to bypass the compositor can be scanned out directly
+ * (X11 _NET_WM_BYPASS_COMPOSITOR, Wayland direct scanout, Windows independent
+ * flip). Swap interval and render loop decide how long a finished frame waits
+ * for vblank and whether the GUI thread waits with it.
+ *
+ * Configured from the environment before the first window:
+ * - DRIVER_PRESENTATION: windowed (default) or fullscreen
+ * - DRIVER_VSYNC: on (default), off (may tear) or adaptive (vsync unless late;
+ *   OpenGL only, selected automatically)
+ * - DRIVER_RENDER_LOOP: threaded or basic (sets QSG_RENDER_LOOP unless given)
+ */
+
+#ifndef PRESENTATIONMODE_H
+#define PRESENTATIONMODE_H
+
+// Qt includes
+#include <QElapsedTimer> // Hand-off -> swap clock
+#include <QObject>       // Base class for Qt objects with signal/slot support
+#include <QPointer>      // Window may be destroyed before the mode object
+#include <QString>       // Mode names
+#include <QTimer>        // 1 Hz latency mean
+
+// Standard library includes
+#include <atomic>        // Swaps are reported on the render thread
+
+class MetricHistogram;
+class QQuickWindow;
+
+/**
+ * @class PresentationMode
+ * @brief Applies the presentation settings and measures swap latency (QML: "presentationMode")
+ *
+ * Swap latency is measured from a video frame being handed to the GUI to the
+ * swap that first shows it (the video Image reports frameLoaded()). It
+ * includes render loop and swap interval waits, but it is not display latency:
+ * composition and scanout after the swap are not visible to the application,
+ * and Qt Quick exposes no presentation feedback to time them.
+ */
+class PresentationMode : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool fullscreen READ isFullscreen CONSTANT)
+    Q_PROPERTY(QString vsync READ vsync CONSTANT)                                  ///< "on", "off" or "adaptive"
+    Q_PROPERTY(QString renderLoop READ renderLoop CONSTANT)                        ///< QSG_RENDER_LOOP, "default" if unset
+    Q_PROPERTY(QString description READ description CONSTANT)                     ///< e.g. "fullscreen, vsync off, threaded loop"
+    Q_PROPERTY(double swapLatencyMs READ swapLatencyMs NOTIFY updated)             ///< Mean over the last second, -1 without frames
+
+public:
+    /**
+     * @brief Reads the environment, sets the default surface format and render loop;
+     *        call after QGuiApplication, before the first window
+     */
+    static void configure();
+
+    explicit PresentationMode(QObject *parent = nullptr);
+    ~PresentationMode();
+
+    /**
+     * @brief Requests compositor bypass for @p window (fullscreen only) and times its swaps
+     */
+    void trackWindow(QQuickWindow *window);
+
+    bool isFullscreen() const;
+    QString vsync() const;
+    QString renderLoop() const;
+    QString description() const;
+    double swapLatencyMs() const { return m_swapLatencyMs; }
+
+public slots:
+    /**
+     * @brief A decoded video frame was handed to the GUI (connect to VideoStreamReceiver::frameChanged)
+     */
+    void frameHandedToGui();
+
+    /**
+     * @brief The video item finished loading the latest frame; the next swap shows it
+     */
+    void frameLoaded();
+
+signals:
+    void updated();
+
+private slots:
+    void sample();
+
+private:
+    void requestCompositorBypass(QQuickWindow *window);
+    void onFrameSwapped();
+
+    QPointer<QQuickWindow> m_window;
+    QElapsedTimer m_clock;
+    QTimer m_timer;
+    MetricHistogram *m_latencyHistogram;
+
+    qint64 m_handedNs;                  ///< GUI thread: last hand-off not yet loaded (-1 none)
+    std::atomic<qint64> m_loadedNs;     ///< Hand-off time of the loaded frame waiting for the next sync (-1 none)
+    std::atomic<qint64> m_syncedNs;     ///< ... synced into the scene, waiting for its swap (-1 none)
+    std::atomic<qint64> m_latencySumNs;
+    std::atomic<qint64> m_latencyCount;
+
+    // Last sample() (GUI thread)
+    qint64 m_lastSumNs;
+    qint64 m_lastCount;
+    double m_swapLatencyMs;
+};
+
+#endif // PRESENTATIONMODE_H
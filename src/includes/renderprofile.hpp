@@ -0,0 +1,129 @@
+/**
+ * @file renderprofile.hpp
+ * @brief UI profile for the Qt Quick software backend (DRIVER_UI_PROFILE=software)
+ *
+ * Without a usable GPU the software backend paints with QPainter into the
+ * window's backing store. It only repaints what changed, but "what changed"
+ * includes everything underneath: every video frame and wheel movement also
+ * redrew its part of bg.jpg, smooth-scaled from 5472x3648 on each pass. The
+ * software profile keeps the scene cheap to repaint in part (background
+ * decoded once at window size, nearest-neighbour video scaling), and checks
+ * from the renderer's own flush regions that frames really are partial.
+ */
+
+#ifndef RENDERPROFILE_H
+#define RENDERPROFILE_H
+
+// Qt includes
+#include <QObject>       // Base class for Qt objects with signal/slot support
+#include <QPointer>      // Window may be destroyed before the profile
+#include <QString>       // Profile name
+#include <QTimer>        // 1 Hz repaint statistics
+
+// Standard library includes
+#include <atomic>        // Flush regions arrive on the render thread
+
+class MetricCounter;
+class MetricGauge;
+class QQuickWindow;
+
+/**
+ * @class RenderProfile
+ * @brief Selected UI profile and repaint statistics (exposed to QML as "renderProfile")
+ *
+ * Call configure() before the first window is created, then construct one
+ * instance and trackWindow() the main window. DRIVER_UI_PROFILE:
+ * - software: software backend, scene set up for partial updates
+ * - default: the GPU scene unchanged (also with QT_QUICK_BACKEND=software, to
+ *   compare against the software profile)
+ * - unset: software if QT_QUICK_BACKEND=software, otherwise default
+ *
+ * In the software profile the renderer's per-frame flush region is read from
+ * its debug output (category qt.scenegraph.softwarecontext.renderer, which is
+ * enabled and swallowed here) and reported as the repainted share of the
+ * window.
+ */
+class RenderProfile : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool software READ isSoftware CONSTANT)                                  ///< Scene set up for the software backend
+    Q_PROPERTY(QString name READ name CONSTANT)                                         ///< "software" or "default"
+    Q_PROPERTY(double dirtyPercent READ dirtyPercent NOTIFY statsChanged)               ///< Mean repainted share of the window per frame, last second (-1 unknown)
+    Q_PROPERTY(double fullRepaintPercent READ fullRepaintPercent NOTIFY statsChanged)   ///< Frames that repainted (nearly) the whole window, last second
+    Q_PROPERTY(bool partialUpdates READ partialUpdates NOTIFY statsChanged)             ///< Verified from the flush regions
+
+public:
+    /**
+     * @brief Cumulative repaint numbers (software profile only)
+     */
+    struct RepaintStats
+    {
+        qint64 frames = 0;          ///< Frames with a flush region
+        double dirtyShareSum = 0.0; ///< Sum of the per-frame repainted share (0..1)
+        qint64 fullRepaints = 0;    ///< Frames that repainted (nearly) the whole window
+    };
+
+    /**
+     * @brief Reads DRIVER_UI_PROFILE and selects the graphics API; call before the first window
+     */
+    static void configure();
+
+    explicit RenderProfile(QObject *parent = nullptr);
+    ~RenderProfile();
+
+    /**
+     * @brief Takes window size and frame count from @p window (software profile only)
+     */
+    void trackWindow(QQuickWindow *window);
+
+    bool isSoftware() const { return m_software; }
+    QString name() const { return m_software ? QStringLiteral("software") : QStringLiteral("default"); }
+    double dirtyPercent() const { return m_dirtyPercent; }
+    double fullRepaintPercent() const { return m_fullRepaintPercent; }
+    bool partialUpdates() const { return m_partialUpdates; }
+
+    /**
+     * @brief Totals since construction; take two and subtract for a window
+     */
+    RepaintStats repaintStats() const;
+
+signals:
+    void statsChanged();
+
+private slots:
+    void sample();
+
+private:
+    static void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &message);
+    void onFlushRegion(const QString &message);
+    void updateWindowArea();
+
+    bool m_software;
+    QPointer<QQuickWindow> m_window;
+    QTimer m_timer;
+
+    // Render thread writes, sample() reads
+    std::atomic<qint64> m_windowArea;       ///< Logical pixels
+    std::atomic<qint64> m_swaps;            ///< Frames swapped (with or without a flush region)
+    std::atomic<qint64> m_regionFrames;
+    std::atomic<qint64> m_dirtySharePpm;    ///< Sum of per-frame shares in parts per million
+    std::atomic<qint64> m_fullRepaints;
+
+    // Last sample() (GUI thread)
+    qint64 m_lastSwaps;
+    qint64 m_lastRegionFrames;
+    qint64 m_lastDirtySharePpm;
+    qint64 m_lastFullRepaints;
+    int m_silentTicks;                      ///< Seconds of frames without any flush region
+    bool m_warnedSilent;
+
+    double m_dirtyPercent;
+    double m_fullRepaintPercent;
+    bool m_partialUpdates;
+
+    MetricGauge *m_dirtyGauge;
+    MetricCounter *m_fullRepaintCounter;
+};
+
+#endif // RENDERPROFILE_H
@@ -0,0 +1,184 @@
+/**
+ * @file rtpreceiveengine.hpp
+ * @brief Native RTP/UDP packet ingest for the video pipeline
+ *
+ * Replaces GStreamer's udpsrc when VideoStreamReceiver runs in native ingest mode.
+ * Packets are read on dedicated threads with kernel RX timestamps and handed to a
+ * sink callback (RtpStreamRouter hands them on to the receiver of each stream).
+ *
+ * Ingest can be sharded: several sockets bound to the same port with SO_REUSEPORT,
+ * each served by its own thread, optionally pinned to a core of its own. The kernel
+ * hashes every flow (sender address and port) onto one shard, so several cameras
+ * sending to one port are received in parallel while each stream stays in order on
+ * a single thread.
+ */
+
+#ifndef RTPRECEIVEENGINE_H
+#define RTPRECEIVEENGINE_H
+
+// Qt includes
+#include <QtGlobal>      // qint64, quint16, platform macros
+
+// Standard library includes
+#include <atomic>        // Lock-free statistics shared with the GUI thread
+#include <functional>    // Packet sink callback
+#include <future>        // Bind result of the receive threads
+#include <memory>        // Shard ownership
+#include <thread>        // Receive threads
+#include <vector>        // Shard list
+
+/**
+ * @class RtpReceiveEngine
+ * @brief Receives RTP datagrams on a port and forwards them with timestamps
+ *
+ * The sink is invoked on the receiving shard's thread, once per datagram, with a
+ * pointer into that shard's receive buffer that is only valid for the call. With
+ * more than one shard the sink is called concurrently and must be thread-safe.
+ */
+class RtpReceiveEngine
+{
+public:
+    /**
+     * @struct Packet
+     * @brief One received datagram as seen by the sink
+     */
+    struct Packet
+    {
+        const char *data;   ///< RTP packet bytes (valid only during the sink call)
+        int size;           ///< Number of bytes
+        qint64 kernelRxNs;  ///< Kernel receive time (CLOCK_REALTIME ns), -1 if unavailable
+        qint64 userRxNs;    ///< Time the packet was read by the engine thread
+        quint16 port;       ///< Local port the packet arrived on
+        quint32 ssrc;       ///< RTP synchronization source (0 if the packet is too short)
+        int shard;          ///< Index of the shard that received the packet
+    };
+
+    using PacketSink = std::function<void(const Packet &)>;
+
+    /**
+     * @struct Config
+     * @brief Socket and thread layout for start()
+     */
+    struct Config
+    {
+        quint16 port = 0;                ///< UDP port to listen on (0: any free port, see port())
+        int shards = 1;                  ///< SO_REUSEPORT sockets/threads on the port (Linux only)
+        bool pinThreads = false;         ///< Pin each shard thread to its own core (Linux only)
+        int receiveBufferSize = 200000;  ///< Kernel socket buffer (SO_RCVBUF) per socket in bytes
+    };
+
+    /**
+     * @struct Stats
+     * @brief Snapshot of the engine counters
+     */
+    struct Stats
+    {
+        qint64 packets = 0;            ///< Datagrams received
+        qint64 bytes = 0;              ///< Payload bytes received
+        qint64 kernelStamped = 0;      ///< Datagrams that carried a kernel timestamp
+        qint64 socketDelaySumNs = 0;   ///< Sum of (userRx - kernelRx) over stamped datagrams
+        qint64 socketDelayMaxNs = 0;   ///< Worst (userRx - kernelRx) seen
+    };
+
+    RtpReceiveEngine();
+    ~RtpReceiveEngine();
+
+    RtpReceiveEngine(const RtpReceiveEngine &) = delete;
+    RtpReceiveEngine &operator=(const RtpReceiveEngine &) = delete;
+
+    /**
+     * @brief Binds all sockets and starts one receive thread per shard
+     * @param config Port, shard count, socket buffer and pinning
+     * @param sink Called for every datagram on the receiving shard's thread
+     * @return false if any socket could not be created or bound (nothing is started)
+     */
+    bool start(const Config &config, PacketSink sink);
+
+    /**
+     * @brief Convenience overload: one unpinned shard
+     */
+    bool start(quint16 port, PacketSink sink, int receiveBufferSize = 200000);
+
+    /**
+     * @brief Stops and joins all receive threads; safe to call when not running
+     */
+    void stop();
+
+    bool isRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Returns the bound port (the one picked by the kernel if Config::port was 0)
+     */
+    quint16 port() const { return m_port; }
+
+    /**
+     * @brief Whether datagrams are stamped by the kernel (Linux only)
+     */
+    bool hasKernelTimestamps() const { return m_kernelTimestamps; }
+
+    /**
+     * @brief Number of running shards (sockets + threads)
+     */
+    int shardCount() const { return static_cast<int>(m_shards.size()); }
+
+    /**
+     * @brief Returns the counters summed over all shards (callable from any thread)
+     */
+    Stats stats() const;
+
+    /**
+     * @brief Returns the counters of one shard, to check how evenly flows are spread
+     */
+    Stats shardStats(int shard) const;
+
+private:
+    /**
+     * @struct Shard
+     * @brief One socket, its thread and its counters
+     *
+     * Aligned to a cache line so shards never share counter lines (no false sharing).
+     */
+    struct alignas(64) Shard
+    {
+        qintptr fd = -1;                 ///< Native socket (Linux), -1 otherwise
+        int index = 0;                   ///< Position in m_shards
+        int core = -1;                   ///< CPU the thread is pinned to, -1 if unpinned
+        std::thread thread;              ///< Receive thread
+
+        // Written only by this shard's thread, read by anyone
+        std::atomic<qint64> packets{0};
+        std::atomic<qint64> bytes{0};
+        std::atomic<qint64> kernelStamped{0};
+        std::atomic<qint64> socketDelaySumNs{0};
+        std::atomic<qint64> socketDelayMaxNs{0};
+    };
+
+    /**
+     * @brief Creates and binds one socket of the shard group (Linux)
+     * @param port Port to bind (0: any free port)
+     * @param reusePort Join an SO_REUSEPORT group (more than one shard)
+     * @return Descriptor, or -1 on failure
+     */
+    qintptr openSocket(quint16 port, bool reusePort);
+
+    /**
+     * @brief Receive loop run on each shard's thread
+     * @param shard Shard served by the calling thread
+     * @param bound Set once the socket is bound (false: bind failed, the loop does not run)
+     */
+    void run(Shard *shard, std::promise<bool> bound);
+
+    /**
+     * @brief Updates a shard's counters after one datagram (its receive thread only)
+     */
+    static void account(Shard *shard, int size, qint64 kernelRxNs, qint64 userRxNs);
+
+    std::vector<std::unique_ptr<Shard>> m_shards;  ///< Active shards
+    std::atomic<bool> m_running;       ///< Cleared by stop() to end the loops
+    Config m_config;                   ///< Configuration of the running engine
+    quint16 m_port;                    ///< Bound port, 0 when stopped
+    bool m_kernelTimestamps;           ///< Whether the kernel stamps datagrams on every shard
+    PacketSink m_sink;                 ///< Consumer of received packets
+};
+
+#endif // RTPRECEIVEENGINE_H
@@ -0,0 +1,159 @@
+/**
+ * @file rtpstreamrouter.hpp
+ * @brief Hands the RTP streams arriving on one port to one receiver each
+ *
+ * A depayloader can only reassemble a single RTP stream, but a (sharded)
+ * RtpReceiveEngine delivers every stream sent to its port. The router owns the
+ * engine of a port and dispatches each packet by SSRC to the sink of the
+ * stream that claimed it, so several cameras can share one port and its
+ * shard threads while every camera keeps a depayloader of its own.
+ *
+ * Routers are shared per port: every VideoStreamReceiver that natively
+ * ingests from a port acquires the same router and adds a stream to it.
+ */
+
+#ifndef RTPSTREAMROUTER_H
+#define RTPSTREAMROUTER_H
+
+// Qt includes
+#include <QtGlobal>      // qint64, quint16, quint32
+
+// Standard library includes
+#include <atomic>        // Routing generation and per-stream counters
+#include <memory>        // Shared routers, stream ownership
+#include <mutex>         // Claim table and per-shard route caches
+#include <utility>       // std::pair in the route caches
+#include <vector>        // Streams, shards and cached routes
+
+#include "rtpreceiveengine.hpp"  // Shared receive engine, Packet / PacketSink
+
+/**
+ * @class RtpStreamRouter
+ * @brief Owns the receive engine of a port and routes its packets by SSRC
+ *
+ * A stream claims the first unclaimed SSRC that arrives while it has none, and
+ * follows a new SSRC once its own has been silent for half a second (sender
+ * restarted). Packets of SSRCs no stream can take are dropped and counted.
+ *
+ * Sinks run on the shard thread that received the packet. The kernel keeps a
+ * flow on one shard, so a stream sent from one source port is delivered in
+ * order by a single thread.
+ */
+class RtpStreamRouter
+{
+public:
+    using Packet = RtpReceiveEngine::Packet;
+    using PacketSink = RtpReceiveEngine::PacketSink;
+
+    /**
+     * @brief Returns the router of a port, starting its engine on first use
+     * @param config Port and engine layout; ignored (except the port) if the router already runs
+     * @return Shared router, or nullptr if the port could not be bound
+     *
+     * Port 0 always starts a new router on a free port (see port()).
+     */
+    static std::shared_ptr<RtpStreamRouter> acquire(const RtpReceiveEngine::Config &config);
+
+    ~RtpStreamRouter();
+
+    RtpStreamRouter(const RtpStreamRouter &) = delete;
+    RtpStreamRouter &operator=(const RtpStreamRouter &) = delete;
+
+    /**
+     * @brief Adds a stream; it claims the next unclaimed SSRC on the port
+     * @param sink Called for every packet of the claimed SSRC, on a shard thread
+     * @return Stream id for removeStream() and the stream accessors
+     */
+    int addStream(PacketSink sink);
+
+    /**
+     * @brief Removes a stream and releases its SSRC
+     *
+     * Waits for sink calls in progress; the sink is not called after this returns.
+     */
+    void removeStream(int id);
+
+    /**
+     * @brief Returns the SSRC a stream currently receives (0 before its first packet)
+     */
+    quint32 streamSsrc(int id) const;
+
+    /**
+     * @brief Returns the number of packets delivered to a stream
+     */
+    qint64 streamPackets(int id) const;
+
+    /**
+     * @brief Returns packets dropped because no stream could take their SSRC
+     */
+    qint64 unroutedPackets() const { return m_unroutedPackets.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Bound port
+     */
+    quint16 port() const { return m_engine.port(); }
+
+    /**
+     * @brief The port's receive engine (kernel timestamps, per-shard counters)
+     */
+    const RtpReceiveEngine &engine() const { return m_engine; }
+
+private:
+    /**
+     * @struct Stream
+     * @brief One consumer of the port and its claim
+     */
+    struct Stream
+    {
+        int id = 0;                          ///< Handle returned by addStream()
+        PacketSink sink;                     ///< Receiver of the claimed SSRC
+        bool claimed = false;                ///< Whether ssrc is valid (guarded by m_mutex)
+        std::atomic<quint32> ssrc{0};        ///< Claimed SSRC (written under m_mutex)
+        std::atomic<qint64> lastNs{0};       ///< Receive time of the latest routed packet
+        std::atomic<qint64> packets{0};      ///< Packets delivered to the sink
+    };
+
+    /**
+     * @struct ShardRoutes
+     * @brief SSRC -> stream cache of one shard thread
+     *
+     * Sinks are called with the mutex held, which is what lets removeStream()
+     * wait for calls in progress. Aligned so shards don't share the line.
+     */
+    struct alignas(64) ShardRoutes
+    {
+        std::mutex mutex;                                 ///< Held while routing a packet
+        quint64 generation = 0;                           ///< m_generation the cache was built for
+        std::vector<std::pair<quint32, Stream *>> cache;  ///< Resolved SSRCs (nullptr: unrouted)
+    };
+
+    RtpStreamRouter();
+
+    /**
+     * @brief Engine sink: finds the stream of a packet and calls its sink
+     */
+    void route(const Packet &packet);
+
+    /**
+     * @brief Looks up or assigns the stream of an SSRC (cache miss, shard lock held)
+     * @param generation Set to the routing generation the result belongs to
+     * @return Stream, or nullptr if no stream can take the SSRC
+     */
+    Stream *resolve(quint32 ssrc, qint64 nowNs, quint64 *generation);
+
+    /**
+     * @brief Returns the stream with the given id (m_mutex held)
+     */
+    Stream *findStream(int id) const;
+
+    RtpReceiveEngine m_engine;                            ///< Sockets and shard threads of the port
+    std::vector<std::unique_ptr<ShardRoutes>> m_routes;  ///< One route cache per shard
+
+    mutable std::mutex m_mutex;                           ///< Guards m_streams and the claims
+    std::vector<std::unique_ptr<Stream>> m_streams;      ///< Added streams
+    int m_nextId;                                         ///< Id of the next added stream
+    std::atomic<quint64> m_generation;                    ///< Bumped on every claim change
+    std::atomic<qint64> m_unroutedPackets;                ///< Packets no stream took
+};
+
+#endif // RTPSTREAMROUTER_H
@@ -0,0 +1,97 @@
+/**
+ * @file startupprofiler.hpp
+ * @brief Startup milestones: time to window, first video frame and live controls
+ *
+ * GStreamer and SDL initialize on worker threads while the QML engine loads
+ * (see VideoStreamReceiver::initializeAsync(), SteeringController::initializeAsync()),
+ * so the interesting numbers are no longer a sum of constructor times but when
+ * the operator can see the window, see video and drive. Each milestone is taken
+ * once, logged, marked in the trace and exported as driver_startup_seconds.
+ */
+
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+
+// Qt includes
+#include <QElapsedTimer> // Startup clock (qMain entry = 0)
+#include <QHash>         // Milestone -> elapsed time
+#include <QMutex>        // Milestones are taken from worker and render threads too
+#include <QObject>       // Base class for Qt objects with signal/slot support
+#include <QString>       // Milestone names
+
+// Standard library includes
+#include <atomic>        // Pending "on next frame" milestone, set from the GUI thread, taken on the render thread
+
+class QQuickWindow;
+
+/**
+ * @class StartupProfiler
+ * @brief Records named startup milestones relative to qMain() (exposed to QML as "startupProfiler")
+ *
+ * Construct it first thing in qMain(). Milestones with a fixed meaning:
+ * - "window": first frame of the main window on screen
+ * - "first frame": first video frame on screen
+ * - "controls live": input device open and control channel connected
+ *
+ * Any other name ("qml loaded", "gstreamer ready", ...) is recorded and logged
+ * the same way. Only the first mark() of a name counts.
+ */
+class StartupProfiler : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(double preMainMs READ preMainMs CONSTANT)                            ///< Process creation -> qMain (loader, static init; -1 if unknown)
+    Q_PROPERTY(double timeToWindowMs READ timeToWindowMs NOTIFY milestoneReached)   ///< -1 until reached
+    Q_PROPERTY(double timeToFirstFrameMs READ timeToFirstFrameMs NOTIFY milestoneReached)
+    Q_PROPERTY(double timeToControlsLiveMs READ timeToControlsLiveMs NOTIFY milestoneReached)
+
+public:
+    explicit StartupProfiler(QObject *parent = nullptr);
+
+    /**
+     * @brief Records @p name at the current time (any thread; repeated marks are ignored)
+     */
+    void mark(const char *name);
+
+    /**
+     * @brief Records @p name when @p window next finishes a frame (see trackWindow())
+     *
+     * For milestones that only count once they are visible, e.g. the first video
+     * frame: the frame is decoded on one thread, handed to QML on the next and
+     * only on screen after the next swap.
+     */
+    void markOnNextFrame(const char *name);
+
+    /**
+     * @brief Takes "window" and markOnNextFrame() milestones from @p window's frame swaps
+     */
+    void trackWindow(QQuickWindow *window);
+
+    /**
+     * @brief Milliseconds since qMain() at which @p name was reached, -1 if not (yet)
+     */
+    Q_INVOKABLE double milestoneMs(const QString &name) const;
+
+    double preMainMs() const { return m_preMainMs; }
+    double timeToWindowMs() const { return milestoneMs(QStringLiteral("window")); }
+    double timeToFirstFrameMs() const { return milestoneMs(QStringLiteral("first frame")); }
+    double timeToControlsLiveMs() const { return milestoneMs(QStringLiteral("controls live")); }
+
+signals:
+    /**
+     * @brief Emitted on the GUI thread after each new milestone
+     */
+    void milestoneReached(const QString &name, double elapsedMs);
+
+private:
+    void onFrameSwapped();
+
+    QElapsedTimer m_clock;                   ///< Started in the constructor
+    double m_preMainMs;                      ///< Process creation -> constructor
+    mutable QMutex m_mutex;                  ///< Guards m_milestones
+    QHash<QString, double> m_milestones;     ///< Name -> ms since m_clock start
+    std::atomic<bool> m_windowShown;         ///< "window" taken (checked on every swap)
+    std::atomic<const char *> m_onNextFrame; ///< markOnNextFrame() name waiting for a swap
+};
+
+#endif // STARTUPPROFILER_H
@@ -13,12 +13,15 @@
 // Qt includes for core functionality and QML integration
 #include <QObject>       // Base class for Qt objects with signal/slot support
 #include <QQmlEngine>    // QML engine integration for exposing to QML
+#include <QElapsedTimer> // Poll interval measurement for the input metrics
 #include <QTimer>        // Timer for periodic joystick polling
 
 // SDL2 includes for game controller/joystick support
 #include <SDL2/SDL.h>    // Simple DirectMedia Layer for input device handling
 
 // Standard library includes
+#include <atomic>        // SDL init result, control snapshot for the render thread
+#include <thread>        // Background SDL initialization
 #include <vector>        // For storing device indices
 
 /**
@@ -38,7 +41,8 @@
  * - Device connection/disconnection management
  *
  * Typical usage:
- * 1. Call refreshDevices() to scan for available devices
+ * 1. Call refreshDevices() to scan for available devices (or initializeAsync()
+ *    and wait for readyChanged())
  * 2. Call connectDevice(index) to connect to a specific device
  * 3. Monitor steering and throttle properties in QML
  * 4. Call disconnectDevice() when done
@@ -54,11 +58,25 @@ class SteeringController : public QObject
     Q_PROPERTY(bool connected READ connected NOTIFY connectedChanged)            ///< Whether a device is currently connected
     Q_PROPERTY(QString deviceName READ deviceName NOTIFY deviceNameChanged)      ///< Name of the currently connected device
     Q_PROPERTY(QStringList availableDevices READ availableDevices NOTIFY availableDevicesChanged)  ///< List of detected device names
+    Q_PROPERTY(bool ready READ isReady NOTIFY readyChanged)                      ///< SDL initialized and devices enumerated
 
 public:
     /**
-     * @brief Constructs the steering controller and initializes SDL2
+     * @struct ControlSnapshot
+     * @brief Steering and throttle of one poll, always read as a pair
+     */
+    struct ControlSnapshot
+    {
+        float steering = 0.0f;  ///< -1.0 (full left) to 1.0 (full right)
+        float throttle = 0.0f;  ///< 0.0 to 1.0
+    };
+
+    /**
+     * @brief Constructs the steering controller; SDL2 is initialized on first use
      * @param parent Parent QObject for memory management (follows Qt parent-child pattern)
+     *
+     * Call initializeAsync() to initialize in the background instead, otherwise the
+     * first refreshDevices() or connectDevice() blocks on SDL's device scan.
      */
     explicit SteeringController(QObject *parent = nullptr);
 
@@ -81,6 +99,15 @@ public:
      */
     qreal throttle() const { return m_throttle; }
 
+    /**
+     * @brief Returns the latest steering/throttle pair
+     *
+     * Lock-free and consistent, so it may be read from any thread - ControlsView
+     * reads it once per frame on the render thread instead of binding to
+     * steeringChanged()/throttleChanged().
+     */
+    ControlSnapshot snapshot() const;
+
     /**
      * @brief Returns whether a device is currently connected
      * @return true if device is connected and polling, false otherwise
@@ -99,6 +126,29 @@ public:
      */
     QStringList availableDevices() const { return m_availableDevices; }
 
+    /**
+     * @brief Returns whether SDL is initialized and availableDevices is populated
+     */
+    bool isReady() const { return m_ready; }
+
+    /**
+     * @brief Initializes SDL's joystick subsystem on a worker thread
+     *
+     * SDL_InitSubSystem() opens and probes every input device, which can take a
+     * few hundred milliseconds (more with DirectInput devices attached). The
+     * device list is filled in and readyChanged() emitted on the GUI thread once
+     * it has finished. No-op once ready.
+     */
+    void initializeAsync();
+
+    /**
+     * @brief Initializes SDL on the calling thread unless already done (waits for initializeAsync())
+     *
+     * For callers that use SDL's joystick API themselves before the first
+     * refreshDevices() (e.g. to attach a virtual joystick).
+     */
+    void ensureInitialized();
+
     // QML-invokable methods (callable from JavaScript in QML)
 
     /**
@@ -156,6 +206,11 @@ signals:
      */
     void availableDevicesChanged();
 
+    /**
+     * @brief Emitted (on the GUI thread) once SDL is initialized and devices are enumerated
+     */
+    void readyChanged();
+
 private slots:
     /**
      * @brief Qt slot to poll the joystick for new input values
@@ -167,15 +222,23 @@ private slots:
     void pollJoystick();
 
 private:
+    friend struct BenchAccess;  // Microbenchmarks (bench/) drive the private hot paths
+
     // Private helper methods
 
     /**
      * @brief Initializes the SDL2 library subsystems
+     * @return true if the joystick subsystem is usable
      *
-     * Called in constructor to set up SDL2's joystick subsystem.
-     * Must be called before any SDL joystick functions can be used.
+     * Called on first use or on the initialization thread to set up SDL2's joystick
+     * subsystem. Must be called before any SDL joystick functions can be used.
+     */
+    bool initSDL();
+
+    /**
+     * @brief GUI thread part of initialization: device list, readyChanged()
      */
-    void initSDL();
+    void finishInitialization();
 
     /**
      * @brief Cleans up and shuts down SDL2 subsystems
@@ -224,6 +287,11 @@ private:
      */
     qreal normalizeAxis(int value, int min = -32768, int max = 32767);
 
+    /**
+     * @brief Publishes m_steering/m_throttle to m_snapshot
+     */
+    void publishSnapshot();
+
     // Member variables (all prefixed with m_ following Qt convention)
 
     // SDL joystick handling
@@ -234,15 +302,27 @@ private:
     qreal m_steering;  ///< Current steering wheel position (-1.0 = full left, 1.0 = full right)
     qreal m_throttle;  ///< Current throttle/brake position (-1.0 = full brake, 1.0 = full throttle)
 
+    std::atomic<quint64> m_snapshot;  ///< m_steering and m_throttle as two packed floats (see snapshot())
+
     // Device connection state
     bool m_connected;                      ///< Flag indicating whether a device is currently connected
     QString m_deviceName;                  ///< Name of the currently connected device
     QStringList m_availableDevices;        ///< User-friendly list of device names for UI display
     std::vector<int> m_deviceIndices;      ///< Corresponding SDL device indices (parallel to m_availableDevices)
 
+    // Initialization (see initializeAsync())
+    bool m_ready;                          ///< finishInitialization() has run
+    std::atomic<bool> m_sdlInitialized;    ///< initSDL() succeeded, SDL_QuitSubSystem() due on destruction
+    std::thread m_initThread;              ///< SDL_InitSubSystem(), joined by finishInitialization()
+
     // Axis mapping configuration
     int m_steeringAxis;  ///< Which joystick axis to use for steering (typically 0)
     int m_throttleAxis;  ///< Which joystick axis to use for throttle (typically 1)
+
+    // Poll timing for the exported input metrics
+    QElapsedTimer m_pollClock;  ///< Started when a device is opened
+    qint64 m_lastPollNs;        ///< m_pollClock time of the previous poll (-1 before the first)
+    double m_pollJitterNs;      ///< Smoothed |interval - timer interval|
 };
 
 #endif // STEERINGCONTROLLER_H
\ No newline at end of file
@@ -0,0 +1,151 @@
+/**
+ * @file stripchart.hpp
+ * @brief Scrolling line chart of one live value as a scene graph item
+ *
+ * Canvas or ChartView would redraw the whole plot on every sample. This item
+ * min/max-decimates samples into one column per pixel as they arrive, so a
+ * 1 kHz input costs the same to draw as a 10 Hz one. The columns live in a
+ * vertex ring that is updated in place (the current column, plus one per
+ * column scrolled), and scrolling and value scaling are a transform matrix.
+ */
+
+#ifndef STRIPCHART_H
+#define STRIPCHART_H
+
+// Qt includes
+#include <QColor>        // Line color
+#include <QElapsedTimer> // Sample clock
+#include <QPointer>      // Controller may be destroyed before the item
+#include <QQuickItem>    // Base class for custom scene graph items
+#include <QTimer>        // Scrolling and metric sampling
+
+// Standard library includes
+#include <vector>        // Column ring
+
+class MetricHistogram;
+class SteeringController;
+
+/**
+ * @class StripChart
+ * @brief Last windowSeconds of a value, newest on the right (QML: StripChart { source: ... })
+ *
+ * Sources:
+ * - Custom: whatever append() is given
+ * - Steering / Throttle: every change of the controller's axes
+ * - ControlRtt / FrameAge: mean of the metric histograms, 20 times a second
+ *   (driver_control_rtt_seconds, RX -> appsink -> GUI), in milliseconds
+ *
+ * Between samples the last value is held. The y axis spans minimum..maximum;
+ * values outside are clipped.
+ */
+class StripChart : public QQuickItem
+{
+    Q_OBJECT
+    QML_ELEMENT
+
+    Q_PROPERTY(Source source READ source WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(SteeringController *controller READ controller WRITE setController NOTIFY controllerChanged)
+    Q_PROPERTY(double windowSeconds READ windowSeconds WRITE setWindowSeconds NOTIFY windowSecondsChanged)  ///< Time across the item (default 30)
+    Q_PROPERTY(double minimum READ minimum WRITE setMinimum NOTIFY rangeChanged)
+    Q_PROPERTY(double maximum READ maximum WRITE setMaximum NOTIFY rangeChanged)
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+    Q_PROPERTY(double value READ value NOTIFY valueChanged)  ///< Last sample (for labels; notified at most at the scroll rate)
+
+public:
+    enum Source {
+        Custom,
+        Steering,
+        Throttle,
+        ControlRtt,
+        FrameAge
+    };
+    Q_ENUM(Source)
+
+    explicit StripChart(QQuickItem *parent = nullptr);
+
+    Source source() const { return m_source; }
+    void setSource(Source source);
+    SteeringController *controller() const { return m_controller; }
+    void setController(SteeringController *controller);
+    double windowSeconds() const { return m_windowSeconds; }
+    void setWindowSeconds(double seconds);
+    double minimum() const { return m_minimum; }
+    void setMinimum(double minimum);
+    double maximum() const { return m_maximum; }
+    void setMaximum(double maximum);
+    QColor color() const { return m_color; }
+    void setColor(const QColor &color);
+    double value() const { return m_lastValue; }
+
+    /**
+     * @brief Adds a sample taken now (GUI thread; O(1))
+     */
+    Q_INVOKABLE void append(double value);
+
+signals:
+    void sourceChanged();
+    void controllerChanged();
+    void windowSecondsChanged();
+    void rangeChanged();
+    void colorChanged();
+    void valueChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+    void itemChange(ItemChange change, const ItemChangeData &value) override;
+
+private slots:
+    void scroll();
+    void sampleMetrics();
+
+private:
+    /**
+     * @brief One pixel column: value range seen during its time slice
+     */
+    struct Column
+    {
+        float first = 0.0f;   ///< Value entering the column (last value of the previous one)
+        float minimum = 0.0f;
+        float maximum = 0.0f;
+        bool valid = false;   ///< Anything known yet (before the first sample: nothing drawn)
+    };
+
+    void resetColumns();
+    void advanceTo(qint64 column);
+    void connectSource();
+    double takeHistogramMeanMs(const char *name, const char *labels, qint64 &lastSumNs, quint64 &lastCount);
+
+    Source m_source;
+    QPointer<SteeringController> m_controller;
+    QMetaObject::Connection m_sourceConnection;
+    double m_windowSeconds;
+    double m_minimum;
+    double m_maximum;
+    QColor m_color;
+    bool m_colorDirty;
+
+    QElapsedTimer m_clock;
+    QTimer m_scrollTimer;
+    QTimer m_metricTimer;
+
+    // Ring of pixel columns; slot = column number % size
+    std::vector<Column> m_columns;
+    qint64 m_columnNs;                ///< Time slice per column
+    qint64 m_headColumn;              ///< Column number of the newest column (-1 none)
+    qint64 m_dirtyFromColumn;         ///< Oldest column whose vertices need rewriting
+    bool m_rebuild;                   ///< Column count changed: new geometry
+    bool m_hasValue;
+    double m_lastValue;
+    bool m_valueNotified;
+
+    // Metric sources (sum/count at the previous sample)
+    qint64 m_rttSumNs = 0;
+    quint64 m_rttCount = 0;
+    qint64 m_decodeSumNs = 0;
+    quint64 m_decodeCount = 0;
+    qint64 m_handoffSumNs = 0;
+    quint64 m_handoffCount = 0;
+};
+
+#endif // STRIPCHART_H
@@ -0,0 +1,108 @@
+/**
+ * @file telemetryrecorder.hpp
+ * @brief Records the session's inputs and latencies into a TimeSeriesStore
+ *
+ * Steering and throttle are recorded at every change, the latency means from
+ * the metric histograms ten times a second. QML asks for "N points of this
+ * window" and gets an LTTB-reduced list, so a plot of the whole session costs
+ * the same as one of the last minute. DRIVER_TELEMETRY_MB bounds the memory
+ * (default 64), DRIVER_TELEMETRY_CSV writes everything retained on exit.
+ */
+
+#ifndef TELEMETRYRECORDER_H
+#define TELEMETRYRECORDER_H
+
+// Qt includes
+#include <QElapsedTimer> // Session clock
+#include <QObject>       // Base class for Qt objects with signal/slot support
+#include <QPointer>      // Controller may be destroyed before the recorder
+#include <QStringList>   // Series names
+#include <QTimer>        // 10 Hz metric sampling
+#include <QVariantList>  // Query results for QML
+
+// Project includes
+#include "timeseriesstore.hpp"  // Sample storage
+
+class MetricHistogram;
+class SteeringController;
+
+/**
+ * @class TelemetryRecorder
+ * @brief Session time series for charts and export (QML: "telemetry")
+ *
+ * Series: steering, throttle (-1..1), control_rtt_ms, frame_age_ms,
+ * swap_latency_ms. Times are seconds since the recorder started.
+ */
+class TelemetryRecorder : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QStringList series READ series CONSTANT)
+    Q_PROPERTY(double memoryMb READ memoryMb NOTIFY sampled)  ///< Chunks allocated so far (bounded by DRIVER_TELEMETRY_MB)
+
+public:
+    explicit TelemetryRecorder(QObject *parent = nullptr);
+    ~TelemetryRecorder();
+
+    /**
+     * @brief Records steering/throttle changes of @p controller
+     */
+    void recordController(SteeringController *controller);
+
+    QStringList series() const { return m_store.seriesNames(); }
+    double memoryMb() const { return m_store.memoryBytes() / (1024.0 * 1024.0); }
+
+    /**
+     * @brief Current time on the session clock (seconds)
+     */
+    Q_INVOKABLE double now() const { return m_clock.nsecsElapsed() / 1e9; }
+
+    /**
+     * @brief Up to @p points of @p series between two session times, as QPointF(seconds, value)
+     */
+    Q_INVOKABLE QVariantList query(const QString &series, double fromSeconds, double toSeconds, int points) const;
+
+    /**
+     * @brief Up to @p points of the last @p seconds of @p series
+     */
+    Q_INVOKABLE QVariantList recent(const QString &series, double seconds, int points) const;
+
+    /**
+     * @brief Writes every retained sample as CSV (series,time_s,value)
+     * @return false if the file could not be written
+     */
+    Q_INVOKABLE bool exportCsv(const QString &path) const;
+
+signals:
+    void sampled();
+
+private slots:
+    void sampleMetrics();
+
+private:
+    struct HistogramSeries {
+        const char *name;
+        const char *labels;
+        int series;
+        const MetricHistogram *histogram = nullptr;
+        qint64 lastSumNs = 0;
+        quint64 lastCount = 0;
+        double takeMeanMs();  ///< -1 when nothing was observed
+    };
+
+    qint64 nowUs() const { return m_clock.nsecsElapsed() / 1000; }
+
+    QElapsedTimer m_clock;
+    QTimer m_timer;
+    TimeSeriesStore m_store;
+    QPointer<SteeringController> m_controller;
+    int m_steering;
+    int m_throttle;
+    int m_frameAge;
+    HistogramSeries m_controlRtt;
+    HistogramSeries m_rxToAppsink;
+    HistogramSeries m_appsinkToGui;
+    HistogramSeries m_swapLatency;
+};
+
+#endif // TELEMETRYRECORDER_H
@@ -0,0 +1,116 @@
+/**
+ * @file threadmonitor.hpp
+ * @brief Per-thread CPU and run-queue wait sampled from /proc (Linux)
+ *
+ * Reads /proc/self/task/<tid>/stat (thread name) and schedstat (time on CPU,
+ * time runnable but waiting for a CPU, number of timeslices) for every thread
+ * of the process, so it is visible whether the GUI thread, the render thread,
+ * the GStreamer streaming threads or the receive engine are burning the time -
+ * and which of them are starved rather than busy.
+ *
+ * Threads we create are named with nameCurrentThread(); GStreamer names its
+ * streaming threads after the element owning the task ("decode:src").
+ */
+
+#ifndef THREADMONITOR_H
+#define THREADMONITOR_H
+
+// Qt includes
+#include <QElapsedTimer> // Sample interval clock
+#include <QHash>         // Previous totals per thread
+#include <QObject>       // Base class for Qt objects with signal/slot support
+#include <QString>       // Thread names
+#include <QTimer>        // Periodic sampling
+#include <QVariantList>  // QML view of the samples
+#include <QVector>       // Sample list
+
+/**
+ * @class ThreadMonitor
+ * @brief Samples per-thread scheduling statistics while running
+ *
+ * Percentages are of one CPU over the last interval, so a thread that keeps a
+ * core busy shows 100 and the process total can exceed 100 on multi-core
+ * machines. When tracing is active every sample is also recorded as trace
+ * counters ("thread cpu %", "thread wait %").
+ */
+class ThreadMonitor : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool running READ isRunning WRITE setRunning NOTIFY runningChanged)
+    Q_PROPERTY(int intervalMs READ intervalMs WRITE setIntervalMs NOTIFY intervalMsChanged)
+    Q_PROPERTY(bool supported READ isSupported CONSTANT)                        ///< /proc is available (Linux)
+    Q_PROPERTY(QVariantList threads READ threads NOTIFY updated)                 ///< Busiest first: {tid, name, cpuPercent, waitPercent, waitPerSliceUs}
+    Q_PROPERTY(double processCpuPercent READ processCpuPercent NOTIFY updated)   ///< Sum over all threads
+
+public:
+    /**
+     * @struct ThreadSample
+     * @brief One thread's share of the last interval
+     */
+    struct ThreadSample
+    {
+        qint64 tid = 0;
+        QString name;
+        double cpuPercent = 0.0;
+        double waitPercent = -1.0;      ///< Runnable but not running; -1 without schedstat
+        double waitPerSliceUs = -1.0;   ///< Mean scheduling delay per timeslice; -1 without schedstat
+    };
+
+    explicit ThreadMonitor(QObject *parent = nullptr);
+
+    /**
+     * @brief Gives the calling thread an OS name (at most 15 characters on Linux)
+     *
+     * Shows up here, in top -H, perf and in trace exports. Not meant for the
+     * main thread, whose name is the process name.
+     */
+    static void nameCurrentThread(const char *name);
+
+    static bool isSupported();
+
+    bool isRunning() const { return m_timer.isActive(); }
+    void setRunning(bool running);
+
+    int intervalMs() const { return m_timer.interval(); }
+    void setIntervalMs(int intervalMs);
+
+    const QVector<ThreadSample> &samples() const { return m_samples; }
+    QVariantList threads() const;
+    double processCpuPercent() const { return m_processCpuPercent; }
+
+public slots:
+    /**
+     * @brief Takes a sample now (the first one after start only sets the baseline)
+     */
+    void sample();
+
+signals:
+    void runningChanged();
+    void intervalMsChanged();
+    void updated();
+
+private:
+    /**
+     * @brief Cumulative totals of one thread as read from /proc
+     */
+    struct TaskTimes
+    {
+        QString name;
+        qint64 cpuNs = 0;
+        qint64 waitNs = -1;    ///< -1 without schedstat
+        qint64 slices = 0;
+    };
+
+    static QHash<qint64, TaskTimes> readTasks();
+    void recordTraceCounters() const;
+
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    qint64 m_lastSampleNs;
+    QHash<qint64, TaskTimes> m_previous;
+    QVector<ThreadSample> m_samples;
+    double m_processCpuPercent;
+};
+
+#endif // THREADMONITOR_H
@@ -0,0 +1,140 @@
+/**
+ * @file timeseriesstore.hpp
+ * @brief Bounded in-memory time series with LTTB downsampling on query
+ *
+ * Session telemetry (inputs, latencies) is kept for minutes to hours and
+ * plotted at a few hundred points. Samples are stored column-wise in
+ * fixed-capacity chunks - timestamps as 32-bit microsecond deltas from the
+ * chunk's base, values as floats, 8 bytes per sample - and the oldest chunk of
+ * a series is recycled once its share of the memory budget is used up.
+ * Queries locate the window by binary search and reduce it with
+ * Largest-Triangle-Three-Buckets in one pass over the samples inside it.
+ */
+
+#ifndef TIMESERIESSTORE_H
+#define TIMESERIESSTORE_H
+
+// Qt includes
+#include <QString>       // Series names
+#include <QStringList>   // Series list
+
+// Standard library includes
+#include <array>         // Chunk columns
+#include <deque>         // Series; chunks of a series, oldest first
+#include <memory>        // Chunk ownership
+#include <vector>        // Query results
+
+/**
+ * @class TimeSeriesStore
+ * @brief Columnar chunked store of (time, value) samples per series (not thread-safe)
+ *
+ * Times are microseconds on any monotonic clock and must not decrease within
+ * a series (earlier ones are stored as the last time). All series share one
+ * memory budget, split evenly when a series is added.
+ */
+class TimeSeriesStore
+{
+public:
+    static constexpr int ChunkCapacity = 4096;
+
+    struct Point {
+        qint64 timeUs;
+        float value;
+    };
+
+    explicit TimeSeriesStore(size_t maxBytes);
+
+    /**
+     * @brief Adds a series (or returns the existing one); add all before recording
+     * @return Index for append() and query()
+     */
+    int addSeries(const QString &name);
+    int seriesIndex(const QString &name) const;  ///< -1 if unknown
+    QStringList seriesNames() const;
+
+    /**
+     * @brief Appends a sample; O(1), allocates only until the series' budget is reached
+     */
+    void append(int series, qint64 timeUs, float value);
+
+    /**
+     * @brief Samples with fromUs <= time <= toUs, reduced to at most @p points (LTTB)
+     *
+     * First and last sample of the window are always kept. @p points <= 0 or a
+     * window holding no more than @p points returns the raw samples.
+     */
+    std::vector<Point> query(int series, qint64 fromUs, qint64 toUs, int points) const;
+
+    /**
+     * @brief Calls @p visit(Point) for every raw sample in the window, oldest first
+     */
+    template <typename Visitor>
+    void forEach(int series, qint64 fromUs, qint64 toUs, Visitor visit) const
+    {
+        Cursor cursor = find(series, fromUs);
+        Cursor end = find(series, toUs + 1);
+        for (quint64 n = end.index() - cursor.index(); n > 0; --n) {
+            visit(cursor.point());
+            cursor.next();
+        }
+    }
+
+    quint64 sampleCount(int series) const;   ///< Retained samples
+    qint64 firstTimeUs(int series) const;    ///< Oldest retained sample, -1 if empty
+    size_t memoryBytes() const;              ///< Chunks currently allocated
+
+private:
+    struct Chunk {
+        qint64 baseUs = 0;          ///< Time of the first sample
+        quint64 firstIndex = 0;     ///< Sequence number of the first sample in its series
+        int size = 0;
+        std::array<quint32, ChunkCapacity> offsetsUs;
+        std::array<float, ChunkCapacity> values;
+
+        qint64 lastUs() const { return baseUs + offsetsUs[size - 1]; }
+    };
+
+    struct Series {
+        QString name;
+        std::deque<std::unique_ptr<Chunk>> chunks;
+        quint64 nextIndex = 0;
+        qint64 lastUs = 0;
+    };
+
+    /**
+     * @brief Sequential position in a series; chunk == chunks.size() is the end
+     */
+    struct Cursor {
+        const Series *series;
+        size_t chunk;
+        int pos;
+
+        Point point() const
+        {
+            const Chunk &c = *series->chunks[chunk];
+            return { c.baseUs + c.offsetsUs[pos], c.values[pos] };
+        }
+        quint64 index() const
+        {
+            return chunk < series->chunks.size() ? series->chunks[chunk]->firstIndex + pos : series->nextIndex;
+        }
+        void next()
+        {
+            if (++pos >= series->chunks[chunk]->size) {
+                ++chunk;
+                pos = 0;
+            }
+        }
+        void advance(quint64 count);
+    };
+
+    Cursor find(int series, qint64 timeUs) const;  ///< First sample at or after @p timeUs
+    std::unique_ptr<Chunk> takeChunk(Series &series);
+
+    size_t m_maxBytes;
+    size_t m_maxChunksPerSeries;
+    size_t m_allocatedChunks;
+    std::deque<Series> m_series;  ///< deque: Series (holding a deque) is not nothrow-movable
+};
+
+#endif // TIMESERIESSTORE_H
@@ -0,0 +1,131 @@
+/**
+ * @file timestampedudpsocket.hpp
+ * @brief UDP socket that reports kernel receive timestamps for each datagram
+ *
+ * User-space timestamps taken in a readyRead handler include scheduler and event
+ * loop delay. On Linux this socket asks the kernel to stamp every datagram on
+ * arrival (SO_TIMESTAMPING, falling back to SO_TIMESTAMPNS) so the time spent on
+ * the wire can be told apart from the time spent in our own process.
+ * On other platforms it wraps QUdpSocket and only user-space timestamps are set.
+ */
+
+#ifndef TIMESTAMPEDUDPSOCKET_H
+#define TIMESTAMPEDUDPSOCKET_H
+
+// Qt includes for core functionality and networking
+#include <QObject>        // Base class for Qt objects with signal/slot support
+#include <QByteArray>     // Datagram payload container
+#include <QHostAddress>   // Peer address representation
+
+class QSocketNotifier;
+class QUdpSocket;
+
+/**
+ * @struct TimestampedDatagram
+ * @brief One received datagram together with its receive timestamps
+ *
+ * Both timestamps are CLOCK_REALTIME nanoseconds so they can be compared with
+ * wall-clock times taken elsewhere (e.g. when a control message was sent).
+ */
+struct TimestampedDatagram
+{
+    QByteArray data;             ///< Datagram payload
+    QHostAddress senderAddress;  ///< Address the datagram came from
+    quint16 senderPort = 0;      ///< Port the datagram came from
+    qint64 kernelRxNs = -1;      ///< Kernel receive time, -1 if the platform gave none
+    qint64 userRxNs = 0;         ///< Time the datagram was read in user space
+};
+
+/**
+ * @class TimestampedUdpSocket
+ * @brief Minimal datagram socket with kernel RX timestamps
+ *
+ * Typical usage:
+ * 1. bind() to a local port
+ * 2. On readyRead(), call readDatagram() until it returns false
+ * 3. writeDatagram() to send from the same port (so replies come back here)
+ */
+class TimestampedUdpSocket : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TimestampedUdpSocket(QObject *parent = nullptr);
+    ~TimestampedUdpSocket();
+
+    /**
+     * @brief Binds the socket and enables kernel timestamps where supported
+     * @param address Local address to bind to
+     * @param port Local port (0 = ephemeral)
+     * @return true on success
+     */
+    bool bind(const QHostAddress &address, quint16 port);
+
+    /**
+     * @brief Closes the socket; safe to call when not bound
+     */
+    void close();
+
+    /**
+     * @brief Reads the next pending datagram without blocking
+     * @param datagram Filled with payload, sender and timestamps
+     * @return false when no datagram is pending
+     */
+    bool readDatagram(TimestampedDatagram &datagram);
+
+    /**
+     * @brief Sends a datagram from the bound port
+     * @return Number of bytes sent, or -1 on error
+     */
+    qint64 writeDatagram(const QByteArray &data, const QHostAddress &host, quint16 port);
+
+    /**
+     * @brief Returns whether datagrams carry kernel timestamps
+     */
+    bool hasKernelTimestamps() const { return m_kernelTimestamps; }
+
+    QString errorString() const { return m_errorString; }
+
+    // Low-level helpers shared with the native RTP receive engine
+
+    /**
+     * @brief Current CLOCK_REALTIME in nanoseconds (same domain as kernel RX stamps)
+     */
+    static qint64 wallClockNs();
+
+    /**
+     * @brief Asks the kernel to timestamp datagrams received on a socket
+     * @param fd Native socket descriptor
+     * @return true if software RX timestamps were enabled (always false off Linux)
+     */
+    static bool enableKernelTimestamps(qintptr fd);
+
+    /**
+     * @brief recvmsg() wrapper that extracts the kernel RX timestamp
+     * @param fd Native non-blocking socket descriptor
+     * @param buffer Destination buffer
+     * @param maxSize Capacity of buffer
+     * @param kernelRxNs Set to the kernel stamp, or -1 if none was attached
+     * @param sender Optional, set to the sender address
+     * @param senderPort Optional, set to the sender port
+     * @return Bytes received, or -1 if nothing was pending / on error (Linux only)
+     */
+    static qint64 receiveTimestamped(qintptr fd, char *buffer, qint64 maxSize, qint64 *kernelRxNs,
+                                     QHostAddress *sender = nullptr, quint16 *senderPort = nullptr);
+
+signals:
+    /**
+     * @brief Emitted when at least one datagram can be read
+     */
+    void readyRead();
+
+private:
+    qintptr m_fd;                  ///< Native descriptor (Linux path), -1 when closed
+    QSocketNotifier *m_notifier;   ///< Read notifier for m_fd (Linux path)
+    QUdpSocket *m_socket;          ///< Portable fallback socket (non-Linux)
+    QByteArray m_receiveBuffer;    ///< recvmsg() target (Linux path), allocated once by bind()
+    bool m_kernelTimestamps;       ///< Whether the kernel stamps our datagrams
+    QString m_errorString;         ///< Last bind/send error
+};
+
+#endif // TIMESTAMPEDUDPSOCKET_H
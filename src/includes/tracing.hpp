@@ -0,0 +1,176 @@
+/**
+ * @file tracing.hpp
+ * @brief Low-overhead trace events from the hot paths, exported as Chrome JSON
+ *
+ * Every thread records into its own fixed-size ring of events (no locks on the
+ * recording path), so the last few seconds of activity on the GUI, streaming,
+ * ingest and network threads are always in memory. A dump - on demand or when a
+ * GUI frame hitch is detected - writes them in the Chrome trace-event format,
+ * which chrome://tracing and ui.perfetto.dev open directly.
+ *
+ * Scopes are compiled in with the DRIVER_TRACING CMake option (default ON) and
+ * recorded only while tracing is enabled at runtime (DRIVER_TRACE=1 or
+ * Tracer::setEnabled()); when disabled a scope costs one relaxed atomic load.
+ */
+
+#ifndef TRACING_H
+#define TRACING_H
+
+// Qt includes
+#include <QObject>       // Base class for Qt objects with signal/slot support
+#include <QPair>         // Counter series
+#include <QString>       // Dump paths
+#include <QVector>
+
+// Standard library includes
+#include <atomic>        // Runtime enable flag read by every scope
+
+#ifndef DRIVER_TRACING
+#define DRIVER_TRACING 0
+#endif
+
+class QQuickWindow;
+
+/**
+ * @class Tracer
+ * @brief Process-wide trace recorder (static recording API, QObject for QML)
+ *
+ * Exposed to QML as "tracing": `tracing.dump()` writes trace-<time>.json to the
+ * working directory and returns its path.
+ *
+ * Hitch detection: markFrame() is called for every frame handed to the GUI. A gap
+ * longer than hitchThresholdMs triggers a background dump of the rolling capture
+ * (at most one every 10 s), so the trace shows what each thread was doing while
+ * the display stood still.
+ */
+class Tracer : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool enabled READ isEnabled WRITE setEnabled NOTIFY enabledChanged)      ///< Scopes are being recorded
+    Q_PROPERTY(bool compiledIn READ compiledIn CONSTANT)                                ///< Built with DRIVER_TRACING
+    Q_PROPERTY(int hitchThresholdMs READ hitchThresholdMs WRITE setHitchThresholdMs NOTIFY hitchThresholdMsChanged)  ///< 0 = no automatic dumps
+    Q_PROPERTY(QString lastDumpPath READ lastDumpPath NOTIFY dumped)                    ///< Most recent trace file
+
+public:
+    static Tracer *instance();
+
+    bool isEnabled() const { return active(); }
+    void setEnabled(bool enabled);
+    static bool compiledIn() { return DRIVER_TRACING != 0; }
+
+    int hitchThresholdMs() const { return m_hitchThresholdMs; }
+    void setHitchThresholdMs(int thresholdMs);
+
+    QString lastDumpPath() const { return m_lastDumpPath; }
+
+    /**
+     * @brief Writes a trace file to the working directory
+     * @return Path of the written file, empty on failure or if nothing was recorded
+     */
+    Q_INVOKABLE QString dump();
+
+    /**
+     * @brief Writes the rolling capture of all threads in Chrome trace-event JSON
+     * @return false if the file could not be written
+     *
+     * Safe to call from any thread while other threads keep recording.
+     */
+    static bool writeChromeJson(const QString &path);
+
+    // Recording API (any thread)
+
+    static bool active() { return s_enabled.load(std::memory_order_relaxed); }
+    static qint64 nowNs();  ///< Monotonic clock used for all events
+
+    /**
+     * @brief Records a finished scope; @p name must be a string literal
+     */
+    static void recordComplete(const char *name, qint64 startNs, qint64 endNs);
+
+    /**
+     * @brief Records a point-in-time marker; @p name must be a string literal
+     */
+    static void recordInstant(const char *name);
+
+    /**
+     * @brief Records one sample of a counter track with a value per series
+     *
+     * For low-rate samples (e.g. once a second): takes a lock and keeps the last
+     * few hundred samples. @p name must be a string literal.
+     */
+    static void recordCounters(const char *name, const QVector<QPair<QString, double>> &series);
+
+    /**
+     * @brief Called on the GUI thread for every frame handed to QML (hitch detection)
+     */
+    static void markFrame();
+
+    /**
+     * @brief Records the scene graph's render passes of @p window ("render" scopes)
+     */
+    static void traceWindow(QQuickWindow *window);
+
+signals:
+    void enabledChanged();
+    void hitchThresholdMsChanged();
+    void dumped(const QString &path, const QString &reason);
+
+private:
+    explicit Tracer(QObject *parent = nullptr);
+
+    /**
+     * @brief Writes a dump on a background thread (hitch dumps)
+     */
+    void dumpAsync(const QString &reason);
+
+    static std::atomic<bool> s_enabled;
+
+    int m_hitchThresholdMs;
+    qint64 m_lastFrameNs;          ///< Previous markFrame() (GUI thread)
+    qint64 m_lastHitchDumpNs;      ///< Rate limit for automatic dumps (GUI thread)
+    std::atomic<bool> m_dumpInProgress;
+    QString m_lastDumpPath;
+};
+
+/**
+ * @class TraceScope
+ * @brief RAII scope recorded as one complete event; use through TRACE_SCOPE
+ */
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name)
+        : m_name(name)
+        , m_startNs(Tracer::active() ? Tracer::nowNs() : -1)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (m_startNs >= 0) {
+            Tracer::recordComplete(m_name, m_startNs, Tracer::nowNs());
+        }
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *m_name;
+    qint64 m_startNs;
+};
+
+#if DRIVER_TRACING
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define TRACE_INSTANT(name) Tracer::recordInstant(name)
+#define TRACE_FRAME() Tracer::markFrame()
+#else
+#define TRACE_SCOPE(name) do {} while (0)
+#define TRACE_INSTANT(name) do {} while (0)
+#define TRACE_FRAME() do {} while (0)
+#endif
+
+#endif // TRACING_H
@@ -14,10 +14,21 @@
 #include <QImage>               // Qt image container for frame storage
 #include <QQuickImageProvider>  // Interface for providing images to QML Image elements
 #include <QTimer>               // Timer for polling GStreamer bus messages
+#include <QElapsedTimer>        // Measures how long a stream switch takes
+#include <QVariantMap>          // Latency breakdown returned to QML
+
+// Standard library includes
+#include <atomic>               // Latency counters written from GStreamer threads
+#include <memory>               // Ownership of the active/pending pipelines
+#include <thread>               // Background GStreamer initialization
 
 // GStreamer includes for video pipeline management
 #include <gst/gst.h>            // Core GStreamer functionality
 #include <gst/app/gstappsink.h> // AppSink element for extracting frames from pipeline
+#include <gst/app/gstappsrc.h>  // AppSrc element fed by the native receive engine
+
+#include "rtpreceiveengine.hpp" // Native UDP ingest with kernel RX timestamps
+#include "rtpstreamrouter.hpp"  // Per-SSRC dispatch of a shared, sharded port
 
 // Forward declaration to allow VideoImageProvider to reference VideoStreamReceiver
 // before its full definition (solves circular dependency)
@@ -64,6 +75,17 @@ private:
  * Pipeline structure:
  * udpsrc -> rtpjpegdepay -> jpegdec -> videoconvert -> appsink
  *
+ * In native ingest mode udpsrc is replaced by an appsrc fed by RtpReceiveEngine
+ * (through the RtpStreamRouter of the port, which hands each receiver one RTP
+ * stream), which stamps every packet with its kernel receive time. The stamp travels as the
+ * buffer PTS (against a wall-clock pipeline clock) and as a "timestamp/x-unix"
+ * reference timestamp meta, so each decoded frame knows when its last packet hit
+ * the network stack.
+ *
+ * switchStream() changes the source without a blackout: the new pipeline runs next
+ * to the current one, and the display cuts over on its first decoded frame before
+ * the old pipeline is torn down.
+ *
  * Features:
  * - Low-latency configuration (drops frames if processing is too slow)
  * - Automatic format conversion to RGB for Qt compatibility
@@ -79,11 +101,43 @@ class VideoStreamReceiver : public QObject
     Q_PROPERTY(bool isStreaming READ isStreaming NOTIFY streamingChanged)     ///< Streaming active status
     Q_PROPERTY(QString status READ status NOTIFY statusChanged)               ///< Human-readable status message
     Q_PROPERTY(bool hasActiveStream READ hasActiveStream NOTIFY hasActiveStreamChanged)  ///< Whether frames are actively being received
+    Q_PROPERTY(bool nativeIngest READ nativeIngest WRITE setNativeIngest NOTIFY nativeIngestChanged)  ///< Use RtpReceiveEngine + appsrc instead of udpsrc
+    Q_PROPERTY(int ingestShards READ ingestShards WRITE setIngestShards NOTIFY ingestShardsChanged)  ///< SO_REUSEPORT sockets/threads for native ingest
+    Q_PROPERTY(bool pinIngestThreads READ pinIngestThreads WRITE setPinIngestThreads NOTIFY pinIngestThreadsChanged)  ///< Pin native ingest threads to cores
+    Q_PROPERTY(int port READ port NOTIFY portChanged)                         ///< UDP port of the stream on screen (0 when stopped)
+    Q_PROPERTY(bool switching READ isSwitching NOTIFY switchingChanged)       ///< A switchStream() is waiting for the new source's first frame
+    Q_PROPERTY(double lastSwitchMs READ lastSwitchMs NOTIFY switchCompleted)  ///< Duration of the last completed switch
+    Q_PROPERTY(QString decoderChain READ decoderChain WRITE setDecoderChain NOTIFY decoderChainChanged)  ///< Custom depay/decode chain (empty = built-in)
+    Q_PROPERTY(bool ready READ isReady NOTIFY readyChanged)                   ///< GStreamer initialized, startStream() builds a pipeline right away
 
 public:
     /**
-     * @brief Constructs the video receiver and initializes GStreamer
+     * @struct PipelineStats
+     * @brief Raw cumulative counters of the pipeline on screen
+     *
+     * Used to compare pipeline configurations (see PipelineComparison); differences
+     * between two snapshots give per-interval rates.
+     */
+    struct PipelineStats
+    {
+        qint64 packets = 0;             ///< RTP packets pushed into the appsrc
+        qint64 framesIn = 0;            ///< Complete frames received (packets with the RTP marker bit)
+        qint64 framesDecoded = 0;       ///< Frames that reached the appsink
+        qint64 rxToAppsinkSumNs = 0;    ///< Kernel RX -> appsink, summed over framesDecoded
+        qint64 rxToAppsinkMaxNs = 0;
+        qint64 rxToAppsinkCount = 0;
+        qint64 appsinkToGuiSumNs = 0;   ///< Appsink -> GUI thread, summed over displayed frames
+        qint64 appsinkToGuiMaxNs = 0;
+        qint64 appsinkToGuiCount = 0;   ///< Frames displayed
+        qint64 streamingCpuNs = 0;      ///< CPU time of the appsrc and appsink streaming threads (external ingest only)
+    };
+
+    /**
+     * @brief Constructs the video receiver; GStreamer is initialized on first use
      * @param parent Parent QObject for memory management (follows Qt parent-child pattern)
+     *
+     * Call initializeAsync() to initialize in the background instead, otherwise the
+     * first startStream() blocks on gst_init() and the plugin loading.
      */
     explicit VideoStreamReceiver(QObject *parent = nullptr);
 
@@ -108,6 +162,29 @@ public:
      */
     QString currentFrame() const { return m_frameId; }
 
+    /**
+     * @brief Returns whether GStreamer is initialized (readyChanged() when it becomes true)
+     */
+    bool isReady() const { return m_ready; }
+
+    /**
+     * @brief Initializes GStreamer and loads the default chain's plugins on a worker thread
+     *
+     * gst_init() may rescan the plugin registry, and loading the plugins of the
+     * first pipeline is a good part of its construction time; neither needs the GUI
+     * thread. A startStream() issued meanwhile is remembered and runs on the GUI
+     * thread as soon as initialization has finished. No-op once ready.
+     */
+    void initializeAsync();
+
+    /**
+     * @brief Initializes GStreamer on the calling thread unless already done (waits for initializeAsync())
+     *
+     * For callers that build GStreamer pipelines of their own before the first
+     * startStream() (e.g. a test sender).
+     */
+    void ensureInitialized();
+
     /**
      * @brief Returns whether the stream is currently active
      * @return true if pipeline is playing, false otherwise
@@ -126,6 +203,118 @@ public:
      */
     QString status() const { return m_status; }
 
+    /**
+     * @brief Returns whether packets are received by the native engine instead of udpsrc
+     */
+    bool nativeIngest() const { return m_nativeIngest; }
+
+    /**
+     * @brief Selects the ingest path; takes effect on the next startStream()
+     * @param enabled true for RtpReceiveEngine + appsrc (kernel RX timestamps)
+     */
+    void setNativeIngest(bool enabled);
+
+    /**
+     * @brief Returns how many SO_REUSEPORT shards native ingest uses
+     */
+    int ingestShards() const { return m_ingestShards; }
+
+    /**
+     * @brief Sets the native ingest shard count; takes effect on the next startStream()
+     * @param shards Sockets (and threads) bound to the stream port, clamped to >= 1
+     *
+     * The kernel hashes each sender onto one shard, so this pays off when several
+     * cameras share the port: each is received on its own thread and routed by
+     * SSRC to the receiver that claimed it. A port already receiving keeps its shards.
+     */
+    void setIngestShards(int shards);
+
+    /**
+     * @brief Returns whether native ingest threads are pinned to cores
+     */
+    bool pinIngestThreads() const { return m_pinIngestThreads; }
+
+    /**
+     * @brief Enables core pinning for native ingest threads (next startStream())
+     */
+    void setPinIngestThreads(bool pin);
+
+    /**
+     * @brief Returns the receive time of the current frame's last packet
+     * @return CLOCK_REALTIME nanoseconds (kernel stamp when available), 0 if unknown
+     */
+    qint64 currentFrameRxNs() const { return m_currentFrameRxNs; }
+
+    /**
+     * @brief Returns where frame latency is spent inside this process
+     * @return Map with socketDelayUs (kernel RX -> engine read), rxToAppsinkUs
+     *         (kernel RX -> decoded frame in appsink), appsinkToGuiUs (appsink ->
+     *         GUI thread) as mean/max values, plus packet counters
+     *
+     * Anything on top of these numbers was spent on the wire or in the sender.
+     */
+    Q_INVOKABLE QVariantMap latencyBreakdown() const;
+
+    /**
+     * @brief Returns the UDP port of the stream currently on screen
+     * @return Port number, 0 when no stream is running
+     */
+    int port() const { return m_active ? m_active->port : 0; }
+
+    /**
+     * @brief Returns whether a switchStream() is still waiting for the new source
+     */
+    bool isSwitching() const { return m_pending != nullptr; }
+
+    /**
+     * @brief Returns how long the last completed switch took
+     * @return Milliseconds from switchStream() to the new source's first frame on screen
+     */
+    double lastSwitchMs() const { return m_lastSwitchMs; }
+
+    /**
+     * @brief Returns the custom depayload/decode chain, empty for the built-in one
+     */
+    QString decoderChain() const { return m_decoderChain; }
+
+    /**
+     * @brief Replaces the part of the pipeline between the RTP source and the appsink
+     * @param chain gst-launch syntax, e.g. "rtpjpegdepay ! avdec_mjpeg ! videoconvert !
+     *        video/x-raw,format=RGB"; must output RGB. Empty restores the built-in chain.
+     *
+     * Takes effect on the next startStream()/switchStream().
+     */
+    void setDecoderChain(const QString &chain);
+
+    /**
+     * @brief Returns whether packets are pushed in from outside (pushExternalPacket())
+     */
+    bool externalIngest() const { return m_externalIngest; }
+
+    /**
+     * @brief Builds pipelines with an appsrc but no receive engine of their own
+     * @param enabled true to feed the stream through pushExternalPacket()
+     *
+     * Lets several receivers decode the very same packets. Also enables CPU time
+     * accounting of the streaming threads (PipelineStats::streamingCpuNs).
+     * Takes effect on the next startStream().
+     */
+    void setExternalIngest(bool enabled);
+
+    /**
+     * @brief Feeds one RTP packet into the running pipeline (external ingest only)
+     * @param packet Packet with its receive timestamps; data is copied
+     *
+     * Called from the feeder's thread. The feeder must be stopped before
+     * stopStream()/startStream(); switchStream() is not supported in this mode.
+     */
+    void pushExternalPacket(const RtpReceiveEngine::Packet &packet);
+
+    /**
+     * @brief Returns the raw counters of the pipeline on screen (all zero when stopped)
+     */
+    PipelineStats pipelineStats() const;
+
     // QML-invokable methods (callable from JavaScript in QML)
 
     /**
@@ -144,6 +333,18 @@ public:
      */
     Q_INVOKABLE void stopStream();
 
+    /**
+     * @brief Switches to another UDP port without blanking the display
+     * @param port UDP port of the new source
+     *
+     * Starts a second pipeline on the new port while the current one keeps
+     * displaying. On the new pipeline's first decoded frame the display cuts over and
+     * the old pipeline is torn down. If the new source produces no frame within a few
+     * seconds (or its pipeline fails) the switch is abandoned and the current stream
+     * stays on screen. Falls back to startStream() when nothing is streaming.
+     */
+    Q_INVOKABLE void switchStream(int port);
+
 signals:
     // Qt signals emitted when properties change (for QML property bindings)
 
@@ -169,6 +370,48 @@ signals:
      */
     void hasActiveStreamChanged();
 
+    /**
+     * @brief Emitted when the ingest path selection changes
+     */
+    void nativeIngestChanged();
+
+    /**
+     * @brief Emitted when the native ingest shard count changes
+     */
+    void ingestShardsChanged();
+
+    /**
+     * @brief Emitted when native ingest core pinning is toggled
+     */
+    void pinIngestThreadsChanged();
+
+    /**
+     * @brief Emitted when the stream on screen changes port (start, switch, stop)
+     */
+    void portChanged();
+
+    /**
+     * @brief Emitted when a switch starts, completes or is abandoned
+     */
+    void switchingChanged();
+
+    /**
+     * @brief Emitted when the display has cut over to the new source
+     * @param port Port now on screen
+     * @param switchMs Time from switchStream() to the first frame of the new source
+     */
+    void switchCompleted(int port, double switchMs);
+
+    /**
+     * @brief Emitted when the custom decoder chain changes
+     */
+    void decoderChainChanged();
+
+    /**
+     * @brief Emitted (on the GUI thread) once GStreamer is initialized
+     */
+    void readyChanged();
+
     /**
      * @brief Emitted when an error occurs during streaming
      * @param message Descriptive error message
@@ -176,12 +419,83 @@ signals:
     void errorOccurred(const QString &message);
 
 private:
+    friend struct BenchAccess;  // Microbenchmarks (bench/) drive the private hot paths
+
+    /**
+     * @struct StreamPipeline
+     * @brief One GStreamer pipeline together with the ingest that feeds it
+     *
+     * Normally only the active pipeline exists. During switchStream() a pending one
+     * runs in parallel until its first frame reaches the GUI thread.
+     */
+    struct StreamPipeline
+    {
+        VideoStreamReceiver *receiver = nullptr;  ///< Owner, for the static GStreamer callbacks
+        quint64 generation = 0;        ///< Unique per pipeline - lets queued frames detect a torn-down source
+        int port = 0;                  ///< UDP port this pipeline receives on
+        GstElement *pipeline = nullptr;  ///< Complete processing chain from UDP to decoded frames
+        GstElement *appsink = nullptr;   ///< Extracts frames from the pipeline
+        GstElement *appsrc = nullptr;    ///< Fed by engine (native ingest only)
+        GstBus *bus = nullptr;           ///< Asynchronous pipeline events
+        std::shared_ptr<RtpStreamRouter> ingest;  ///< Router of the port (native ingest only)
+        int ingestStream = 0;            ///< This pipeline's stream in ingest
+        QString error;                   ///< First bus error (pending pipelines only)
+        bool measureCpu = false;         ///< Sample streaming thread CPU time (external ingest)
+
+        // RTP SSRC lock for external ingest (see pushPacket())
+        std::atomic<quint32> streamSsrc{0};          ///< SSRC this pipeline is locked to (0 = none yet)
+        std::atomic<qint64> streamSsrcLastNs{0};     ///< Last time a packet of streamSsrc arrived
+        std::atomic<qint64> foreignSsrcPackets{0};   ///< Packets dropped because they belong to another stream
+
+        // Kernel RX -> appsink latency (nanoseconds), written by this pipeline's streaming thread
+        std::atomic<qint64> rxToAppsinkSumNs{0};
+        std::atomic<qint64> rxToAppsinkMaxNs{0};
+        std::atomic<qint64> rxToAppsinkCount{0};
+
+        // Frame accounting for drop statistics
+        std::atomic<qint64> packets{0};        ///< Packets pushed (from any ingest thread)
+        std::atomic<qint64> framesIn{0};       ///< Packets carrying the RTP marker bit
+        std::atomic<qint64> framesDecoded{0};  ///< Samples pulled from the appsink
+
+        // Streaming thread CPU time (measureCpu only). With no queue in the chain the
+        // appsrc and appsink run on one thread, which is then only counted once.
+        std::atomic<qint64> sourceThreadCpuNs{0};
+        std::atomic<qint64> sinkThreadCpuNs{0};
+        std::atomic<quintptr> sourceThreadId{0};
+        std::atomic<quintptr> sinkThreadId{0};
+    };
+
+    /**
+     * @brief GUI thread part of initialization: receiver-owned GStreamer objects, deferred start
+     */
+    void finishInitialization();
+
+    /**
+     * @brief Builds a pipeline for a port, sets it PLAYING and starts native ingest
+     * @param port UDP port to receive on
+     * @param errorMessage Set to a description of the failure
+     * @return The running pipeline, or nullptr on failure (nothing is left running)
+     */
+    std::unique_ptr<StreamPipeline> createPipeline(int port, QString *errorMessage);
+
+    /**
+     * @brief Stops a pipeline's ingest, sets it to NULL and releases it
+     * @param stream Pipeline to destroy (may be partially built or null); reset on return
+     */
+    void destroyPipeline(std::unique_ptr<StreamPipeline> &stream);
+
+    /**
+     * @brief Drops the pending pipeline and keeps the current stream on screen
+     * @param error Reported through errorOccurred() unless empty (cancelled switch)
+     */
+    void abandonSwitch(const QString &error);
+
     // Static callback functions for GStreamer (must be static to match C API)
 
     /**
      * @brief GStreamer callback invoked when a new decoded frame is available
      * @param appsink The appsink element that received the frame
-     * @param user_data Pointer to the VideoStreamReceiver instance (set during initialization)
+     * @param user_data Pointer to the StreamPipeline the appsink belongs to
      * @return GST_FLOW_OK to continue processing, or error code to stop
      *
      * This is called from GStreamer's internal thread, so it must be thread-safe.
@@ -193,31 +507,54 @@ private:
      * @brief GStreamer bus callback for receiving pipeline messages (errors, warnings, state changes)
      * @param bus The message bus
      * @param message The message to process
-     * @param user_data Pointer to the VideoStreamReceiver instance
+     * @param user_data Pointer to the StreamPipeline the bus belongs to
      * @return TRUE to keep receiving messages, FALSE to stop
      *
      * Handles asynchronous events from the pipeline and delegates to handleBusMessage()
      */
     static gboolean busCallback(GstBus *bus, GstMessage *message, gpointer user_data);
 
+    /**
+     * @brief Buffer probe on the appsrc pad that samples its streaming thread's CPU time
+     * @param user_data Pointer to the StreamPipeline the appsrc belongs to
+     */
+    static GstPadProbeReturn onSourceBuffer(GstPad *pad, GstPadProbeInfo *info, gpointer user_data);
+
     // Private helper methods for internal processing
 
     /**
      * @brief Processes a new video sample from GStreamer
+     * @param stream Pipeline that produced the sample
      * @param sample GStreamer sample containing the video frame and metadata
      *
      * Extracts the raw image data, converts it to QImage, and updates the frame counter.
      * Called from onNewSample() callback.
      */
-    void processNewSample(GstSample *sample);
+    void processNewSample(StreamPipeline *stream, GstSample *sample);
+
+    /**
+     * @brief Wraps a packet from RtpReceiveEngine in a GstBuffer and pushes it to the appsrc
+     * @param stream Pipeline whose engine received the packet
+     * @param packet Received RTP packet with its timestamps
+     *
+     * Runs on a receive (shard) thread, or the caller's thread for external ingest.
+     */
+    void pushPacket(StreamPipeline *stream, const RtpReceiveEngine::Packet &packet);
+
+    /**
+     * @brief Adds a latency sample to a sum/max/count accumulator
+     */
+    static void accumulateLatency(std::atomic<qint64> &sum, std::atomic<qint64> &max,
+                                  std::atomic<qint64> &count, qint64 valueNs);
 
     /**
      * @brief Handles messages from the GStreamer bus (errors, warnings, state changes)
+     * @param stream Pipeline the message came from
      * @param message The GStreamer message to process
      *
      * Called from busCallback() to handle pipeline events like errors and state transitions.
      */
-    void handleBusMessage(GstMessage *message);
+    void handleBusMessage(StreamPipeline *stream, GstMessage *message);
 
     /**
      * @brief Qt slot to check for GStreamer bus messages
@@ -254,9 +591,11 @@ private:
 
     // Member variables (all prefixed with m_ following Qt convention)
 
-    GstElement *m_pipeline;  ///< GStreamer pipeline - the complete processing chain from UDP to decoded frames
-    GstElement *m_appsink;   ///< AppSink element - extracts frames from pipeline for application use
-    GstBus *m_bus;           ///< Message bus - receives asynchronous events from the pipeline
+    std::unique_ptr<StreamPipeline> m_active;   ///< Pipeline whose frames are on screen
+    std::unique_ptr<StreamPipeline> m_pending;  ///< Pipeline being switched to (switchStream() only)
+    quint64 m_pipelineGeneration;  ///< Last StreamPipeline::generation handed out
+    QElapsedTimer m_switchClock;   ///< Started by switchStream()
+    double m_lastSwitchMs;         ///< Duration of the last completed switch
     QImage m_currentImage;   ///< Most recently decoded frame stored as QImage (RGB format)
     QString m_frameId;       ///< Unique identifier for current frame (e.g., "frame_123")
     QString m_status;        ///< Current status message displayed to user
@@ -266,6 +605,30 @@ private:
     QTimer *m_busTimer;      ///< Timer to poll GStreamer bus for messages (avoids GLib main loop)
     QTimer *m_frameTimeoutTimer;  ///< Timer to detect when no frames are being received
     qint64 m_lastFrameTime;  ///< Timestamp of last received frame (milliseconds since epoch)
+
+    // Initialization (see initializeAsync())
+    bool m_ready;                ///< finishInitialization() has run
+    std::thread m_initThread;    ///< gst_init() + plugin warm-up, joined by finishInitialization()
+    int m_pendingPort;           ///< startStream() requested before ready (0 = none)
+
+    // Native ingest (RtpReceiveEngine -> appsrc)
+    bool m_nativeIngest;             ///< Use the native engine for the next pipeline
+    GstClock *m_wallClock;           ///< CLOCK_REALTIME pipeline clock so PTS maps back to kernel stamps
+    GstCaps *m_unixTimestampCaps;    ///< "timestamp/x-unix" caps for reference timestamp metas
+    int m_ingestShards;              ///< SO_REUSEPORT shards for native ingest
+    bool m_pinIngestThreads;         ///< Pin native ingest threads to cores
+    bool m_externalIngest;           ///< appsrc fed through pushExternalPacket()
+    QString m_decoderChain;          ///< Custom depay/decode chain, empty for the built-in one
+    qint64 m_currentFrameRxNs;       ///< Receive time of the frame in m_currentImage (GUI thread)
+
+    // Appsink -> GUI latency accumulator (nanoseconds), written on the GUI thread
+    std::atomic<qint64> m_appsinkToGuiSumNs;
+    std::atomic<qint64> m_appsinkToGuiMaxNs;
+    std::atomic<qint64> m_appsinkToGuiCount;
+
+    // Displayed frame rate window for the driver_video_fps metric (GUI thread)
+    int m_fpsTickFrames;             ///< m_frameCounter at the last checkFrameTimeout()
+    qint64 m_fpsTickMs;              ///< Time of the last checkFrameTimeout()
 };
 
 #endif // VIDEOSTREAMRECEIVER_H
\ No newline at end of file
@@ -3,7 +3,8 @@
  * @brief Application entry point and component initialization
  *
  * Sets up the Qt application, registers QML types and context properties,
- * and initializes video streaming components.
+ * and initializes video streaming components. GStreamer and SDL initialize on
+ * worker threads while the QML engine loads; startup milestones are logged.
  */
 
 #include <QGuiApplication>
@@ -11,29 +12,87 @@
 #include <QQmlContext>
 #include <QIcon>
 #include <QQuickStyle>
+#include <QQuickWindow>
 #include "includes/steeringcontroller.hpp"
 #include "includes/mjpegdecoder.hpp"              // Old HTTP MJPEG implementation (kept for reference)
 #include "includes/videoscreenreciever.hpp"       // New GStreamer RTP implementation
+#include "includes/pipelinecomparison.hpp"        // A/B comparison of two pipeline configurations
+#include "includes/pcapreplaysource.hpp"          // Field capture replay (DRIVER_PCAP_REPLAY)
+#include "includes/tracing.hpp"                   // Hot path trace capture (Chrome JSON)
+#include "includes/logging.hpp"                   // Asynchronous logging (DRIVER_LOG, DRIVER_LOG_FILE)
+#include "includes/metricsserver.hpp"             // Optional Prometheus endpoint on localhost
+#include "includes/performancestats.hpp"          // 4 Hz aggregate behind the performance HUD
+#include "includes/startupprofiler.hpp"           // Time to window / first frame / live controls
+#include "includes/renderprofile.hpp"             // Software backend UI profile (DRIVER_UI_PROFILE)
+#include "includes/presentationmode.hpp"          // Fullscreen / vsync / render loop, swap latency
+#include "includes/framegovernor.hpp"             // Sheds decorative effects when frames run over budget
+#include "includes/telemetryrecorder.hpp"         // Session time series (charts, CSV export)
+#include "includes/pathpredictor.hpp"             // Latency-compensated path overlay
 #include "net/includes/steeringcontrollerservice.hpp"
 
 int qMain(int argc, char *argv[])
 {
+    // Log through the background writer from the start; remaining qDebug() calls included
+    Logger::configureFromEnvironment();
+    Logger::installQtMessageHandler();
+
+    // Startup milestones are measured from here
+    StartupProfiler startupProfiler;
+
     QGuiApplication app(argc, argv);
 
     // Set Qt Quick Controls style to Basic for full customization support
     QQuickStyle::setStyle("Basic");
 
+    // Fullscreen with compositor bypass, swap interval and render loop (DRIVER_PRESENTATION,
+    // DRIVER_VSYNC, DRIVER_RENDER_LOOP); before the window is created
+    PresentationMode::configure();
+    PresentationMode presentationMode(&app);
+
+    // GPU-less machines: software backend with a scene that repaints only what changes
+    RenderProfile::configure();
+    RenderProfile renderProfile(&app);
+
+    // Rolling trace capture of the hot paths, dumped on F9 or automatically on a GUI hitch;
+    // enabled before the subsystems so their background initialization is traced too
+    Tracer *tracer = Tracer::instance();
+    if (qEnvironmentVariableIntValue("DRIVER_TRACE") == 1) {
+        tracer->setEnabled(true);
+    }
+    if (qEnvironmentVariableIsSet("DRIVER_TRACE_HITCH_MS")) {
+        tracer->setHitchThresholdMs(qEnvironmentVariableIntValue("DRIVER_TRACE_HITCH_MS"));
+    }
+
     // Create SteeringController instance
     SteeringController steeringController(&app);
 
-    // Auto-connect to first available device
-    if (steeringController.availableDevices().length() > 0) {
-        steeringController.connectDevice(0);
-    }
+    // SDL init and the device scan run on a worker thread while QML loads;
+    // auto-connect to the first available device once they are done
+    QObject::connect(&steeringController, &SteeringController::readyChanged, &app, [&]() {
+        startupProfiler.mark("input ready");
+        if (steeringController.availableDevices().length() > 0) {
+            steeringController.connectDevice(0);
+        }
+    });
+    steeringController.initializeAsync();
 
     // Create WebSocket service
     SteeringControllerService steeringControllerService(&steeringController, &app);
 
+    // Controls are live once a device is open and the car is connected, in either order
+    auto checkControlsLive = [&]() {
+        if (steeringController.connected() && steeringControllerService.isConnected()) {
+            startupProfiler.mark("controls live");
+        }
+    };
+    QObject::connect(&steeringController, &SteeringController::connectedChanged, &app, checkControlsLive);
+    QObject::connect(&steeringControllerService, &SteeringControllerService::connected, &app, checkControlsLive);
+
+    // Optionally duplicate every control message over UDP (first arrival wins on the car)
+    if (qEnvironmentVariableIntValue("DRIVER_HEDGED_CONTROL") == 1) {
+        steeringControllerService.setHedgedDelivery(true);
+    }
+
     /* ========================================================================
      * VIDEO STREAMING SETUP
      * ========================================================================
@@ -44,6 +103,102 @@ int qMain(int argc, char *argv[])
     VideoStreamReceiver videoReceiver(&app);
     VideoImageProvider *videoImageProvider = new VideoImageProvider(&videoReceiver);
 
+    // Optionally receive packets ourselves (kernel RX timestamps) instead of via udpsrc
+    if (qEnvironmentVariableIntValue("DRIVER_NATIVE_INGEST") == 1) {
+        videoReceiver.setNativeIngest(true);
+    }
+    // Sharded native ingest: N SO_REUSEPORT sockets, each with its own receive thread
+    if (qEnvironmentVariableIntValue("DRIVER_INGEST_SHARDS") > 1) {
+        videoReceiver.setIngestShards(qEnvironmentVariableIntValue("DRIVER_INGEST_SHARDS"));
+    }
+    // Keep each native receive thread on a core of its own
+    if (qEnvironmentVariableIntValue("DRIVER_PIN_INGEST") == 1) {
+        videoReceiver.setPinIngestThreads(true);
+    }
+
+    // gst_init() and plugin loading on a worker thread; VideoScreen.qml's startStream()
+    // is held back until they are done
+    QObject::connect(&videoReceiver, &VideoStreamReceiver::readyChanged, &app, [&]() {
+        startupProfiler.mark("gstreamer ready");
+    });
+    videoReceiver.initializeAsync();
+
+    // First decoded frame counts once it is on screen (next swap of the window)
+    QMetaObject::Connection firstFrameConnection;
+    firstFrameConnection = QObject::connect(&videoReceiver, &VideoStreamReceiver::frameChanged, &app, [&]() {
+        startupProfiler.markOnNextFrame("first frame");
+        QObject::disconnect(firstFrameConnection);
+    });
+
+    // Swap latency: frame handed to the GUI -> the swap that shows it
+    QObject::connect(&videoReceiver, &VideoStreamReceiver::frameChanged,
+                     &presentationMode, &PresentationMode::frameHandedToGui);
+
+    // A/B comparison mode: the same packets decoded by two pipeline configurations side
+    // by side, replacing the normal video view (chains empty = built-in chain)
+    PipelineComparison pipelineComparison(&app);
+    if (qEnvironmentVariableIntValue("DRIVER_AB_COMPARE") == 1) {
+        pipelineComparison.setChainA(qEnvironmentVariable("DRIVER_AB_CHAIN_A"));
+        pipelineComparison.setChainB(qEnvironmentVariable("DRIVER_AB_CHAIN_B"));
+        pipelineComparison.setEnabled(true);
+    }
+
+    // Replay a field capture to the port the receiver listens on (chosen by VideoScreen.qml,
+    // followed when the stream stops, restarts or switches), looping until exit; goes
+    // through the normal ingest path (udpsrc or native engine) like a live camera
+    PcapReplaySource pcapReplay;
+    if (qEnvironmentVariableIsSet("DRIVER_PCAP_REPLAY")) {
+        PcapReplaySource::Config replayConfig;
+        replayConfig.path = qEnvironmentVariable("DRIVER_PCAP_REPLAY");
+        replayConfig.udpPort = static_cast<quint16>(qEnvironmentVariableIntValue("DRIVER_PCAP_PORT"));
+        bool speedValid = false;
+        double speed = qEnvironmentVariable("DRIVER_PCAP_SPEED").toDouble(&speedValid);
+        replayConfig.speed = speedValid ? qMax(0.0, speed) : 1.0;
+        replayConfig.loops = 0;
+        QString error;
+        if (pcapReplay.load(replayConfig, &error)) {
+            QMetaObject::Connection replayPortConnection =
+                QObject::connect(&videoReceiver, &VideoStreamReceiver::portChanged, &app, [&]() {
+                    pcapReplay.stop();
+                    if (videoReceiver.port() > 0) {
+                        pcapReplay.startLoopback(static_cast<quint16>(videoReceiver.port()));
+                    }
+                });
+            // The receiver outlives pcapReplay and still emits portChanged() when it stops
+            QObject::connect(&app, &QCoreApplication::aboutToQuit, &app, [replayPortConnection]() {
+                QObject::disconnect(replayPortConnection);
+            });
+        } else {
+            LOG_ERROR("main", "Capture replay disabled: {}", error);
+        }
+    }
+
+    // Optionally serve counters/gauges/histograms for scraping during soak runs
+    MetricsServer metricsServer(&app);
+    if (qEnvironmentVariableIntValue("DRIVER_METRICS_PORT") > 0) {
+        metricsServer.listen(static_cast<quint16>(qEnvironmentVariableIntValue("DRIVER_METRICS_PORT")));
+    }
+
+    // Aggregated numbers for the performance HUD (F3); idle until the HUD is shown
+    PerformanceStats performanceStats(&app);
+
+    // Session history of inputs and latencies for charts and CSV export (bounded memory)
+    TelemetryRecorder telemetry(&app);
+    telemetry.recordController(&steeringController);
+
+    // Replays the commands sent since the shown frame was captured through a vehicle model
+    PathPredictor pathPredictor(&app);
+    pathPredictor.setReceiver(&videoReceiver);
+    QObject::connect(&steeringControllerService, &SteeringControllerService::controlSent,
+                     &pathPredictor, &PathPredictor::recordCommand);
+
+    // Turns off smoothing, translucency and the background step by step when frames run
+    // over budget, so video and controls keep theirs; the HUD refreshes less often too
+    FrameGovernor frameGovernor(&app);
+    QObject::connect(&frameGovernor, &FrameGovernor::levelChanged, &performanceStats, [&]() {
+        performanceStats.setIntervalMs(frameGovernor.hudIntervalMs());
+    });
+
     // Old MJPEG HTTP Decoder (KEPT FOR REFERENCE - CURRENTLY UNUSED)
     // This implementation is commented out in VideoScreen.qml but kept here for easy rollback
     //MjpegDecoder mjpegDecoder(&app);
@@ -57,6 +212,8 @@ int qMain(int argc, char *argv[])
 
     // Register image providers for QML Image elements
     engine.addImageProvider("videostream", videoImageProvider);  // GStreamer provider (active)
+    engine.addImageProvider("videostream_a", new VideoImageProvider(pipelineComparison.receiverA()));  // A/B mode
+    engine.addImageProvider("videostream_b", new VideoImageProvider(pipelineComparison.receiverB()));
     //engine.addImageProvider("mjpeg", mjpegDecoder.imageProvider());  // Old MJPEG provider (inactive)
 
     // Register C++ objects as QML context properties
@@ -64,6 +221,15 @@ int qMain(int argc, char *argv[])
     engine.rootContext()->setContextProperty("steeringController", &steeringController);
     engine.rootContext()->setContextProperty("steeringControllerService", &steeringControllerService);
     engine.rootContext()->setContextProperty("videoReceiver", &videoReceiver);  // GStreamer receiver (active)
+    engine.rootContext()->setContextProperty("pipelineComparison", &pipelineComparison);
+    engine.rootContext()->setContextProperty("tracing", tracer);
+    engine.rootContext()->setContextProperty("performanceStats", &performanceStats);
+    engine.rootContext()->setContextProperty("startupProfiler", &startupProfiler);
+    engine.rootContext()->setContextProperty("renderProfile", &renderProfile);
+    engine.rootContext()->setContextProperty("presentationMode", &presentationMode);
+    engine.rootContext()->setContextProperty("frameGovernor", &frameGovernor);
+    engine.rootContext()->setContextProperty("telemetry", &telemetry);
+    engine.rootContext()->setContextProperty("pathPredictor", &pathPredictor);
     //engine.rootContext()->setContextProperty("mjpegDecoder", &mjpegDecoder);    // Old decoder (inactive)
 
     // Handle QML loading failures
@@ -76,6 +242,19 @@ int qMain(int argc, char *argv[])
 
     // Load the main QML module
     engine.loadFromModule("Driver", "Main");
+    startupProfiler.mark("qml loaded");
+
+    // Render passes of the main window show up as "render" scopes
+    if (!engine.rootObjects().isEmpty()) {
+        Tracer::traceWindow(qobject_cast<QQuickWindow *>(engine.rootObjects().constFirst()));
+        performanceStats.trackWindow(qobject_cast<QQuickWindow *>(engine.rootObjects().constFirst()));
+        startupProfiler.trackWindow(qobject_cast<QQuickWindow *>(engine.rootObjects().constFirst()));
+        renderProfile.trackWindow(qobject_cast<QQuickWindow *>(engine.rootObjects().constFirst()));
+        presentationMode.trackWindow(qobject_cast<QQuickWindow *>(engine.rootObjects().constFirst()));
+        frameGovernor.trackWindow(qobject_cast<QQuickWindow *>(engine.rootObjects().constFirst()));
+    }
 
-    return app.exec();
+    int exitCode = app.exec();
+    Logger::flush();
+    return exitCode;
 }
@@ -0,0 +1,201 @@
+/**
+ * @file controlsview.cpp
+ * @brief Implementation of the scene graph controls view
+ */
+
+#include "includes/controlsview.hpp"
+#include "includes/steeringcontroller.hpp"  // Control snapshot
+#include "includes/logging.hpp"             // Missing artwork
+#include "includes/tracing.hpp"             // updatePaintNode() scope
+#include <QImageReader>                     // SVG rasterized at the target pixel size
+#include <QQuickWindow>                     // Node and texture factories
+#include <QSGImageNode>                     // Wheel and pedal artwork
+#include <QSGRectangleNode>                 // Bars
+#include <QSGTransformNode>                 // Wheel rotation
+
+namespace {
+// Layout in design units (the former Wheel + Pedal row), scaled uniformly to the item
+constexpr qreal DesignWidth = 255.0;
+constexpr qreal DesignHeight = 130.0;
+const QRectF SteeringBarRect(0.0, 0.0, 100.0, 16.0);
+const QRectF WheelRect(0.0, 20.0, 100.0, 100.0);
+const QRectF PedalRect(120.0, 15.0, 100.0, 100.0);
+const QRectF ThrottleBarRect(225.0, 15.0, 30.0, 100.0);
+
+// Wheel rotation at full lock, as in Wheel.qml
+constexpr qreal MaxWheelAngle = 450.0;
+
+const QColor BarBackground(0x62, 0x63, 0x63);
+const QColor BarFill(0x80, 0x33, 0x00);
+
+// Shipped with the "modules" QML module (ui/modules)
+const char *const WheelArtwork = ":/qt/qml/modules/resources/steeringWheel.svg";
+const char *const PedalArtwork = ":/qt/qml/modules/resources/pedal.svg";
+
+/**
+ * @brief Node tree of the item; built once, then only updated in place
+ */
+struct ControlsNode : public QSGNode
+{
+    QSGRectangleNode *steeringBackground = nullptr;
+    QSGRectangleNode *steeringFill = nullptr;
+    QSGTransformNode *wheelTransform = nullptr;
+    QSGImageNode *wheel = nullptr;
+    QSGImageNode *pedal = nullptr;
+    QSGRectangleNode *throttleBackground = nullptr;
+    QSGRectangleNode *throttleFill = nullptr;
+};
+
+/**
+ * @brief Rasterizes @p path at @p pixelSize into a texture for @p node
+ *
+ * The node owns its texture (setOwnsTexture), so setTexture() deletes the old one.
+ */
+void setArtwork(QQuickWindow *window, QSGImageNode *node, const char *path, const QSize &pixelSize)
+{
+    QImageReader reader(QString::fromLatin1(path));
+    reader.setScaledSize(pixelSize);  // Vector artwork renders sharp at any size
+    QImage image = reader.read();
+    if (image.isNull()) {
+        LOG_WARN("ControlsView", "Cannot load {}: {}", path, reader.errorString());
+        image = QImage(1, 1, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+    }
+
+    node->setTexture(window->createTextureFromImage(image));
+}
+}
+
+ControlsView::ControlsView(QQuickItem *parent)
+    : QQuickItem(parent)
+    , m_artworkDirty(true)
+{
+    setFlag(ItemHasContents, true);
+    setImplicitSize(DesignWidth, DesignHeight);
+    // smooth: false (frame governor) switches the wheel to nearest-neighbour sampling
+    connect(this, &QQuickItem::smoothChanged, this, &QQuickItem::update);
+}
+
+void ControlsView::setController(SteeringController *controller)
+{
+    if (m_controller == controller) {
+        return;
+    }
+    disconnect(m_steeringConnection);
+    disconnect(m_throttleConnection);
+    m_controller = controller;
+    if (m_controller) {
+        // Input only marks the item dirty; update() coalesces to one paint per frame
+        m_steeringConnection = connect(m_controller, &SteeringController::steeringChanged, this, &QQuickItem::update);
+        m_throttleConnection = connect(m_controller, &SteeringController::throttleChanged, this, &QQuickItem::update);
+    }
+    update();
+    emit controllerChanged();
+}
+
+void ControlsView::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size()) {
+        m_artworkDirty = true;
+        update();
+    }
+}
+
+void ControlsView::itemChange(ItemChange change, const ItemChangeData &value)
+{
+    QQuickItem::itemChange(change, value);
+    if (change == ItemDevicePixelRatioHasChanged) {
+        m_artworkDirty = true;
+        update();
+    }
+}
+
+/**
+ * @brief Runs on the render thread with the GUI thread blocked; O(1) per frame
+ */
+QSGNode *ControlsView::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    TRACE_SCOPE("ControlsView::updatePaintNode");
+    if (width() <= 0.0 || height() <= 0.0) {
+        delete oldNode;
+        return nullptr;
+    }
+
+    QQuickWindow *win = window();
+    auto *node = static_cast<ControlsNode *>(oldNode);
+    if (!node) {
+        node = new ControlsNode;
+        node->steeringBackground = win->createRectangleNode();
+        node->steeringFill = win->createRectangleNode();
+        node->wheelTransform = new QSGTransformNode;
+        node->wheel = win->createImageNode();
+        node->pedal = win->createImageNode();
+        node->throttleBackground = win->createRectangleNode();
+        node->throttleFill = win->createRectangleNode();
+
+        node->steeringBackground->setColor(BarBackground);
+        node->steeringFill->setColor(BarFill);
+        node->throttleBackground->setColor(BarBackground);
+        node->throttleFill->setColor(BarFill);
+        node->wheel->setOwnsTexture(true);
+        node->pedal->setOwnsTexture(true);
+
+        node->appendChildNode(node->steeringBackground);
+        node->appendChildNode(node->steeringFill);
+        node->wheelTransform->appendChildNode(node->wheel);
+        node->appendChildNode(node->wheelTransform);
+        node->appendChildNode(node->pedal);
+        node->appendChildNode(node->throttleBackground);
+        node->appendChildNode(node->throttleFill);
+        m_artworkDirty = true;
+    }
+
+    // Design units -> item coordinates, centered
+    qreal scale = qMin(width() / DesignWidth, height() / DesignHeight);
+    QPointF origin((width() - DesignWidth * scale) / 2.0, (height() - DesignHeight * scale) / 2.0);
+    auto map = [&](const QRectF &rect) {
+        return QRectF(origin + rect.topLeft() * scale, rect.size() * scale);
+    };
+    QRectF steeringBar = map(SteeringBarRect);
+    QRectF wheel = map(WheelRect);
+    QRectF throttleBar = map(ThrottleBarRect);
+
+    if (m_artworkDirty) {
+        m_artworkDirty = false;
+        qreal dpr = win->effectiveDevicePixelRatio();
+        QRectF pedal = map(PedalRect);
+        setArtwork(win, node->wheel, WheelArtwork, (wheel.size() * dpr).toSize());
+        setArtwork(win, node->pedal, PedalArtwork, (pedal.size() * dpr).toSize());
+        node->wheel->setRect(wheel);
+        node->pedal->setRect(pedal);
+        node->steeringBackground->setRect(steeringBar);
+        node->throttleBackground->setRect(throttleBar);
+    }
+
+    // One consistent steering/throttle pair per frame, however often input changed
+    SteeringController::ControlSnapshot controls = m_controller ? m_controller->snapshot()
+                                                                : SteeringController::ControlSnapshot();
+    qreal steering = qBound(-1.0, qreal(controls.steering), 1.0);
+    qreal throttle = qBound(0.0, qreal(controls.throttle), 1.0);
+
+    // Rotated every frame: bilinear unless smoothing is off; no-op when unchanged
+    node->wheel->setFiltering(smooth() ? QSGTexture::Linear : QSGTexture::Nearest);
+
+    QMatrix4x4 rotation;
+    rotation.translate(float(wheel.center().x()), float(wheel.center().y()));
+    rotation.rotate(float(steering * MaxWheelAngle), 0.0f, 0.0f, 1.0f);
+    rotation.translate(float(-wheel.center().x()), float(-wheel.center().y()));
+    node->wheelTransform->setMatrix(rotation);
+
+    // Steering bar fills from the center towards the side steered to
+    qreal fillWidth = steeringBar.width() / 2.0 * qAbs(steering);
+    qreal fillLeft = steering >= 0.0 ? steeringBar.center().x() : steeringBar.center().x() - fillWidth;
+    node->steeringFill->setRect(QRectF(fillLeft, steeringBar.top(), fillWidth, steeringBar.height()));
+
+    // Throttle bar fills from the bottom
+    qreal fillHeight = throttleBar.height() * throttle;
+    node->throttleFill->setRect(QRectF(throttleBar.left(), throttleBar.bottom() - fillHeight,
+                                       throttleBar.width(), fillHeight));
+    return node;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file framegovernor.cpp
+ * @brief Implementation of the frame-budget governor
+ */
+
+#include "includes/framegovernor.hpp"
+#include "includes/logging.hpp"  // Level changes
+#include "includes/metrics.hpp"  // driver_ui_degrade_level
+#include "includes/tracing.hpp"  // Level changes as instant events
+#include <QQuickWindow>          // Sync/render pass signals
+#include <QScreen>               // Refresh rate
+
+namespace {
+constexpr int EvaluateIntervalMs = 500;
+constexpr qint64 MinFramesPerWindow = 5;   ///< Fewer frames: idle window, no verdict
+constexpr double HotShare = 0.10;          ///< Frames over budget that make a window hot
+constexpr double CoolShare = 0.01;         ///< ... at most this many for a cool window
+constexpr double CoolCostShare = 0.5;      ///< ... and a mean cost below this share of the budget
+constexpr int HotWindowsToDegrade = 2;     ///< 1 s of overload sheds one level
+constexpr int CoolWindowsToRestore = 20;   ///< 10 s of headroom restores one level
+constexpr double BudgetShare = 0.75;       ///< Of the refresh interval; the rest is swap and GUI work
+constexpr double DefaultRefreshHz = 60.0;
+
+constexpr int HudIntervalMs = 250;         ///< PerformanceStats' own rate
+constexpr int ReducedHudIntervalMs = 1000;
+
+const char *const LevelNames[] = { "full", "reduced", "minimal", "bare" };
+}
+
+FrameGovernor::FrameGovernor(QObject *parent)
+    : QObject(parent)
+    , m_enabled(!qEnvironmentVariableIsSet("DRIVER_FRAME_GOVERNOR")
+                || qEnvironmentVariableIntValue("DRIVER_FRAME_GOVERNOR") != 0)
+    , m_budgetOverrideMs(qMax(0.0, qEnvironmentVariable("DRIVER_FRAME_BUDGET_MS").toDouble()))
+    , m_levelGauge(&MetricsRegistry::instance().gauge(
+          "driver_ui_degrade_level", "Frame governor level (0 = all effects, 3 = bare)"))
+    , m_budgetNs(qint64(1e9 / DefaultRefreshHz * BudgetShare))
+    , m_passStartNs(-1)
+    , m_frameSyncNs(0)
+    , m_frames(0)
+    , m_overBudget(0)
+    , m_costSumNs(0)
+    , m_level(Full)
+    , m_hotWindows(0)
+    , m_coolWindows(0)
+    , m_frameCostMs(0.0)
+{
+    m_clock.start();
+    m_timer.setInterval(EvaluateIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &FrameGovernor::evaluate);
+}
+
+QString FrameGovernor::levelName() const
+{
+    return QString::fromLatin1(LevelNames[m_level]);
+}
+
+int FrameGovernor::hudIntervalMs() const
+{
+    return m_level >= Reduced ? ReducedHudIntervalMs : HudIntervalMs;
+}
+
+void FrameGovernor::trackWindow(QQuickWindow *window)
+{
+    if (!window) {
+        return;
+    }
+    m_window = window;
+    connect(window, &QWindow::screenChanged, this, &FrameGovernor::updateBudget);
+    updateBudget();
+
+    // Render thread (GUI thread with the basic loop); sync and render of one frame
+    // never overlap, so one start timestamp serves both
+    connect(window, &QQuickWindow::beforeSynchronizing, this, [this]() {
+        m_passStartNs.store(m_clock.nsecsElapsed(), std::memory_order_relaxed);
+    }, Qt::DirectConnection);
+    connect(window, &QQuickWindow::afterSynchronizing, this, [this]() {
+        qint64 startNs = m_passStartNs.exchange(-1, std::memory_order_relaxed);
+        if (startNs >= 0) {
+            m_frameSyncNs.store(m_clock.nsecsElapsed() - startNs, std::memory_order_relaxed);
+        }
+    }, Qt::DirectConnection);
+    connect(window, &QQuickWindow::beforeRendering, this, [this]() {
+        m_passStartNs.store(m_clock.nsecsElapsed(), std::memory_order_relaxed);
+    }, Qt::DirectConnection);
+    connect(window, &QQuickWindow::afterRendering, this, [this]() {
+        qint64 startNs = m_passStartNs.exchange(-1, std::memory_order_relaxed);
+        if (startNs >= 0) {
+            onPassDone(m_frameSyncNs.exchange(0, std::memory_order_relaxed) + m_clock.nsecsElapsed() - startNs);
+        }
+    }, Qt::DirectConnection);
+
+    m_levelGauge->set(m_level);
+    m_timer.start();
+}
+
+void FrameGovernor::updateBudget()
+{
+    double budgetMs = m_budgetOverrideMs;
+    if (budgetMs <= 0.0) {
+        double refreshHz = m_window && m_window->screen() ? m_window->screen()->refreshRate() : 0.0;
+        budgetMs = 1000.0 / (refreshHz > 1.0 ? refreshHz : DefaultRefreshHz) * BudgetShare;
+    }
+    m_budgetNs.store(qint64(budgetMs * 1e6), std::memory_order_relaxed);
+    LOG_DEBUG("FrameGovernor", "Frame budget {} us", qRound(budgetMs * 1000.0));
+    emit budgetChanged();
+}
+
+/**
+ * @brief Render thread, once per rendered frame
+ */
+void FrameGovernor::onPassDone(qint64 passNs)
+{
+    m_costSumNs.fetch_add(passNs, std::memory_order_relaxed);
+    if (passNs > m_budgetNs.load(std::memory_order_relaxed)) {
+        m_overBudget.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_frames.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FrameGovernor::evaluate()
+{
+    qint64 frames = m_frames.exchange(0, std::memory_order_relaxed);
+    qint64 overBudget = m_overBudget.exchange(0, std::memory_order_relaxed);
+    qint64 costSumNs = m_costSumNs.exchange(0, std::memory_order_relaxed);
+    if (frames < MinFramesPerWindow) {
+        return;  // Nothing animating: says nothing about load
+    }
+
+    double meanCostNs = double(costSumNs) / frames;
+    m_frameCostMs = meanCostNs / 1e6;
+    emit sampled();
+    if (!m_enabled) {
+        return;
+    }
+
+    double overShare = double(qMin(overBudget, frames)) / frames;
+    qint64 budgetNs = m_budgetNs.load(std::memory_order_relaxed);
+    if (overShare >= HotShare) {
+        m_coolWindows = 0;
+        if (++m_hotWindows >= HotWindowsToDegrade && m_level < Bare) {
+            setLevel(m_level + 1, "over budget");
+        }
+    } else if (overShare <= CoolShare && meanCostNs < budgetNs * CoolCostShare) {
+        m_hotWindows = 0;
+        if (++m_coolWindows >= CoolWindowsToRestore && m_level > Full) {
+            setLevel(m_level - 1, "headroom");
+        }
+    } else {
+        // Between the thresholds: hold the level, restart both streaks
+        m_hotWindows = 0;
+        m_coolWindows = 0;
+    }
+}
+
+void FrameGovernor::setLevel(int level, const char *reason)
+{
+    LOG_INFO("FrameGovernor", "UI effects {} -> {} ({}, mean frame {} us, budget {} us)",
+             LevelNames[m_level], LevelNames[level], reason,
+             qRound(m_frameCostMs * 1000.0), qRound(budgetMs() * 1000.0));
+    TRACE_INSTANT(level > m_level ? "ui_degrade" : "ui_restore");
+    m_level = level;
+    m_hotWindows = 0;
+    m_coolWindows = 0;
+    m_levelGauge->set(m_level);
+    emit levelChanged();
+}
@@ -0,0 +1,92 @@
+/**
+ * @file gstplugins.cpp
+ * @brief Implementation of the GStreamer plugin source selection
+ */
+
+#include "includes/gstplugins.hpp"
+#include "includes/logging.hpp"  // Which registry / plugin set is in use
+#include <QCoreApplication>      // applicationDirPath() for the private plugin directory
+#include <QDir>                  // Path resolution
+#include <QFileInfo>             // Registry presence check
+#include <gst/gst.h>             // gst_registry_fork_set_enabled(), static plugin macros
+#include <mutex>                 // Registration happens once even with several gst_init() callers
+
+#if defined(DRIVER_GST_PLUGINS_STATIC)
+// Generated by src/CMakeLists.txt from DRIVER_GST_PLUGIN_SET:
+// DRIVER_GST_STATIC_PLUGINS(X) expands X(name) once per plugin
+#include "gststaticplugins.h"
+
+#define DRIVER_GST_DECLARE_PLUGIN(name) GST_PLUGIN_STATIC_DECLARE(name);
+DRIVER_GST_STATIC_PLUGINS(DRIVER_GST_DECLARE_PLUGIN)
+#undef DRIVER_GST_DECLARE_PLUGIN
+#endif
+
+namespace {
+/**
+ * @brief Sets @p name unless the user already did
+ */
+void setDefault(const char *name, const QByteArray &value)
+{
+    if (!qEnvironmentVariableIsSet(name)) {
+        qputenv(name, value);
+    }
+}
+}
+
+namespace GstPlugins {
+
+const char *mode()
+{
+#if defined(DRIVER_GST_PLUGINS_STATIC)
+    return "static";
+#elif defined(DRIVER_GST_PLUGINS_PRIVATE)
+    return "private";
+#else
+    return "system";
+#endif
+}
+
+void prepare()
+{
+#if defined(DRIVER_GST_PLUGINS_STATIC)
+    // Nothing to scan: no plugin directories, no registry file to read or write
+    setDefault("GST_PLUGIN_SYSTEM_PATH_1_0", QByteArray());
+    setDefault("GST_PLUGIN_PATH_1_0", QByteArray());
+    setDefault("GST_REGISTRY_DISABLE", "yes");
+    gst_registry_fork_set_enabled(FALSE);
+    LOG_DEBUG("GstPlugins", "Static plugin set, registry disabled");
+#elif defined(DRIVER_GST_PLUGINS_PRIVATE)
+    // DRIVER_GST_PRIVATE_PLUGIN_DIR is relative to the executable (set by CMake from
+    // the install layout); a build tree has no such directory and uses the system set
+    QString pluginDir = QDir(QCoreApplication::applicationDirPath())
+                            .absoluteFilePath(QStringLiteral(DRIVER_GST_PRIVATE_PLUGIN_DIR));
+    if (!QFileInfo(pluginDir).isDir()) {
+        LOG_WARN("GstPlugins", "Private plugin directory {} missing, using the system registry", pluginDir);
+        return;
+    }
+    QString registry = QDir(pluginDir).absoluteFilePath(QStringLiteral("registry.bin"));
+    setDefault("GST_PLUGIN_SYSTEM_PATH_1_0", QDir::toNativeSeparators(pluginDir).toLocal8Bit());
+    setDefault("GST_PLUGIN_PATH_1_0", QByteArray());
+    setDefault("GST_REGISTRY", QDir::toNativeSeparators(registry).toLocal8Bit());
+    // Trust the install-time registry; without one the curated directory is scanned once
+    if (QFileInfo::exists(registry)) {
+        setDefault("GST_REGISTRY_UPDATE", "no");
+    }
+    gst_registry_fork_set_enabled(FALSE);
+    LOG_DEBUG("GstPlugins", "Private plugin set in {}", pluginDir);
+#endif
+}
+
+void registerStatic()
+{
+#if defined(DRIVER_GST_PLUGINS_STATIC)
+    static std::once_flag once;
+    std::call_once(once, []() {
+#define DRIVER_GST_REGISTER_PLUGIN(name) GST_PLUGIN_STATIC_REGISTER(name);
+        DRIVER_GST_STATIC_PLUGINS(DRIVER_GST_REGISTER_PLUGIN)
+#undef DRIVER_GST_REGISTER_PLUGIN
+    });
+#endif
+}
+
+} // namespace GstPlugins
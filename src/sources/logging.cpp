@@ -0,0 +1,364 @@
+/**
+ * @file logging.cpp
+ * @brief Implementation of the log ring and its background writer
+ *
+ * The ring is a bounded multi-producer queue (per-slot sequence numbers, one
+ * CAS per push), so any thread can log without taking a lock. The writer thread
+ * wakes every 20 ms, formats whatever has been queued, writes it in one go and
+ * flushes. Output errors or a slow terminal only ever stall the writer.
+ */
+
+#include "includes/logging.hpp"
+#include "includes/threadmonitor.hpp"  // Names the writer thread
+#include <QDateTime>           // Line timestamps
+#include <chrono>
+#include <condition_variable>  // Writer wake-up
+#include <cstdio>              // stderr / log file output
+#include <cstdlib>             // atexit
+#include <memory>
+#include <mutex>
+#include <thread>              // Background writer
+
+#ifdef Q_OS_LINUX
+#include <sys/syscall.h>       // gettid
+#include <unistd.h>
+#endif
+
+std::atomic<int> Logger::s_level{Logger::Debug};
+
+namespace {
+// ~1 MB of records; a burst larger than this in one writer period is dropped
+constexpr size_t RingSize = 4096;
+constexpr auto WriterPeriod = std::chrono::milliseconds(20);
+
+const char *levelName(int level)
+{
+    switch (level) {
+    case Logger::Trace: return "TRACE";
+    case Logger::Debug: return "DEBUG";
+    case Logger::Info: return "INFO ";
+    case Logger::Warn: return "WARN ";
+    default: return "ERROR";
+    }
+}
+
+quint64 currentThreadId()
+{
+    thread_local quint64 id = 0;
+    if (id == 0) {
+#ifdef Q_OS_LINUX
+        id = static_cast<quint64>(::syscall(SYS_gettid));
+#else
+        id = static_cast<quint64>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+#endif
+    }
+    return id;
+}
+
+QString argToString(const LogArg &arg)
+{
+    struct Visitor {
+        QString operator()(std::monostate) const { return QString(); }
+        QString operator()(qint64 value) const { return QString::number(value); }
+        QString operator()(quint64 value) const { return QString::number(value); }
+        QString operator()(double value) const { return QString::number(value); }
+        QString operator()(bool value) const { return value ? QStringLiteral("true") : QStringLiteral("false"); }
+        QString operator()(const QString &value) const { return value; }
+        QString operator()(const QByteArray &value) const { return QString::fromUtf8(value); }
+    };
+    return std::visit(Visitor(), arg);
+}
+
+/**
+ * @brief "HH:mm:ss.zzz LEVEL tid [category] message\n"
+ *
+ * Placeholders without an argument stay as "{}"; arguments without a
+ * placeholder are appended, separated by spaces.
+ */
+QByteArray formatRecord(const Logger::Record &record)
+{
+    const QString format = QString::fromUtf8(record.format);
+    QString message;
+    message.reserve(format.size() + 32);
+    int next = 0;
+    qsizetype from = 0;
+    while (true) {
+        const qsizetype at = format.indexOf(QLatin1String("{}"), from);
+        if (at < 0 || next >= record.argc) {
+            message += QStringView(format).mid(from);
+            break;
+        }
+        message += QStringView(format).mid(from, at - from);
+        message += argToString(record.args[next++]);
+        from = at + 2;
+    }
+    for (; next < record.argc; ++next) {
+        message += QLatin1Char(' ');
+        message += argToString(record.args[next]);
+    }
+    if (record.suppressed > 0) {
+        message += QString(" (%1 similar suppressed)").arg(record.suppressed);
+    }
+
+    QByteArray line = QDateTime::fromMSecsSinceEpoch(record.timeMs).toString("HH:mm:ss.zzz").toUtf8();
+    line += ' ';
+    line += levelName(record.level);
+    line += ' ';
+    line += QByteArray::number(record.threadId);
+    line += " [";
+    line += record.category;
+    line += "] ";
+    line += message.toUtf8();
+    line += '\n';
+    return line;
+}
+
+struct Slot {
+    std::atomic<size_t> sequence{0};
+    Logger::Record record;
+};
+
+/**
+ * @class LogWriter
+ * @brief Owns the ring, the output stream and the writer thread
+ */
+class LogWriter
+{
+public:
+    LogWriter()
+        : m_slots(new Slot[RingSize])
+    {
+        for (size_t i = 0; i < RingSize; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        const QByteArray path = qgetenv("DRIVER_LOG_FILE");
+        if (!path.isEmpty()) {
+            m_file = std::fopen(path.constData(), "a");
+        }
+        m_out = m_file ? m_file : stderr;
+
+        m_thread = std::thread([this]() {
+            ThreadMonitor::nameCurrentThread("log-writer");
+            run();
+        });
+        std::atexit([]() { LogWriter::instance().shutdown(); });
+    }
+
+    // Never destroyed: static destructors may still log after main() returns
+    static LogWriter &instance()
+    {
+        static LogWriter *writer = new LogWriter;
+        return *writer;
+    }
+
+    void push(Logger::Record &&record)
+    {
+        if (m_stopped.load(std::memory_order_acquire)) {
+            // After shutdown there is no writer left - write synchronously
+            std::lock_guard<std::mutex> lock(m_outputMutex);
+            const QByteArray line = formatRecord(record);
+            std::fwrite(line.constData(), 1, size_t(line.size()), m_out);
+            std::fflush(m_out);
+            return;
+        }
+
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Slot &slot = m_slots[pos % RingSize];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const qint64 diff = qint64(sequence) - qint64(pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.record = std::move(record);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return;
+                }
+            } else if (diff < 0) {
+                // Full: drop rather than wait for the writer
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void flush()
+    {
+        const size_t target = m_enqueuePos.load(std::memory_order_acquire);
+        while (!m_stopped.load(std::memory_order_acquire)
+               && m_dequeuePos.load(std::memory_order_acquire) < target) {
+            m_wake.notify_one();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    void shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            if (m_stopRequested) {
+                return;
+            }
+            m_stopRequested = true;
+        }
+        m_wake.notify_one();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+        m_stopped.store(true, std::memory_order_release);
+        drain();  // Anything pushed between the writer's last pass and the flag
+    }
+
+    quint64 dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Synchronous write for qFatal(), ordered after everything queued
+     */
+    void writeNow(const QByteArray &line)
+    {
+        flush();
+        std::lock_guard<std::mutex> lock(m_outputMutex);
+        std::fwrite(line.constData(), 1, size_t(line.size()), m_out);
+        std::fflush(m_out);
+    }
+
+private:
+    void run()
+    {
+        while (true) {
+            drain();
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            if (m_stopRequested) {
+                lock.unlock();
+                drain();
+                return;
+            }
+            m_wake.wait_for(lock, WriterPeriod);
+        }
+    }
+
+    void drain()
+    {
+        QByteArray batch;
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Slot &slot = m_slots[pos % RingSize];
+            if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+                break;  // Empty, or the producer has not published this slot yet
+            }
+            batch += formatRecord(slot.record);
+            slot.record = Logger::Record();  // Release captured strings now
+            slot.sequence.store(pos + RingSize, std::memory_order_release);
+            ++pos;
+            m_dequeuePos.store(pos, std::memory_order_release);
+        }
+
+        const quint64 dropped = m_dropped.load(std::memory_order_relaxed);
+        if (dropped != m_reportedDropped) {
+            batch += QDateTime::currentDateTime().toString("HH:mm:ss.zzz").toUtf8()
+                     + " WARN  " + QByteArray::number(currentThreadId())
+                     + " [Logger] " + QByteArray::number(dropped - m_reportedDropped)
+                     + " messages dropped (queue full)\n";
+            m_reportedDropped = dropped;
+        }
+
+        if (!batch.isEmpty()) {
+            std::lock_guard<std::mutex> lock(m_outputMutex);
+            std::fwrite(batch.constData(), 1, size_t(batch.size()), m_out);
+            std::fflush(m_out);
+        }
+    }
+
+    std::unique_ptr<Slot[]> m_slots;
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) std::atomic<size_t> m_dequeuePos{0};
+    std::atomic<quint64> m_dropped{0};
+    quint64 m_reportedDropped = 0;    ///< Writer thread only
+
+    std::FILE *m_file = nullptr;
+    std::FILE *m_out = nullptr;
+    std::mutex m_outputMutex;
+
+    std::thread m_thread;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    bool m_stopRequested = false;
+    std::atomic<bool> m_stopped{false};
+};
+
+void qtMessageHandler(QtMsgType type, const QMessageLogContext &, const QString &message)
+{
+    Logger::Level level = Logger::Debug;
+    switch (type) {
+    case QtDebugMsg: level = Logger::Debug; break;
+    case QtInfoMsg: level = Logger::Info; break;
+    case QtWarningMsg: level = Logger::Warn; break;
+    case QtCriticalMsg: level = Logger::Error; break;
+    case QtFatalMsg: {
+        Logger::Record record;
+        record.timeMs = QDateTime::currentMSecsSinceEpoch();
+        record.threadId = currentThreadId();
+        record.level = Logger::Error;
+        record.category = "qt";
+        record.format = "FATAL: {}";
+        record.argc = 1;
+        record.args[0] = message;
+        LogWriter::instance().writeNow(formatRecord(record));
+        return;  // Qt aborts after the handler returns
+    }
+    }
+    if (Logger::enabledFor(level)) {
+        Logger::submit(level, "qt", 0, "{}", message);
+    }
+}
+} // namespace
+
+void Logger::configureFromEnvironment()
+{
+    const QByteArray level = qgetenv("DRIVER_LOG").toLower();
+    if (level == "trace") {
+        setLevel(Trace);
+    } else if (level == "debug") {
+        setLevel(Debug);
+    } else if (level == "info") {
+        setLevel(Info);
+    } else if (level == "warn" || level == "warning") {
+        setLevel(Warn);
+    } else if (level == "error") {
+        setLevel(Error);
+    }
+
+    // Start the writer (and open DRIVER_LOG_FILE) before the first hot path logs
+    LogWriter::instance();
+}
+
+void Logger::installQtMessageHandler()
+{
+    LogWriter::instance();
+    qInstallMessageHandler(qtMessageHandler);
+}
+
+void Logger::flush()
+{
+    LogWriter::instance().flush();
+}
+
+quint64 Logger::droppedCount()
+{
+    return LogWriter::instance().dropped();
+}
+
+void Logger::enqueue(Record &&record)
+{
+    record.timeMs = QDateTime::currentMSecsSinceEpoch();
+    record.threadId = currentThreadId();
+    LogWriter::instance().push(std::move(record));
+}
+
+qint64 Logger::monotonicMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
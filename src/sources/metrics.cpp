@@ -0,0 +1,201 @@
+/**
+ * @file metrics.cpp
+ * @brief Implementation of the metrics registry and the Prometheus text rendering
+ */
+
+#include "includes/metrics.hpp"
+#include <QMutexLocker>
+
+MetricHistogram::MetricHistogram(const std::vector<double> &upperBoundsSeconds)
+    : m_buckets(new std::atomic<quint64>[upperBoundsSeconds.size() + 1])
+{
+    m_boundsNs.reserve(upperBoundsSeconds.size());
+    for (double bound : upperBoundsSeconds) {
+        m_boundsNs.push_back(static_cast<qint64>(bound * 1e9));
+    }
+    for (size_t i = 0; i <= m_boundsNs.size(); ++i) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+quint64 MetricHistogram::count() const
+{
+    quint64 total = 0;
+    for (size_t i = 0; i <= m_boundsNs.size(); ++i) {
+        total += m_buckets[i].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+MetricsRegistry &MetricsRegistry::instance()
+{
+    // Never destroyed: cached references stay valid during static destruction
+    static MetricsRegistry *registry = new MetricsRegistry;
+    return *registry;
+}
+
+const std::vector<double> &MetricsRegistry::latencyBuckets()
+{
+    static const std::vector<double> buckets = {
+        0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0
+    };
+    return buckets;
+}
+
+MetricsRegistry::Series &MetricsRegistry::series(const char *name, const char *help, Type type, const char *labels)
+{
+    Family *family = nullptr;
+    for (const auto &candidate : m_families) {
+        if (candidate->name == name) {
+            family = candidate.get();
+            break;
+        }
+    }
+    if (!family) {
+        m_families.push_back(std::make_unique<Family>());
+        family = m_families.back().get();
+        family->name = name;
+        family->help = help;
+        family->type = type;
+    }
+    Q_ASSERT_X(family->type == type, "MetricsRegistry", "metric registered with two types");
+
+    for (const auto &existing : family->series) {
+        if (existing->labels == labels) {
+            return *existing;
+        }
+    }
+    family->series.push_back(std::make_unique<Series>());
+    Series &created = *family->series.back();
+    created.labels = labels;
+    return created;
+}
+
+const MetricsRegistry::Series *MetricsRegistry::find(const char *name, const char *labels) const
+{
+    for (const auto &family : m_families) {
+        if (family->name != name) {
+            continue;
+        }
+        for (const auto &existing : family->series) {
+            if (existing->labels == labels) {
+                return existing.get();
+            }
+        }
+        return nullptr;
+    }
+    return nullptr;
+}
+
+const MetricCounter *MetricsRegistry::findCounter(const char *name, const char *labels) const
+{
+    QMutexLocker locker(&m_mutex);
+    const Series *entry = find(name, labels);
+    return entry ? entry->counter.get() : nullptr;
+}
+
+const MetricGauge *MetricsRegistry::findGauge(const char *name, const char *labels) const
+{
+    QMutexLocker locker(&m_mutex);
+    const Series *entry = find(name, labels);
+    return entry ? entry->gauge.get() : nullptr;
+}
+
+const MetricHistogram *MetricsRegistry::findHistogram(const char *name, const char *labels) const
+{
+    QMutexLocker locker(&m_mutex);
+    const Series *entry = find(name, labels);
+    return entry ? entry->histogram.get() : nullptr;
+}
+
+MetricCounter &MetricsRegistry::counter(const char *name, const char *help, const char *labels)
+{
+    QMutexLocker locker(&m_mutex);
+    Series &entry = series(name, help, Type::Counter, labels);
+    if (!entry.counter) {
+        entry.counter = std::make_unique<MetricCounter>();
+    }
+    return *entry.counter;
+}
+
+MetricGauge &MetricsRegistry::gauge(const char *name, const char *help, const char *labels)
+{
+    QMutexLocker locker(&m_mutex);
+    Series &entry = series(name, help, Type::Gauge, labels);
+    if (!entry.gauge) {
+        entry.gauge = std::make_unique<MetricGauge>();
+    }
+    return *entry.gauge;
+}
+
+MetricHistogram &MetricsRegistry::histogram(const char *name, const char *help,
+                                            const std::vector<double> &upperBoundsSeconds, const char *labels)
+{
+    QMutexLocker locker(&m_mutex);
+    Series &entry = series(name, help, Type::Histogram, labels);
+    if (!entry.histogram) {
+        entry.histogram = std::make_unique<MetricHistogram>(upperBoundsSeconds);
+    }
+    return *entry.histogram;
+}
+
+QByteArray MetricsRegistry::exposition() const
+{
+    // "name{labels,extra} value" - either label part may be empty
+    auto seriesName = [](const QByteArray &name, const QByteArray &labels, const QByteArray &extra) {
+        QByteArray line = name;
+        if (!labels.isEmpty() || !extra.isEmpty()) {
+            line += '{';
+            line += labels;
+            if (!labels.isEmpty() && !extra.isEmpty()) {
+                line += ',';
+            }
+            line += extra;
+            line += '}';
+        }
+        return line;
+    };
+    auto number = [](double value) { return QByteArray::number(value, 'g', 10); };
+
+    QMutexLocker locker(&m_mutex);
+    QByteArray text;
+    text.reserve(8192);
+    for (const auto &family : m_families) {
+        static const char *typeNames[] = { "counter", "gauge", "histogram" };
+        text += "# HELP " + family->name + ' ' + family->help + '\n';
+        text += "# TYPE " + family->name + ' ' + typeNames[int(family->type)] + '\n';
+
+        for (const auto &entry : family->series) {
+            switch (family->type) {
+            case Type::Counter:
+                text += seriesName(family->name, entry->labels, QByteArray()) + ' '
+                        + QByteArray::number(entry->counter->value()) + '\n';
+                break;
+            case Type::Gauge:
+                text += seriesName(family->name, entry->labels, QByteArray()) + ' '
+                        + number(entry->gauge->value()) + '\n';
+                break;
+            case Type::Histogram: {
+                const MetricHistogram &histogram = *entry->histogram;
+                const QByteArray bucketName = family->name + "_bucket";
+                quint64 cumulative = 0;
+                for (size_t i = 0; i < histogram.bucketCount(); ++i) {
+                    cumulative += histogram.bucketValue(i);
+                    text += seriesName(bucketName, entry->labels,
+                                       "le=\"" + number(histogram.upperBoundNs(i) / 1e9) + '"')
+                            + ' ' + QByteArray::number(cumulative) + '\n';
+                }
+                cumulative += histogram.bucketValue(histogram.bucketCount());
+                text += seriesName(bucketName, entry->labels, "le=\"+Inf\"") + ' '
+                        + QByteArray::number(cumulative) + '\n';
+                text += seriesName(family->name + "_sum", entry->labels, QByteArray()) + ' '
+                        + number(histogram.sumNs() / 1e9) + '\n';
+                text += seriesName(family->name + "_count", entry->labels, QByteArray()) + ' '
+                        + QByteArray::number(cumulative) + '\n';
+                break;
+            }
+            }
+        }
+    }
+    return text;
+}
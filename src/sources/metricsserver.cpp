@@ -0,0 +1,88 @@
+/**
+ * @file metricsserver.cpp
+ * @brief Implementation of the localhost /metrics endpoint
+ */
+
+#include "includes/metricsserver.hpp"
+#include "includes/metrics.hpp"
+#include "includes/logging.hpp"  // Asynchronous logging
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+namespace {
+// Requests are a single line plus headers; anything larger is not a scraper
+constexpr qint64 MaxRequestBytes = 8192;
+}
+
+MetricsServer::MetricsServer(QObject *parent)
+    : QObject(parent)
+    , m_server(new QTcpServer(this))
+{
+    connect(m_server, &QTcpServer::newConnection, this, &MetricsServer::onNewConnection);
+}
+
+bool MetricsServer::listen(quint16 port)
+{
+    if (!m_server->listen(QHostAddress::LocalHost, port)) {
+        LOG_WARN("MetricsServer", "Failed to listen on 127.0.0.1:{}: {}", port, m_server->errorString());
+        return false;
+    }
+    LOG_INFO("MetricsServer", "Serving metrics on http://127.0.0.1:{}/metrics", m_server->serverPort());
+    return true;
+}
+
+quint16 MetricsServer::port() const
+{
+    return m_server->serverPort();
+}
+
+void MetricsServer::onNewConnection()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { handleRequest(socket); });
+    }
+}
+
+void MetricsServer::handleRequest(QTcpSocket *socket)
+{
+    // Wait for the end of the headers; the body (if any) is ignored
+    QByteArray request = socket->peek(MaxRequestBytes);
+    if (!request.contains("\r\n\r\n") && !request.contains("\n\n")) {
+        if (socket->bytesAvailable() >= MaxRequestBytes) {
+            socket->abort();
+        }
+        return;
+    }
+    socket->readAll();
+
+    const QList<QByteArray> requestLine = request.left(request.indexOf('\n')).trimmed().split(' ');
+    const QByteArray method = requestLine.value(0);
+    const QByteArray path = requestLine.value(1);
+
+    QByteArray status = "200 OK";
+    QByteArray contentType = "text/plain; version=0.0.4; charset=utf-8";
+    QByteArray body;
+    if (method != "GET" && method != "HEAD") {
+        status = "405 Method Not Allowed";
+        contentType = "text/plain";
+        body = "Only GET is supported\n";
+    } else if (path == "/metrics" || path.startsWith("/metrics?")) {
+        body = MetricsRegistry::instance().exposition();
+    } else {
+        status = "404 Not Found";
+        contentType = "text/plain";
+        body = "Try /metrics\n";
+    }
+
+    QByteArray response = "HTTP/1.0 " + status + "\r\n"
+                          "Content-Type: " + contentType + "\r\n"
+                          "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                          "Connection: close\r\n\r\n";
+    if (method != "HEAD") {
+        response += body;
+    }
+    socket->write(response);
+    socket->disconnectFromHost();
+}
@@ -0,0 +1,265 @@
+/**
+ * @file pathpredictor.cpp
+ * @brief Implementation of the latency-compensated path prediction
+ */
+
+#include "includes/pathpredictor.hpp"
+#include "includes/videoscreenreciever.hpp"   // Frame receive times
+#include "includes/timestampedudpsocket.hpp"  // wallClockNs(), the receive stamps' clock
+#include "includes/logging.hpp"               // Model parameters
+#include "includes/metrics.hpp"               // Control RTT
+#include <QtMath>                             // qDegreesToRadians, qQNaN
+#include <cmath>                              // Bicycle model
+
+namespace {
+constexpr int UpdateIntervalMs = 16;          ///< Roughly every displayed frame
+constexpr int RttSampleIntervalMs = 250;
+constexpr double RttSmoothing = 0.25;         ///< EWMA weight of a new RTT mean
+constexpr qint64 DefaultOneWayNs = 25000000;  ///< Until the first acked message
+constexpr qint64 StepNs = 5000000;            ///< Integration step
+constexpr qint64 SpeedWarmupNs = 2000000000;  ///< Commands before the capture that shape its speed
+constexpr qint64 MaxHorizonNs = 1500000000;   ///< Older frames: video stalled, no prediction
+constexpr size_t MaxCommands = 4096;
+constexpr double MinDepthM = 0.05;            ///< Closer (or behind): not projected
+constexpr double BrakeTauShare = 0.25;        ///< Full brake slows down in this share of the time constant
+
+double envDouble(const char *name, double fallback)
+{
+    bool ok = false;
+    double value = qEnvironmentVariable(name).toDouble(&ok);
+    return ok ? value : fallback;
+}
+}
+
+PathPredictor::PathPredictor(QObject *parent)
+    : QObject(parent)
+    , m_wheelbaseM(qMax(0.01, envDouble("DRIVER_WHEELBASE_M", 0.26)))
+    , m_maxSteerRad(qDegreesToRadians(qBound(0.0, envDouble("DRIVER_MAX_STEER_DEG", 25.0), 60.0)))
+    , m_maxSpeedMps(qMax(0.0, envDouble("DRIVER_MAX_SPEED_MPS", 3.0)))
+    , m_speedTauS(qMax(0.01, envDouble("DRIVER_SPEED_TAU_MS", 400.0) / 1000.0))
+    , m_cameraHeightM(qMax(0.01, envDouble("DRIVER_CAMERA_HEIGHT_M", 0.25)))
+    , m_cameraPitchRad(qDegreesToRadians(envDouble("DRIVER_CAMERA_PITCH_DEG", 15.0)))
+    , m_focalScale(0.5 / std::tan(qDegreesToRadians(qBound(10.0, envDouble("DRIVER_CAMERA_HFOV_DEG", 90.0), 170.0)) / 2.0))
+    , m_cameraDelayNs(qint64(qMax(0.0, envDouble("DRIVER_CAMERA_DELAY_MS", 0.0)) * 1e6))
+    , m_oneWayOverrideNs(qEnvironmentVariableIsSet("DRIVER_ONE_WAY_MS")
+                             ? qint64(qMax(0.0, envDouble("DRIVER_ONE_WAY_MS", 0.0)) * 1e6) : -1)
+    , m_lookaheadNs(qint64(qMax(0.0, envDouble("DRIVER_PATH_LOOKAHEAD_MS", 1000.0)) * 1e6))
+    , m_timewarpMaxRad(qDegreesToRadians(qBound(0.0, envDouble("DRIVER_TIMEWARP_MAX_DEG", 15.0), 45.0)))
+    , m_enabled(false)
+    , m_timewarp(false)
+    , m_frameRxNs(0)
+    , m_rttHistogram(nullptr)
+    , m_rttLastSumNs(0)
+    , m_rttLastCount(0)
+    , m_oneWayNs(m_oneWayOverrideNs >= 0 ? m_oneWayOverrideNs : DefaultOneWayNs)
+    , m_oneWayMeasured(false)
+    , m_valid(false)
+    , m_horizonMs(-1.0)
+    , m_speedMps(0.0)
+    , m_yawRad(0.0)
+    , m_timewarpShift(0.0)
+{
+    m_timer.setInterval(UpdateIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &PathPredictor::predict);
+    m_rttTimer.setInterval(RttSampleIntervalMs);
+    connect(&m_rttTimer, &QTimer::timeout, this, &PathPredictor::sampleRtt);
+
+    LOG_INFO("PathPredictor", "Wheelbase {} mm, camera {} mm high, pitch {} deg, one-way {}",
+             qRound(m_wheelbaseM * 1000.0), qRound(m_cameraHeightM * 1000.0),
+             qRound(qRadiansToDegrees(m_cameraPitchRad)),
+             m_oneWayOverrideNs >= 0 ? QString("%1 ms").arg(m_oneWayOverrideNs / 1e6) : QString("from RTT"));
+    setEnabled(!qEnvironmentVariableIsSet("DRIVER_PATH_PREDICTION")
+               || qEnvironmentVariableIntValue("DRIVER_PATH_PREDICTION") != 0);
+    setTimewarp(qEnvironmentVariableIntValue("DRIVER_TIMEWARP") != 0);
+}
+
+double PathPredictor::yawDeg() const
+{
+    return qRadiansToDegrees(m_yawRad);
+}
+
+void PathPredictor::setReceiver(VideoStreamReceiver *receiver)
+{
+    if (m_receiver) {
+        disconnect(m_receiver, nullptr, this, nullptr);
+    }
+    m_receiver = receiver;
+    if (receiver) {
+        connect(receiver, &VideoStreamReceiver::frameChanged, this, &PathPredictor::onFrameChanged);
+    }
+}
+
+void PathPredictor::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled) {
+        return;
+    }
+    m_enabled = enabled;
+    updateTimers();
+    emit enabledChanged();
+}
+
+void PathPredictor::setTimewarp(bool enabled)
+{
+    if (m_timewarp == enabled) {
+        return;
+    }
+    m_timewarp = enabled;
+    LOG_INFO("PathPredictor", "Timewarp {}", enabled ? "on" : "off");
+    updateTimers();
+    emit timewarpChanged();
+}
+
+/**
+ * @brief Predicts while the overlay or the timewarp needs it
+ */
+void PathPredictor::updateTimers()
+{
+    if (m_enabled || m_timewarp) {
+        m_timer.start();
+        m_rttTimer.start();
+        predict();
+    } else {
+        m_timer.stop();
+        m_rttTimer.stop();
+        invalidate();
+    }
+}
+
+void PathPredictor::invalidate()
+{
+    if (m_valid || m_timewarpShift != 0.0) {
+        m_valid = false;
+        m_points.clear();
+        m_yawRad = 0.0;
+        m_timewarpShift = 0.0;
+        emit updated();
+    }
+}
+
+void PathPredictor::recordCommand(double steering, double throttle, qint64 sentWallNs)
+{
+    m_commands.push_back({ sentWallNs, float(steering), float(throttle) });
+    if (m_commands.size() > MaxCommands) {
+        m_commands.pop_front();
+    }
+}
+
+void PathPredictor::onFrameChanged()
+{
+    // Without a receive stamp (udpsrc without one) the hand-off is the best bound
+    qint64 rxNs = m_receiver ? m_receiver->currentFrameRxNs() : 0;
+    m_frameRxNs = rxNs > 0 ? rxNs : TimestampedUdpSocket::wallClockNs();
+}
+
+void PathPredictor::sampleRtt()
+{
+    if (m_oneWayOverrideNs >= 0) {
+        return;
+    }
+    if (!m_rttHistogram) {
+        m_rttHistogram = MetricsRegistry::instance().findHistogram("driver_control_rtt_seconds", "path=\"ws\"");
+        if (!m_rttHistogram) {
+            return;
+        }
+        m_rttLastSumNs = m_rttHistogram->sumNs();
+        m_rttLastCount = m_rttHistogram->count();
+        return;
+    }
+    quint64 count = m_rttHistogram->count();
+    qint64 sumNs = m_rttHistogram->sumNs();
+    if (count > m_rttLastCount) {
+        qint64 oneWayNs = (sumNs - m_rttLastSumNs) / qint64(count - m_rttLastCount) / 2;
+        m_oneWayNs = m_oneWayMeasured ? qint64(m_oneWayNs + RttSmoothing * (oneWayNs - m_oneWayNs)) : oneWayNs;
+        m_oneWayMeasured = true;
+    }
+    m_rttLastCount = count;
+    m_rttLastSumNs = sumNs;
+}
+
+void PathPredictor::step(Pose &pose, const Command &command, double dt) const
+{
+    // Throttle sets a target speed, reached with a first-order lag; braking (negative) only slows down
+    double throttle = qBound(-1.0, double(command.throttle), 1.0);
+    double target = throttle > 0.0 ? throttle * m_maxSpeedMps : 0.0;
+    double tau = throttle < 0.0 ? m_speedTauS * (1.0 - (1.0 - BrakeTauShare) * -throttle) : m_speedTauS;
+    pose.speed += (target - pose.speed) * (1.0 - std::exp(-dt / tau));
+
+    // Kinematic bicycle about the rear axle; steering +1 is full right (clockwise)
+    double steerAngle = -qBound(-1.0, double(command.steering), 1.0) * m_maxSteerRad;
+    pose.x += pose.speed * std::cos(pose.heading) * dt;
+    pose.y += pose.speed * std::sin(pose.heading) * dt;
+    pose.heading += pose.speed / m_wheelbaseM * std::tan(steerAngle) * dt;
+}
+
+QPointF PathPredictor::project(const Pose &pose) const
+{
+    // Pinhole camera above the capture position, looking forward, pitched down
+    double depth = pose.x * std::cos(m_cameraPitchRad) + m_cameraHeightM * std::sin(m_cameraPitchRad);
+    double down = m_cameraHeightM * std::cos(m_cameraPitchRad) - pose.x * std::sin(m_cameraPitchRad);
+    if (depth < MinDepthM) {
+        return QPointF(qQNaN(), qQNaN());
+    }
+    return QPointF(0.5 - pose.y / depth * m_focalScale, down / depth * m_focalScale);
+}
+
+void PathPredictor::predict()
+{
+    qint64 nowNs = TimestampedUdpSocket::wallClockNs();
+    qint64 captureNs = m_frameRxNs - m_oneWayNs - m_cameraDelayNs;
+    if (m_frameRxNs <= 0 || !m_receiver || !m_receiver->isStreaming() || nowNs - captureNs > MaxHorizonNs) {
+        invalidate();
+        return;
+    }
+    captureNs = qMin(captureNs, nowNs);
+
+    // A command acts from when it reaches the car; the one before the warm-up is in effect at its start
+    qint64 startNs = captureNs - SpeedWarmupNs;
+    while (m_commands.size() > 1 && m_commands[1].sentWallNs + m_oneWayNs <= startNs) {
+        m_commands.pop_front();
+    }
+
+    Command current{ 0, 0.0f, 0.0f };
+    auto next = m_commands.cbegin();
+    qint64 timeNs = startNs;
+    Pose pose;
+    auto runTo = [&](qint64 targetNs) {
+        while (timeNs < targetNs) {
+            while (next != m_commands.cend() && next->sentWallNs + m_oneWayNs <= timeNs) {
+                current = *next++;
+            }
+            qint64 dtNs = qMin(StepNs, targetNs - timeNs);
+            step(pose, current, dtNs / 1e9);
+            timeNs += dtNs;
+        }
+    };
+
+    // Speed at the capture, then the path from where the frame was taken
+    runTo(captureNs);
+    pose.x = 0.0;
+    pose.y = 0.0;
+    pose.heading = 0.0;
+
+    m_points.clear();
+    m_points.reserve(pointCount());
+    for (int i = 0; i < PointsPerSegment; ++i) {
+        runTo(captureNs + (nowNs - captureNs) * i / (PointsPerSegment - 1));
+        m_points.append(project(pose));
+    }
+    m_speedMps = pose.speed;
+    m_yawRad = pose.heading;
+    // Commands still in flight take effect during the lookahead, then the last one holds
+    for (int i = 1; i <= PointsPerSegment; ++i) {
+        runTo(nowNs + m_lookaheadNs * i / PointsPerSegment);
+        m_points.append(project(pose));
+    }
+
+    // Timewarp: turning the camera by the yaw moves the scene by f * tan(yaw) across the image
+    // (left turn: scene moves right); a pure shift, no resampling of the frame
+    m_timewarpShift = m_timewarp
+        ? std::tan(qBound(-m_timewarpMaxRad, m_yawRad, m_timewarpMaxRad)) * m_focalScale
+        : 0.0;
+    m_horizonMs = (nowNs - captureNs) / 1e6;
+    m_valid = true;
+    emit updated();
+}
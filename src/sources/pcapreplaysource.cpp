@@ -0,0 +1,528 @@
+/**
+ * @file pcapreplaysource.cpp
+ * @brief Implementation of the pcap/pcapng loader and the replay thread
+ *
+ * The whole capture is parsed up front into one payload buffer plus an index,
+ * so the replay loop does no file I/O or parsing and its timing is limited only
+ * by the sleep/spin wait below.
+ */
+
+#include "includes/pcapreplaysource.hpp"
+#include "includes/threadmonitor.hpp"         // Replay thread name
+#include "includes/timestampedudpsocket.hpp"  // Wall clock, as used for live RX stamps
+#include "includes/logging.hpp"               // Asynchronous logging
+#include <QFile>               // Capture input
+#include <QHostAddress>
+#include <QtEndian>            // qbswap() for foreign byte order captures
+#include <QUdpSocket>          // Loopback replay
+#include <chrono>
+#include <memory>
+
+namespace {
+// pcap: magic numbers as read little-endian
+constexpr quint32 PcapMagicMicros = 0xa1b2c3d4;
+constexpr quint32 PcapMagicMicrosSwapped = 0xd4c3b2a1;
+constexpr quint32 PcapMagicNanos = 0xa1b23c4d;
+constexpr quint32 PcapMagicNanosSwapped = 0x4d3cb2a1;
+constexpr int PcapHeaderSize = 24;
+constexpr int PcapRecordHeaderSize = 16;
+
+// pcapng block types
+constexpr quint32 BlockSectionHeader = 0x0a0d0d0a;
+constexpr quint32 BlockInterfaceDescription = 0x00000001;
+constexpr quint32 BlockObsoletePacket = 0x00000002;
+constexpr quint32 BlockSimplePacket = 0x00000003;
+constexpr quint32 BlockEnhancedPacket = 0x00000006;
+constexpr quint32 ByteOrderMagic = 0x1a2b3c4d;
+constexpr quint16 OptionEnd = 0;
+constexpr quint16 OptionTimestampResolution = 9;
+
+// Link types (www.tcpdump.org/linktypes.html)
+constexpr int LinkNull = 0;
+constexpr int LinkEthernet = 1;
+constexpr int LinkRaw = 101;
+constexpr int LinkRawAlt = 12;       // DLT_RAW on some BSDs
+constexpr int LinkLoop = 108;
+constexpr int LinkLinuxSll = 113;
+constexpr int LinkIpv4 = 228;
+constexpr int LinkIpv6 = 229;
+constexpr int LinkLinuxSll2 = 276;
+
+constexpr quint16 EtherTypeIpv4 = 0x0800;
+constexpr quint16 EtherTypeIpv6 = 0x86dd;
+constexpr quint16 EtherTypeVlan = 0x8100;
+constexpr quint16 EtherTypeQinQ = 0x88a8;
+constexpr int ProtocolUdp = 17;
+
+// Replay wait: sleep until this close to the deadline, then spin (OS timers are coarse)
+constexpr auto SpinWindow = std::chrono::milliseconds(2);
+constexpr auto MaxSleepSlice = std::chrono::milliseconds(100);
+
+/**
+ * @brief Bounds-checked reader for the file's byte order
+ */
+struct Reader
+{
+    const uchar *data;
+    qint64 size;
+    bool swapped;   ///< File byte order differs from little-endian
+
+    bool has(qint64 offset, qint64 length) const { return offset >= 0 && length >= 0 && offset + length <= size; }
+    quint16 u16(qint64 offset) const
+    {
+        quint16 value = quint16(data[offset]) | quint16(data[offset + 1]) << 8;
+        return swapped ? qbswap(value) : value;
+    }
+    quint32 u32(qint64 offset) const
+    {
+        quint32 value = quint32(data[offset]) | quint32(data[offset + 1]) << 8
+                      | quint32(data[offset + 2]) << 16 | quint32(data[offset + 3]) << 24;
+        return swapped ? qbswap(value) : value;
+    }
+};
+
+// Network byte order fields inside the frames
+quint16 be16(const uchar *p)
+{
+    return quint16(p[0]) << 8 | p[1];
+}
+
+quint32 rtpSsrc(const char *data, int size)
+{
+    if (size < 12) {
+        return 0;
+    }
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    return quint32(p[8]) << 24 | quint32(p[9]) << 16 | quint32(p[10]) << 8 | p[11];
+}
+
+/**
+ * @brief Converts a timestamp in 1/unitsPerSecond units to nanoseconds without overflow
+ */
+qint64 toNs(quint64 timestamp, quint64 unitsPerSecond)
+{
+    if (unitsPerSecond == 0) {
+        return 0;
+    }
+    quint64 seconds = timestamp / unitsPerSecond;
+    quint64 fraction = timestamp % unitsPerSecond;
+    return static_cast<qint64>(seconds * 1000000000ULL
+                               + static_cast<quint64>(double(fraction) * 1e9 / unitsPerSecond));
+}
+}
+
+PcapReplaySource::PcapReplaySource()
+    : m_skipped(0)
+    , m_running(false)
+    , m_stopRequested(false)
+    , m_replayedPackets(0)
+    , m_replayedBytes(0)
+    , m_sendErrors(0)
+    , m_maxLateNs(0)
+    , m_loopsDone(0)
+{
+}
+
+PcapReplaySource::~PcapReplaySource()
+{
+    stop();
+}
+
+bool PcapReplaySource::load(const Config &config, QString *errorMessage)
+{
+    stop();
+    m_config = config;
+    m_payloads.clear();
+    m_packets.clear();
+    m_skipped = 0;
+
+    QFile file(config.path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *errorMessage = QString("Cannot open %1: %2").arg(config.path, file.errorString());
+        return false;
+    }
+    const QByteArray contents = file.readAll();
+    if (contents.size() < 4) {
+        *errorMessage = QString("%1 is not a capture file").arg(config.path);
+        return false;
+    }
+
+    Reader magic{ reinterpret_cast<const uchar *>(contents.constData()), contents.size(), false };
+    bool parsed = magic.u32(0) == BlockSectionHeader ? parsePcapng(contents, errorMessage)
+                                                     : parsePcap(contents, errorMessage);
+    if (!parsed) {
+        return false;
+    }
+    if (m_packets.empty()) {
+        *errorMessage = config.udpPort > 0
+            ? QString("%1 contains no UDP datagrams to port %2").arg(config.path).arg(config.udpPort)
+            : QString("%1 contains no UDP datagrams").arg(config.path);
+        return false;
+    }
+
+    LOG_INFO("PcapReplaySource", "Loaded {} datagrams ({} bytes, {} s) from {}, skipped {} frames",
+             m_packets.size(), m_payloads.size(), captureDurationS(), config.path, m_skipped);
+    return true;
+}
+
+bool PcapReplaySource::parsePcap(const QByteArray &file, QString *errorMessage)
+{
+    Reader reader{ reinterpret_cast<const uchar *>(file.constData()), file.size(), false };
+    quint32 magic = reader.u32(0);
+    quint64 unitsPerSecond = 1000000;
+    switch (magic) {
+    case PcapMagicMicros:
+        break;
+    case PcapMagicMicrosSwapped:
+        reader.swapped = true;
+        break;
+    case PcapMagicNanos:
+        unitsPerSecond = 1000000000;
+        break;
+    case PcapMagicNanosSwapped:
+        reader.swapped = true;
+        unitsPerSecond = 1000000000;
+        break;
+    default:
+        *errorMessage = QString("%1 is neither pcap nor pcapng").arg(m_config.path);
+        return false;
+    }
+    if (!reader.has(0, PcapHeaderSize)) {
+        *errorMessage = QString("%1: truncated pcap header").arg(m_config.path);
+        return false;
+    }
+    int linkType = static_cast<int>(reader.u32(20) & 0xffff);
+
+    qint64 offset = PcapHeaderSize;
+    while (reader.has(offset, PcapRecordHeaderSize)) {
+        quint64 seconds = reader.u32(offset);
+        quint64 fraction = reader.u32(offset + 4);
+        qint64 capturedLength = reader.u32(offset + 8);
+        offset += PcapRecordHeaderSize;
+        if (!reader.has(offset, capturedLength)) {
+            break;  // Capture cut off mid-record (e.g. tcpdump killed)
+        }
+        qint64 timestampNs = toNs(seconds * unitsPerSecond + fraction, unitsPerSecond);
+        addFrame(linkType, timestampNs, file.constData() + offset, static_cast<int>(capturedLength));
+        offset += capturedLength;
+    }
+    return true;
+}
+
+bool PcapReplaySource::parsePcapng(const QByteArray &file, QString *errorMessage)
+{
+    Reader reader{ reinterpret_cast<const uchar *>(file.constData()), file.size(), false };
+
+    struct Interface
+    {
+        int linkType;
+        quint64 unitsPerSecond;
+    };
+    std::vector<Interface> interfaces;
+    qint64 lastTimestampNs = 0;
+
+    qint64 offset = 0;
+    while (reader.has(offset, 12)) {
+        quint32 type = reader.u32(offset);
+        if (type == BlockSectionHeader) {
+            // Each section declares its own byte order; interface ids restart
+            reader.swapped = false;
+            if (reader.u32(offset + 8) != ByteOrderMagic) {
+                reader.swapped = true;
+                if (reader.u32(offset + 8) != ByteOrderMagic) {
+                    *errorMessage = QString("%1: bad pcapng byte-order magic").arg(m_config.path);
+                    return false;
+                }
+            }
+            interfaces.clear();
+        }
+
+        qint64 length = reader.u32(offset + 4);
+        if (length < 12 || length % 4 != 0 || !reader.has(offset, length)) {
+            break;  // Truncated or corrupt: keep what was read so far
+        }
+        qint64 body = offset + 8;
+        qint64 bodyEnd = offset + length - 4;
+
+        if (type == BlockInterfaceDescription && reader.has(body, 8)) {
+            Interface iface{ reader.u16(body), 1000000 };
+            for (qint64 option = body + 8; option + 4 <= bodyEnd;) {
+                quint16 code = reader.u16(option);
+                quint16 optionLength = reader.u16(option + 2);
+                if (code == OptionEnd) {
+                    break;
+                }
+                if (code == OptionTimestampResolution && optionLength >= 1) {
+                    // MSB clear: 10^-n seconds, set: 2^-n seconds
+                    uchar resolution = reader.data[option + 4];
+                    int exponent = resolution & 0x7f;
+                    if (resolution & 0x80) {
+                        iface.unitsPerSecond = exponent < 63 ? (1ULL << exponent) : 0;
+                    } else {
+                        iface.unitsPerSecond = 1;
+                        for (int i = 0; i < exponent && i < 19; ++i) {
+                            iface.unitsPerSecond *= 10;
+                        }
+                    }
+                }
+                option += 4 + ((optionLength + 3) & ~3);
+            }
+            interfaces.push_back(iface);
+        } else if ((type == BlockEnhancedPacket || type == BlockObsoletePacket) && reader.has(body, 20)) {
+            // Obsolete packet blocks have a 16-bit interface id followed by a drop count
+            quint32 interfaceId = type == BlockEnhancedPacket ? reader.u32(body) : reader.u16(body);
+            quint64 timestamp = quint64(reader.u32(body + 4)) << 32 | reader.u32(body + 8);
+            qint64 capturedLength = reader.u32(body + 12);
+            if (interfaceId < interfaces.size() && body + 20 + capturedLength <= bodyEnd) {
+                const Interface &iface = interfaces[interfaceId];
+                lastTimestampNs = toNs(timestamp, iface.unitsPerSecond);
+                addFrame(iface.linkType, lastTimestampNs, file.constData() + body + 20,
+                         static_cast<int>(capturedLength));
+            } else {
+                ++m_skipped;
+            }
+        } else if (type == BlockSimplePacket && reader.has(body, 4) && !interfaces.empty()) {
+            // No timestamp: replayed right after the previous packet
+            qint64 capturedLength = qMin<qint64>(reader.u32(body), bodyEnd - body - 4);
+            addFrame(interfaces.front().linkType, lastTimestampNs, file.constData() + body + 4,
+                     static_cast<int>(capturedLength));
+        }
+        offset += length;
+    }
+    return true;
+}
+
+void PcapReplaySource::addFrame(int linkType, qint64 timestampNs, const char *data, int size)
+{
+    const uchar *frame = reinterpret_cast<const uchar *>(data);
+    const uchar *end = frame + size;
+    const uchar *ip = nullptr;
+
+    // Link layer -> IP header
+    switch (linkType) {
+    case LinkEthernet: {
+        if (size < 14) {
+            break;
+        }
+        quint16 etherType = be16(frame + 12);
+        const uchar *next = frame + 14;
+        while ((etherType == EtherTypeVlan || etherType == EtherTypeQinQ) && next + 4 <= end) {
+            etherType = be16(next + 2);
+            next += 4;
+        }
+        if (etherType == EtherTypeIpv4 || etherType == EtherTypeIpv6) {
+            ip = next;
+        }
+        break;
+    }
+    case LinkLinuxSll:
+        if (size >= 16 && (be16(frame + 14) == EtherTypeIpv4 || be16(frame + 14) == EtherTypeIpv6)) {
+            ip = frame + 16;
+        }
+        break;
+    case LinkLinuxSll2:
+        if (size >= 20 && (be16(frame) == EtherTypeIpv4 || be16(frame) == EtherTypeIpv6)) {
+            ip = frame + 20;
+        }
+        break;
+    case LinkNull:
+    case LinkLoop:
+        // 4-byte address family in varying byte order; the IP version nibble is enough
+        if (size > 4) {
+            ip = frame + 4;
+        }
+        break;
+    case LinkRaw:
+    case LinkRawAlt:
+    case LinkIpv4:
+    case LinkIpv6:
+        ip = frame;
+        break;
+    default:
+        break;
+    }
+    if (!ip || ip >= end) {
+        ++m_skipped;
+        return;
+    }
+
+    // IP -> UDP header
+    const uchar *udp = nullptr;
+    int version = ip[0] >> 4;
+    if (version == 4 && ip + 20 <= end) {
+        int headerLength = (ip[0] & 0x0f) * 4;
+        quint16 fragment = be16(ip + 6);
+        const uchar *packetEnd = ip + be16(ip + 2);
+        if (packetEnd < end && packetEnd >= ip + headerLength) {
+            end = packetEnd;  // Ethernet padding
+        }
+        // Offset or more-fragments set: only whole datagrams are replayed
+        if (ip[9] == ProtocolUdp && (fragment & 0x3fff) == 0 && headerLength >= 20) {
+            udp = ip + headerLength;
+        }
+    } else if (version == 6 && ip + 40 <= end) {
+        const uchar *packetEnd = ip + 40 + be16(ip + 4);
+        if (packetEnd < end) {
+            end = packetEnd;
+        }
+        int next = ip[6];
+        const uchar *header = ip + 40;
+        // Hop-by-hop, routing, destination options and AH may precede UDP; fragments are skipped
+        while (header + 8 <= end && (next == 0 || next == 43 || next == 60 || next == 51)) {
+            int length = next == 51 ? (header[1] + 2) * 4 : (header[1] + 1) * 8;
+            next = header[0];
+            header += length;
+        }
+        if (next == ProtocolUdp) {
+            udp = header;
+        }
+    }
+    if (!udp || udp + 8 > end) {
+        ++m_skipped;
+        return;
+    }
+
+    quint16 port = be16(udp + 2);
+    int payloadSize = be16(udp + 4) - 8;
+    const uchar *payload = udp + 8;
+    // A datagram cut by the snap length would be a corrupt RTP packet
+    if (payloadSize < 0 || payload + payloadSize > end
+        || (m_config.udpPort != 0 && port != m_config.udpPort)) {
+        ++m_skipped;
+        return;
+    }
+
+    CapturedPacket packet;
+    packet.timestampNs = timestampNs;
+    packet.offset = static_cast<int>(m_payloads.size());
+    packet.size = payloadSize;
+    packet.port = port;
+    m_payloads.append(reinterpret_cast<const char *>(payload), payloadSize);
+    m_packets.push_back(packet);
+}
+
+bool PcapReplaySource::start(PacketSink sink)
+{
+    return launch(std::move(sink), 0);
+}
+
+bool PcapReplaySource::startLoopback(quint16 port)
+{
+    return launch(PacketSink(), port);
+}
+
+bool PcapReplaySource::launch(PacketSink sink, quint16 loopbackPort)
+{
+    stop();
+    if (m_packets.empty()) {
+        LOG_WARN("PcapReplaySource", "Nothing to replay - load() a capture first");
+        return false;
+    }
+
+    m_replayedPackets.store(0);
+    m_replayedBytes.store(0);
+    m_sendErrors.store(0);
+    m_maxLateNs.store(0);
+    m_loopsDone.store(0);
+    m_stopRequested.store(false);
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&PcapReplaySource::run, this, std::move(sink), loopbackPort);
+    return true;
+}
+
+void PcapReplaySource::stop()
+{
+    m_stopRequested.store(true);
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_running.store(false, std::memory_order_release);
+}
+
+double PcapReplaySource::captureDurationS() const
+{
+    if (m_packets.size() < 2) {
+        return 0.0;
+    }
+    return (m_packets.back().timestampNs - m_packets.front().timestampNs) / 1e9;
+}
+
+PcapReplaySource::Stats PcapReplaySource::stats() const
+{
+    Stats stats;
+    stats.packets = m_replayedPackets.load(std::memory_order_relaxed);
+    stats.bytes = m_replayedBytes.load(std::memory_order_relaxed);
+    stats.sendErrors = m_sendErrors.load(std::memory_order_relaxed);
+    stats.maxLateNs = m_maxLateNs.load(std::memory_order_relaxed);
+    stats.loopsDone = m_loopsDone.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void PcapReplaySource::run(PacketSink sink, quint16 loopbackPort)
+{
+    using Clock = std::chrono::steady_clock;
+    ThreadMonitor::nameCurrentThread("pcap-replay");
+
+    // Created on this thread; writeDatagram() needs no event loop
+    std::unique_ptr<QUdpSocket> socket;
+    if (loopbackPort != 0) {
+        socket = std::make_unique<QUdpSocket>();
+    }
+
+    Packet out;
+    out.shard = 0;
+    const double speed = m_config.speed;
+    const qint64 firstNs = m_packets.front().timestampNs;
+
+    for (int loop = 0; m_config.loops <= 0 || loop < m_config.loops; ++loop) {
+        const Clock::time_point passStart = Clock::now();
+        for (const CapturedPacket &packet : m_packets) {
+            if (m_stopRequested.load(std::memory_order_relaxed)) {
+                break;
+            }
+
+            if (speed > 0.0) {
+                // Out-of-order capture timestamps (offset < 0) go out immediately
+                auto offset = std::chrono::nanoseconds(static_cast<qint64>((packet.timestampNs - firstNs) / speed));
+                Clock::time_point due = passStart + offset;
+                Clock::time_point now = Clock::now();
+                while (due - now > SpinWindow && !m_stopRequested.load(std::memory_order_relaxed)) {
+                    std::this_thread::sleep_for(qMin<Clock::duration>(due - now - SpinWindow, MaxSleepSlice));
+                    now = Clock::now();
+                }
+                while (now < due) {
+                    std::this_thread::yield();
+                    now = Clock::now();
+                }
+                qint64 lateNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now - due).count();
+                if (lateNs > m_maxLateNs.load(std::memory_order_relaxed)) {
+                    m_maxLateNs.store(lateNs, std::memory_order_relaxed);
+                }
+            }
+
+            const char *data = m_payloads.constData() + packet.offset;
+            if (socket) {
+                if (socket->writeDatagram(data, packet.size, QHostAddress(QHostAddress::LocalHost), loopbackPort) < 0) {
+                    m_sendErrors.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+            } else {
+                out.data = data;
+                out.size = packet.size;
+                out.kernelRxNs = TimestampedUdpSocket::wallClockNs();
+                out.userRxNs = out.kernelRxNs;
+                out.port = packet.port;
+                out.ssrc = rtpSsrc(data, packet.size);
+                sink(out);
+            }
+            m_replayedPackets.fetch_add(1, std::memory_order_relaxed);
+            m_replayedBytes.fetch_add(packet.size, std::memory_order_relaxed);
+        }
+        if (m_stopRequested.load(std::memory_order_relaxed)) {
+            break;
+        }
+        m_loopsDone.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    m_running.store(false, std::memory_order_release);
+}
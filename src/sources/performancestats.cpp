@@ -0,0 +1,220 @@
+/**
+ * @file performancestats.cpp
+ * @brief Implementation of the 4 Hz stats aggregation behind the performance HUD
+ */
+
+#include "includes/performancestats.hpp"
+#include "includes/metrics.hpp"  // Source of every subsystem number
+#include "includes/tracing.hpp"  // Thread samples also go to traces
+#include <QQuickWindow>          // Frame and render pass signals
+
+namespace {
+constexpr int SampleIntervalMs = 250;
+// A GUI frame gap longer than this means the window was idle, not slow
+constexpr qint64 MaxGuiFrameNs = 1000LL * 1000 * 1000;
+}
+
+quint64 PerformanceStats::CounterDelta::take(quint64 *total)
+{
+    if (!counter) {
+        counter = MetricsRegistry::instance().findCounter(name, labels);
+        if (!counter) {
+            return 0;
+        }
+        last = counter->value();
+    }
+    quint64 value = counter->value();
+    quint64 delta = value - last;
+    last = value;
+    if (total) {
+        *total = value;
+    }
+    return delta;
+}
+
+double PerformanceStats::HistogramDelta::takeMeanMs()
+{
+    if (!histogram) {
+        histogram = MetricsRegistry::instance().findHistogram(name, labels);
+        if (!histogram) {
+            return -1.0;
+        }
+        lastSumNs = histogram->sumNs();
+        lastCount = histogram->count();
+    }
+    // Count before sum: a concurrent observation then only skews one tick slightly
+    quint64 count = histogram->count();
+    qint64 sumNs = histogram->sumNs();
+    quint64 deltaCount = count - lastCount;
+    qint64 deltaSumNs = sumNs - lastSumNs;
+    lastCount = count;
+    lastSumNs = sumNs;
+    return deltaCount > 0 ? (double(deltaSumNs) / deltaCount) / 1e6 : -1.0;
+}
+
+PerformanceStats::PerformanceStats(QObject *parent)
+    : QObject(parent)
+    , m_threadMonitor(this)
+    , m_lastTickNs(0)
+    , m_framesDisplayed{"driver_video_frames_displayed_total", ""}
+    , m_decodeDrops{"driver_video_frames_dropped_total", "stage=\"decode\""}
+    , m_handoffDrops{"driver_video_frames_dropped_total", "stage=\"handoff\""}
+    , m_wsSent{"driver_control_messages_sent_total", "path=\"ws\""}
+    , m_polls{"driver_input_polls_total", ""}
+    , m_rxToAppsink{"driver_video_rx_to_appsink_seconds", ""}
+    , m_appsinkToGui{"driver_video_appsink_to_gui_seconds", ""}
+    , m_wsRtt{"driver_control_rtt_seconds", "path=\"ws\""}
+    , m_queueDepthGauge(nullptr)
+    , m_inputJitterGauge(nullptr)
+    , m_lastGuiFrameNs(-1)
+    , m_guiFrameSumNs(0)
+    , m_guiFrameMaxNs(0)
+    , m_guiFrameCount(0)
+    , m_tracking(false)
+    , m_renderStartNs(-1)
+    , m_renderSumNs(0)
+    , m_renderMaxNs(0)
+    , m_renderCount(0)
+    , m_videoFps(0.0)
+    , m_frameAgeMs(-1.0)
+    , m_decodeMs(-1.0)
+    , m_droppedFrames(0)
+    , m_dropRate(0.0)
+    , m_handoffQueueDepth(0)
+    , m_controlRttMs(-1.0)
+    , m_sendRateHz(0.0)
+    , m_inputRateHz(0.0)
+    , m_inputJitterMs(0.0)
+    , m_guiFrameMs(0.0)
+    , m_guiFrameMaxMs(0.0)
+    , m_renderMs(0.0)
+    , m_renderMaxMs(0.0)
+{
+    m_clock.start();
+    m_timer.setInterval(SampleIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &PerformanceStats::sample);
+
+    // Thread sampling costs a few /proc reads per thread: only while someone looks
+    connect(this, &PerformanceStats::runningChanged, this, &PerformanceStats::updateThreadMonitor);
+    connect(Tracer::instance(), &Tracer::enabledChanged, this, &PerformanceStats::updateThreadMonitor);
+    updateThreadMonitor();
+}
+
+void PerformanceStats::setRunning(bool running)
+{
+    if (running == isRunning()) {
+        return;
+    }
+    if (running) {
+        // Start from a clean window so the first tick doesn't average over idle time
+        m_lastTickNs = m_clock.nsecsElapsed();
+        m_lastGuiFrameNs = -1;
+        m_guiFrameSumNs = m_guiFrameMaxNs = m_guiFrameCount = 0;
+        m_renderSumNs = m_renderMaxNs = m_renderCount = 0;
+        m_tracking = true;
+        m_timer.start();
+        sample();
+    } else {
+        m_tracking = false;
+        m_timer.stop();
+    }
+    emit runningChanged();
+}
+
+void PerformanceStats::setIntervalMs(int intervalMs)
+{
+    // Rates and means divide by the measured tick length, so any interval works
+    m_timer.setInterval(qMax(SampleIntervalMs, intervalMs));
+}
+
+void PerformanceStats::updateThreadMonitor()
+{
+    m_threadMonitor.setRunning(isRunning() || Tracer::active());
+}
+
+void PerformanceStats::trackWindow(QQuickWindow *window)
+{
+    if (!window) {
+        return;
+    }
+
+    // Once per frame on the GUI thread, after animations advanced
+    connect(window, &QQuickWindow::afterAnimating, this, [this]() {
+        if (!m_tracking.load(std::memory_order_relaxed)) {
+            return;
+        }
+        qint64 nowNs = m_clock.nsecsElapsed();
+        if (m_lastGuiFrameNs >= 0 && nowNs - m_lastGuiFrameNs < MaxGuiFrameNs) {
+            qint64 intervalNs = nowNs - m_lastGuiFrameNs;
+            m_guiFrameSumNs += intervalNs;
+            m_guiFrameMaxNs = qMax(m_guiFrameMaxNs, intervalNs);
+            ++m_guiFrameCount;
+        }
+        m_lastGuiFrameNs = nowNs;
+    });
+
+    // Render thread (GUI thread with the basic loop); one writer per window
+    connect(window, &QQuickWindow::beforeRendering, this, [this]() {
+        if (m_tracking.load(std::memory_order_relaxed)) {
+            m_renderStartNs.store(m_clock.nsecsElapsed(), std::memory_order_relaxed);
+        }
+    }, Qt::DirectConnection);
+    connect(window, &QQuickWindow::afterRendering, this, [this]() {
+        qint64 startNs = m_renderStartNs.exchange(-1, std::memory_order_relaxed);
+        if (startNs < 0) {
+            return;
+        }
+        qint64 renderNs = m_clock.nsecsElapsed() - startNs;
+        m_renderSumNs.fetch_add(renderNs, std::memory_order_relaxed);
+        m_renderCount.fetch_add(1, std::memory_order_relaxed);
+        if (renderNs > m_renderMaxNs.load(std::memory_order_relaxed)) {
+            m_renderMaxNs.store(renderNs, std::memory_order_relaxed);
+        }
+    }, Qt::DirectConnection);
+}
+
+void PerformanceStats::sample()
+{
+    qint64 nowNs = m_clock.nsecsElapsed();
+    double seconds = qMax<qint64>(nowNs - m_lastTickNs, 1) / 1e9;
+    m_lastTickNs = nowNs;
+
+    // Video
+    m_videoFps = m_framesDisplayed.take() / seconds;
+    quint64 decodeDropsTotal = 0;
+    quint64 handoffDropsTotal = 0;
+    quint64 drops = m_decodeDrops.take(&decodeDropsTotal) + m_handoffDrops.take(&handoffDropsTotal);
+    m_droppedFrames = static_cast<qint64>(decodeDropsTotal + handoffDropsTotal);
+    m_dropRate = drops / seconds;
+    m_decodeMs = m_rxToAppsink.takeMeanMs();
+    double handoffMs = m_appsinkToGui.takeMeanMs();
+    m_frameAgeMs = (m_decodeMs >= 0 && handoffMs >= 0) ? m_decodeMs + handoffMs : handoffMs;
+    if (!m_queueDepthGauge) {
+        m_queueDepthGauge = MetricsRegistry::instance().findGauge("driver_video_handoff_queue_depth");
+    }
+    m_handoffQueueDepth = m_queueDepthGauge ? qRound(m_queueDepthGauge->value()) : 0;
+
+    // Control and input
+    double rttMs = m_wsRtt.takeMeanMs();
+    if (rttMs >= 0) {
+        m_controlRttMs = rttMs;  // Keep the last value through ticks without acks
+    }
+    m_sendRateHz = m_wsSent.take() / seconds;
+    m_inputRateHz = m_polls.take() / seconds;
+    if (!m_inputJitterGauge) {
+        m_inputJitterGauge = MetricsRegistry::instance().findGauge("driver_input_poll_jitter_seconds");
+    }
+    m_inputJitterMs = m_inputJitterGauge ? m_inputJitterGauge->value() * 1e3 : 0.0;
+
+    // GUI / render
+    m_guiFrameMs = m_guiFrameCount > 0 ? (double(m_guiFrameSumNs) / m_guiFrameCount) / 1e6 : 0.0;
+    m_guiFrameMaxMs = m_guiFrameMaxNs / 1e6;
+    m_guiFrameSumNs = m_guiFrameMaxNs = m_guiFrameCount = 0;
+
+    qint64 renderCount = m_renderCount.exchange(0, std::memory_order_relaxed);
+    qint64 renderSumNs = m_renderSumNs.exchange(0, std::memory_order_relaxed);
+    m_renderMs = renderCount > 0 ? (double(renderSumNs) / renderCount) / 1e6 : 0.0;
+    m_renderMaxMs = m_renderMaxNs.exchange(0, std::memory_order_relaxed) / 1e6;
+
+    emit updated();
+}
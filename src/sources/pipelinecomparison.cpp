@@ -0,0 +1,269 @@
+/**
+ * @file pipelinecomparison.cpp
+ * @brief Implementation of the A/B pipeline comparison mode
+ *
+ * One RtpReceiveEngine thread pushes a copy of each packet into both receivers
+ * (alternating which side goes first), so both pipelines decode byte-identical
+ * input with identical kernel receive timestamps.
+ */
+
+#include "includes/pipelinecomparison.hpp"
+#include "includes/logging.hpp" // Asynchronous logging
+#include <QDateTime>           // Export file names
+#include <QDir>                // Export location
+#include <QFile>               // Export output
+#include <QJsonArray>          // JSON export
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>         // CSV export
+
+namespace {
+// Two hours of history per side is plenty for a tuning session
+constexpr int MaxSamples = 2 * 2 * 3600;
+
+double meanMs(qint64 sumNs, qint64 count)
+{
+    return count > 0 ? (double(sumNs) / count) / 1e6 : 0.0;
+}
+
+QString csvQuoted(QString text)
+{
+    return '"' + text.replace('"', "\"\"") + '"';
+}
+}
+
+PipelineComparison::PipelineComparison(QObject *parent)
+    : QObject(parent)
+    , m_feedBFirst(false)
+    , m_enabled(false)
+    , m_port(0)
+    , m_samplesPort(0)
+    , m_sampleTimer(new QTimer(this))
+    , m_lastSampleNs(0)
+{
+    // Both receivers get their packets from m_engine instead of binding the port
+    m_a.label = "A";
+    m_a.receiver = new VideoStreamReceiver(this);
+    m_a.receiver->setExternalIngest(true);
+    m_b.label = "B";
+    m_b.receiver = new VideoStreamReceiver(this);
+    m_b.receiver->setExternalIngest(true);
+
+    connect(m_a.receiver, &VideoStreamReceiver::decoderChainChanged, this, &PipelineComparison::chainAChanged);
+    connect(m_b.receiver, &VideoStreamReceiver::decoderChainChanged, this, &PipelineComparison::chainBChanged);
+    connect(m_sampleTimer, &QTimer::timeout, this, &PipelineComparison::onSampleTimeout);
+}
+
+PipelineComparison::~PipelineComparison()
+{
+    // The engine pushes into the receivers - stop it before they are destroyed
+    m_engine.stop();
+}
+
+void PipelineComparison::setEnabled(bool enabled)
+{
+    if (m_enabled != enabled) {
+        m_enabled = enabled;
+        emit enabledChanged();
+    }
+}
+
+void PipelineComparison::setChainA(const QString &chain)
+{
+    m_a.receiver->setDecoderChain(chain);
+}
+
+void PipelineComparison::setChainB(const QString &chain)
+{
+    m_b.receiver->setDecoderChain(chain);
+}
+
+bool PipelineComparison::start(int port)
+{
+    stop();
+
+    LOG_DEBUG("PipelineComparison", "Port {} - A: {} - B: {}", port,
+              chainA().isEmpty() ? QString("built-in") : chainA(),
+              chainB().isEmpty() ? QString("built-in") : chainB());
+
+    // Pipelines first, so the appsrcs exist before the first packet arrives
+    m_a.receiver->startStream(port);
+    m_b.receiver->startStream(port);
+    if (!m_a.receiver->isStreaming() || !m_b.receiver->isStreaming()) {
+        QString failed = m_a.receiver->isStreaming() ? m_b.label : m_a.label;
+        stop();
+        emit errorOccurred(QString("Pipeline %1 failed to start").arg(failed));
+        return false;
+    }
+
+    bool started = m_engine.start(static_cast<quint16>(port), [this](const RtpReceiveEngine::Packet &packet) {
+        // Each push allocates and copies a buffer; alternating the order keeps
+        // that cost from always landing on the same side's latency
+        m_feedBFirst = !m_feedBFirst;
+        VideoStreamReceiver *first = m_feedBFirst ? m_b.receiver : m_a.receiver;
+        VideoStreamReceiver *second = m_feedBFirst ? m_a.receiver : m_b.receiver;
+        first->pushExternalPacket(packet);
+        second->pushExternalPacket(packet);
+    });
+    if (!started) {
+        stop();
+        emit errorOccurred(QString("Failed to bind UDP port %1").arg(port));
+        return false;
+    }
+
+    m_port = port;
+    m_samplesPort = port;
+    m_samples.clear();
+    m_a.last = m_a.receiver->pipelineStats();
+    m_b.last = m_b.receiver->pipelineStats();
+    m_a.stats.clear();
+    m_b.stats.clear();
+    m_clock.start();
+    m_lastSampleNs = 0;
+    m_sampleTimer->start(1000);
+
+    emit runningChanged();
+    emit statsChanged();
+    return true;
+}
+
+void PipelineComparison::stop()
+{
+    bool wasRunning = isRunning();
+
+    // Engine first: it must not push into a pipeline that is being torn down
+    m_engine.stop();
+    m_sampleTimer->stop();
+    m_a.receiver->stopStream();
+    m_b.receiver->stopStream();
+    m_port = 0;
+
+    if (wasRunning) {
+        emit runningChanged();
+    }
+}
+
+void PipelineComparison::onSampleTimeout()
+{
+    qint64 nowNs = m_clock.nsecsElapsed();
+    double intervalS = (nowNs - m_lastSampleNs) / 1e9;
+    m_lastSampleNs = nowNs;
+    if (intervalS <= 0.0) {
+        return;
+    }
+
+    double elapsedS = nowNs / 1e9;
+    for (Side *side : { &m_a, &m_b }) {
+        side->stats = sampleSide(*side, intervalS);
+
+        QVariantMap sample = side->stats;
+        sample["elapsedS"] = elapsedS;
+        sample["side"] = side->label;
+        m_samples.append(sample);
+    }
+    while (m_samples.size() > MaxSamples) {
+        m_samples.removeFirst();
+    }
+
+    emit statsChanged();
+}
+
+QVariantMap PipelineComparison::sampleSide(Side &side, double intervalS)
+{
+    VideoStreamReceiver::PipelineStats now = side.receiver->pipelineStats();
+    const VideoStreamReceiver::PipelineStats &last = side.last;
+
+    qint64 framesIn = now.framesIn - last.framesIn;
+    qint64 decoded = now.framesDecoded - last.framesDecoded;
+    qint64 displayed = now.appsinkToGuiCount - last.appsinkToGuiCount;
+    double rxToAppsinkMs = meanMs(now.rxToAppsinkSumNs - last.rxToAppsinkSumNs,
+                                  now.rxToAppsinkCount - last.rxToAppsinkCount);
+    double appsinkToGuiMs = meanMs(now.appsinkToGuiSumNs - last.appsinkToGuiSumNs, displayed);
+
+    QVariantMap stats;
+    stats["fps"] = displayed / intervalS;
+    stats["decodedFps"] = decoded / intervalS;
+    stats["framesIn"] = framesIn;
+    // Frames still in flight at the sample boundary can make this briefly negative
+    stats["dropped"] = qMax<qint64>(0, framesIn - decoded);
+    stats["rxToAppsinkMs"] = rxToAppsinkMs;
+    stats["appsinkToGuiMs"] = appsinkToGuiMs;
+    stats["rxToGuiMs"] = rxToAppsinkMs + appsinkToGuiMs;
+    stats["rxToAppsinkMaxMs"] = now.rxToAppsinkMaxNs / 1e6;
+    stats["cpuPercent"] = (now.streamingCpuNs - last.streamingCpuNs) / (intervalS * 1e9) * 100.0;
+    stats["totalFramesIn"] = now.framesIn;
+    stats["totalDecoded"] = now.framesDecoded;
+    stats["totalDropped"] = qMax<qint64>(0, now.framesIn - now.framesDecoded);
+
+    side.last = now;
+    return stats;
+}
+
+QVariantMap PipelineComparison::summary(const Side &side) const
+{
+    VideoStreamReceiver::PipelineStats now = side.receiver->pipelineStats();
+    double elapsedS = m_clock.isValid() ? m_clock.nsecsElapsed() / 1e9 : 0.0;
+
+    QVariantMap summary;
+    summary["chain"] = side.receiver->decoderChain().isEmpty() ? QString("built-in") : side.receiver->decoderChain();
+    summary["elapsedS"] = elapsedS;
+    summary["packets"] = now.packets;
+    summary["framesIn"] = now.framesIn;
+    summary["framesDecoded"] = now.framesDecoded;
+    summary["framesDisplayed"] = now.appsinkToGuiCount;
+    summary["dropped"] = qMax<qint64>(0, now.framesIn - now.framesDecoded);
+    summary["fps"] = elapsedS > 0.0 ? now.appsinkToGuiCount / elapsedS : 0.0;
+    summary["rxToAppsinkMeanMs"] = meanMs(now.rxToAppsinkSumNs, now.rxToAppsinkCount);
+    summary["rxToAppsinkMaxMs"] = now.rxToAppsinkMaxNs / 1e6;
+    summary["appsinkToGuiMeanMs"] = meanMs(now.appsinkToGuiSumNs, now.appsinkToGuiCount);
+    summary["appsinkToGuiMaxMs"] = now.appsinkToGuiMaxNs / 1e6;
+    summary["cpuPercent"] = elapsedS > 0.0 ? now.streamingCpuNs / (elapsedS * 1e9) * 100.0 : 0.0;
+    return summary;
+}
+
+QString PipelineComparison::exportResults(const QString &format) const
+{
+    bool csv = format.compare("csv", Qt::CaseInsensitive) == 0;
+    QString path = QDir::current().filePath(QString("pipeline-ab-%1.%2")
+        .arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss"), csv ? "csv" : "json"));
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        LOG_WARN("PipelineComparison", "Cannot write {}: {}", path, file.errorString());
+        return QString();
+    }
+
+    if (csv) {
+        QTextStream out(&file);
+        out << "elapsed_s,side,chain,fps,decoded_fps,frames_in,dropped,"
+               "rx_to_appsink_ms,appsink_to_gui_ms,rx_to_gui_ms,rx_to_appsink_max_ms,cpu_percent\n";
+        for (const QVariant &entry : m_samples) {
+            QVariantMap sample = entry.toMap();
+            const Side &side = sample["side"].toString() == m_b.label ? m_b : m_a;
+            QString chain = side.receiver->decoderChain().isEmpty() ? QString("built-in") : side.receiver->decoderChain();
+            out << QString::number(sample["elapsedS"].toDouble(), 'f', 3) << ','
+                << side.label << ','
+                << csvQuoted(chain) << ','
+                << QString::number(sample["fps"].toDouble(), 'f', 2) << ','
+                << QString::number(sample["decodedFps"].toDouble(), 'f', 2) << ','
+                << sample["framesIn"].toLongLong() << ','
+                << sample["dropped"].toLongLong() << ','
+                << QString::number(sample["rxToAppsinkMs"].toDouble(), 'f', 3) << ','
+                << QString::number(sample["appsinkToGuiMs"].toDouble(), 'f', 3) << ','
+                << QString::number(sample["rxToGuiMs"].toDouble(), 'f', 3) << ','
+                << QString::number(sample["rxToAppsinkMaxMs"].toDouble(), 'f', 3) << ','
+                << QString::number(sample["cpuPercent"].toDouble(), 'f', 1) << '\n';
+        }
+    } else {
+        QJsonObject root;
+        root["port"] = m_samplesPort;
+        root["exportedAt"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+        root["summaryA"] = QJsonObject::fromVariantMap(summary(m_a));
+        root["summaryB"] = QJsonObject::fromVariantMap(summary(m_b));
+        root["samples"] = QJsonArray::fromVariantList(m_samples);
+        file.write(QJsonDocument(root).toJson());
+    }
+
+    LOG_DEBUG("PipelineComparison", "Wrote {} samples to {}", m_samples.size(), path);
+    return path;
+}
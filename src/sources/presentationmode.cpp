@@ -0,0 +1,236 @@
+/**
+ * @file presentationmode.cpp
+ * @brief Implementation of the presentation settings and swap latency measurement
+ */
+
+#include "includes/presentationmode.hpp"
+#include "includes/logging.hpp"  // Mode at startup, latency summary at exit
+#include "includes/metrics.hpp"  // driver_swap_latency_seconds
+#include <QGuiApplication>       // platformName(), native X11 connection
+#include <QQuickWindow>          // setGraphicsApi(), frame signals
+#include <QSurfaceFormat>        // Swap interval
+
+#if defined(DRIVER_HAVE_XCB)
+#if QT_CONFIG(xcb)
+#include <QtGui/qguiapplication_platform.h>  // QNativeInterface::QX11Application
+#include <xcb/xcb.h>                         // _NET_WM_BYPASS_COMPOSITOR property
+#include <cstdlib>                           // free() of xcb replies
+#define DRIVER_X11_BYPASS 1
+#endif
+#endif
+
+namespace {
+constexpr int SampleIntervalMs = 1000;
+
+enum class VSync { On, Off, Adaptive };
+
+bool s_fullscreen = false;
+VSync s_vsync = VSync::On;
+
+/**
+ * @brief Lower-cased, trimmed value of @p name (empty if unset)
+ */
+QByteArray setting(const char *name)
+{
+    return qgetenv(name).trimmed().toLower();
+}
+}
+
+void PresentationMode::configure()
+{
+    QByteArray presentation = setting("DRIVER_PRESENTATION");
+    s_fullscreen = presentation == "fullscreen";
+    if (!presentation.isEmpty() && !s_fullscreen && presentation != "windowed") {
+        LOG_WARN("PresentationMode", "Unknown DRIVER_PRESENTATION '{}', using windowed", presentation.constData());
+    }
+
+    QByteArray vsync = setting("DRIVER_VSYNC");
+    if (vsync == "off") {
+        s_vsync = VSync::Off;
+    } else if (vsync == "adaptive") {
+        s_vsync = VSync::Adaptive;
+    } else {
+        s_vsync = VSync::On;
+        if (!vsync.isEmpty() && vsync != "on") {
+            LOG_WARN("PresentationMode", "Unknown DRIVER_VSYNC '{}', using on", vsync.constData());
+        }
+    }
+
+    // Threaded: the GUI thread syncs and moves on while the render thread waits for vblank
+    QByteArray loop = setting("DRIVER_RENDER_LOOP");
+    if (loop == "threaded" || loop == "basic") {
+        if (qEnvironmentVariableIsSet("QSG_RENDER_LOOP")) {
+            LOG_WARN("PresentationMode", "QSG_RENDER_LOOP is set, ignoring DRIVER_RENDER_LOOP={}", loop.constData());
+        } else {
+            qputenv("QSG_RENDER_LOOP", loop);
+        }
+    } else if (!loop.isEmpty()) {
+        LOG_WARN("PresentationMode", "Unknown DRIVER_RENDER_LOOP '{}'", loop.constData());
+    }
+
+    // 0 turns vsync off with every RHI backend; a negative interval (swap late frames
+    // immediately) only reaches the driver through OpenGL
+    QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+    format.setSwapInterval(s_vsync == VSync::Off ? 0 : (s_vsync == VSync::Adaptive ? -1 : 1));
+    if (s_fullscreen) {
+        format.setAlphaBufferSize(0);  // Only opaque surfaces are scanned out directly
+    }
+    QSurfaceFormat::setDefaultFormat(format);
+    if (s_vsync == VSync::Adaptive && !qEnvironmentVariableIsSet("QSG_RHI_BACKEND")) {
+        QQuickWindow::setGraphicsApi(QSGRendererInterface::OpenGL);
+    }
+}
+
+PresentationMode::PresentationMode(QObject *parent)
+    : QObject(parent)
+    , m_latencyHistogram(&MetricsRegistry::instance().histogram(
+          "driver_swap_latency_seconds", "Video frame handed to the GUI -> swap that shows it (before composition and scanout)",
+          MetricsRegistry::latencyBuckets()))
+    , m_handedNs(-1)
+    , m_loadedNs(-1)
+    , m_syncedNs(-1)
+    , m_latencySumNs(0)
+    , m_latencyCount(0)
+    , m_lastSumNs(0)
+    , m_lastCount(0)
+    , m_swapLatencyMs(-1.0)
+{
+    m_clock.start();
+    m_timer.setInterval(SampleIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &PresentationMode::sample);
+}
+
+PresentationMode::~PresentationMode()
+{
+    qint64 count = m_latencyCount.load(std::memory_order_relaxed);
+    if (count > 0) {
+        qint64 meanUs = m_latencySumNs.load(std::memory_order_relaxed) / count / 1000;
+        LOG_INFO("PresentationMode", "Swap latency ({}): mean {} us over {} frames", description(), meanUs, count);
+    }
+}
+
+bool PresentationMode::isFullscreen() const
+{
+    return s_fullscreen;
+}
+
+QString PresentationMode::vsync() const
+{
+    switch (s_vsync) {
+    case VSync::Off:
+        return QStringLiteral("off");
+    case VSync::Adaptive:
+        return QStringLiteral("adaptive");
+    default:
+        return QStringLiteral("on");
+    }
+}
+
+QString PresentationMode::renderLoop() const
+{
+    return qEnvironmentVariable("QSG_RENDER_LOOP", QStringLiteral("default"));
+}
+
+QString PresentationMode::description() const
+{
+    return QStringLiteral("%1, vsync %2, %3 loop")
+        .arg(s_fullscreen ? QStringLiteral("fullscreen") : QStringLiteral("windowed"), vsync(), renderLoop());
+}
+
+void PresentationMode::trackWindow(QQuickWindow *window)
+{
+    if (!window) {
+        return;
+    }
+    m_window = window;
+    LOG_INFO("PresentationMode", "Presentation: {} ({})", description(), QGuiApplication::platformName());
+    if (s_fullscreen) {
+        requestCompositorBypass(window);
+    }
+
+    // Render thread with the threaded loop, GUI thread otherwise; the GUI thread is
+    // blocked during afterSynchronizing, so a frame loaded before it is in this frame
+    connect(window, &QQuickWindow::afterSynchronizing, this, [this]() {
+        qint64 loadedNs = m_loadedNs.exchange(-1, std::memory_order_relaxed);
+        if (loadedNs >= 0) {
+            m_syncedNs.store(loadedNs, std::memory_order_relaxed);
+        }
+    }, Qt::DirectConnection);
+    connect(window, &QQuickWindow::frameSwapped, this, &PresentationMode::onFrameSwapped, Qt::DirectConnection);
+    m_timer.start();
+}
+
+void PresentationMode::requestCompositorBypass(QQuickWindow *window)
+{
+    QString platform = QGuiApplication::platformName();
+    if (platform == QLatin1String("xcb")) {
+#if defined(DRIVER_X11_BYPASS)
+        auto *x11 = qGuiApp->nativeInterface<QNativeInterface::QX11Application>();
+        xcb_connection_t *connection = x11 ? x11->connection() : nullptr;
+        if (connection) {
+            static const char name[] = "_NET_WM_BYPASS_COMPOSITOR";
+            xcb_intern_atom_reply_t *atom = xcb_intern_atom_reply(
+                connection, xcb_intern_atom(connection, 0, sizeof(name) - 1, name), nullptr);
+            if (atom) {
+                quint32 bypass = 1;  // 1 = bypass requested, 2 = keep compositing
+                xcb_change_property(connection, XCB_PROP_MODE_REPLACE, static_cast<xcb_window_t>(window->winId()),
+                                    atom->atom, XCB_ATOM_CARDINAL, 32, 1, &bypass);
+                xcb_flush(connection);
+                free(atom);
+                LOG_INFO("PresentationMode", "Requested compositor bypass (_NET_WM_BYPASS_COMPOSITOR)");
+                return;
+            }
+        }
+        LOG_WARN("PresentationMode", "Cannot set _NET_WM_BYPASS_COMPOSITOR, the window stays composited");
+#else
+        Q_UNUSED(window);
+        LOG_WARN("PresentationMode", "Built without xcb, cannot request compositor bypass");
+#endif
+    } else if (platform.startsWith(QLatin1String("wayland"))) {
+        // No protocol to ask for it; compositors scan out opaque fullscreen surfaces by themselves
+        LOG_INFO("PresentationMode", "Wayland: opaque fullscreen surface, direct scanout is up to the compositor");
+    } else if (platform == QLatin1String("windows")) {
+        // Fullscreen flip-model swap chains are promoted to independent flip by DWM
+        LOG_INFO("PresentationMode", "Windows: fullscreen swap chain, eligible for independent flip");
+    }
+}
+
+void PresentationMode::frameHandedToGui()
+{
+    m_handedNs = m_clock.nsecsElapsed();
+}
+
+void PresentationMode::frameLoaded()
+{
+    if (m_handedNs >= 0) {
+        m_loadedNs.store(m_handedNs, std::memory_order_relaxed);
+        m_handedNs = -1;
+    }
+}
+
+void PresentationMode::onFrameSwapped()
+{
+    qint64 handedNs = m_syncedNs.exchange(-1, std::memory_order_relaxed);
+    if (handedNs < 0) {
+        return;
+    }
+    qint64 latencyNs = m_clock.nsecsElapsed() - handedNs;
+    m_latencyHistogram->observeNs(latencyNs);
+    m_latencySumNs.fetch_add(latencyNs, std::memory_order_relaxed);
+    m_latencyCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PresentationMode::sample()
+{
+    // Count before sum, as in PerformanceStats
+    qint64 count = m_latencyCount.load(std::memory_order_relaxed);
+    qint64 sumNs = m_latencySumNs.load(std::memory_order_relaxed);
+    qint64 frames = count - m_lastCount;
+    double latencyMs = frames > 0 ? double(sumNs - m_lastSumNs) / frames / 1e6 : -1.0;
+    m_lastCount = count;
+    m_lastSumNs = sumNs;
+    if (latencyMs != m_swapLatencyMs) {
+        m_swapLatencyMs = latencyMs;
+        emit updated();
+    }
+}
@@ -0,0 +1,236 @@
+/**
+ * @file renderprofile.cpp
+ * @brief Implementation of the UI profile selection and software repaint statistics
+ */
+
+#include "includes/renderprofile.hpp"
+#include "includes/logging.hpp"  // Profile choice, partial update verdicts
+#include "includes/metrics.hpp"  // driver_render_dirty_ratio, driver_render_full_repaints_total
+#include <QLoggingCategory>      // Enables the software renderer's flush region output
+#include <QQuickWindow>          // setGraphicsApi(), frameSwapped()
+#include <QRegularExpression>    // Rectangles of a QRegion's debug output
+
+namespace {
+constexpr int SampleIntervalMs = 1000;
+// Share of the window above which a frame counts as a full repaint
+constexpr double FullRepaintShare = 0.95;
+// Seconds of rendered frames without any flush region before giving up on verification
+constexpr int SilentTicksWarn = 5;
+
+// qsgsoftwarerenderer.cpp: qCDebug(lcRenderer) << "render" << m_flushRegion << <timings>
+const char *const RendererCategory = "qt.scenegraph.softwarecontext.renderer";
+const QLatin1String RenderMessagePrefix("render QRegion(");
+
+bool s_software = false;
+std::atomic<RenderProfile *> s_instance{nullptr};
+QtMessageHandler s_previousHandler = nullptr;
+QLoggingCategory::CategoryFilter s_previousFilter = nullptr;
+
+void categoryFilter(QLoggingCategory *category)
+{
+    if (s_previousFilter) {
+        s_previousFilter(category);
+    }
+    if (qstrcmp(category->categoryName(), RendererCategory) == 0) {
+        category->setEnabled(QtDebugMsg, true);
+    }
+}
+
+/**
+ * @brief Area of the rectangles in a QRegion's debug string ("QRegion(x,y wxh)" or
+ *        "QRegion(size=n, bounds=(...) - [(x,y wxh), ...])"; the rectangles don't overlap)
+ */
+qint64 regionArea(const QString &message)
+{
+    static const QRegularExpression rectPattern(QStringLiteral("(-?\\d+),(-?\\d+) (\\d+)x(\\d+)"));
+    qint64 area = 0;
+    int rects = 0;
+    qint64 firstArea = 0;
+    QRegularExpressionMatchIterator it = rectPattern.globalMatch(message);
+    while (it.hasNext()) {
+        QRegularExpressionMatch match = it.next();
+        qint64 rectArea = match.captured(3).toLongLong() * match.captured(4).toLongLong();
+        if (rects++ == 0) {
+            firstArea = rectArea;
+        }
+        area += rectArea;
+    }
+    // Several rectangles are preceded by their bounding rectangle
+    return rects > 1 ? area - firstArea : area;
+}
+}
+
+void RenderProfile::configure()
+{
+    QByteArray profile = qgetenv("DRIVER_UI_PROFILE").trimmed().toLower();
+    if (profile.isEmpty()) {
+        QByteArray backend = qgetenv("QT_QUICK_BACKEND");
+        s_software = backend == "software" || backend == "softwarecontext";
+    } else {
+        s_software = profile == "software";
+        if (!s_software && profile != "default") {
+            LOG_WARN("RenderProfile", "Unknown DRIVER_UI_PROFILE '{}', using default", profile.constData());
+        }
+    }
+
+    if (s_software) {
+        QQuickWindow::setGraphicsApi(QSGRendererInterface::Software);
+    }
+    LOG_INFO("RenderProfile", "UI profile: {}", s_software ? "software" : "default");
+}
+
+RenderProfile::RenderProfile(QObject *parent)
+    : QObject(parent)
+    , m_software(s_software)
+    , m_windowArea(0)
+    , m_swaps(0)
+    , m_regionFrames(0)
+    , m_dirtySharePpm(0)
+    , m_fullRepaints(0)
+    , m_lastSwaps(0)
+    , m_lastRegionFrames(0)
+    , m_lastDirtySharePpm(0)
+    , m_lastFullRepaints(0)
+    , m_silentTicks(0)
+    , m_warnedSilent(false)
+    , m_dirtyPercent(-1.0)
+    , m_fullRepaintPercent(-1.0)
+    , m_partialUpdates(false)
+    , m_dirtyGauge(nullptr)
+    , m_fullRepaintCounter(nullptr)
+{
+    if (!m_software) {
+        return;
+    }
+
+    m_dirtyGauge = &MetricsRegistry::instance().gauge(
+        "driver_render_dirty_ratio", "Mean share of the window repainted per frame (software backend)");
+    m_fullRepaintCounter = &MetricsRegistry::instance().counter(
+        "driver_render_full_repaints_total", "Frames that repainted the whole window (software backend)");
+
+    m_timer.setInterval(SampleIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &RenderProfile::sample);
+
+    // Our handler sits in front of the logger's and only takes the renderer's messages
+    s_instance.store(this);
+    s_previousFilter = QLoggingCategory::installFilter(categoryFilter);
+    s_previousHandler = qInstallMessageHandler(messageHandler);
+}
+
+RenderProfile::~RenderProfile()
+{
+    if (!m_software) {
+        return;
+    }
+    qInstallMessageHandler(s_previousHandler);
+    QLoggingCategory::installFilter(s_previousFilter);
+    s_instance.store(nullptr);
+}
+
+void RenderProfile::trackWindow(QQuickWindow *window)
+{
+    if (!m_software || !window) {
+        return;
+    }
+    m_window = window;
+    updateWindowArea();
+    connect(window, &QWindow::widthChanged, this, &RenderProfile::updateWindowArea);
+    connect(window, &QWindow::heightChanged, this, &RenderProfile::updateWindowArea);
+
+    // Software render loop: the GUI thread (or the render thread with QSG_RENDER_LOOP=threaded)
+    connect(window, &QQuickWindow::frameSwapped, this, [this]() {
+        m_swaps.fetch_add(1, std::memory_order_relaxed);
+    }, Qt::DirectConnection);
+    m_timer.start();
+}
+
+RenderProfile::RepaintStats RenderProfile::repaintStats() const
+{
+    RepaintStats stats;
+    stats.frames = m_regionFrames.load(std::memory_order_relaxed);
+    stats.dirtyShareSum = m_dirtySharePpm.load(std::memory_order_relaxed) / 1e6;
+    stats.fullRepaints = m_fullRepaints.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void RenderProfile::messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    if (context.category && qstrcmp(context.category, RendererCategory) == 0) {
+        if (RenderProfile *profile = s_instance.load()) {
+            profile->onFlushRegion(message);
+        }
+        return;  // One line per frame: never forwarded to the log
+    }
+    if (s_previousHandler) {
+        s_previousHandler(type, context, message);
+    }
+}
+
+/**
+ * @brief Render thread, once per rendered frame
+ */
+void RenderProfile::onFlushRegion(const QString &message)
+{
+    qint64 windowArea = m_windowArea.load(std::memory_order_relaxed);
+    if (windowArea <= 0 || !message.startsWith(RenderMessagePrefix)) {
+        return;
+    }
+    double share = qMin(1.0, double(regionArea(message)) / windowArea);
+    m_dirtySharePpm.fetch_add(qRound64(share * 1e6), std::memory_order_relaxed);
+    if (share >= FullRepaintShare) {
+        m_fullRepaints.fetch_add(1, std::memory_order_relaxed);
+        m_fullRepaintCounter->increment();
+    }
+    // Last, so sample() never sees a frame without its share
+    m_regionFrames.fetch_add(1, std::memory_order_release);
+}
+
+void RenderProfile::updateWindowArea()
+{
+    if (m_window) {
+        m_windowArea.store(qint64(m_window->width()) * m_window->height(), std::memory_order_relaxed);
+    }
+}
+
+void RenderProfile::sample()
+{
+    qint64 regionFrames = m_regionFrames.load(std::memory_order_acquire);
+    qint64 dirtySharePpm = m_dirtySharePpm.load(std::memory_order_relaxed);
+    qint64 fullRepaints = m_fullRepaints.load(std::memory_order_relaxed);
+    qint64 swaps = m_swaps.load(std::memory_order_relaxed);
+
+    qint64 frames = regionFrames - m_lastRegionFrames;
+    qint64 full = fullRepaints - m_lastFullRepaints;
+    qint64 sharePpm = dirtySharePpm - m_lastDirtySharePpm;
+    bool rendered = swaps > m_lastSwaps;
+    m_lastRegionFrames = regionFrames;
+    m_lastFullRepaints = fullRepaints;
+    m_lastDirtySharePpm = dirtySharePpm;
+    m_lastSwaps = swaps;
+
+    if (frames > 0) {
+        m_silentTicks = 0;
+        m_dirtyPercent = double(sharePpm) / frames / 1e4;
+        m_fullRepaintPercent = 100.0 * full / frames;
+        m_dirtyGauge->set(m_dirtyPercent / 100.0);
+
+        // Mostly partial frames; the first frame and resizes are always full
+        bool partial = m_fullRepaintPercent < 50.0;
+        if (partial != m_partialUpdates) {
+            m_partialUpdates = partial;
+            if (partial) {
+                LOG_INFO("RenderProfile", "Partial updates verified: {} % of the window repainted per frame",
+                         qRound(m_dirtyPercent));
+            } else {
+                LOG_WARN("RenderProfile", "Full-window repaints: {} of {} frames in the last second", full, frames);
+            }
+        }
+    } else if (rendered && !m_warnedSilent && ++m_silentTicks >= SilentTicksWarn) {
+        // Qt built with QT_NO_DEBUG_OUTPUT, or a renderer that no longer logs its flush region
+        m_warnedSilent = true;
+        LOG_WARN("RenderProfile", "No flush regions from the software renderer; partial updates not verified");
+    } else {
+        return;  // Idle: keep the last numbers
+    }
+    emit statsChanged();
+}
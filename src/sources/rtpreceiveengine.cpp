@@ -0,0 +1,341 @@
+/**
+ * @file rtpreceiveengine.cpp
+ * @brief Implementation of the native RTP/UDP packet ingest
+ *
+ * Linux: raw sockets with kernel RX timestamps, several per port via SO_REUSEPORT
+ * when sharded, each polled by its own (optionally core-pinned) thread with a short
+ * timeout so stop() is honoured promptly. Other platforms: a single QUdpSocket owned
+ * by the receive thread and read with waitForReadyRead() (user-space timestamps
+ * only, no sharding or pinning); start() waits for the thread to bind it, so
+ * failures are still reported to the caller.
+ */
+
+#include "includes/rtpreceiveengine.hpp"
+#include "includes/timestampedudpsocket.hpp"
+#include "includes/logging.hpp"       // Asynchronous logging from the receive threads
+#include "includes/threadmonitor.hpp"  // Thread names
+#include <QUdpSocket>          // Portable fallback receive path
+#include <cstdio>              // snprintf() for thread names
+#include <memory>              // Receive buffer
+
+#ifdef Q_OS_LINUX
+#include <sys/socket.h>        // socket(), bind(), setsockopt(), getsockname()
+#include <netinet/in.h>        // sockaddr_in
+#include <poll.h>              // poll() with timeout for responsive shutdown
+#include <pthread.h>           // pthread_setaffinity_np()
+#include <sched.h>             // cpu_set_t
+#include <unistd.h>            // close()
+#include <errno.h>
+#include <string.h>            // strerror()
+#endif
+
+namespace {
+// Largest possible UDP payload - RTP/JPEG senders normally stay below the MTU
+constexpr int MaxDatagramSize = 65536;
+// How often the receive loops re-check m_running while idle
+constexpr int PollTimeoutMs = 100;
+// Shared by all engines so several receivers don't pin their threads to the same cores
+std::atomic<int> s_nextCore(0);
+
+/**
+ * @brief Reads the SSRC from an RTP header (bytes 8..11, network order)
+ */
+quint32 rtpSsrc(const char *data, int size)
+{
+    if (size < 12) {
+        return 0;
+    }
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(data);
+    return (quint32(p[8]) << 24) | (quint32(p[9]) << 16) | (quint32(p[10]) << 8) | quint32(p[11]);
+}
+}
+
+RtpReceiveEngine::RtpReceiveEngine()
+    : m_running(false)
+    , m_port(0)
+    , m_kernelTimestamps(false)
+{
+}
+
+RtpReceiveEngine::~RtpReceiveEngine()
+{
+    stop();
+}
+
+bool RtpReceiveEngine::start(quint16 port, PacketSink sink, int receiveBufferSize)
+{
+    Config config;
+    config.port = port;
+    config.receiveBufferSize = receiveBufferSize;
+    return start(config, std::move(sink));
+}
+
+bool RtpReceiveEngine::start(const Config &config, PacketSink sink)
+{
+    stop();
+
+    m_config = config;
+    m_sink = std::move(sink);
+
+#ifdef Q_OS_LINUX
+    int shardCount = qMax(1, config.shards);
+    bool reusePort = shardCount > 1;
+    quint16 port = config.port;
+    bool stamped = true;
+    unsigned int cores = qMax(1u, std::thread::hardware_concurrency());
+
+    // Bind every socket here rather than on the threads so failures are reported to the caller
+    for (int i = 0; i < shardCount; ++i) {
+        qintptr fd = openSocket(port, reusePort);
+        if (fd < 0) {
+            for (auto &shard : m_shards) {
+                ::close(static_cast<int>(shard->fd));
+            }
+            m_shards.clear();
+            return false;
+        }
+
+        // With port 0 the first socket gets a free port from the kernel; the others join it
+        if (port == 0) {
+            sockaddr_in local = {};
+            socklen_t length = sizeof(local);
+            if (::getsockname(static_cast<int>(fd), reinterpret_cast<sockaddr *>(&local), &length) == 0) {
+                port = ntohs(local.sin_port);
+            }
+        }
+
+        auto shard = std::make_unique<Shard>();
+        shard->fd = fd;
+        shard->index = i;
+        shard->core = config.pinThreads ? int(s_nextCore.fetch_add(1) % cores) : -1;
+        stamped = TimestampedUdpSocket::enableKernelTimestamps(fd) && stamped;
+        m_shards.push_back(std::move(shard));
+    }
+    m_port = port;
+    m_kernelTimestamps = stamped;
+#else
+    if (config.shards > 1 || config.pinThreads) {
+        LOG_WARN("RtpReceiveEngine", "Sharding and thread pinning need Linux - using one unpinned receive thread");
+    }
+    auto shard = std::make_unique<Shard>();
+    m_shards.push_back(std::move(shard));
+#endif
+
+    // Each thread reports once its socket is ready (the non-Linux path binds on the thread)
+    std::vector<std::future<bool>> ready;
+    m_running.store(true, std::memory_order_release);
+    for (auto &shard : m_shards) {
+        std::promise<bool> bound;
+        ready.push_back(bound.get_future());
+        shard->thread = std::thread(&RtpReceiveEngine::run, this, shard.get(), std::move(bound));
+    }
+
+    bool started = true;
+    for (auto &result : ready) {
+        started = result.get() && started;
+    }
+    if (!started) {
+        stop();
+        return false;
+    }
+
+    LOG_DEBUG("RtpReceiveEngine", "Listening on port {} - shards: {} - pinned: {} - kernel timestamps: {}",
+              m_port, m_shards.size(), config.pinThreads, m_kernelTimestamps);
+    return true;
+}
+
+void RtpReceiveEngine::stop()
+{
+    m_running.store(false, std::memory_order_release);
+    for (auto &shard : m_shards) {
+        if (shard->thread.joinable()) {
+            shard->thread.join();
+        }
+#ifdef Q_OS_LINUX
+        if (shard->fd >= 0) {
+            ::close(static_cast<int>(shard->fd));
+        }
+#endif
+    }
+    m_shards.clear();
+    m_port = 0;
+    m_kernelTimestamps = false;
+}
+
+qintptr RtpReceiveEngine::openSocket(quint16 port, bool reusePort)
+{
+#ifdef Q_OS_LINUX
+    int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        LOG_WARN("RtpReceiveEngine", "socket() failed: {}", strerror(errno));
+        return -1;
+    }
+
+    // SO_REUSEPORT must be set on every socket of the group before bind(); the
+    // kernel then hashes each flow onto one of them
+    int on = 1;
+    if (reusePort && setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) < 0) {
+        LOG_WARN("RtpReceiveEngine", "SO_REUSEPORT failed: {}", strerror(errno));
+        ::close(fd);
+        return -1;
+    }
+
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &m_config.receiveBufferSize, sizeof(m_config.receiveBufferSize));
+
+    sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    local.sin_port = htons(port);
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (::bind(fd, reinterpret_cast<sockaddr *>(&local), sizeof(local)) < 0) {
+        LOG_WARN("RtpReceiveEngine", "bind() to port {} failed: {}", port, strerror(errno));
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+#else
+    Q_UNUSED(port) Q_UNUSED(reusePort)
+    return -1;
+#endif
+}
+
+RtpReceiveEngine::Stats RtpReceiveEngine::stats() const
+{
+    Stats total;
+    for (int i = 0; i < shardCount(); ++i) {
+        Stats shard = shardStats(i);
+        total.packets += shard.packets;
+        total.bytes += shard.bytes;
+        total.kernelStamped += shard.kernelStamped;
+        total.socketDelaySumNs += shard.socketDelaySumNs;
+        total.socketDelayMaxNs = qMax(total.socketDelayMaxNs, shard.socketDelayMaxNs);
+    }
+    return total;
+}
+
+RtpReceiveEngine::Stats RtpReceiveEngine::shardStats(int index) const
+{
+    Stats stats;
+    if (index < 0 || index >= shardCount()) {
+        return stats;
+    }
+
+    const Shard *shard = m_shards[static_cast<size_t>(index)].get();
+    stats.packets = shard->packets.load(std::memory_order_relaxed);
+    stats.bytes = shard->bytes.load(std::memory_order_relaxed);
+    stats.kernelStamped = shard->kernelStamped.load(std::memory_order_relaxed);
+    stats.socketDelaySumNs = shard->socketDelaySumNs.load(std::memory_order_relaxed);
+    stats.socketDelayMaxNs = shard->socketDelayMaxNs.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void RtpReceiveEngine::account(Shard *shard, int size, qint64 kernelRxNs, qint64 userRxNs)
+{
+    // Single writer per shard: plain load + store is enough for the counters
+    shard->packets.store(shard->packets.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    shard->bytes.store(shard->bytes.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+    if (kernelRxNs >= 0) {
+        qint64 delay = userRxNs - kernelRxNs;
+        shard->kernelStamped.store(shard->kernelStamped.load(std::memory_order_relaxed) + 1,
+                                   std::memory_order_relaxed);
+        shard->socketDelaySumNs.store(shard->socketDelaySumNs.load(std::memory_order_relaxed) + delay,
+                                      std::memory_order_relaxed);
+        if (delay > shard->socketDelayMaxNs.load(std::memory_order_relaxed)) {
+            shard->socketDelayMaxNs.store(delay, std::memory_order_relaxed);
+        }
+    }
+}
+
+void RtpReceiveEngine::run(Shard *shard, std::promise<bool> bound)
+{
+    // One receive buffer per thread, reused for every datagram
+    std::unique_ptr<char[]> buffer(new char[MaxDatagramSize]);
+
+    Packet packet;
+    packet.data = buffer.get();
+    packet.shard = shard->index;
+
+#ifdef Q_OS_LINUX
+    packet.port = m_port;
+
+    // Thread names show up in top/perf/traces, e.g. "rtp-rx5000" or "rtp-rx5000.2"
+    char name[16];
+    if (m_shards.size() > 1) {
+        snprintf(name, sizeof(name), "rtp-rx%u.%d", unsigned(m_port), shard->index);
+    } else {
+        snprintf(name, sizeof(name), "rtp-rx%u", unsigned(m_port));
+    }
+    ThreadMonitor::nameCurrentThread(name);
+
+    if (shard->core >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(shard->core, &cpus);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) {
+            LOG_WARN("RtpReceiveEngine", "Failed to pin the {} receive thread to core {}", name, shard->core);
+        }
+    }
+
+    pollfd pfd;
+    pfd.fd = static_cast<int>(shard->fd);
+    pfd.events = POLLIN;
+    bound.set_value(true);  // Bound by start()
+
+    while (m_running.load(std::memory_order_acquire)) {
+        int ready = ::poll(&pfd, 1, PollTimeoutMs);
+        if (ready <= 0) {
+            continue;  // timeout or EINTR - re-check m_running
+        }
+
+        // Drain everything that is queued before polling again
+        for (;;) {
+            qint64 kernelRxNs = -1;
+            qint64 size = TimestampedUdpSocket::receiveTimestamped(shard->fd, buffer.get(), MaxDatagramSize,
+                                                                   &kernelRxNs);
+            if (size < 0) {
+                break;
+            }
+
+            packet.size = static_cast<int>(size);
+            packet.kernelRxNs = kernelRxNs;
+            packet.userRxNs = TimestampedUdpSocket::wallClockNs();
+            packet.ssrc = rtpSsrc(packet.data, packet.size);
+
+            account(shard, packet.size, packet.kernelRxNs, packet.userRxNs);
+            m_sink(packet);
+        }
+    }
+#else
+    // QUdpSocket must be created on the thread that uses it; start() waits for the result
+    QUdpSocket socket;
+    if (!socket.bind(QHostAddress::AnyIPv4, m_config.port)) {
+        LOG_WARN("RtpReceiveEngine", "bind() to port {} failed: {}", m_config.port, socket.errorString());
+        bound.set_value(false);
+        return;
+    }
+    socket.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, m_config.receiveBufferSize);
+    m_port = socket.localPort();  // Published to start() by the promise
+    packet.port = m_port;
+    bound.set_value(true);
+
+    while (m_running.load(std::memory_order_acquire)) {
+        if (!socket.waitForReadyRead(PollTimeoutMs)) {
+            continue;
+        }
+
+        while (socket.hasPendingDatagrams()) {
+            qint64 size = socket.readDatagram(buffer.get(), MaxDatagramSize);
+            if (size < 0) {
+                break;
+            }
+
+            packet.size = static_cast<int>(size);
+            packet.kernelRxNs = -1;
+            packet.userRxNs = TimestampedUdpSocket::wallClockNs();
+            packet.ssrc = rtpSsrc(packet.data, packet.size);
+
+            account(shard, packet.size, packet.kernelRxNs, packet.userRxNs);
+            m_sink(packet);
+        }
+    }
+#endif
+}
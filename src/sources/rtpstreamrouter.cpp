@@ -0,0 +1,223 @@
+/**
+ * @file rtpstreamrouter.cpp
+ * @brief Implementation of the per-port RTP stream router
+ *
+ * The hot path takes only the receiving shard's own mutex: each shard thread
+ * caches the streams of the SSRCs it has seen. Claim changes (a stream taking
+ * or following an SSRC, a stream being removed) bump a generation counter,
+ * which makes every shard rebuild its cache from the claim table.
+ */
+
+#include "includes/rtpstreamrouter.hpp"
+#include "includes/logging.hpp"       // Claim changes and dropped streams
+#include <QString>             // Hex SSRCs in log messages
+#include <map>                 // Router registry
+#include <thread>              // std::this_thread::yield()
+
+namespace {
+// A stream whose SSRC was silent this long follows a new one (sender restarted)
+constexpr qint64 StreamTimeoutNs = 500000000LL;
+// Distinct SSRCs a shard remembers before starting over
+constexpr size_t MaxCachedRoutes = 32;
+
+// Routers by bound port; an entry stays until its router has released the port
+std::mutex s_registryMutex;
+std::map<quint16, std::weak_ptr<RtpStreamRouter>> s_routers;
+}
+
+std::shared_ptr<RtpStreamRouter> RtpStreamRouter::acquire(const RtpReceiveEngine::Config &config)
+{
+    std::unique_lock<std::mutex> lock(s_registryMutex);
+
+    while (config.port != 0) {
+        auto it = s_routers.find(config.port);
+        if (it == s_routers.end()) {
+            break;
+        }
+        if (std::shared_ptr<RtpStreamRouter> router = it->second.lock()) {
+            if (router->m_engine.shardCount() != qMax(1, config.shards)) {
+                LOG_INFO("RtpStreamRouter", "Port {} already runs {} shard(s) - sharing them", config.port,
+                         router->m_engine.shardCount());
+            }
+            return router;
+        }
+
+        // The last user is releasing the port right now; wait until it is free
+        lock.unlock();
+        std::this_thread::yield();
+        lock.lock();
+    }
+
+    std::shared_ptr<RtpStreamRouter> router(new RtpStreamRouter());
+    for (int i = 0; i < qMax(1, config.shards); ++i) {
+        router->m_routes.push_back(std::make_unique<ShardRoutes>());
+    }
+
+    RtpStreamRouter *target = router.get();
+    if (!router->m_engine.start(config, [target](const Packet &packet) { target->route(packet); })) {
+        return nullptr;
+    }
+
+    s_routers[router->port()] = router;
+    return router;
+}
+
+RtpStreamRouter::RtpStreamRouter()
+    : m_nextId(1)
+    , m_generation(1)  // Caches start at 0, so the first packet of each shard builds one
+    , m_unroutedPackets(0)
+{
+}
+
+RtpStreamRouter::~RtpStreamRouter()
+{
+    // Join the shard threads first: no route() call may outlive the streams
+    quint16 port = m_engine.port();
+    m_engine.stop();
+
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    auto it = s_routers.find(port);
+    if (it != s_routers.end() && it->second.expired()) {
+        s_routers.erase(it);
+    }
+}
+
+int RtpStreamRouter::addStream(PacketSink sink)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto stream = std::make_unique<Stream>();
+    stream->id = m_nextId++;
+    stream->sink = std::move(sink);
+    m_streams.push_back(std::move(stream));
+    return m_streams.back()->id;
+}
+
+void RtpStreamRouter::removeStream(int id)
+{
+    std::unique_ptr<Stream> removed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto it = m_streams.begin(); it != m_streams.end(); ++it) {
+            if ((*it)->id == id) {
+                removed = std::move(*it);
+                m_streams.erase(it);
+                break;
+            }
+        }
+        if (!removed) {
+            return;
+        }
+        m_generation.fetch_add(1, std::memory_order_release);
+    }
+
+    // A shard may be inside the stream's sink; once each shard lock has been taken
+    // once, every later packet sees the new generation and drops its cached pointer
+    for (auto &routes : m_routes) {
+        std::lock_guard<std::mutex> wait(routes->mutex);
+    }
+}
+
+quint32 RtpStreamRouter::streamSsrc(int id) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Stream *stream = findStream(id);
+    return stream ? stream->ssrc.load(std::memory_order_relaxed) : 0;
+}
+
+qint64 RtpStreamRouter::streamPackets(int id) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Stream *stream = findStream(id);
+    return stream ? stream->packets.load(std::memory_order_relaxed) : 0;
+}
+
+RtpStreamRouter::Stream *RtpStreamRouter::findStream(int id) const
+{
+    for (const auto &stream : m_streams) {
+        if (stream->id == id) {
+            return stream.get();
+        }
+    }
+    return nullptr;
+}
+
+void RtpStreamRouter::route(const Packet &packet)
+{
+    ShardRoutes &routes = *m_routes[static_cast<size_t>(packet.shard)];
+    std::lock_guard<std::mutex> lock(routes.mutex);
+
+    quint64 generation = m_generation.load(std::memory_order_acquire);
+    if (routes.generation != generation) {
+        routes.cache.clear();
+        routes.generation = generation;
+    }
+
+    Stream *stream = nullptr;
+    for (const auto &route : routes.cache) {
+        if (route.first == packet.ssrc) {
+            stream = route.second;
+            break;
+        }
+    }
+
+    // Unrouted SSRCs are not cached: they are retried until a stream frees up
+    if (!stream) {
+        stream = resolve(packet.ssrc, packet.userRxNs, &generation);
+        if (!stream) {
+            if (m_unroutedPackets.fetch_add(1, std::memory_order_relaxed) == 0) {
+                LOG_WARN("RtpStreamRouter", "Port {}: dropping RTP stream {} - no receiver is free for it",
+                         m_engine.port(), QString::number(packet.ssrc, 16));
+            }
+            return;
+        }
+        if (routes.generation != generation || routes.cache.size() >= MaxCachedRoutes) {
+            routes.cache.clear();
+            routes.generation = generation;
+        }
+        routes.cache.emplace_back(packet.ssrc, stream);
+    }
+
+    stream->lastNs.store(packet.userRxNs, std::memory_order_relaxed);
+    stream->packets.fetch_add(1, std::memory_order_relaxed);
+    stream->sink(packet);
+}
+
+RtpStreamRouter::Stream *RtpStreamRouter::resolve(quint32 ssrc, qint64 nowNs, quint64 *generation)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Claimed already, or the first stream without a claim, or one whose sender went quiet
+    Stream *idle = nullptr;
+    Stream *silent = nullptr;
+    for (const auto &stream : m_streams) {
+        if (stream->claimed && stream->ssrc.load(std::memory_order_relaxed) == ssrc) {
+            *generation = m_generation.load(std::memory_order_relaxed);
+            return stream.get();
+        }
+        if (!stream->claimed) {
+            idle = idle ? idle : stream.get();
+        } else if (!silent && nowNs - stream->lastNs.load(std::memory_order_relaxed) >= StreamTimeoutNs) {
+            silent = stream.get();
+        }
+    }
+
+    Stream *stream = idle ? idle : silent;
+    if (!stream) {
+        return nullptr;
+    }
+
+    if (stream->claimed) {
+        LOG_INFO("RtpStreamRouter", "Port {}: stream {} follows RTP stream {} (was {})", m_engine.port(), stream->id,
+                 QString::number(ssrc, 16), QString::number(stream->ssrc.load(std::memory_order_relaxed), 16));
+    } else {
+        LOG_DEBUG("RtpStreamRouter", "Port {}: stream {} receives RTP stream {}", m_engine.port(), stream->id,
+                  QString::number(ssrc, 16));
+    }
+    stream->claimed = true;
+    stream->ssrc.store(ssrc, std::memory_order_relaxed);
+    stream->lastNs.store(nowNs, std::memory_order_relaxed);
+
+    // Other shards may still cache the SSRC this stream had before
+    *generation = m_generation.fetch_add(1, std::memory_order_release) + 1;
+    return stream;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file startupprofiler.cpp
+ * @brief Implementation of the startup milestone recorder
+ */
+
+#include "includes/startupprofiler.hpp"
+#include "includes/logging.hpp"  // One line per milestone
+#include "includes/metrics.hpp"  // driver_startup_seconds
+#include "includes/tracing.hpp"  // Milestones as instant events
+#include <QQuickWindow>          // frameSwapped()
+
+#if defined(Q_OS_WIN)
+#include <qt_windows.h>          // GetProcessTimes()
+#elif defined(Q_OS_LINUX)
+#include <QFile>                 // /proc/self/stat
+#include <time.h>                // clock_gettime(CLOCK_BOOTTIME)
+#include <unistd.h>              // sysconf(_SC_CLK_TCK)
+#endif
+
+namespace {
+/**
+ * @brief Milestones exported as metrics (label values must be string literals)
+ */
+struct ExportedMilestone
+{
+    const char *name;
+    const char *labels;
+};
+
+constexpr ExportedMilestone ExportedMilestones[] = {
+    { "qml loaded", "milestone=\"qml_loaded\"" },
+    { "window", "milestone=\"window\"" },
+    { "gstreamer ready", "milestone=\"gstreamer_ready\"" },
+    { "input ready", "milestone=\"input_ready\"" },
+    { "first frame", "milestone=\"first_frame\"" },
+    { "controls live", "milestone=\"controls_live\"" },
+};
+
+MetricGauge &milestoneGauge(const char *labels)
+{
+    return MetricsRegistry::instance().gauge(
+        "driver_startup_seconds", "Time from process start to the startup milestone (0 = not reached)", labels);
+}
+
+/**
+ * @brief Milliseconds between process creation and now, -1 where unsupported
+ */
+double processAgeMs()
+{
+#if defined(Q_OS_WIN)
+    FILETIME creation, exitTime, kernel, user, now;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exitTime, &kernel, &user)) {
+        return -1.0;
+    }
+    GetSystemTimePreciseAsFileTime(&now);
+    auto ticks = [](const FILETIME &time) {  // 100 ns units
+        return (static_cast<qint64>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    };
+    return (ticks(now) - ticks(creation)) / 1e4;
+#elif defined(Q_OS_LINUX)
+    QFile stat(QStringLiteral("/proc/self/stat"));
+    if (!stat.open(QIODevice::ReadOnly)) {
+        return -1.0;
+    }
+    // Fields after the command name (which may contain spaces); starttime is field 22
+    QByteArray line = stat.readAll();
+    QList<QByteArray> fields = line.mid(line.lastIndexOf(')') + 2).split(' ');
+    if (fields.size() < 20) {
+        return -1.0;
+    }
+    double startS = fields.at(19).toDouble() / sysconf(_SC_CLK_TCK);
+    timespec now;
+    clock_gettime(CLOCK_BOOTTIME, &now);
+    return (now.tv_sec + now.tv_nsec / 1e9 - startS) * 1000.0;
+#else
+    return -1.0;
+#endif
+}
+}
+
+StartupProfiler::StartupProfiler(QObject *parent)
+    : QObject(parent)
+    , m_preMainMs(processAgeMs())
+    , m_windowShown(false)
+    , m_onNextFrame(nullptr)
+{
+    m_clock.start();
+    for (const ExportedMilestone &milestone : ExportedMilestones) {
+        milestoneGauge(milestone.labels);  // Register the series before the first scrape
+    }
+    if (m_preMainMs >= 0.0) {
+        LOG_DEBUG("Startup", "Process start -> main: {} ms", qRound(m_preMainMs));
+    }
+}
+
+void StartupProfiler::mark(const char *name)
+{
+    double elapsedMs = m_clock.nsecsElapsed() / 1e6;
+    QString key = QString::fromUtf8(name);
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_milestones.contains(key)) {
+            return;
+        }
+        m_milestones.insert(key, elapsedMs);
+    }
+
+    TRACE_INSTANT(name);
+    LOG_INFO("Startup", "{} after {} ms", name, qRound(elapsedMs));
+    for (const ExportedMilestone &milestone : ExportedMilestones) {
+        if (qstrcmp(milestone.name, name) == 0) {
+            // Exported from process creation so the loader shows up too
+            milestoneGauge(milestone.labels).set((qMax(0.0, m_preMainMs) + elapsedMs) / 1000.0);
+        }
+    }
+
+    // Property notifications belong on the GUI thread (QML bindings)
+    QMetaObject::invokeMethod(this, [this, key, elapsedMs]() {
+        emit milestoneReached(key, elapsedMs);
+    }, Qt::QueuedConnection);
+}
+
+void StartupProfiler::markOnNextFrame(const char *name)
+{
+    m_onNextFrame.store(name, std::memory_order_release);
+}
+
+void StartupProfiler::trackWindow(QQuickWindow *window)
+{
+    if (!window) {
+        return;
+    }
+    // Direct: frameSwapped() comes from the render thread, a queued hop would add a frame
+    connect(window, &QQuickWindow::frameSwapped, this, &StartupProfiler::onFrameSwapped, Qt::DirectConnection);
+}
+
+void StartupProfiler::onFrameSwapped()
+{
+    if (!m_windowShown.exchange(true, std::memory_order_relaxed)) {
+        mark("window");
+    }
+    if (const char *pending = m_onNextFrame.exchange(nullptr, std::memory_order_acq_rel)) {
+        mark(pending);
+    }
+}
+
+double StartupProfiler::milestoneMs(const QString &name) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_milestones.value(name, -1.0);
+}
@@ -9,15 +9,47 @@
  */
 
 #include "includes/steeringcontroller.hpp"
-#include <QDebug>    // Qt logging for debugging output
+#include "includes/logging.hpp"  // Asynchronous logging
 #include <QtMath>    // Qt math utilities (qAbs for absolute value)
+#include <cstring>   // memcpy() for the packed control snapshot
+#include "includes/tracing.hpp"  // Trace scope around each poll
+#include "includes/metrics.hpp"  // Exported input metrics (lock-free)
+#include "includes/threadmonitor.hpp"  // Names the initialization thread
+
+namespace {
+/**
+ * @brief Input metrics, shared by all controllers in the process
+ */
+struct InputMetrics
+{
+    MetricsRegistry &registry = MetricsRegistry::instance();
+    MetricCounter &polls = registry.counter(
+        "driver_input_polls_total", "Joystick polls (input sample rate)");
+    MetricCounter &changes = registry.counter(
+        "driver_input_changes_total", "Polls that changed steering or throttle");
+    MetricHistogram &pollInterval = registry.histogram(
+        "driver_input_poll_interval_seconds", "Time between joystick polls",
+        { 0.004, 0.008, 0.012, 0.016, 0.018, 0.020, 0.025, 0.033, 0.050, 0.100 });
+    MetricGauge &pollJitter = registry.gauge(
+        "driver_input_poll_jitter_seconds", "Smoothed deviation of the poll interval from the timer interval");
+    MetricGauge &connected = registry.gauge(
+        "driver_input_connected", "1 while an input device is open");
+};
+
+InputMetrics &inputMetrics()
+{
+    static InputMetrics metrics;
+    return metrics;
+}
+}
 
 /**
  * @brief Constructor - initializes SDL2 and sets up polling timer
  * @param parent Parent QObject for memory management (follows Qt parent-child pattern)
  *
- * Initializes all member variables, sets up SDL2's joystick subsystem, configures
- * the polling timer for 60Hz updates (~16ms interval), and scans for available devices.
+ * Initializes all member variables and configures the polling timer for 60Hz updates
+ * (~16ms interval). SDL2 and the device scan are left to initializeAsync() or the first
+ * refreshDevices()/connectDevice(), so construction never blocks on input hardware.
  *
  * Default axis mapping:
  * - Axis 0: Steering wheel (left/right)
@@ -29,20 +61,19 @@ SteeringController::SteeringController(QObject *parent)
     , m_pollTimer(new QTimer(this))  // Create polling timer (Qt parent system will delete it)
     , m_steering(0.0)              // Start with centered steering
     , m_throttle(0.0)              // Start with neutral throttle
+    , m_snapshot(0)                // Both 0.0f
     , m_connected(false)           // Not connected to any device initially
     , m_steeringAxis(0)            // Default to axis 0 for steering
     , m_throttleAxis(2)            // Default to axis 2 for throttle (common for pedals)
+    , m_lastPollNs(-1)             // No poll yet
+    , m_pollJitterNs(0.0)
+    , m_ready(false)               // SDL initialized on first use or by initializeAsync()
+    , m_sdlInitialized(false)
 {
-    // Initialize SDL2's joystick subsystem
-    initSDL();
-
     // Setup polling timer to run at 60Hz for smooth input updates
     // 60Hz = 1000ms / 60 ≈ 16.67ms, rounded to 16ms
     m_pollTimer->setInterval(16);
     connect(m_pollTimer, &QTimer::timeout, this, &SteeringController::pollJoystick);
-
-    // Scan for available devices and populate device list
-    updateDeviceList();
 }
 
 /**
@@ -53,25 +84,90 @@ SteeringController::SteeringController(QObject *parent)
  */
 SteeringController::~SteeringController()
 {
+    // A queued finishInitialization() dies with this object; the thread must not outlive it
+    if (m_initThread.joinable()) {
+        m_initThread.join();
+    }
     cleanupSDL();
 }
 
+/**
+ * @brief Runs SDL_InitSubSystem() on a worker thread
+ *
+ * The device list is read on the GUI thread afterwards (cheap once SDL has
+ * probed the devices), so m_availableDevices is only ever touched there.
+ */
+void SteeringController::initializeAsync()
+{
+    if (m_ready || m_initThread.joinable()) {
+        return;
+    }
+    m_initThread = std::thread([this]() {
+        ThreadMonitor::nameCurrentThread("input-init");
+        initSDL();
+        QMetaObject::invokeMethod(this, [this]() { finishInitialization(); }, Qt::QueuedConnection);
+    });
+}
+
+/**
+ * @brief Makes sure SDL is usable from here on, blocking if necessary
+ *
+ * Waits for a running initializeAsync() or initializes on the calling thread.
+ */
+void SteeringController::ensureInitialized()
+{
+    if (m_ready) {
+        return;
+    }
+    if (m_initThread.joinable()) {
+        m_initThread.join();
+    } else {
+        initSDL();
+    }
+    finishInitialization();
+}
+
+void SteeringController::finishInitialization()
+{
+    if (m_initThread.joinable()) {
+        m_initThread.join();
+    }
+    if (m_ready) {
+        return;  // ensureInitialized() got here first
+    }
+    m_ready = true;
+    updateDeviceList();
+    emit readyChanged();
+}
+
 /**
  * @brief Initializes SDL2's joystick subsystem
  *
- * Called in constructor to set up SDL2. Only initializes the joystick subsystem,
- * not video, audio, or other SDL2 features. Logs error if initialization fails.
+ * Called on first use or on the initialization thread to set up SDL2. Only initializes
+ * the joystick subsystem, not video, audio, or other SDL2 features. Logs error if
+ * initialization fails.
  *
  * Note: SDL_InitSubSystem is safe to call multiple times - it will only initialize once.
  */
-void SteeringController::initSDL()
+bool SteeringController::initSDL()
 {
+    TRACE_SCOPE("sdl_init");
+#ifdef SDL_HINT_JOYSTICK_THREAD
+    // Device notifications get their own thread instead of a hidden window on the
+    // initializing thread, which would otherwise have to keep pumping messages
+    SDL_SetHint(SDL_HINT_JOYSTICK_THREAD, "1");
+#endif
+
     // Initialize only the joystick subsystem (we don't need video, audio, etc.)
+    QElapsedTimer clock;
+    clock.start();
     if (SDL_InitSubSystem(SDL_INIT_JOYSTICK) < 0) {
-        qWarning() << "Failed to initialize SDL joystick:" << SDL_GetError();
-        return;
+        LOG_WARN("SteeringController", "Failed to initialize SDL joystick: {}", SDL_GetError());
+        return false;
     }
-    qDebug() << "SDL Joystick initialized";
+    m_sdlInitialized.store(true);
+    LOG_DEBUG("SteeringController", "SDL Joystick initialized in {} ms", clock.elapsed());
+    return true;
 }
 
 /**
@@ -84,8 +180,10 @@ void SteeringController::cleanupSDL()
 {
     // Close any open joystick first
     closeJoystick();
-    // Shut down SDL's joystick subsystem
-    SDL_QuitSubSystem(SDL_INIT_JOYSTICK);
+    // Shut down SDL's joystick subsystem (balances a successful SDL_InitSubSystem only)
+    if (m_sdlInitialized.exchange(false)) {
+        SDL_QuitSubSystem(SDL_INIT_JOYSTICK);
+    }
 }
 
 /**
@@ -124,17 +222,21 @@ void SteeringController::updateDeviceList()
 
     // Notify QML that the device list has changed
     emit availableDevicesChanged();
-    qDebug() << "Found" << numJoysticks << "joystick devices";
+    LOG_DEBUG("SteeringController", "Found {} joystick devices", numJoysticks);
 }
 
 /**
  * @brief Public method to refresh the list of available devices
  *
  * Called from QML when user wants to rescan for devices (e.g., after plugging
- * in a new controller). Simply delegates to updateDeviceList().
+ * in a new controller). Initializes SDL first if that hasn't happened yet.
  */
 void SteeringController::refreshDevices()
 {
+    if (!m_ready) {
+        ensureInitialized();  // Scans the devices as part of initialization
+        return;
+    }
     updateDeviceList();
 }
 
@@ -148,9 +250,11 @@ void SteeringController::refreshDevices()
  */
 void SteeringController::connectDevice(int index)
 {
+    ensureInitialized();
+
     // Validate that index is within bounds of device list
     if (index < 0 || index >= static_cast<int>(m_deviceIndices.size())) {
-        qWarning() << "Invalid device index:" << index;
+        LOG_WARN("SteeringController", "Invalid device index: {}", index);
         return;
     }
 
@@ -187,7 +291,7 @@ void SteeringController::openJoystick(int sdlIndex)
     // Attempt to open the joystick device
     m_joystick = SDL_JoystickOpen(sdlIndex);
     if (!m_joystick) {
-        qWarning() << "Failed to open joystick:" << SDL_GetError();
+        LOG_WARN("SteeringController", "Failed to open joystick: {}", SDL_GetError());
         m_connected = false;
         emit connectedChanged();
         return;
@@ -198,15 +302,19 @@ void SteeringController::openJoystick(int sdlIndex)
     m_connected = true;
 
     // Log connection success and device capabilities
-    qDebug() << "Connected to:" << m_deviceName;
-    qDebug() << "Axes:" << SDL_JoystickNumAxes(m_joystick);
-    qDebug() << "Buttons:" << SDL_JoystickNumButtons(m_joystick);
+    LOG_DEBUG("SteeringController", "Connected to: {}", m_deviceName);
+    LOG_DEBUG("SteeringController", "Axes: {}", SDL_JoystickNumAxes(m_joystick));
+    LOG_DEBUG("SteeringController", "Buttons: {}", SDL_JoystickNumButtons(m_joystick));
 
     // Notify QML of connection state and device name changes
     emit connectedChanged();
     emit deviceNameChanged();
 
     // Start polling the joystick for input
+    m_pollClock.start();
+    m_lastPollNs = -1;
+    m_pollJitterNs = 0.0;
+    inputMetrics().connected.set(1);
     m_pollTimer->start();
 }
 
@@ -233,9 +341,11 @@ void SteeringController::closeJoystick()
 
     // Reset connection state and all input values
     m_connected = false;
+    inputMetrics().connected.set(0);
     m_deviceName.clear();
     m_steering = 0.0;
     m_throttle = 0.0;
+    publishSnapshot();
 
     // Notify QML of all property changes
     emit connectedChanged();
@@ -263,6 +373,21 @@ void SteeringController::pollJoystick()
 {
     // Only poll if joystick is actually connected
     if (!m_joystick) return;
+    TRACE_SCOPE("pollJoystick");
+
+    // Sample rate and jitter of the poll loop itself
+    InputMetrics &metrics = inputMetrics();
+    qint64 nowNs = m_pollClock.nsecsElapsed();
+    metrics.polls.increment();
+    if (m_lastPollNs >= 0) {
+        qint64 intervalNs = nowNs - m_lastPollNs;
+        metrics.pollInterval.observeNs(intervalNs);
+        double deviationNs = qAbs(double(intervalNs) - m_pollTimer->interval() * 1e6);
+        m_pollJitterNs += (deviationNs - m_pollJitterNs) / 16.0;
+        metrics.pollJitter.set(m_pollJitterNs / 1e9);
+    }
+    m_lastPollNs = nowNs;
+    bool changed = false;
 
     // Update SDL's internal joystick state (reads latest values from device)
     SDL_JoystickUpdate();
@@ -281,6 +406,7 @@ void SteeringController::pollJoystick()
         // Only emit signal if value changed significantly (avoids noise/jitter)
         if (qAbs(newSteering - m_steering) > 0.001) {
             m_steering = newSteering;
+            changed = true;
             emit steeringChanged();
         }
     }
@@ -301,9 +427,40 @@ void SteeringController::pollJoystick()
         // Only emit signal if value changed significantly
         if (qAbs(newThrottle - m_throttle) > 0.001) {
             m_throttle = newThrottle;
+            changed = true;
             emit throttleChanged();
         }
     }
+
+    if (changed) {
+        publishSnapshot();
+        metrics.changes.increment();
+    }
+}
+
+/**
+ * @brief Packs steering and throttle into one 64-bit word
+ *
+ * A single atomic store/load keeps the pair consistent without a lock, so the
+ * render thread never sees the steering of one poll with the throttle of another.
+ */
+void SteeringController::publishSnapshot()
+{
+    float values[2] = { static_cast<float>(m_steering), static_cast<float>(m_throttle) };
+    quint64 packed;
+    std::memcpy(&packed, values, sizeof(packed));
+    m_snapshot.store(packed, std::memory_order_release);
+}
+
+SteeringController::ControlSnapshot SteeringController::snapshot() const
+{
+    quint64 packed = m_snapshot.load(std::memory_order_acquire);
+    float values[2];
+    std::memcpy(values, &packed, sizeof(values));
+    ControlSnapshot result;
+    result.steering = values[0];
+    result.throttle = values[1];
+    return result;
 }
 
 /**
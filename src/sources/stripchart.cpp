@@ -0,0 +1,455 @@
+/**
+ * @file stripchart.cpp
+ * @brief Implementation of the scene graph strip chart
+ */
+
+#include "includes/stripchart.hpp"
+#include "includes/steeringcontroller.hpp"  // Steering / throttle sources
+#include "includes/metrics.hpp"             // RTT / frame age sources
+#include "includes/tracing.hpp"             // updatePaintNode() scope
+#include <QPainter>                         // Software backend drawing
+#include <QQuickWindow>                     // Graphics API, painter of the software backend
+#include <QSGFlatColorMaterial>             // Line color
+#include <QSGGeometryNode>                  // Vertex ring
+#include <QSGRenderNode>                    // Software backend fallback
+#include <QSGTransformNode>                 // Scrolling and value scaling
+#include <limits>                           // "Nothing dirty" marker
+
+namespace {
+constexpr double DefaultWindowSeconds = 30.0;
+constexpr int MetricSampleIntervalMs = 50;
+constexpr int MinScrollIntervalMs = 16;
+constexpr qint64 NothingDirty = std::numeric_limits<qint64>::max();
+
+// Per ring index: connector from the previous column, then the column's min -> max
+constexpr int VerticesPerColumn = 4;
+
+/**
+ * @brief Transform node with the line geometry below it (RHI backends)
+ *
+ * The geometry holds every column twice (ring slot s at index s and s + N), so
+ * the newest N columns are always one contiguous index range; the matrix maps
+ * (index, value) to item coordinates and the item clips the rest.
+ */
+struct StripChartNode : public QSGTransformNode
+{
+    QSGGeometryNode *line = nullptr;
+    int columns = 0;
+};
+
+/**
+ * @brief The software backend draws no custom geometry: the same lines through QPainter
+ */
+class StripChartPainterNode : public QSGRenderNode
+{
+public:
+    explicit StripChartPainterNode(QQuickWindow *window) : m_window(window) {}
+
+    void render(const RenderState *state) override
+    {
+        auto *painter = static_cast<QPainter *>(
+            m_window->rendererInterface()->getResource(m_window, QSGRendererInterface::PainterResource));
+        if (!painter) {
+            return;
+        }
+        const QRegion *clipRegion = state->clipRegion();
+        if (clipRegion && !clipRegion->isEmpty()) {
+            painter->setClipRegion(*clipRegion, Qt::ReplaceClip);  // Before setTransform()
+        }
+        painter->setTransform(matrix()->toTransform());
+        painter->setOpacity(inheritedOpacity());
+        painter->setPen(QPen(color, 0));
+        painter->drawLines(lines);
+    }
+
+    StateFlags changedStates() const override { return {}; }
+    RenderingFlags flags() const override { return BoundedRectRendering; }
+    QRectF rect() const override { return bounds; }
+
+    QVector<QLineF> lines;
+    QColor color;
+    QRectF bounds;
+
+private:
+    QQuickWindow *m_window;
+};
+
+void setVertex(QSGGeometry::Point2D *vertex, float x, float y)
+{
+    vertex->x = x;
+    vertex->y = y;
+}
+}
+
+StripChart::StripChart(QQuickItem *parent)
+    : QQuickItem(parent)
+    , m_source(Custom)
+    , m_windowSeconds(DefaultWindowSeconds)
+    , m_minimum(0.0)
+    , m_maximum(1.0)
+    , m_color(Qt::green)
+    , m_colorDirty(true)
+    , m_columnNs(1)
+    , m_headColumn(-1)
+    , m_dirtyFromColumn(NothingDirty)
+    , m_rebuild(true)
+    , m_hasValue(false)
+    , m_lastValue(0.0)
+    , m_valueNotified(true)
+{
+    setFlag(ItemHasContents, true);
+    setClip(true);  // Hides the other half of the mirrored ring and out-of-range values
+    setImplicitSize(300.0, 60.0);
+    m_clock.start();
+
+    connect(&m_scrollTimer, &QTimer::timeout, this, &StripChart::scroll);
+    m_metricTimer.setInterval(MetricSampleIntervalMs);
+    connect(&m_metricTimer, &QTimer::timeout, this, &StripChart::sampleMetrics);
+}
+
+void StripChart::setSource(Source source)
+{
+    if (m_source == source) {
+        return;
+    }
+    m_source = source;
+    connectSource();
+    emit sourceChanged();
+}
+
+void StripChart::setController(SteeringController *controller)
+{
+    if (m_controller == controller) {
+        return;
+    }
+    m_controller = controller;
+    connectSource();
+    emit controllerChanged();
+}
+
+void StripChart::setWindowSeconds(double seconds)
+{
+    seconds = qMax(0.1, seconds);
+    if (qFuzzyCompare(m_windowSeconds, seconds)) {
+        return;
+    }
+    m_windowSeconds = seconds;
+    resetColumns();
+    emit windowSecondsChanged();
+}
+
+void StripChart::setMinimum(double minimum)
+{
+    if (qFuzzyCompare(m_minimum, minimum)) {
+        return;
+    }
+    m_minimum = minimum;
+    update();  // Only the matrix changes
+    emit rangeChanged();
+}
+
+void StripChart::setMaximum(double maximum)
+{
+    if (qFuzzyCompare(m_maximum, maximum)) {
+        return;
+    }
+    m_maximum = maximum;
+    update();
+    emit rangeChanged();
+}
+
+void StripChart::setColor(const QColor &color)
+{
+    if (m_color == color) {
+        return;
+    }
+    m_color = color;
+    m_colorDirty = true;
+    update();
+    emit colorChanged();
+}
+
+void StripChart::connectSource()
+{
+    disconnect(m_sourceConnection);
+    m_metricTimer.stop();
+
+    switch (m_source) {
+    case Steering:
+        if (m_controller) {
+            m_sourceConnection = connect(m_controller, &SteeringController::steeringChanged, this, [this]() {
+                append(m_controller->steering());
+            });
+        }
+        break;
+    case Throttle:
+        if (m_controller) {
+            m_sourceConnection = connect(m_controller, &SteeringController::throttleChanged, this, [this]() {
+                append(m_controller->throttle());
+            });
+        }
+        break;
+    case ControlRtt:
+    case FrameAge:
+        // Start from the current totals, not the mean since process start
+        takeHistogramMeanMs("driver_control_rtt_seconds", "path=\"ws\"", m_rttSumNs, m_rttCount);
+        takeHistogramMeanMs("driver_video_rx_to_appsink_seconds", "", m_decodeSumNs, m_decodeCount);
+        takeHistogramMeanMs("driver_video_appsink_to_gui_seconds", "", m_handoffSumNs, m_handoffCount);
+        if (isVisible()) {
+            m_metricTimer.start();
+        }
+        break;
+    case Custom:
+        break;
+    }
+}
+
+double StripChart::takeHistogramMeanMs(const char *name, const char *labels, qint64 &lastSumNs, quint64 &lastCount)
+{
+    const MetricHistogram *histogram = MetricsRegistry::instance().findHistogram(name, labels);
+    if (!histogram) {
+        return -1.0;
+    }
+    quint64 count = histogram->count();
+    qint64 sumNs = histogram->sumNs();
+    quint64 deltaCount = count - lastCount;
+    qint64 deltaSumNs = sumNs - lastSumNs;
+    lastCount = count;
+    lastSumNs = sumNs;
+    return deltaCount > 0 ? (double(deltaSumNs) / deltaCount) / 1e6 : -1.0;
+}
+
+void StripChart::sampleMetrics()
+{
+    if (m_source == ControlRtt) {
+        double rttMs = takeHistogramMeanMs("driver_control_rtt_seconds", "path=\"ws\"", m_rttSumNs, m_rttCount);
+        if (rttMs >= 0.0) {
+            append(rttMs);
+        }
+    } else if (m_source == FrameAge) {
+        // Same composition as PerformanceStats::frameAgeMs (decode part missing with udpsrc)
+        double decodeMs = takeHistogramMeanMs("driver_video_rx_to_appsink_seconds", "", m_decodeSumNs, m_decodeCount);
+        double handoffMs = takeHistogramMeanMs("driver_video_appsink_to_gui_seconds", "", m_handoffSumNs, m_handoffCount);
+        if (handoffMs >= 0.0) {
+            append(decodeMs >= 0.0 ? decodeMs + handoffMs : handoffMs);
+        }
+    }
+}
+
+void StripChart::append(double value)
+{
+    m_lastValue = value;
+    m_hasValue = true;
+    m_valueNotified = false;
+    if (m_columns.empty()) {
+        return;  // No size yet; resetColumns() starts from the held value
+    }
+
+    qint64 column = m_clock.nsecsElapsed() / m_columnNs;
+    advanceTo(column);
+    Column &slot = m_columns[column % qint64(m_columns.size())];
+    float sample = float(value);
+    if (!slot.valid) {
+        slot.first = slot.minimum = slot.maximum = sample;
+        slot.valid = true;
+    } else {
+        slot.minimum = qMin(slot.minimum, sample);
+        slot.maximum = qMax(slot.maximum, sample);
+    }
+    m_dirtyFromColumn = qMin(m_dirtyFromColumn, column);
+    update();  // Coalesced: however many samples, one paint per frame
+}
+
+void StripChart::advanceTo(qint64 column)
+{
+    if (column <= m_headColumn) {
+        return;
+    }
+    // New columns start as the held last value; after a gap longer than the ring
+    // every slot is rewritten once
+    qint64 size = qint64(m_columns.size());
+    qint64 from = m_headColumn < 0 ? column : qMax(m_headColumn + 1, column - size + 1);
+    float held = float(m_lastValue);
+    for (qint64 c = from; c <= column; ++c) {
+        Column &slot = m_columns[c % size];
+        slot.first = slot.minimum = slot.maximum = held;
+        slot.valid = m_hasValue;
+    }
+    m_dirtyFromColumn = qMin(m_dirtyFromColumn, from);
+    m_headColumn = column;
+}
+
+void StripChart::scroll()
+{
+    if (!m_columns.empty()) {
+        qint64 head = m_headColumn;
+        advanceTo(m_clock.nsecsElapsed() / m_columnNs);
+        if (m_headColumn != head) {
+            update();
+        }
+    }
+    if (!m_valueNotified) {
+        m_valueNotified = true;
+        emit valueChanged();
+    }
+}
+
+void StripChart::resetColumns()
+{
+    int columns = qMax(2, qFloor(width()));
+    m_columns.assign(columns, Column());
+    m_columnNs = qMax<qint64>(1, qint64(m_windowSeconds * 1e9 / columns));
+    m_headColumn = -1;
+    if (m_hasValue) {
+        advanceTo(m_clock.nsecsElapsed() / m_columnNs);
+    }
+    m_rebuild = true;
+    m_scrollTimer.setInterval(qMax<int>(MinScrollIntervalMs, int(m_columnNs / 1000000)));
+    if (isVisible()) {
+        m_scrollTimer.start();
+    }
+    update();
+}
+
+void StripChart::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (qFloor(newGeometry.width()) != qFloor(oldGeometry.width()) || m_columns.empty()) {
+        resetColumns();
+    } else if (newGeometry.height() != oldGeometry.height()) {
+        update();  // Matrix only
+    }
+}
+
+void StripChart::itemChange(ItemChange change, const ItemChangeData &value)
+{
+    QQuickItem::itemChange(change, value);
+    if (change != ItemVisibleHasChanged) {
+        return;
+    }
+    // Hidden charts neither scroll nor poll metrics; input sources still append (O(1))
+    if (value.boolValue) {
+        if (!m_columns.empty()) {
+            m_scrollTimer.start();
+        }
+        if (m_source == ControlRtt || m_source == FrameAge) {
+            m_metricTimer.start();
+        }
+    } else {
+        m_scrollTimer.stop();
+        m_metricTimer.stop();
+    }
+}
+
+/**
+ * @brief Runs on the render thread with the GUI thread blocked; writes only dirty columns
+ */
+QSGNode *StripChart::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    TRACE_SCOPE("StripChart::updatePaintNode");
+    int size = int(m_columns.size());
+    if (size == 0 || width() <= 0.0 || height() <= 0.0) {
+        delete oldNode;
+        return nullptr;
+    }
+
+    double columnWidth = width() / size;
+    double range = m_maximum - m_minimum;
+    double yScale = qFuzzyIsNull(range) ? 0.0 : height() / range;
+    qint64 firstColumn = m_headColumn - size + 1;  // Shown at the left edge
+
+    // Software backend: rebuild the (few hundred) lines in item coordinates
+    if (window()->rendererInterface()->graphicsApi() == QSGRendererInterface::Software) {
+        auto *node = static_cast<StripChartPainterNode *>(oldNode);
+        if (!node) {
+            node = new StripChartPainterNode(window());
+        }
+        node->bounds = boundingRect();
+        node->color = m_color;
+        node->lines.clear();
+        auto y = [&](float value) { return height() - (value - m_minimum) * yScale; };
+        for (qint64 c = qMax<qint64>(0, firstColumn); c <= m_headColumn; ++c) {
+            const Column &slot = m_columns[c % size];
+            if (!slot.valid) {
+                continue;
+            }
+            double x = (c - firstColumn) * columnWidth;
+            node->lines.append(QLineF(x - columnWidth, y(slot.first), x, y(slot.first)));
+            node->lines.append(QLineF(x, y(slot.minimum), x, y(slot.maximum)));
+        }
+        node->markDirty(QSGNode::DirtyMaterial);
+        m_dirtyFromColumn = NothingDirty;
+        m_rebuild = false;
+        return node;
+    }
+
+    auto *node = static_cast<StripChartNode *>(oldNode);
+    if (!node) {
+        node = new StripChartNode;
+        node->line = new QSGGeometryNode;
+        auto *material = new QSGFlatColorMaterial;
+        node->line->setMaterial(material);
+        node->line->setFlag(QSGNode::OwnsMaterial);
+        node->line->setFlag(QSGNode::OwnsGeometry);
+        node->appendChildNode(node->line);
+        m_rebuild = true;
+        m_colorDirty = true;
+    }
+
+    if (m_rebuild || node->columns != size) {
+        auto *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 2 * size * VerticesPerColumn);
+        geometry->setDrawingMode(QSGGeometry::DrawLines);
+        geometry->setLineWidth(1.0f);
+        geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
+        node->line->setGeometry(geometry);  // Deletes the old one (OwnsGeometry)
+        node->columns = size;
+        m_rebuild = false;
+        m_dirtyFromColumn = qMin<qint64>(m_dirtyFromColumn, qMax<qint64>(0, firstColumn));
+        // Slots never written stay degenerate (zero-length lines draw nothing)
+        QSGGeometry::Point2D *vertices = geometry->vertexDataAsPoint2D();
+        for (int i = 0; i < geometry->vertexCount(); ++i) {
+            setVertex(vertices + i, float(i / VerticesPerColumn), 0.0f);
+        }
+    }
+
+    if (m_colorDirty) {
+        m_colorDirty = false;
+        static_cast<QSGFlatColorMaterial *>(node->line->material())->setColor(m_color);
+        node->line->markDirty(QSGNode::DirtyMaterial);
+    }
+
+    // Rewrite the columns that changed since the last frame, both mirror copies
+    if (m_dirtyFromColumn <= m_headColumn) {
+        QSGGeometry::Point2D *vertices = node->line->geometry()->vertexDataAsPoint2D();
+        for (qint64 c = qMax(m_dirtyFromColumn, qMax<qint64>(0, firstColumn)); c <= m_headColumn; ++c) {
+            const Column &slot = m_columns[c % size];
+            int slotIndex = int(c % size);
+            for (int index : { slotIndex, slotIndex + size }) {
+                QSGGeometry::Point2D *v = vertices + index * VerticesPerColumn;
+                float x = float(index);
+                if (slot.valid) {
+                    setVertex(v + 0, x - 1.0f, slot.first);
+                    setVertex(v + 1, x, slot.first);
+                    setVertex(v + 2, x, slot.minimum);
+                    setVertex(v + 3, x, slot.maximum);
+                } else {
+                    for (int i = 0; i < VerticesPerColumn; ++i) {
+                        setVertex(v + i, x, 0.0f);
+                    }
+                }
+            }
+        }
+        node->line->markDirty(QSGNode::DirtyGeometry);
+    }
+    m_dirtyFromColumn = NothingDirty;
+
+    // Newest column (mirror copy at slot + N) at the right edge; values scaled into the height
+    qint64 headIndex = m_headColumn % size + size;
+    double xOffset = -(headIndex - size + 1) * columnWidth;
+    QMatrix4x4 matrix(float(columnWidth), 0.0f, 0.0f, float(xOffset),
+                      0.0f, float(-yScale), 0.0f, float(height() + m_minimum * yScale),
+                      0.0f, 0.0f, 1.0f, 0.0f,
+                      0.0f, 0.0f, 0.0f, 1.0f);
+    node->setMatrix(matrix);
+    return node;
+}
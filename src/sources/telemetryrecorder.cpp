@@ -0,0 +1,170 @@
+/**
+ * @file telemetryrecorder.cpp
+ * @brief Implementation of the session telemetry recorder
+ */
+
+#include "includes/telemetryrecorder.hpp"
+#include "includes/steeringcontroller.hpp"  // Input series
+#include "includes/logging.hpp"             // Budget, export
+#include "includes/metrics.hpp"             // Latency series
+#include <QFile>                            // CSV export
+#include <QPointF>                          // Query points
+#include <limits>                           // Whole-series export window
+
+namespace {
+constexpr int SampleIntervalMs = 100;
+constexpr size_t DefaultBudgetMb = 64;
+constexpr qint64 CsvFlushBytes = 1 << 20;
+
+size_t budgetBytes()
+{
+    int mb = qEnvironmentVariableIntValue("DRIVER_TELEMETRY_MB");
+    return size_t(mb > 0 ? mb : DefaultBudgetMb) * 1024 * 1024;
+}
+}
+
+double TelemetryRecorder::HistogramSeries::takeMeanMs()
+{
+    if (!histogram) {
+        histogram = MetricsRegistry::instance().findHistogram(name, labels);
+        if (!histogram) {
+            return -1.0;
+        }
+        lastSumNs = histogram->sumNs();
+        lastCount = histogram->count();
+    }
+    // Count before sum, as in PerformanceStats
+    quint64 count = histogram->count();
+    qint64 sumNs = histogram->sumNs();
+    quint64 deltaCount = count - lastCount;
+    qint64 deltaSumNs = sumNs - lastSumNs;
+    lastCount = count;
+    lastSumNs = sumNs;
+    return deltaCount > 0 ? (double(deltaSumNs) / deltaCount) / 1e6 : -1.0;
+}
+
+TelemetryRecorder::TelemetryRecorder(QObject *parent)
+    : QObject(parent)
+    , m_store(budgetBytes())
+    , m_steering(-1)
+    , m_throttle(-1)
+    , m_frameAge(-1)
+    , m_controlRtt{"driver_control_rtt_seconds", "path=\"ws\"", -1}
+    , m_rxToAppsink{"driver_video_rx_to_appsink_seconds", "", -1}
+    , m_appsinkToGui{"driver_video_appsink_to_gui_seconds", "", -1}
+    , m_swapLatency{"driver_swap_latency_seconds", "", -1}
+{
+    // All series up front, so each gets its share of the budget from the start
+    m_steering = m_store.addSeries("steering");
+    m_throttle = m_store.addSeries("throttle");
+    m_controlRtt.series = m_store.addSeries("control_rtt_ms");
+    m_frameAge = m_store.addSeries("frame_age_ms");  // Decode + hand-off, like the HUD's
+    m_swapLatency.series = m_store.addSeries("swap_latency_ms");
+
+    m_clock.start();
+    m_timer.setInterval(SampleIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &TelemetryRecorder::sampleMetrics);
+    m_timer.start();
+    LOG_INFO("Telemetry", "Recording {} series, up to {} MB", m_store.seriesNames().size(), budgetBytes() / (1024 * 1024));
+}
+
+TelemetryRecorder::~TelemetryRecorder()
+{
+    if (qEnvironmentVariableIsSet("DRIVER_TELEMETRY_CSV")) {
+        exportCsv(qEnvironmentVariable("DRIVER_TELEMETRY_CSV"));
+    }
+}
+
+void TelemetryRecorder::recordController(SteeringController *controller)
+{
+    if (m_controller) {
+        disconnect(m_controller, nullptr, this, nullptr);
+    }
+    m_controller = controller;
+    if (!controller) {
+        return;
+    }
+    connect(controller, &SteeringController::steeringChanged, this, [this]() {
+        m_store.append(m_steering, nowUs(), float(m_controller->steering()));
+    });
+    connect(controller, &SteeringController::throttleChanged, this, [this]() {
+        m_store.append(m_throttle, nowUs(), float(m_controller->throttle()));
+    });
+}
+
+void TelemetryRecorder::sampleMetrics()
+{
+    qint64 timeUs = nowUs();
+    double rttMs = m_controlRtt.takeMeanMs();
+    if (rttMs >= 0.0) {
+        m_store.append(m_controlRtt.series, timeUs, float(rttMs));
+    }
+    double decodeMs = m_rxToAppsink.takeMeanMs();
+    double handoffMs = m_appsinkToGui.takeMeanMs();
+    if (handoffMs >= 0.0) {
+        m_store.append(m_frameAge, timeUs, float(decodeMs >= 0.0 ? decodeMs + handoffMs : handoffMs));
+    }
+    double swapMs = m_swapLatency.takeMeanMs();
+    if (swapMs >= 0.0) {
+        m_store.append(m_swapLatency.series, timeUs, float(swapMs));
+    }
+    emit sampled();
+}
+
+QVariantList TelemetryRecorder::query(const QString &series, double fromSeconds, double toSeconds, int points) const
+{
+    QVariantList result;
+    int index = m_store.seriesIndex(series);
+    if (index < 0) {
+        LOG_WARN("Telemetry", "Unknown series '{}'", series);
+        return result;
+    }
+    std::vector<TimeSeriesStore::Point> reduced =
+        m_store.query(index, qint64(fromSeconds * 1e6), qint64(toSeconds * 1e6), points);
+    result.reserve(int(reduced.size()));
+    for (const TimeSeriesStore::Point &point : reduced) {
+        result.append(QPointF(point.timeUs / 1e6, point.value));
+    }
+    return result;
+}
+
+QVariantList TelemetryRecorder::recent(const QString &series, double seconds, int points) const
+{
+    double end = now();
+    return query(series, end - seconds, end, points);
+}
+
+bool TelemetryRecorder::exportCsv(const QString &path) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        LOG_ERROR("Telemetry", "Cannot write {}: {}", path, file.errorString());
+        return false;
+    }
+
+    QByteArray buffer("series,time_s,value\n");
+    quint64 rows = 0;
+    const QStringList names = m_store.seriesNames();
+    for (int index = 0; index < names.size(); ++index) {
+        QByteArray prefix = names.at(index).toUtf8() + ',';
+        m_store.forEach(index, 0, std::numeric_limits<qint64>::max() - 1, [&](const TimeSeriesStore::Point &point) {
+            buffer += prefix;
+            buffer += QByteArray::number(point.timeUs / 1e6, 'f', 6);
+            buffer += ',';
+            buffer += QByteArray::number(point.value, 'g', 7);
+            buffer += '\n';
+            ++rows;
+            if (buffer.size() >= CsvFlushBytes) {
+                file.write(buffer);
+                buffer.clear();
+            }
+        });
+    }
+    file.write(buffer);
+    if (file.error() != QFileDevice::NoError) {
+        LOG_ERROR("Telemetry", "Writing {} failed: {}", path, file.errorString());
+        return false;
+    }
+    LOG_INFO("Telemetry", "Exported {} samples to {}", rows, path);
+    return true;
+}
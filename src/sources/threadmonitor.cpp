@@ -0,0 +1,208 @@
+/**
+ * @file threadmonitor.cpp
+ * @brief Implementation of the /proc based per-thread scheduling statistics
+ */
+
+#include "includes/threadmonitor.hpp"
+#include "includes/tracing.hpp"  // Samples as trace counters
+#include <QDir>                  // /proc/self/task listing
+#include <QFile>                 // stat / schedstat
+#include <QVariantMap>
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <pthread.h>             // pthread_setname_np()
+#include <unistd.h>              // getpid(), sysconf()
+#endif
+
+namespace {
+constexpr int DefaultIntervalMs = 1000;
+// pthread names are limited to 16 bytes including the terminator
+constexpr size_t MaxThreadNameLength = 15;
+}
+
+ThreadMonitor::ThreadMonitor(QObject *parent)
+    : QObject(parent)
+    , m_lastSampleNs(0)
+    , m_processCpuPercent(0.0)
+{
+    m_clock.start();
+    m_timer.setInterval(DefaultIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &ThreadMonitor::sample);
+}
+
+void ThreadMonitor::nameCurrentThread(const char *name)
+{
+#ifdef Q_OS_LINUX
+    char truncated[MaxThreadNameLength + 1] = {};
+    qstrncpy(truncated, name, sizeof(truncated));
+    pthread_setname_np(pthread_self(), truncated);
+#else
+    Q_UNUSED(name)
+#endif
+}
+
+bool ThreadMonitor::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return QFile::exists(QStringLiteral("/proc/self/task"));
+#else
+    return false;
+#endif
+}
+
+void ThreadMonitor::setRunning(bool running)
+{
+    if (running == isRunning()) {
+        return;
+    }
+    if (running) {
+        if (!isSupported()) {
+            return;
+        }
+        // Fresh baseline: totals from before the pause would average over idle time
+        m_previous.clear();
+        m_timer.start();
+        sample();
+    } else {
+        m_timer.stop();
+    }
+    emit runningChanged();
+}
+
+void ThreadMonitor::setIntervalMs(int intervalMs)
+{
+    intervalMs = qMax(intervalMs, 100);
+    if (intervalMs != m_timer.interval()) {
+        m_timer.setInterval(intervalMs);
+        emit intervalMsChanged();
+    }
+}
+
+QVariantList ThreadMonitor::threads() const
+{
+    QVariantList list;
+    list.reserve(m_samples.size());
+    for (const ThreadSample &thread : m_samples) {
+        QVariantMap entry;
+        entry["tid"] = thread.tid;
+        entry["name"] = thread.name;
+        entry["cpuPercent"] = thread.cpuPercent;
+        entry["waitPercent"] = thread.waitPercent;
+        entry["waitPerSliceUs"] = thread.waitPerSliceUs;
+        list.append(entry);
+    }
+    return list;
+}
+
+void ThreadMonitor::sample()
+{
+    qint64 nowNs = m_clock.nsecsElapsed();
+    QHash<qint64, TaskTimes> current = readTasks();
+    double intervalNs = double(qMax<qint64>(nowNs - m_lastSampleNs, 1));
+    bool haveBaseline = !m_previous.isEmpty();
+    m_lastSampleNs = nowNs;
+
+    m_samples.clear();
+    m_processCpuPercent = 0.0;
+    if (haveBaseline) {
+        for (auto it = current.constBegin(); it != current.constEnd(); ++it) {
+            auto previous = m_previous.constFind(it.key());
+            if (previous == m_previous.constEnd()) {
+                continue;  // Started during the interval: no baseline yet
+            }
+            const TaskTimes &now = it.value();
+            ThreadSample thread;
+            thread.tid = it.key();
+            thread.name = now.name;
+            thread.cpuPercent = 100.0 * (now.cpuNs - previous->cpuNs) / intervalNs;
+            if (now.waitNs >= 0 && previous->waitNs >= 0) {
+                qint64 waitNs = now.waitNs - previous->waitNs;
+                qint64 slices = now.slices - previous->slices;
+                thread.waitPercent = 100.0 * waitNs / intervalNs;
+                thread.waitPerSliceUs = slices > 0 ? (double(waitNs) / slices) / 1e3 : 0.0;
+            }
+            m_processCpuPercent += thread.cpuPercent;
+            m_samples.append(thread);
+        }
+        std::sort(m_samples.begin(), m_samples.end(), [](const ThreadSample &a, const ThreadSample &b) {
+            return a.cpuPercent > b.cpuPercent;
+        });
+    }
+    m_previous = current;
+
+    if (haveBaseline) {
+        recordTraceCounters();
+        emit updated();
+    }
+}
+
+QHash<qint64, ThreadMonitor::TaskTimes> ThreadMonitor::readTasks()
+{
+    QHash<qint64, TaskTimes> tasks;
+#ifdef Q_OS_LINUX
+    static const qint64 nsPerTick = 1000000000LL / sysconf(_SC_CLK_TCK);
+    const qint64 mainTid = getpid();
+    const QStringList tids = QDir("/proc/self/task").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &tid : tids) {
+        QFile statFile(QString("/proc/self/task/%1/stat").arg(tid));
+        if (!statFile.open(QIODevice::ReadOnly)) {
+            continue;  // Exited since the directory listing
+        }
+
+        // "tid (comm) state ..." - comm may itself contain spaces and parentheses
+        QByteArray stat = statFile.readAll();
+        int open = stat.indexOf('(');
+        int close = stat.lastIndexOf(')');
+        if (open < 0 || close < open) {
+            continue;
+        }
+        // Fields after comm start at field 3 (state); utime and stime are fields 14 and 15
+        QList<QByteArray> fields = stat.mid(close + 2).split(' ');
+        if (fields.size() < 13) {
+            continue;
+        }
+
+        TaskTimes times;
+        qint64 id = tid.toLongLong();
+        // The main thread carries the process name; it is the GUI thread here
+        times.name = id == mainTid ? QStringLiteral("GUI")
+                                   : QString::fromUtf8(stat.mid(open + 1, close - open - 1));
+        times.cpuNs = (fields[11].toLongLong() + fields[12].toLongLong()) * nsPerTick;
+
+        // "<ns on cpu> <ns waiting on a runqueue> <timeslices>" (CONFIG_SCHEDSTATS / SCHED_INFO)
+        QFile schedFile(QString("/proc/self/task/%1/schedstat").arg(tid));
+        if (schedFile.open(QIODevice::ReadOnly)) {
+            QList<QByteArray> sched = schedFile.readAll().trimmed().split(' ');
+            if (sched.size() >= 3) {
+                times.cpuNs = sched[0].toLongLong();  // Nanosecond resolution instead of ticks
+                times.waitNs = sched[1].toLongLong();
+                times.slices = sched[2].toLongLong();
+            }
+        }
+        tasks.insert(id, times);
+    }
+#endif
+    return tasks;
+}
+
+void ThreadMonitor::recordTraceCounters() const
+{
+    if (!Tracer::active()) {
+        return;
+    }
+    QVector<QPair<QString, double>> cpu;
+    QVector<QPair<QString, double>> wait;
+    for (const ThreadSample &thread : m_samples) {
+        // Names repeat (e.g. several "queue0:src"), the tid keeps the tracks apart
+        QString track = QString("%1 (%2)").arg(thread.name).arg(thread.tid);
+        cpu.append({ track, thread.cpuPercent });
+        if (thread.waitPercent >= 0) {
+            wait.append({ track, thread.waitPercent });
+        }
+    }
+    Tracer::recordCounters("thread cpu %", cpu);
+    if (!wait.isEmpty()) {
+        Tracer::recordCounters("thread wait %", wait);
+    }
+}
@@ -0,0 +1,215 @@
+/**
+ * @file timeseriesstore.cpp
+ * @brief Implementation of the chunked time series store and LTTB queries
+ */
+
+#include "includes/timeseriesstore.hpp"
+#include <algorithm>  // Chunk / offset binary search
+#include <cmath>      // LTTB triangle areas
+#include <limits>     // Offset range
+
+namespace {
+constexpr qint64 MaxOffsetUs = std::numeric_limits<quint32>::max();
+constexpr size_t MinChunksPerSeries = 2;
+}
+
+TimeSeriesStore::TimeSeriesStore(size_t maxBytes)
+    : m_maxBytes(maxBytes)
+    , m_maxChunksPerSeries(MinChunksPerSeries)
+    , m_allocatedChunks(0)
+{
+}
+
+int TimeSeriesStore::addSeries(const QString &name)
+{
+    int existing = seriesIndex(name);
+    if (existing >= 0) {
+        return existing;
+    }
+    m_series.emplace_back();
+    m_series.back().name = name;
+    m_maxChunksPerSeries = std::max(MinChunksPerSeries, m_maxBytes / (sizeof(Chunk) * m_series.size()));
+    return int(m_series.size()) - 1;
+}
+
+int TimeSeriesStore::seriesIndex(const QString &name) const
+{
+    for (size_t i = 0; i < m_series.size(); ++i) {
+        if (m_series[i].name == name) {
+            return int(i);
+        }
+    }
+    return -1;
+}
+
+QStringList TimeSeriesStore::seriesNames() const
+{
+    QStringList names;
+    for (const Series &series : m_series) {
+        names.append(series.name);
+    }
+    return names;
+}
+
+std::unique_ptr<TimeSeriesStore::Chunk> TimeSeriesStore::takeChunk(Series &series)
+{
+    // At the budget: the oldest chunk becomes the newest, no allocation
+    if (series.chunks.size() >= m_maxChunksPerSeries) {
+        std::unique_ptr<Chunk> chunk = std::move(series.chunks.front());
+        series.chunks.pop_front();
+        return chunk;
+    }
+    ++m_allocatedChunks;
+    return std::make_unique<Chunk>();
+}
+
+void TimeSeriesStore::append(int series, qint64 timeUs, float value)
+{
+    Series &s = m_series[series];
+    timeUs = std::max(timeUs, s.lastUs);
+    s.lastUs = timeUs;
+
+    Chunk *chunk = s.chunks.empty() ? nullptr : s.chunks.back().get();
+    if (!chunk || chunk->size == ChunkCapacity || timeUs - chunk->baseUs > MaxOffsetUs) {
+        std::unique_ptr<Chunk> fresh = takeChunk(s);
+        fresh->baseUs = timeUs;
+        fresh->firstIndex = s.nextIndex;
+        fresh->size = 0;
+        s.chunks.push_back(std::move(fresh));
+        chunk = s.chunks.back().get();
+    }
+    chunk->offsetsUs[chunk->size] = quint32(timeUs - chunk->baseUs);
+    chunk->values[chunk->size] = value;
+    ++chunk->size;
+    ++s.nextIndex;
+}
+
+void TimeSeriesStore::Cursor::advance(quint64 count)
+{
+    // Whole chunks at a time; chunks only hold consecutive indices
+    while (count > 0 && chunk < series->chunks.size()) {
+        quint64 left = quint64(series->chunks[chunk]->size - pos);
+        if (count < left) {
+            pos += int(count);
+            return;
+        }
+        count -= left;
+        ++chunk;
+        pos = 0;
+    }
+}
+
+TimeSeriesStore::Cursor TimeSeriesStore::find(int series, qint64 timeUs) const
+{
+    const Series &s = m_series[series];
+    auto chunk = std::partition_point(s.chunks.begin(), s.chunks.end(),
+                                      [timeUs](const std::unique_ptr<Chunk> &c) { return c->lastUs() < timeUs; });
+    if (chunk == s.chunks.end()) {
+        return { &s, s.chunks.size(), 0 };
+    }
+    // lastUs() >= timeUs, so the offset fits
+    const Chunk &c = **chunk;
+    quint32 offset = timeUs > c.baseUs ? quint32(timeUs - c.baseUs) : 0;
+    int pos = int(std::lower_bound(c.offsetsUs.begin(), c.offsetsUs.begin() + c.size, offset) - c.offsetsUs.begin());
+    return { &s, size_t(chunk - s.chunks.begin()), pos };
+}
+
+std::vector<TimeSeriesStore::Point> TimeSeriesStore::query(int series, qint64 fromUs, qint64 toUs, int points) const
+{
+    std::vector<Point> result;
+    if (series < 0 || series >= int(m_series.size()) || toUs < fromUs) {
+        return result;
+    }
+    Cursor start = find(series, fromUs);
+    quint64 count = find(series, toUs + 1).index() - start.index();
+
+    if (points <= 0 || count <= quint64(points)) {
+        result.reserve(count);
+        forEach(series, fromUs, toUs, [&result](const Point &point) { result.push_back(point); });
+        return result;
+    }
+    if (points < 3) {
+        // No room for buckets: the window's ends
+        Cursor last = start;
+        last.advance(count - 1);
+        result.push_back(start.point());
+        if (points == 2) {
+            result.push_back(last.point());
+        }
+        return result;
+    }
+
+    // LTTB: first point, one point per bucket of the (count - 2) inner samples
+    // maximizing the triangle with the previous pick and the next bucket's mean,
+    // last point. The next bucket's mean is this bucket's candidates one step
+    // later, so every sample is read twice, in order.
+    result.reserve(points);
+    quint64 inner = count - 2;
+    quint64 buckets = quint64(points - 2);
+    auto boundary = [inner, buckets](quint64 bucket) { return bucket * inner / buckets + 1; };  // Integer: the last one is exact
+    qint64 originUs = start.point().timeUs;  // Areas in doubles relative to the window start
+    Point selected = start.point();
+    result.push_back(selected);
+
+    Cursor bucket = start;
+    bucket.advance(1);
+    Cursor ahead = bucket;
+    ahead.advance(boundary(1) - 1);
+
+    for (quint64 i = 0; i < buckets; ++i) {
+        quint64 bucketStart = boundary(i);
+        quint64 bucketEnd = boundary(i + 1);
+        quint64 nextEnd = std::min(boundary(i + 2), count);
+
+        double meanTime = 0.0;
+        double meanValue = 0.0;
+        quint64 nextCount = nextEnd > bucketEnd ? nextEnd - bucketEnd : 0;
+        for (quint64 n = 0; n < nextCount; ++n) {
+            Point point = ahead.point();
+            meanTime += double(point.timeUs - originUs);
+            meanValue += point.value;
+            ahead.next();
+        }
+        if (nextCount > 0) {
+            meanTime /= nextCount;
+            meanValue /= nextCount;
+        }
+
+        double selectedTime = double(selected.timeUs - originUs);
+        double bestArea = -1.0;
+        Point best = selected;
+        for (quint64 n = bucketStart; n < bucketEnd; ++n) {
+            Point point = bucket.point();
+            double area = std::abs((selectedTime - meanTime) * (point.value - selected.value)
+                                   - (selectedTime - double(point.timeUs - originUs)) * (meanValue - selected.value));
+            if (area > bestArea) {
+                bestArea = area;
+                best = point;
+            }
+            bucket.next();
+        }
+        selected = best;
+        result.push_back(selected);
+    }
+
+    // The bucket cursor now stands on the window's last sample
+    result.push_back(bucket.point());
+    return result;
+}
+
+quint64 TimeSeriesStore::sampleCount(int series) const
+{
+    const Series &s = m_series[series];
+    return s.chunks.empty() ? 0 : s.nextIndex - s.chunks.front()->firstIndex;
+}
+
+qint64 TimeSeriesStore::firstTimeUs(int series) const
+{
+    const Series &s = m_series[series];
+    return s.chunks.empty() ? -1 : s.chunks.front()->baseUs;
+}
+
+size_t TimeSeriesStore::memoryBytes() const
+{
+    return m_allocatedChunks * sizeof(Chunk);
+}
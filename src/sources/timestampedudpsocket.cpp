@@ -0,0 +1,286 @@
+/**
+ * @file timestampedudpsocket.cpp
+ * @brief Implementation of the UDP socket with kernel receive timestamps
+ *
+ * Linux: a raw non-blocking socket watched by a QSocketNotifier and read with
+ * recvmsg() so the SCM_TIMESTAMPING / SCM_TIMESTAMPNS control message can be
+ * parsed. Elsewhere: a thin wrapper around QUdpSocket.
+ */
+
+#include "includes/timestampedudpsocket.hpp"
+#include "includes/logging.hpp"  // Asynchronous logging
+#include <QNetworkDatagram>    // Datagram container used by the QUdpSocket fallback
+#include <QSocketNotifier>     // Event loop integration for the raw descriptor
+#include <QUdpSocket>          // Portable fallback
+#include <chrono>              // Wall clock in nanoseconds
+
+#ifdef Q_OS_LINUX
+#include <sys/socket.h>        // socket(), recvmsg(), setsockopt()
+#include <netinet/in.h>        // sockaddr_in / sockaddr_in6
+#include <unistd.h>            // close()
+#include <errno.h>
+#include <string.h>            // strerror()
+#include <linux/net_tstamp.h>  // SOF_TIMESTAMPING_* flags
+#include <linux/errqueue.h>    // struct scm_timestamping
+#endif
+
+namespace {
+// Largest possible UDP payload; control acks are far smaller
+constexpr int MaxDatagramSize = 65536;
+}
+
+TimestampedUdpSocket::TimestampedUdpSocket(QObject *parent)
+    : QObject(parent)
+    , m_fd(-1)
+    , m_notifier(nullptr)
+    , m_socket(nullptr)
+    , m_kernelTimestamps(false)
+{
+}
+
+TimestampedUdpSocket::~TimestampedUdpSocket()
+{
+    close();
+}
+
+qint64 TimestampedUdpSocket::wallClockNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool TimestampedUdpSocket::enableKernelTimestamps(qintptr fd)
+{
+#ifdef Q_OS_LINUX
+    // Preferred: SO_TIMESTAMPING with software RX stamps (taken when the packet
+    // enters the network stack, before any socket queueing or scheduling delay)
+    int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    if (setsockopt(static_cast<int>(fd), SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0) {
+        return true;
+    }
+
+    // Older kernels: nanosecond timestamps via SO_TIMESTAMPNS
+    int on = 1;
+    if (setsockopt(static_cast<int>(fd), SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) == 0) {
+        return true;
+    }
+
+    LOG_WARN("TimestampedUdpSocket", "Kernel RX timestamps unavailable: {}", strerror(errno));
+    return false;
+#else
+    Q_UNUSED(fd)
+    return false;
+#endif
+}
+
+qint64 TimestampedUdpSocket::receiveTimestamped(qintptr fd, char *buffer, qint64 maxSize, qint64 *kernelRxNs,
+                                                QHostAddress *sender, quint16 *senderPort)
+{
+    *kernelRxNs = -1;
+
+#ifdef Q_OS_LINUX
+    sockaddr_storage from;
+    iovec iov;
+    iov.iov_base = buffer;
+    iov.iov_len = static_cast<size_t>(maxSize);
+
+    // Room for either control message type
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(scm_timestamping)) + CMSG_SPACE(sizeof(timespec))];
+
+    msghdr msg = {};
+    msg.msg_name = &from;
+    msg.msg_namelen = sizeof(from);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t received = recvmsg(static_cast<int>(fd), &msg, MSG_DONTWAIT);
+    if (received < 0) {
+        return -1;  // EAGAIN (nothing pending) or a real error - caller just stops reading
+    }
+
+    for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET) {
+            continue;
+        }
+
+        const timespec *ts = nullptr;
+        if (cmsg->cmsg_type == SCM_TIMESTAMPING) {
+            // ts[0] = software stamp, ts[2] = raw hardware stamp (PHC clock, not wall clock)
+            ts = &reinterpret_cast<const scm_timestamping *>(CMSG_DATA(cmsg))->ts[0];
+        } else if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            ts = reinterpret_cast<const timespec *>(CMSG_DATA(cmsg));
+        }
+
+        if (ts && (ts->tv_sec != 0 || ts->tv_nsec != 0)) {
+            *kernelRxNs = static_cast<qint64>(ts->tv_sec) * 1000000000LL + ts->tv_nsec;
+            break;
+        }
+    }
+
+    if (sender) {
+        *sender = QHostAddress(reinterpret_cast<const sockaddr *>(&from));
+    }
+    if (senderPort) {
+        *senderPort = from.ss_family == AF_INET6
+            ? ntohs(reinterpret_cast<const sockaddr_in6 *>(&from)->sin6_port)
+            : ntohs(reinterpret_cast<const sockaddr_in *>(&from)->sin_port);
+    }
+    return received;
+#else
+    Q_UNUSED(fd) Q_UNUSED(buffer) Q_UNUSED(maxSize) Q_UNUSED(sender) Q_UNUSED(senderPort)
+    return -1;
+#endif
+}
+
+bool TimestampedUdpSocket::bind(const QHostAddress &address, quint16 port)
+{
+    close();
+
+#ifdef Q_OS_LINUX
+    bool ipv6 = address.protocol() == QAbstractSocket::IPv6Protocol;
+    int fd = ::socket(ipv6 ? AF_INET6 : AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        m_errorString = QString::fromLocal8Bit(strerror(errno));
+        return false;
+    }
+
+    sockaddr_storage local = {};
+    socklen_t localLength;
+    if (ipv6) {
+        sockaddr_in6 *in6 = reinterpret_cast<sockaddr_in6 *>(&local);
+        in6->sin6_family = AF_INET6;
+        in6->sin6_port = htons(port);
+        Q_IPV6ADDR addr = address.toIPv6Address();
+        memcpy(&in6->sin6_addr, &addr, sizeof(addr));
+        localLength = sizeof(sockaddr_in6);
+    } else {
+        sockaddr_in *in4 = reinterpret_cast<sockaddr_in *>(&local);
+        in4->sin_family = AF_INET;
+        in4->sin_port = htons(port);
+        in4->sin_addr.s_addr = htonl(address.isNull() || address == QHostAddress::Any
+                                     ? INADDR_ANY : address.toIPv4Address());
+        localLength = sizeof(sockaddr_in);
+    }
+
+    if (::bind(fd, reinterpret_cast<sockaddr *>(&local), localLength) < 0) {
+        m_errorString = QString::fromLocal8Bit(strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    m_fd = fd;
+    m_kernelTimestamps = enableKernelTimestamps(m_fd);
+    if (m_receiveBuffer.size() != MaxDatagramSize) {
+        m_receiveBuffer.resize(MaxDatagramSize);  // Kept across close()/bind()
+    }
+    m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &TimestampedUdpSocket::readyRead);
+    return true;
+#else
+    m_socket = new QUdpSocket(this);
+    if (!m_socket->bind(address, port)) {
+        m_errorString = m_socket->errorString();
+        delete m_socket;
+        m_socket = nullptr;
+        return false;
+    }
+    connect(m_socket, &QUdpSocket::readyRead, this, &TimestampedUdpSocket::readyRead);
+    return true;
+#endif
+}
+
+void TimestampedUdpSocket::close()
+{
+    if (m_notifier) {
+        m_notifier->setEnabled(false);
+        delete m_notifier;
+        m_notifier = nullptr;
+    }
+#ifdef Q_OS_LINUX
+    if (m_fd >= 0) {
+        ::close(static_cast<int>(m_fd));
+    }
+#endif
+    m_fd = -1;
+
+    if (m_socket) {
+        m_socket->close();
+        delete m_socket;
+        m_socket = nullptr;
+    }
+    m_kernelTimestamps = false;
+}
+
+bool TimestampedUdpSocket::readDatagram(TimestampedDatagram &datagram)
+{
+#ifdef Q_OS_LINUX
+    if (m_fd < 0) {
+        return false;
+    }
+
+    // Receive into the socket's buffer, then copy only the payload: a datagram
+    // reused across reads keeps its capacity, so small acks allocate nothing
+    qint64 size = receiveTimestamped(m_fd, m_receiveBuffer.data(), m_receiveBuffer.size(),
+                                     &datagram.kernelRxNs, &datagram.senderAddress, &datagram.senderPort);
+    datagram.userRxNs = wallClockNs();
+    if (size < 0) {
+        datagram.data.clear();
+        return false;
+    }
+    datagram.data.resize(size);
+    memcpy(datagram.data.data(), m_receiveBuffer.constData(), static_cast<size_t>(size));
+    return true;
+#else
+    if (!m_socket || !m_socket->hasPendingDatagrams()) {
+        return false;
+    }
+
+    QNetworkDatagram received = m_socket->receiveDatagram();
+    datagram.userRxNs = wallClockNs();
+    datagram.kernelRxNs = -1;
+    datagram.data = received.data();
+    datagram.senderAddress = received.senderAddress();
+    datagram.senderPort = static_cast<quint16>(received.senderPort());
+    return true;
+#endif
+}
+
+qint64 TimestampedUdpSocket::writeDatagram(const QByteArray &data, const QHostAddress &host, quint16 port)
+{
+#ifdef Q_OS_LINUX
+    if (m_fd < 0) {
+        return -1;
+    }
+
+    sockaddr_storage to = {};
+    socklen_t toLength;
+    if (host.protocol() == QAbstractSocket::IPv6Protocol) {
+        sockaddr_in6 *in6 = reinterpret_cast<sockaddr_in6 *>(&to);
+        in6->sin6_family = AF_INET6;
+        in6->sin6_port = htons(port);
+        Q_IPV6ADDR addr = host.toIPv6Address();
+        memcpy(&in6->sin6_addr, &addr, sizeof(addr));
+        toLength = sizeof(sockaddr_in6);
+    } else {
+        sockaddr_in *in4 = reinterpret_cast<sockaddr_in *>(&to);
+        in4->sin_family = AF_INET;
+        in4->sin_port = htons(port);
+        in4->sin_addr.s_addr = htonl(host.toIPv4Address());
+        toLength = sizeof(sockaddr_in);
+    }
+
+    ssize_t sent = ::sendto(static_cast<int>(m_fd), data.constData(), static_cast<size_t>(data.size()),
+                            0, reinterpret_cast<sockaddr *>(&to), toLength);
+    if (sent < 0) {
+        m_errorString = QString::fromLocal8Bit(strerror(errno));
+    }
+    return sent;
+#else
+    if (!m_socket) {
+        return -1;
+    }
+    return m_socket->writeDatagram(data, host, port);
+#endif
+}
@@ -0,0 +1,412 @@
+/**
+ * @file tracing.cpp
+ * @brief Implementation of the per-thread trace rings and the Chrome JSON export
+ *
+ * Each ring has a single writer (its thread). Slots are written with relaxed
+ * atomics and published by a release store of the head index; a reader copies
+ * the ring and then discards every slot the writer may have reused meanwhile,
+ * so dumps never block or slow down the recording threads.
+ */
+
+#include "includes/tracing.hpp"
+#include "includes/threadmonitor.hpp"  // Names the dump thread
+#include "includes/logging.hpp"        // Asynchronous logging
+#include <QCoreApplication>    // Application pid, GUI thread identification
+#include <QDateTime>           // Dump file names
+#include <QDir>                // Dump location
+#include <QFile>               // Dump output
+#include <QMutex>              // Thread registry
+#include <QMutexLocker>
+#include <QQuickWindow>        // Render pass scopes
+#include <QThread>             // Thread names
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <thread>              // Background hitch dumps
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <pthread.h>           // pthread_getname_np
+#include <sys/syscall.h>       // gettid
+#include <unistd.h>
+#endif
+
+namespace {
+// ~0.5 MB per thread; at a few thousand events/s per thread that is several seconds
+constexpr quint64 EventsPerThread = 16384;
+// Rings of exited threads are kept for dumps until this many rings exist
+constexpr size_t MaxThreadBuffers = 64;
+constexpr qint64 MinNsBetweenHitchDumps = 10LL * 1000 * 1000 * 1000;
+constexpr qint64 MaxHitchNs = 5LL * 1000 * 1000 * 1000;
+// Counter samples come in at about 1 Hz per track: minutes of history
+constexpr size_t MaxCounterSamples = 512;
+
+struct TraceEvent
+{
+    std::atomic<const char *> name{nullptr};
+    std::atomic<qint64> startNs{0};
+    std::atomic<qint64> durationNs{0};   ///< -1 for instant events
+};
+
+struct ThreadBuffer
+{
+    std::unique_ptr<TraceEvent[]> events{new TraceEvent[EventsPerThread]};
+    std::atomic<quint64> head{0};        ///< Number of events ever written
+    qint64 tid = 0;
+    QString name;
+};
+
+struct EventCopy
+{
+    const char *name;
+    qint64 startNs;
+    qint64 durationNs;
+};
+
+struct CounterSample
+{
+    const char *name;
+    qint64 timestampNs;
+    QVector<QPair<QString, double>> series;
+};
+
+QMutex &registryMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+std::vector<std::shared_ptr<ThreadBuffer>> &registry()
+{
+    static std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    return buffers;
+}
+
+std::deque<CounterSample> &counterSamples()  // Guarded by registryMutex()
+{
+    static std::deque<CounterSample> samples;
+    return samples;
+}
+
+qint64 currentTid()
+{
+#ifdef Q_OS_LINUX
+    return static_cast<qint64>(syscall(SYS_gettid));
+#else
+    return static_cast<qint64>(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+#endif
+}
+
+QString currentThreadName()
+{
+    QCoreApplication *app = QCoreApplication::instance();
+    if (app && QThread::currentThread() == app->thread()) {
+        return QStringLiteral("GUI");
+    }
+    QString name = QThread::currentThread()->objectName();
+#ifdef Q_OS_LINUX
+    // GStreamer and engine threads are not QThreads but carry OS names
+    if (name.isEmpty()) {
+        char buffer[16] = {};
+        if (pthread_getname_np(pthread_self(), buffer, sizeof(buffer)) == 0) {
+            name = QString::fromUtf8(buffer);
+        }
+    }
+#endif
+    return name.isEmpty() ? QString("thread-%1").arg(currentTid()) : name;
+}
+
+ThreadBuffer *threadBuffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<ThreadBuffer>();
+        buffer->tid = currentTid();
+        buffer->name = currentThreadName();
+
+        QMutexLocker locker(&registryMutex());
+        auto &buffers = registry();
+        // Drop the oldest rings of threads that have exited (registry holds the only reference)
+        for (auto it = buffers.begin(); buffers.size() >= MaxThreadBuffers && it != buffers.end();) {
+            it = it->use_count() == 1 ? buffers.erase(it) : it + 1;
+        }
+        buffers.push_back(buffer);
+    }
+    return buffer.get();
+}
+
+/**
+ * @brief Copies the valid part of a ring that its writer may be appending to
+ */
+std::vector<EventCopy> snapshot(const ThreadBuffer &buffer)
+{
+    quint64 head = buffer.head.load(std::memory_order_acquire);
+    quint64 first = head > EventsPerThread ? head - EventsPerThread : 0;
+
+    std::vector<EventCopy> events;
+    events.reserve(static_cast<size_t>(head - first));
+    for (quint64 index = first; index < head; ++index) {
+        const TraceEvent &event = buffer.events[index % EventsPerThread];
+        events.push_back({ event.name.load(std::memory_order_relaxed),
+                           event.startNs.load(std::memory_order_relaxed),
+                           event.durationNs.load(std::memory_order_relaxed) });
+    }
+
+    // The writer fills slot (newHead % size) before publishing newHead, so every
+    // index up to newHead - size may have been overwritten while copying
+    std::atomic_thread_fence(std::memory_order_acquire);
+    quint64 newHead = buffer.head.load(std::memory_order_relaxed);
+    quint64 firstValid = newHead >= EventsPerThread ? newHead - EventsPerThread + 1 : 0;
+    if (firstValid > first) {
+        events.erase(events.begin(), events.begin() + static_cast<ptrdiff_t>(qMin(firstValid, head) - first));
+    }
+    return events;
+}
+
+QByteArray jsonString(const QString &text)
+{
+    QByteArray escaped = text.toUtf8();
+    escaped.replace('\\', "\\\\").replace('"', "\\\"");
+    return '"' + escaped + '"';
+}
+}
+
+std::atomic<bool> Tracer::s_enabled{false};
+
+Tracer::Tracer(QObject *parent)
+    : QObject(parent)
+    , m_hitchThresholdMs(100)
+    , m_lastFrameNs(0)
+    , m_lastHitchDumpNs(-MinNsBetweenHitchDumps)
+    , m_dumpInProgress(false)
+{
+}
+
+Tracer *Tracer::instance()
+{
+    static Tracer *tracer = new Tracer(QCoreApplication::instance());
+    return tracer;
+}
+
+void Tracer::setEnabled(bool enabled)
+{
+    if (active() == enabled) {
+        return;
+    }
+    if (enabled && !compiledIn()) {
+        LOG_WARN("Tracer", "Built without DRIVER_TRACING - no scopes will be recorded");
+    }
+    s_enabled.store(enabled, std::memory_order_relaxed);
+    m_lastFrameNs = 0;
+    emit enabledChanged();
+}
+
+void Tracer::setHitchThresholdMs(int thresholdMs)
+{
+    if (m_hitchThresholdMs != thresholdMs) {
+        m_hitchThresholdMs = thresholdMs;
+        emit hitchThresholdMsChanged();
+    }
+}
+
+qint64 Tracer::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::recordComplete(const char *name, qint64 startNs, qint64 endNs)
+{
+    ThreadBuffer *buffer = threadBuffer();
+    quint64 index = buffer->head.load(std::memory_order_relaxed);
+    TraceEvent &event = buffer->events[index % EventsPerThread];
+    event.name.store(name, std::memory_order_relaxed);
+    event.startNs.store(startNs, std::memory_order_relaxed);
+    event.durationNs.store(endNs - startNs, std::memory_order_relaxed);
+    buffer->head.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::recordInstant(const char *name)
+{
+    if (!active()) {
+        return;
+    }
+    qint64 now = nowNs();
+    recordComplete(name, now, now - 1);  // Duration -1 marks an instant event
+}
+
+void Tracer::recordCounters(const char *name, const QVector<QPair<QString, double>> &series)
+{
+    if (!active() || series.isEmpty()) {
+        return;
+    }
+    CounterSample sample{ name, nowNs(), series };
+    QMutexLocker locker(&registryMutex());
+    auto &samples = counterSamples();
+    if (samples.size() >= MaxCounterSamples) {
+        samples.pop_front();
+    }
+    samples.push_back(std::move(sample));
+}
+
+void Tracer::markFrame()
+{
+    if (!active()) {
+        return;
+    }
+
+    Tracer *tracer = instance();
+    qint64 now = nowNs();
+    qint64 gapNs = tracer->m_lastFrameNs > 0 ? now - tracer->m_lastFrameNs : 0;
+    tracer->m_lastFrameNs = now;
+
+    // Gaps of seconds are a stalled or restarted stream, not a stutter
+    if (tracer->m_hitchThresholdMs <= 0 || gapNs < tracer->m_hitchThresholdMs * 1000000LL
+        || gapNs > MaxHitchNs) {
+        return;
+    }
+
+    recordInstant("hitch");
+    if (now - tracer->m_lastHitchDumpNs >= MinNsBetweenHitchDumps) {
+        tracer->m_lastHitchDumpNs = now;
+        tracer->dumpAsync(QString("hitch: %1 ms without a frame").arg(gapNs / 1e6, 0, 'f', 1));
+    }
+}
+
+void Tracer::traceWindow(QQuickWindow *window)
+{
+#if DRIVER_TRACING
+    if (!window) {
+        return;
+    }
+    // Emitted on the render thread (GUI thread with the basic loop); one window per
+    // render thread, so a thread-local start time is enough
+    static thread_local qint64 renderStartNs = -1;
+    connect(window, &QQuickWindow::beforeRendering, window, []() {
+        renderStartNs = active() ? nowNs() : -1;
+    }, Qt::DirectConnection);
+    connect(window, &QQuickWindow::afterRendering, window, []() {
+        if (renderStartNs >= 0) {
+            recordComplete("render", renderStartNs, nowNs());
+            renderStartNs = -1;
+        }
+    }, Qt::DirectConnection);
+#else
+    Q_UNUSED(window)
+#endif
+}
+
+QString Tracer::dump()
+{
+    QString path = QDir::current().filePath(QString("trace-%1.json")
+        .arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss-zzz")));
+    if (!writeChromeJson(path)) {
+        return QString();
+    }
+    m_lastDumpPath = path;
+    emit dumped(path, QStringLiteral("requested"));
+    return path;
+}
+
+void Tracer::dumpAsync(const QString &reason)
+{
+    bool expected = false;
+    if (!m_dumpInProgress.compare_exchange_strong(expected, true)) {
+        return;
+    }
+
+    QString path = QDir::current().filePath(QString("trace-hitch-%1.json")
+        .arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss-zzz")));
+    LOG_WARN("Tracer", "{} - writing {}", reason, path);
+
+    // Copying every ring and formatting takes milliseconds: not on the GUI thread
+    std::thread([this, path, reason]() {
+        ThreadMonitor::nameCurrentThread("trace-dump");
+        bool written = writeChromeJson(path);
+        m_dumpInProgress.store(false);
+        if (written) {
+            QMetaObject::invokeMethod(this, [this, path, reason]() {
+                m_lastDumpPath = path;
+                emit dumped(path, reason);
+            }, Qt::QueuedConnection);
+        }
+    }).detach();
+}
+
+bool Tracer::writeChromeJson(const QString &path)
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::deque<CounterSample> counters;
+    {
+        QMutexLocker locker(&registryMutex());
+        buffers = registry();
+        counters = counterSamples();
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        LOG_WARN("Tracer", "Cannot write {}: {}", path, file.errorString());
+        return false;
+    }
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto append = [&out, &first](const QByteArray &event) {
+        if (!first) {
+            out += ",\n";
+        }
+        first = false;
+        out += event;
+    };
+
+    qint64 events = 0;
+    for (const auto &buffer : buffers) {
+        const QByteArray tid = QByteArray::number(buffer->tid);
+        append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tid
+               + ",\"args\":{\"name\":" + jsonString(buffer->name) + "}}");
+
+        for (const EventCopy &event : snapshot(*buffer)) {
+            if (!event.name) {
+                continue;
+            }
+            // Chrome trace timestamps are microseconds
+            QByteArray record = "{\"name\":\"" + QByteArray(event.name) + "\",\"cat\":\"driver\",\"pid\":" + pid
+                + ",\"tid\":" + tid + ",\"ts\":" + QByteArray::number(event.startNs / 1000.0, 'f', 3);
+            if (event.durationNs < 0) {
+                record += ",\"ph\":\"i\",\"s\":\"g\"}";
+            } else {
+                record += ",\"ph\":\"X\",\"dur\":" + QByteArray::number(event.durationNs / 1000.0, 'f', 3) + "}";
+            }
+            append(record);
+            ++events;
+        }
+    }
+
+    // Counter tracks ("ph":"C"): one series per args key
+    for (const CounterSample &counter : counters) {
+        QByteArray args;
+        for (const auto &series : counter.series) {
+            args += (args.isEmpty() ? "" : ",") + jsonString(series.first) + ":"
+                + QByteArray::number(series.second, 'f', 2);
+        }
+        append("{\"name\":\"" + QByteArray(counter.name) + "\",\"ph\":\"C\",\"pid\":" + pid
+               + ",\"ts\":" + QByteArray::number(counter.timestampNs / 1000.0, 'f', 3)
+               + ",\"args\":{" + args + "}}");
+        ++events;
+    }
+    out += "\n]}\n";
+
+    if (events == 0) {
+        LOG_WARN("Tracer", "Nothing recorded - is tracing enabled (DRIVER_TRACE=1)?");
+        file.remove();
+        return false;
+    }
+    if (file.write(out) != out.size()) {
+        LOG_WARN("Tracer", "Short write to {}", path);
+        return false;
+    }
+    LOG_DEBUG("Tracer", "Wrote {} events from {} threads to {}", events, buffers.size(), path);
+    return true;
+}
@@ -8,9 +8,23 @@
  */
 
 #include "includes/videoscreenreciever.hpp"
-#include <QDebug>              // Qt logging for debugging output
+#include "includes/logging.hpp"  // Asynchronous logging (never blocks the streaming thread)
 #include <QDateTime>           // Qt date/time utilities for frame timeout tracking
+#include <QThread>             // Streaming thread identity for CPU accounting
 #include <gst/video/video.h>   // GStreamer video utilities for format info and conversions
+#include "includes/timestampedudpsocket.hpp"  // Wall clock in the kernel timestamp domain
+#include "includes/tracing.hpp"               // Trace scopes on the frame path
+#include "includes/metrics.hpp"               // Exported counters/histograms (lock-free)
+#include "includes/threadmonitor.hpp"         // Names the initialization thread
+#include "includes/gstplugins.hpp"            // Curated plugin set / private registry (DRIVER_GST_PLUGINS)
+#include <mutex>                              // std::call_once around gst_init()
+#include <cstdio>                             // std::snprintf for frame IDs
+
+#ifdef Q_OS_WIN
+#include <qt_windows.h>        // GetThreadTimes()
+#else
+#include <time.h>              // clock_gettime(CLOCK_THREAD_CPUTIME_ID)
+#endif
 
 /* ============================================================================
  * VideoImageProvider Implementation
@@ -44,6 +58,7 @@ QImage VideoImageProvider::requestImage(const QString &id, QSize *size, const QS
 {
     Q_UNUSED(id)             // We don't use the ID - always return the latest frame
     Q_UNUSED(requestedSize)  // We don't scale - return original resolution
+    TRACE_SCOPE("requestImage");
 
     // Get the current frame from the receiver
     QImage image = m_receiver->currentImage();
@@ -62,32 +77,153 @@ QImage VideoImageProvider::requestImage(const QString &id, QSize *size, const QS
  * Main class that manages the GStreamer pipeline and frame processing.
  */
 
+namespace {
+// A switch is abandoned if the new source shows no frame within this time
+constexpr qint64 SwitchTimeoutMs = 5000;
+// Packets the appsrc may hold when the depayloader falls behind (a few MJPEG frames);
+// beyond that the oldest are dropped, so a stall never turns into queued-up latency
+constexpr guint64 AppsrcMaxBytes = 1024 * 1024;
+
+/**
+ * @brief CPU time consumed by the calling thread so far, in nanoseconds
+ */
+qint64 currentThreadCpuNs()
+{
+#ifdef Q_OS_WIN
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+        return 0;
+    }
+    ULARGE_INTEGER kernelTime, userTime;
+    kernelTime.LowPart = kernel.dwLowDateTime;
+    kernelTime.HighPart = kernel.dwHighDateTime;
+    userTime.LowPart = user.dwLowDateTime;
+    userTime.HighPart = user.dwHighDateTime;
+    return static_cast<qint64>(kernelTime.QuadPart + userTime.QuadPart) * 100;  // 100 ns units
+#else
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0;
+    }
+    return static_cast<qint64>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+#endif
+}
+
+quintptr currentThreadKey()
+{
+    return reinterpret_cast<quintptr>(QThread::currentThreadId());
+}
+
+/**
+ * @brief Video receiver metrics, shared by all receivers in the process
+ */
+struct VideoMetrics
+{
+    MetricsRegistry &registry = MetricsRegistry::instance();
+    MetricCounter &packets = registry.counter(
+        "driver_video_packets_total", "RTP packets pushed into the pipeline (native ingest)");
+    MetricCounter &foreignSsrcPackets = registry.counter(
+        "driver_video_foreign_ssrc_packets_total", "Packets dropped because another RTP stream is locked");
+    MetricCounter &framesReceived = registry.counter(
+        "driver_video_frames_received_total", "Frames completed on the wire (RTP marker bit, native ingest)");
+    MetricCounter &framesDecoded = registry.counter(
+        "driver_video_frames_decoded_total", "Frames delivered to the appsink");
+    MetricCounter &framesDisplayed = registry.counter(
+        "driver_video_frames_displayed_total", "Frames handed to QML");
+    MetricCounter &decodeDrops = registry.counter(
+        "driver_video_frames_dropped_total", "Frames discarded inside the receiver", "stage=\"decode\"");
+    MetricCounter &handoffDrops = registry.counter(
+        "driver_video_frames_dropped_total", "Frames discarded inside the receiver", "stage=\"handoff\"");
+    MetricGauge &fps = registry.gauge(
+        "driver_video_fps", "Frames handed to QML per second (1 s window)");
+    MetricGauge &handoffQueueDepth = registry.gauge(
+        "driver_video_handoff_queue_depth", "Decoded frames waiting for the GUI thread");
+    MetricHistogram &socketDelay = registry.histogram(
+        "driver_video_socket_delay_seconds", "Kernel RX to ingest thread read",
+        MetricsRegistry::latencyBuckets());
+    MetricHistogram &rxToAppsink = registry.histogram(
+        "driver_video_rx_to_appsink_seconds", "Kernel RX of a frame's last packet to decoded frame",
+        MetricsRegistry::latencyBuckets());
+    MetricHistogram &appsinkToGui = registry.histogram(
+        "driver_video_appsink_to_gui_seconds", "Decoded frame to GUI thread handoff",
+        MetricsRegistry::latencyBuckets());
+};
+
+VideoMetrics &videoMetrics()
+{
+    static VideoMetrics metrics;
+    return metrics;
+}
+
+/**
+ * @brief gst_init() plus loading the built-in chain's plugins, once per process
+ *
+ * Thread safe; concurrent callers wait for the first one. Creating one element
+ * of each factory loads its plugin and registers its types, which is most of
+ * what gst_parse_launch() would otherwise do on the GUI thread for the first
+ * pipeline. Factories that are missing are left for createPipeline() to report.
+ */
+void initializeGStreamerOnce()
+{
+    static std::once_flag once;
+    std::call_once(once, []() {
+        TRACE_SCOPE("gst_init");
+        QElapsedTimer clock;
+        clock.start();
+        GstPlugins::prepare();
+        gst_init(nullptr, nullptr);
+        GstPlugins::registerStatic();
+        qint64 initMs = clock.elapsed();
+
+        static const char *const DefaultChainFactories[] = {
+            "udpsrc", "appsrc", "capsfilter", "rtpjpegdepay", "queue", "jpegdec", "videoconvert", "appsink"
+        };
+        for (const char *factory : DefaultChainFactories) {
+            if (GstElement *element = gst_element_factory_make(factory, nullptr)) {
+                gst_object_unref(element);
+            }
+        }
+        LOG_DEBUG("VideoStreamReceiver", "gst_init {} ms ({} plugins), plugin warm-up {} ms",
+                  initMs, GstPlugins::mode(), clock.elapsed() - initMs);
+    });
+}
+}
+
 /**
- * @brief Constructor - initializes GStreamer and sets up initial state
+ * @brief Constructor - sets up initial state; GStreamer is not touched here
  * @param parent Parent QObject for Qt's memory management system
  *
  * Qt's parent-child system ensures this object is deleted when parent is deleted.
- * GStreamer is initialized here once for the lifetime of the receiver.
+ * GStreamer is initialized later, once per process: in the background by
+ * initializeAsync(), or by ensureInitialized() when the first stream starts.
  */
 VideoStreamReceiver::VideoStreamReceiver(QObject *parent)
     : QObject(parent)           // Initialize QObject base class with parent
-    , m_pipeline(nullptr)       // No pipeline yet - will be created in startStream()
-    , m_appsink(nullptr)        // No appsink element yet
-    , m_bus(nullptr)            // No message bus yet
+    , m_pipelineGeneration(0)   // No pipeline created yet
+    , m_lastSwitchMs(0.0)       // No switch performed yet
     , m_frameCounter(0)         // Start frame numbering at 0
     , m_isStreaming(false)      // Not streaming initially
     , m_hasActiveStream(false)  // No active stream initially
     , m_busTimer(nullptr)       // Bus polling timer - created when pipeline starts
     , m_frameTimeoutTimer(nullptr)  // Frame timeout timer - created when pipeline starts
     , m_lastFrameTime(0)        // No frames received yet
+    , m_ready(false)            // GStreamer initialized on first use or by initializeAsync()
+    , m_pendingPort(0)          // No deferred startStream()
+    , m_nativeIngest(false)     // Default to GStreamer's udpsrc
+    , m_wallClock(nullptr)      // Created in finishInitialization()
+    , m_unixTimestampCaps(nullptr)  // Created in finishInitialization()
+    , m_ingestShards(1)         // One receive socket and thread per port
+    , m_pinIngestThreads(false) // Let the scheduler place the ingest threads
+    , m_externalIngest(false)   // Pipelines receive packets themselves
+    , m_currentFrameRxNs(0)     // No frames received yet
+    , m_appsinkToGuiSumNs(0)
+    , m_appsinkToGuiMaxNs(0)
+    , m_appsinkToGuiCount(0)
+    , m_fpsTickFrames(0)
+    , m_fpsTickMs(0)
 {
-    qDebug() << "[VideoStreamReceiver] Constructor started";
-
-    // Initialize GStreamer library (safe to call multiple times - only initializes once)
-    // nullptr arguments mean no command-line args to parse
-    qDebug() << "[VideoStreamReceiver] Initializing GStreamer...";
-    gst_init(nullptr, nullptr);
-    qDebug() << "[VideoStreamReceiver] GStreamer initialized successfully";
+    LOG_DEBUG("VideoStreamReceiver", "Constructor started");
+    videoMetrics();  // Register the series before the first scrape
 
     // Initialize with a placeholder frame ID to avoid QML warnings
     // QML will try to load this immediately but won't find a valid image
@@ -96,14 +232,11 @@ VideoStreamReceiver::VideoStreamReceiver(QObject *parent)
     // Create a placeholder black image to avoid errors when QML first requests an image
     m_currentImage = QImage(640, 480, QImage::Format_RGB888);
     m_currentImage.fill(Qt::black);
-    qDebug() << "[VideoStreamReceiver] Placeholder image created";
+    LOG_DEBUG("VideoStreamReceiver", "Placeholder image created");
 
     // Set initial status message for UI
     setStatus("Ready");
-
-    // Log GStreamer version for debugging/verification
-    qDebug() << "[VideoStreamReceiver] GStreamer version:" << gst_version_string();
-    qDebug() << "[VideoStreamReceiver] Constructor completed successfully";
+    LOG_DEBUG("VideoStreamReceiver", "Constructor completed successfully");
 }
 
 /**
@@ -113,11 +246,89 @@ VideoStreamReceiver::VideoStreamReceiver(QObject *parent)
  */
 VideoStreamReceiver::~VideoStreamReceiver()
 {
-    qDebug() << "[VideoStreamReceiver] Destructor called";
+    LOG_DEBUG("VideoStreamReceiver", "Destructor called");
+    // A queued finishInitialization() dies with this object; the thread must not outlive it
+    if (m_initThread.joinable()) {
+        m_initThread.join();
+    }
+
     // Stop the stream and clean up all GStreamer resources
     // Safe to call even if stream isn't running
     stopStream();
-    qDebug() << "[VideoStreamReceiver] Destructor completed";
+
+    // Release objects created in finishInitialization()
+    if (m_unixTimestampCaps) {
+        gst_caps_unref(m_unixTimestampCaps);
+    }
+    if (m_wallClock) {
+        gst_object_unref(m_wallClock);
+    }
+    LOG_DEBUG("VideoStreamReceiver", "Destructor completed");
+}
+
+/**
+ * @brief Runs gst_init() and the plugin warm-up on a worker thread
+ *
+ * Completion is handed back to the GUI thread through a queued call, where the
+ * receiver-owned objects are created and a startStream() requested in the
+ * meantime is carried out.
+ */
+void VideoStreamReceiver::initializeAsync()
+{
+    if (m_ready || m_initThread.joinable()) {
+        return;
+    }
+    setStatus("Initializing GStreamer...");
+    m_initThread = std::thread([this]() {
+        ThreadMonitor::nameCurrentThread("gst-init");
+        initializeGStreamerOnce();
+        QMetaObject::invokeMethod(this, [this]() { finishInitialization(); }, Qt::QueuedConnection);
+    });
+}
+
+/**
+ * @brief Makes sure GStreamer is usable from here on, blocking if necessary
+ *
+ * Waits for a running initializeAsync() or initializes on the calling thread.
+ */
+void VideoStreamReceiver::ensureInitialized()
+{
+    if (m_ready) {
+        return;
+    }
+    if (m_initThread.joinable()) {
+        m_initThread.join();
+    }
+    initializeGStreamerOnce();
+    finishInitialization();
+}
+
+void VideoStreamReceiver::finishInitialization()
+{
+    if (m_initThread.joinable()) {
+        m_initThread.join();
+    }
+    if (m_ready) {
+        return;  // ensureInitialized() got here first
+    }
+
+    // Wall-clock (CLOCK_REALTIME) pipeline clock for native ingest: buffer PTS plus the
+    // pipeline base time then equals the kernel receive timestamp of the packet
+    m_wallClock = GST_CLOCK(g_object_new(GST_TYPE_SYSTEM_CLOCK, "clock-type", GST_CLOCK_TYPE_REALTIME, nullptr));
+    m_unixTimestampCaps = gst_caps_new_empty_simple("timestamp/x-unix");
+    m_ready = true;
+
+    // Log GStreamer version for debugging/verification
+    LOG_DEBUG("VideoStreamReceiver", "GStreamer version: {}", gst_version_string());
+    emit readyChanged();
+
+    if (m_pendingPort > 0) {
+        int port = m_pendingPort;
+        m_pendingPort = 0;
+        startStream(port);
+    } else if (!m_active) {
+        setStatus("Ready");
+    }
 }
 
 /**
@@ -125,83 +336,263 @@ VideoStreamReceiver::~VideoStreamReceiver()
  * @param port UDP port number to listen on (typically 5000 or similar)
  *
  * This method creates a complete GStreamer pipeline for low-latency video reception.
- * If a stream is already running, it stops it first before starting the new one.
- *
- * Pipeline explanation:
- * 1. udpsrc - Receives UDP packets on specified port
- * 2. application/x-rtp,encoding-name=JPEG - Caps filter for RTP/JPEG
- * 3. rtpjpegdepay - Extracts JPEG frames from RTP packets
- * 4. jpegdec - Decodes JPEG to raw video frames
- * 5. videoconvert - Converts pixel format if needed
- * 6. video/x-raw,format=RGB - Forces RGB format for Qt compatibility
- * 7. appsink - Extracts frames for application use
+ * If a stream is already running, it stops it first before starting the new one
+ * (use switchStream() to change sources without blanking the display).
  */
 void VideoStreamReceiver::startStream(int port)
 {
-    qDebug() << "[VideoStreamReceiver::startStream] Called with port:" << port;
+    LOG_DEBUG("VideoStreamReceiver::startStream", "Called with port: {}", port);
+
+    // Still initializing in the background - start as soon as that is done
+    if (!m_ready && m_initThread.joinable()) {
+        LOG_DEBUG("VideoStreamReceiver::startStream", "GStreamer not ready yet, deferring");
+        m_pendingPort = port;
+        return;
+    }
+    ensureInitialized();
 
     // If a pipeline already exists, stop it first to avoid resource conflicts
-    if (m_pipeline) {
-        qDebug() << "[VideoStreamReceiver::startStream] Existing pipeline found, stopping it first";
+    if (m_active || m_pending) {
+        LOG_DEBUG("VideoStreamReceiver::startStream", "Existing pipeline found, stopping it first");
         stopStream();
     }
 
     // Update UI status to show stream is initializing
-    qDebug() << "[VideoStreamReceiver::startStream] Setting status to 'Starting stream...'";
+    LOG_DEBUG("VideoStreamReceiver::startStream", "Setting status to 'Starting stream...'");
     setStatus("Starting stream...");
 
+    QString errorMessage;
+    m_active = createPipeline(port, &errorMessage);
+    if (!m_active) {
+        LOG_WARN("VideoStreamReceiver::startStream", "ERROR: {}", errorMessage);
+        setStatus("Error: " + errorMessage);
+        emit errorOccurred(errorMessage);  // Notify UI of error
+        return;  // Abort startup
+    }
+
+    // Use Qt timer to poll bus instead of GLib's event loop (which conflicts with Qt)
+    // Create and start timer to check for messages every 50ms
+    LOG_DEBUG("VideoStreamReceiver::startStream", "Creating bus polling timer...");
+    m_busTimer = new QTimer(this);
+    connect(m_busTimer, &QTimer::timeout, this, &VideoStreamReceiver::checkBusMessages);
+    m_busTimer->start(50);  // Check bus 20 times per second
+    LOG_DEBUG("VideoStreamReceiver::startStream", "Bus polling timer started (50ms interval)");
+
+    // Create frame timeout timer to detect when no frames are being received
+    // Check every 1 second if we've received frames recently
+    LOG_DEBUG("VideoStreamReceiver::startStream", "Creating frame timeout timer...");
+    m_frameTimeoutTimer = new QTimer(this);
+    connect(m_frameTimeoutTimer, &QTimer::timeout, this, &VideoStreamReceiver::checkFrameTimeout);
+    m_frameTimeoutTimer->start(1000);  // Check every 1 second
+    LOG_DEBUG("VideoStreamReceiver::startStream", "Frame timeout timer started (1000ms interval)");
+
+    // Initialize frame timeout tracking
+    m_lastFrameTime = 0;  // No frames received yet
+    m_currentFrameRxNs = 0;
+
+    // Reset latency accumulators for the new stream
+    m_appsinkToGuiSumNs = 0;
+    m_appsinkToGuiMaxNs = 0;
+    m_appsinkToGuiCount = 0;
+    m_fpsTickFrames = m_frameCounter;
+    m_fpsTickMs = QDateTime::currentMSecsSinceEpoch();
+    setHasActiveStream(false);  // Start with no active stream until we receive frames
+
+    // Success! Update state and notify UI
+    LOG_DEBUG("VideoStreamReceiver::startStream", "Updating streaming state...");
+    setStreaming(true);  // Update property and emit signal
+    emit portChanged();
+    setStatus("Streaming on port " + QString::number(port));
+    LOG_DEBUG("VideoStreamReceiver::startStream", "Stream started successfully on port: {}", port);
+}
+
+/**
+ * @brief Switches the displayed stream to another port without a blackout
+ * @param port UDP port of the new source
+ *
+ * The current pipeline keeps feeding the display while a pending one starts on the
+ * new port. The cut-over happens in the GUI thread when the pending pipeline's first
+ * frame arrives (see processNewSample()); checkFrameTimeout() and checkBusMessages()
+ * abandon the switch if the new source stays silent or fails.
+ */
+void VideoStreamReceiver::switchStream(int port)
+{
+    LOG_DEBUG("VideoStreamReceiver::switchStream", "Called with port: {}", port);
+
+    // Nothing on screen to keep - a plain start is just as fast
+    if (!m_active) {
+        startStream(port);
+        return;
+    }
+
+    // Switching back to the port on screen cancels a switch in progress
+    if (port == m_active->port) {
+        if (m_pending) {
+            abandonSwitch(QString());
+        }
+        return;
+    }
+
+    bool wasSwitching = isSwitching();
+
+    // A newer request supersedes a switch that hasn't completed yet
+    if (m_pending) {
+        LOG_DEBUG("VideoStreamReceiver::switchStream", "Superseding pending switch to port {}", m_pending->port);
+        destroyPipeline(m_pending);
+    }
+
+    m_switchClock.start();
+    QString errorMessage;
+    m_pending = createPipeline(port, &errorMessage);
+    if (!m_pending) {
+        LOG_WARN("VideoStreamReceiver::switchStream", "ERROR: {}", errorMessage);
+        emit errorOccurred(QString("Switch to port %1 failed: %2").arg(port).arg(errorMessage));
+    } else {
+        setStatus(QString("Switching to port %1...").arg(port));
+    }
+
+    if (wasSwitching != isSwitching()) {
+        emit switchingChanged();
+    }
+}
+
+/**
+ * @brief Drops the pending pipeline; the active stream stays on screen
+ * @param error Reason reported through errorOccurred(), empty when cancelled
+ */
+void VideoStreamReceiver::abandonSwitch(const QString &error)
+{
+    if (!m_pending) {
+        return;
+    }
+
+    LOG_DEBUG("VideoStreamReceiver::abandonSwitch", "Abandoning switch to port {}", m_pending->port);
+    destroyPipeline(m_pending);
+    emit switchingChanged();
+
+    if (!error.isEmpty()) {
+        LOG_WARN("VideoStreamReceiver::abandonSwitch", "{}", error);
+        emit errorOccurred(error);
+    }
+    if (m_active) {
+        setStatus("Streaming on port " + QString::number(m_active->port));
+    }
+}
+
+/**
+ * @brief Builds, starts and returns a pipeline receiving on the given port
+ * @param port UDP port to receive on
+ * @param errorMessage Filled in on failure
+ * @return Running pipeline, or nullptr if any step failed
+ *
+ * Pipeline explanation:
+ * 1. udpsrc - Receives UDP packets on specified port (or appsrc fed by RtpReceiveEngine)
+ * 2. application/x-rtp,encoding-name=JPEG - Caps filter for RTP/JPEG
+ * 3. rtpjpegdepay - Extracts JPEG frames from RTP packets
+ * 4. jpegdec - Decodes JPEG to raw video frames
+ * 5. videoconvert - Converts pixel format if needed
+ * 6. video/x-raw,format=RGB - Forces RGB format for Qt compatibility
+ * 7. appsink - Extracts frames for application use
+ *
+ * GStreamer names each streaming thread after the element owning its task, so
+ * the element names show up in ThreadMonitor and traces: "rtp:src" runs the
+ * depayloader, "decode:src" the decoder, converter and appsink.
+ */
+std::unique_ptr<VideoStreamReceiver::StreamPipeline> VideoStreamReceiver::createPipeline(int port,
+                                                                                        QString *errorMessage)
+{
+    auto stream = std::make_unique<StreamPipeline>();
+    stream->receiver = this;
+    stream->generation = ++m_pipelineGeneration;
+    stream->port = port;
+    stream->measureCpu = m_externalIngest;
+
+    // Packet source: GStreamer's udpsrc, or an appsrc fed by our native receive engine
+    // (the engine binds the port itself and stamps packets with kernel RX times) or
+    // by pushExternalPacket()
+    bool appsrcSource = m_nativeIngest || m_externalIngest;
+    bool ownEngine = m_nativeIngest && !m_externalIngest;
+    QString sourceStr = appsrcSource
+        ? QString(
+            "appsrc name=rtp is-live=true format=time do-timestamp=false "   // Live source, PTS set by pushPacket()
+            "caps=\"application/x-rtp,media=video,clock-rate=90000,encoding-name=JPEG,payload=26\" ! ")
+        : QString(
+            "udpsrc name=rtp port=%1 buffer-size=200000 ! "           // UDP source with 200KB buffer (port substituted below)
+            "application/x-rtp,encoding-name=JPEG ! ").arg(port);  // RTP caps filter for JPEG payload
+
+    // Depayload/decode chain: built-in, or a custom one under evaluation (A/B comparison)
+    QString decodeStr = m_decoderChain.isEmpty()
+        ? QString(
+            "rtpjpegdepay ! "                                // RTP depayloader - extracts JPEG from RTP packets
+            "queue name=decode max-size-buffers=100 leaky=downstream ! "   // Queue with 2-frame buffer (smooth transitions)
+            //                        ^ drop oldest frames if queue fills up
+            "jpegdec ! "                                     // JPEG decoder - converts JPEG to raw video
+            "videoconvert ! "                                // Format converter - ensures compatible pixel format
+            "video/x-raw,format=RGB ! ")                     // Caps filter - force RGB format (Qt uses RGB)
+        : m_decoderChain + " ! ";
+
     // Build the GStreamer pipeline description string
     // This uses GStreamer's launch syntax to create and link elements
-    QString pipelineStr = QString(
-        "udpsrc port=%1 buffer-size=200000 ! "           // UDP source with 200KB buffer (port substituted below)
-        "application/x-rtp,encoding-name=JPEG ! "        // RTP caps filter for JPEG payload
-        "rtpjpegdepay ! "                                // RTP depayloader - extracts JPEG from RTP packets
-        "queue max-size-buffers=100 leaky=downstream ! "   // Queue with 2-frame buffer (smooth transitions)
-        //                        ^ drop oldest frames if queue fills up
-        "jpegdec ! "                                     // JPEG decoder - converts JPEG to raw video
-        "videoconvert ! "                                // Format converter - ensures compatible pixel format
-        "video/x-raw,format=RGB ! "                      // Caps filter - force RGB format (Qt uses RGB)
+    QString pipelineStr = sourceStr + decodeStr + QString(
         "appsink name=sink sync=false max-buffers=100 drop=false"  // App sink with 2-frame buffering
         //        ^ give it a name for later retrieval
         //                     ^ don't sync to clock (low latency)
         //                                ^ keep 2 buffers (retain previous frame)
         //                                                ^ let queue handle drops (smoother)
-    ).arg(port);  // Substitute %1 with actual port number
+    );
 
-    qDebug() << "[VideoStreamReceiver::startStream] Creating pipeline:" << pipelineStr;
+    LOG_DEBUG("VideoStreamReceiver::createPipeline", "Creating pipeline: {}", pipelineStr);
 
     // Parse and create the pipeline from the description string
-    qDebug() << "[VideoStreamReceiver::startStream] Calling gst_parse_launch...";
     GError *error = nullptr;  // GStreamer uses this for error reporting
-    m_pipeline = gst_parse_launch(pipelineStr.toUtf8().constData(), &error);
+    stream->pipeline = gst_parse_launch(pipelineStr.toUtf8().constData(), &error);
 
     // Check if pipeline creation failed
     if (error) {
-        QString errorMsg = QString("Failed to create pipeline: %1").arg(error->message);
-        qWarning() << "[VideoStreamReceiver::startStream] ERROR:" << errorMsg;
-        emit this->errorOccurred(errorMsg);  // Notify UI of error
-        setStatus("Error: " + QString(error->message));
+        *errorMessage = QString("Failed to create pipeline: %1").arg(error->message);
         g_error_free(error);  // Free GLib error object
-        return;  // Abort startup
+        destroyPipeline(stream);  // gst_parse_launch() may still have returned a partial pipeline
+        return nullptr;
     }
-    qDebug() << "[VideoStreamReceiver::startStream] Pipeline created successfully";
 
     // Extract the appsink element by name so we can configure it
     // The pipeline is a bin (container) of elements
-    qDebug() << "[VideoStreamReceiver::startStream] Getting appsink element...";
-    m_appsink = gst_bin_get_by_name(GST_BIN(m_pipeline), "sink");
-    if (!m_appsink) {
-        qWarning() << "[VideoStreamReceiver::startStream] ERROR: Failed to get appsink element";
-        setStatus("Error: Failed to initialize");
-        gst_object_unref(m_pipeline);  // Clean up the pipeline
-        m_pipeline = nullptr;
-        return;
+    stream->appsink = gst_bin_get_by_name(GST_BIN(stream->pipeline), "sink");
+    if (!stream->appsink) {
+        *errorMessage = "Failed to initialize";
+        destroyPipeline(stream);
+        return nullptr;
+    }
+
+    // Native ingest: grab the appsrc and run the pipeline on the wall clock so
+    // buffer PTS values can be converted back to kernel receive timestamps
+    if (appsrcSource) {
+        stream->appsrc = gst_bin_get_by_name(GST_BIN(stream->pipeline), "rtp");
+        if (!stream->appsrc) {
+            *errorMessage = "Failed to initialize";
+            destroyPipeline(stream);
+            return nullptr;
+        }
+        gst_pipeline_use_clock(GST_PIPELINE(stream->pipeline), m_wallClock);
+
+        // Bounded and leaky: late packets are worth less than fresh ones
+        gst_app_src_set_max_bytes(GST_APP_SRC(stream->appsrc), AppsrcMaxBytes);
+        #if GST_VERSION_MAJOR >= 1 && GST_VERSION_MINOR >= 20
+        gst_app_src_set_leaky_type(GST_APP_SRC(stream->appsrc), GST_APP_LEAKY_TYPE_DOWNSTREAM);
+        #else
+        LOG_WARN("VideoStreamReceiver::createPipeline", "GStreamer < 1.20: appsrc queue is not leaky");
+        #endif
+
+        // CPU accounting for the appsrc's streaming thread (depayloader up to the first queue)
+        if (stream->measureCpu) {
+            GstPad *pad = gst_element_get_static_pad(stream->appsrc, "src");
+            gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, onSourceBuffer, stream.get(), nullptr);
+            gst_object_unref(pad);
+        }
     }
-    qDebug() << "[VideoStreamReceiver::startStream] Appsink element retrieved successfully";
 
     // Configure callbacks for the appsink element
     // These callbacks are invoked when specific events occur
-    qDebug() << "[VideoStreamReceiver::startStream] Configuring appsink callbacks...";
     GstAppSinkCallbacks callbacks;
     callbacks.eos = nullptr;              // End-of-stream callback (not needed)
     callbacks.new_preroll = nullptr;      // Preroll callback (not needed)
@@ -211,175 +602,187 @@ void VideoStreamReceiver::startStream(int port)
     #endif
 
     // Register the callbacks with the appsink
-    // 'this' is passed as user_data and will be available in the callbacks
-    gst_app_sink_set_callbacks(GST_APP_SINK(m_appsink), &callbacks, this, nullptr);
-    //                                                                 ^      ^
-    //                                                                 |      destroy notify function (none)
-    //                                                                 user_data pointer (our instance)
-    qDebug() << "[VideoStreamReceiver::startStream] Appsink callbacks registered";
+    // The pipeline context is passed as user_data so frames know which source they came from
+    gst_app_sink_set_callbacks(GST_APP_SINK(stream->appsink), &callbacks, stream.get(), nullptr);
 
     // Get the message bus for the pipeline
     // The bus is used for asynchronous communication (errors, state changes, etc.)
-    qDebug() << "[VideoStreamReceiver::startStream] Getting message bus...";
-    m_bus = gst_element_get_bus(m_pipeline);
-    qDebug() << "[VideoStreamReceiver::startStream] Message bus retrieved";
-
-    // Use Qt timer to poll bus instead of GLib's event loop (which conflicts with Qt)
-    // Create and start timer to check for messages every 50ms
-    qDebug() << "[VideoStreamReceiver::startStream] Creating bus polling timer...";
-    m_busTimer = new QTimer(this);
-    connect(m_busTimer, &QTimer::timeout, this, &VideoStreamReceiver::checkBusMessages);
-    m_busTimer->start(50);  // Check bus 20 times per second
-    qDebug() << "[VideoStreamReceiver::startStream] Bus polling timer started (50ms interval)";
-
-    // Create frame timeout timer to detect when no frames are being received
-    // Check every 1 second if we've received frames recently
-    qDebug() << "[VideoStreamReceiver::startStream] Creating frame timeout timer...";
-    m_frameTimeoutTimer = new QTimer(this);
-    connect(m_frameTimeoutTimer, &QTimer::timeout, this, &VideoStreamReceiver::checkFrameTimeout);
-    m_frameTimeoutTimer->start(1000);  // Check every 1 second
-    qDebug() << "[VideoStreamReceiver::startStream] Frame timeout timer started (1000ms interval)";
-
-    // Initialize frame timeout tracking
-    m_lastFrameTime = 0;  // No frames received yet
-    setHasActiveStream(false);  // Start with no active stream until we receive frames
+    stream->bus = gst_element_get_bus(stream->pipeline);
 
     // Transition the pipeline to PLAYING state
     // GStreamer uses state machine: NULL -> READY -> PAUSED -> PLAYING
-    qDebug() << "[VideoStreamReceiver::startStream] Setting pipeline state to PLAYING...";
-    GstStateChangeReturn ret = gst_element_set_state(m_pipeline, GST_STATE_PLAYING);
-    qDebug() << "[VideoStreamReceiver::startStream] gst_element_set_state returned:" << ret;
+    GstStateChangeReturn ret = gst_element_set_state(stream->pipeline, GST_STATE_PLAYING);
+    LOG_DEBUG("VideoStreamReceiver::createPipeline", "gst_element_set_state returned: {}", ret);
 
     if (ret == GST_STATE_CHANGE_FAILURE) {
         // Pipeline couldn't start (maybe port already in use, wrong format, etc.)
-        qWarning() << "[VideoStreamReceiver::startStream] ERROR: Failed to start pipeline";
-        setStatus("Error: Failed to start");
-        emit errorOccurred("Failed to start stream");
-        stopStream();  // Clean up
+        *errorMessage = "Failed to start";
+        destroyPipeline(stream);
+        return nullptr;
+    }
+
+    // Native ingest: start receiving only once the appsrc can accept buffers. The
+    // port's router (shared with other receivers on the port) hands this pipeline
+    // one RTP stream, so its depayloader never sees another camera's packets
+    if (ownEngine) {
+        RtpReceiveEngine::Config config;
+        config.port = static_cast<quint16>(port);
+        config.shards = m_ingestShards;
+        config.pinThreads = m_pinIngestThreads;
+
+        stream->ingest = RtpStreamRouter::acquire(config);
+        if (!stream->ingest) {
+            *errorMessage = "Failed to bind UDP port " + QString::number(port);
+            destroyPipeline(stream);
+            return nullptr;
+        }
+
+        StreamPipeline *target = stream.get();
+        stream->ingestStream = stream->ingest->addStream([this, target](const RtpReceiveEngine::Packet &packet) {
+            pushPacket(target, packet);
+        });
+    }
+
+    return stream;
+}
+
+/**
+ * @brief Shuts a pipeline down and releases all of its GStreamer resources
+ * @param stream Pipeline to destroy; may be null or partially constructed
+ *
+ * Cleanup order is important:
+ * 1. Leave the port's router (its receive threads push into the appsrc)
+ * 2. Flush the bus and set the pipeline to NULL state (stops all processing)
+ * 3. Unref the elements taken with gst_bin_get_by_name() and the bus
+ * 4. Unref the pipeline (which also unrefs all remaining elements)
+ */
+void VideoStreamReceiver::destroyPipeline(std::unique_ptr<StreamPipeline> &stream)
+{
+    if (!stream) {
         return;
     }
 
-    // Success! Update state and notify UI
-    qDebug() << "[VideoStreamReceiver::startStream] Pipeline state change successful";
-    qDebug() << "[VideoStreamReceiver::startStream] Updating streaming state...";
-    setStreaming(true);  // Update property and emit signal
-    setStatus("Streaming on port " + QString::number(port));
-    qDebug() << "[VideoStreamReceiver::startStream] Stream started successfully on port:" << port;
-    qDebug() << "[VideoStreamReceiver::startStream] startStream() completed successfully";
+    LOG_DEBUG("VideoStreamReceiver::destroyPipeline", "Destroying pipeline for port {}", stream->port);
+
+    // Leave the router before anything its threads push into goes away; the last
+    // receiver on the port stops the receive threads
+    if (stream->ingest) {
+        stream->ingest->removeStream(stream->ingestStream);
+        stream->ingest.reset();
+    }
+
+    // Flush any remaining messages from the bus before shutting down
+    // This prevents warnings about unhandled messages
+    if (stream->bus) {
+        GstMessage *msg;
+        while ((msg = gst_bus_pop(stream->bus)) != nullptr) {
+            gst_message_unref(msg);
+        }
+    }
+
+    // Transition pipeline to NULL state
+    // This stops all processing and releases hardware resources
+    // State transitions: PLAYING -> PAUSED -> READY -> NULL
+    if (stream->pipeline) {
+        GstStateChangeReturn ret = gst_element_set_state(stream->pipeline, GST_STATE_NULL);
+        if (ret == GST_STATE_CHANGE_FAILURE) {
+            LOG_WARN("VideoStreamReceiver::destroyPipeline", "Failed to set pipeline to NULL state");
+        }
+    }
+
+    // Don't wait for state change during shutdown - it can hang if event loop is stopped
+    // The pipeline will finish transitioning asynchronously before being unreferenced
+
+    // Unreference the appsink and appsrc
+    // gst_bin_get_by_name() adds a reference, so we must unref them
+    // Do this BEFORE unreferencing the pipeline
+    if (stream->appsink) {
+        gst_object_unref(stream->appsink);
+        stream->appsink = nullptr;
+    }
+    if (stream->appsrc) {
+        gst_object_unref(stream->appsrc);
+        stream->appsrc = nullptr;
+    }
+
+    // Clean up the message bus
+    if (stream->bus) {
+        gst_object_unref(stream->bus);
+        stream->bus = nullptr;
+    }
+
+    // Unreference the pipeline last
+    // This decreases the reference count and will automatically free the pipeline
+    // and all its elements when the count reaches 0
+    if (stream->pipeline) {
+        gst_object_unref(stream->pipeline);
+        stream->pipeline = nullptr;
+    }
+
+    stream.reset();
 }
 
 /**
  * @brief Stops the video stream and releases all GStreamer resources
  *
- * This method safely shuts down the pipeline and cleans up all allocated resources.
+ * This method safely shuts down the pipeline (and a pending switch target, if any)
+ * and cleans up all allocated resources.
  * It's safe to call multiple times or when no stream is running.
- *
- * Cleanup order is important:
- * 1. Set pipeline to NULL state (stops all processing)
- * 2. Remove bus watch and unref bus
- * 3. Unref pipeline (which also unrefs all elements including appsink)
- * 4. Update state flags
  */
 void VideoStreamReceiver::stopStream()
 {
-    qDebug() << "[VideoStreamReceiver::stopStream] Called";
+    LOG_DEBUG("VideoStreamReceiver::stopStream", "Called");
+    m_pendingPort = 0;  // A start deferred until GStreamer is ready is cancelled too
 
     // Only proceed if we have an active pipeline
-    if (m_pipeline) {
-        qDebug() << "[VideoStreamReceiver::stopStream] Active pipeline found, stopping...";
+    if (m_active || m_pending) {
+        LOG_DEBUG("VideoStreamReceiver::stopStream", "Active pipeline found, stopping...");
 
         // CRITICAL: Stop timers FIRST to prevent callbacks during cleanup
         // This prevents race conditions where callbacks try to access pipeline being destroyed
         if (m_busTimer) {
-            qDebug() << "[VideoStreamReceiver::stopStream] Stopping bus polling timer...";
+            LOG_DEBUG("VideoStreamReceiver::stopStream", "Stopping bus polling timer...");
             m_busTimer->stop();
-            qDebug() << "[VideoStreamReceiver::stopStream] Disconnecting bus timer...";
             m_busTimer->disconnect();  // Disconnect all signals to prevent callbacks during deletion
-            qDebug() << "[VideoStreamReceiver::stopStream] Deleting bus timer...";
             m_busTimer->deleteLater();  // Use deleteLater instead of delete for safety
             m_busTimer = nullptr;
-            qDebug() << "[VideoStreamReceiver::stopStream] Bus timer marked for deletion";
+            LOG_DEBUG("VideoStreamReceiver::stopStream", "Bus timer marked for deletion");
         }
 
         if (m_frameTimeoutTimer) {
-            qDebug() << "[VideoStreamReceiver::stopStream] Stopping frame timeout timer...";
+            LOG_DEBUG("VideoStreamReceiver::stopStream", "Stopping frame timeout timer...");
             m_frameTimeoutTimer->stop();
-            qDebug() << "[VideoStreamReceiver::stopStream] Disconnecting frame timeout timer...";
             m_frameTimeoutTimer->disconnect();  // Disconnect all signals
-            qDebug() << "[VideoStreamReceiver::stopStream] Deleting frame timeout timer...";
             m_frameTimeoutTimer->deleteLater();  // Use deleteLater for safety
             m_frameTimeoutTimer = nullptr;
-            qDebug() << "[VideoStreamReceiver::stopStream] Frame timeout timer marked for deletion";
-        }
-
-        // Flush any remaining messages from the bus before shutting down
-        // This prevents warnings about unhandled messages
-        if (m_bus) {
-            qDebug() << "[VideoStreamReceiver::stopStream] Flushing remaining bus messages...";
-            GstMessage *msg;
-            while ((msg = gst_bus_pop(m_bus)) != nullptr) {
-                gst_message_unref(msg);
-            }
-            qDebug() << "[VideoStreamReceiver::stopStream] Bus flushed";
-        }
-
-        // Transition pipeline to NULL state
-        // This stops all processing and releases hardware resources
-        // State transitions: PLAYING -> PAUSED -> READY -> NULL
-        qDebug() << "[VideoStreamReceiver::stopStream] Setting pipeline state to NULL...";
-        GstStateChangeReturn ret = gst_element_set_state(m_pipeline, GST_STATE_NULL);
-
-        if (ret == GST_STATE_CHANGE_FAILURE) {
-            qWarning() << "[VideoStreamReceiver::stopStream] Failed to set pipeline to NULL state";
-        } else {
-            qDebug() << "[VideoStreamReceiver::stopStream] Pipeline state change initiated";
-        }
-
-        // Don't wait for state change during shutdown - it can hang if event loop is stopped
-        // The pipeline will finish transitioning asynchronously before being unreferenced
-
-        // Unreference the appsink
-        // gst_bin_get_by_name() adds a reference, so we must unref it
-        // Do this BEFORE unreferencing the pipeline
-        if (m_appsink) {
-            qDebug() << "[VideoStreamReceiver::stopStream] Unreferencing appsink...";
-            gst_object_unref(m_appsink);
-            m_appsink = nullptr;
-            qDebug() << "[VideoStreamReceiver::stopStream] Appsink unreferenced";
+            LOG_DEBUG("VideoStreamReceiver::stopStream", "Frame timeout timer marked for deletion");
         }
 
-        // Clean up the message bus
-        if (m_bus) {
-            qDebug() << "[VideoStreamReceiver::stopStream] Unreferencing message bus...";
-            gst_object_unref(m_bus);      // Decrease reference count (will free if count reaches 0)
-            m_bus = nullptr;              // Clear our pointer
-            qDebug() << "[VideoStreamReceiver::stopStream] Message bus unreferenced";
+        // Tear down a switch in progress first, then the pipeline on screen
+        bool wasSwitching = isSwitching();
+        destroyPipeline(m_pending);
+        destroyPipeline(m_active);
+        if (wasSwitching) {
+            emit switchingChanged();
         }
 
-        // Unreference the pipeline last
-        // This decreases the reference count and will automatically free the pipeline
-        // and all its elements when the count reaches 0
-        qDebug() << "[VideoStreamReceiver::stopStream] Unreferencing pipeline...";
-        gst_object_unref(m_pipeline);
-        m_pipeline = nullptr;   // Clear our pointer
-        qDebug() << "[VideoStreamReceiver::stopStream] Pipeline unreferenced";
-
         // Update state and notify UI
-        qDebug() << "[VideoStreamReceiver::stopStream] Updating streaming state to false...";
+        LOG_DEBUG("VideoStreamReceiver::stopStream", "Updating streaming state to false...");
         setStreaming(false);    // Update property and emit streamingChanged signal
         setHasActiveStream(false);  // No active stream when stopped
+        emit portChanged();
         setStatus("Stopped");   // Update status and emit statusChanged signal
-        qDebug() << "[VideoStreamReceiver::stopStream] Stream stopped successfully";
+        LOG_DEBUG("VideoStreamReceiver::stopStream", "Stream stopped successfully");
     } else {
-        qDebug() << "[VideoStreamReceiver::stopStream] No active pipeline, nothing to stop";
+        LOG_DEBUG("VideoStreamReceiver::stopStream", "No active pipeline, nothing to stop");
     }
-    qDebug() << "[VideoStreamReceiver::stopStream] stopStream() completed";
+    LOG_DEBUG("VideoStreamReceiver::stopStream", "stopStream() completed");
 }
 
 /**
  * @brief Static callback invoked by GStreamer when a new decoded frame is available
  * @param appsink The appsink element that has a new sample ready
- * @param user_data Pointer to VideoStreamReceiver instance (set in startStream)
+ * @param user_data Pointer to the StreamPipeline the appsink belongs to (set in createPipeline)
  * @return GST_FLOW_OK to continue processing, or error code to stop pipeline
  *
  * IMPORTANT: This is called from GStreamer's streaming thread, NOT the main Qt thread!
@@ -388,22 +791,23 @@ void VideoStreamReceiver::stopStream()
  */
 GstFlowReturn VideoStreamReceiver::onNewSample(GstAppSink *appsink, gpointer user_data)
 {
-    // Cast the generic pointer back to our VideoStreamReceiver instance
-    // This pointer was passed to gst_app_sink_set_callbacks() in startStream()
-    VideoStreamReceiver *receiver = static_cast<VideoStreamReceiver*>(user_data);
+    // Cast the generic pointer back to the pipeline context
+    // This pointer was passed to gst_app_sink_set_callbacks() in createPipeline()
+    StreamPipeline *stream = static_cast<StreamPipeline*>(user_data);
+    TRACE_SCOPE("onNewSample");
 
     // Pull the sample (frame + metadata) from the appsink
     // This removes it from the appsink's internal queue
     GstSample *sample = gst_app_sink_pull_sample(appsink);
     if (sample) {
         // Process the sample (extract image data, update QImage, emit signal)
-        receiver->processNewSample(sample);
+        stream->receiver->processNewSample(stream, sample);
 
         // Decrease reference count on the sample
         // GStreamer will free it when ref count reaches 0
         gst_sample_unref(sample);
     } else {
-        qWarning() << "[VideoStreamReceiver::onNewSample] WARNING: Sample is null";
+        LOG_WARN("VideoStreamReceiver::onNewSample", "WARNING: Sample is null");
     }
 
     // Return GST_FLOW_OK to tell GStreamer everything is fine and to continue
@@ -413,6 +817,7 @@ GstFlowReturn VideoStreamReceiver::onNewSample(GstAppSink *appsink, gpointer use
 
 /**
  * @brief Processes a new video sample from GStreamer and converts it to QImage
+ * @param stream Pipeline that produced the sample
  * @param sample GStreamer sample containing the video frame buffer and metadata (caps)
  *
  * This method extracts the raw RGB data from the GStreamer buffer and creates a QImage.
@@ -428,9 +833,13 @@ GstFlowReturn VideoStreamReceiver::onNewSample(GstAppSink *appsink, gpointer use
  * 4. Create QImage from the raw data (deep copy so it's safe across threads)
  * 5. Unmap buffer to release memory lock
  * 6. Marshal the QImage to main thread using QMetaObject::invokeMethod
+ * 7. On the main thread: cut over if the frame is the first of a pending switch,
+ *    drop it if its pipeline is no longer on screen
  */
-void VideoStreamReceiver::processNewSample(GstSample *sample)
+void VideoStreamReceiver::processNewSample(StreamPipeline *stream, GstSample *sample)
 {
+    TRACE_SCOPE("processNewSample");
+
     // Extract the buffer (contains actual pixel data) from the sample
     GstBuffer *buffer = gst_sample_get_buffer(sample);
 
@@ -440,22 +849,32 @@ void VideoStreamReceiver::processNewSample(GstSample *sample)
 
     // Sanity check - both must exist for us to proceed
     if (!buffer || !caps) {
-        qWarning() << "[VideoStreamReceiver::processNewSample] ERROR: Buffer or caps is null, skipping frame";
+        LOG_WARN("VideoStreamReceiver::processNewSample", "ERROR: Buffer or caps is null, skipping frame");
+        videoMetrics().decodeDrops.increment();
         return;  // Silently skip this frame
     }
 
     // Parse the caps into a GstVideoInfo structure for easy access to video parameters
     GstVideoInfo videoInfo;
     if (!gst_video_info_from_caps(&videoInfo, caps)) {
-        qWarning() << "[VideoStreamReceiver::processNewSample] ERROR: Failed to parse video info from caps";
+        LOG_WARN("VideoStreamReceiver::processNewSample", "ERROR: Failed to parse video info from caps");
+        videoMetrics().decodeDrops.increment();
         return;  // Can't proceed without knowing the format
     }
 
+    // A custom decoder chain must deliver RGB like the built-in one
+    if (GST_VIDEO_INFO_FORMAT(&videoInfo) != GST_VIDEO_FORMAT_RGB) {
+        LOG_WARN("VideoStreamReceiver::processNewSample", "ERROR: Decoder chain must output RGB, got {}", gst_video_format_to_string(GST_VIDEO_INFO_FORMAT(&videoInfo)));
+        videoMetrics().decodeDrops.increment();
+        return;
+    }
+
     // Map the buffer to access the raw pixel data
     // Mapping locks the buffer and gives us a pointer to its memory
     GstMapInfo map;
     if (!gst_buffer_map(buffer, &map, GST_MAP_READ)) {
-        qWarning() << "[VideoStreamReceiver::processNewSample] ERROR: Failed to map buffer";
+        LOG_WARN("VideoStreamReceiver::processNewSample", "ERROR: Failed to map buffer");
+        videoMetrics().decodeDrops.increment();
         return;  // Can't access the data
     }
 
@@ -466,39 +885,88 @@ void VideoStreamReceiver::processNewSample(GstSample *sample)
     //                                                   ^
     //                                                   plane 0 (RGB has only one plane)
 
-    // Create QImage from the raw buffer data
-    // We MUST call .copy() because:
-    // 1. map.data will be invalid after we unmap the buffer
-    // 2. QImage needs to own its own data for thread safety
-    // 3. This QImage will be passed to the main thread
+    // Copy the frame out of the GStreamer buffer and flip it to the correct
+    // orientation in one pass: mirrored() always returns a new image that owns its
+    // pixels, so it stays valid after map.data is unmapped and can be passed to the
+    // main thread (a .copy() first would copy every frame twice)
     QImage newImage = QImage(map.data, width, height, stride,
-                             QImage::Format_RGB888).copy();
+                             QImage::Format_RGB888).mirrored(true, true);
     //                       ^ RGB format (8 bits per channel, 3 channels)
-    //                                             ^ deep copy the data
-
-    // Flip the image horizontally and vertically to correct orientation
-    newImage = newImage.mirrored(true, true);
-    //                           ^     ^
-    //                           |     vertical flip
-    //                           horizontal flip
+    //                                                         ^     ^
+    //                                                         |     vertical flip
+    //                                                         horizontal flip
 
     // Unmap the buffer to release the memory lock
     // After this, map.data is invalid and should not be accessed
     gst_buffer_unmap(buffer, &map);
 
+    // Latency bookkeeping: in native ingest mode PTS + base time is the kernel
+    // receive time of the packet that completed this frame (see pushPacket())
+    qint64 appsinkNs = TimestampedUdpSocket::wallClockNs();
+    qint64 rxNs = 0;
+    GstClockTime pts = GST_BUFFER_PTS(buffer);
+    if (stream->appsrc && GST_CLOCK_TIME_IS_VALID(pts)) {
+        rxNs = static_cast<qint64>(pts + gst_element_get_base_time(stream->pipeline));
+        accumulateLatency(stream->rxToAppsinkSumNs, stream->rxToAppsinkMaxNs, stream->rxToAppsinkCount,
+                          appsinkNs - rxNs);
+        videoMetrics().rxToAppsink.observeNs(appsinkNs - rxNs);
+    }
+    videoMetrics().framesDecoded.increment();
+
+    // Single writer (this streaming thread): load + store is enough
+    stream->framesDecoded.store(stream->framesDecoded.load(std::memory_order_relaxed) + 1,
+                                std::memory_order_relaxed);
+    if (stream->measureCpu) {
+        stream->sinkThreadCpuNs.store(currentThreadCpuNs(), std::memory_order_relaxed);
+        stream->sinkThreadId.store(currentThreadKey(), std::memory_order_relaxed);
+    }
+
+    // The pipeline may be torn down before the lambda runs - identify it by generation
+    quint64 generation = stream->generation;
+    videoMetrics().handoffQueueDepth.add(1);
+
     // CRITICAL: We're in GStreamer's thread, but Qt objects must be updated on main thread!
     // Use QMetaObject::invokeMethod to safely marshal the image to the main thread
     // Qt::QueuedConnection ensures the lambda runs on the main thread
-    QMetaObject::invokeMethod(this, [this, newImage]() {
+    QMetaObject::invokeMethod(this, [this, newImage, appsinkNs, rxNs, generation]() {
         // This lambda runs on the main Qt thread, so it's safe to update Qt objects
+        TRACE_SCOPE("frameHandoff");
+        VideoMetrics &metrics = videoMetrics();
+        metrics.handoffQueueDepth.add(-1);
+
+        // First frame of the source being switched to: promote it to active. The old
+        // pipeline is only torn down after this frame is on screen, so the display
+        // never goes blank; frames it still has queued are dropped below.
+        std::unique_ptr<StreamPipeline> previous;
+        if (m_pending && m_pending->generation == generation) {
+            m_lastSwitchMs = m_switchClock.nsecsElapsed() / 1e6;
+            previous = std::move(m_active);
+            m_active = std::move(m_pending);
+            m_appsinkToGuiSumNs = 0;
+            m_appsinkToGuiMaxNs = 0;
+            m_appsinkToGuiCount = 0;
+        } else if (!m_active || m_active->generation != generation) {
+            metrics.handoffDrops.increment();
+            return;  // Frame from a pending or torn-down pipeline - not on screen
+        }
+
+        // Time spent waiting in the GUI thread's event queue
+        qint64 handoffNs = TimestampedUdpSocket::wallClockNs() - appsinkNs;
+        accumulateLatency(m_appsinkToGuiSumNs, m_appsinkToGuiMaxNs, m_appsinkToGuiCount, handoffNs);
+        metrics.appsinkToGui.observeNs(handoffNs);
+        metrics.framesDisplayed.increment();
 
         // Update the current image (thread-safe now)
         m_currentImage = newImage;
+        m_currentFrameRxNs = rxNs;
 
         // Generate a new unique frame ID for QML
         // QML monitors the currentFrame property; changing it triggers Image reload
         m_frameCounter++;  // Increment to next frame number
-        m_frameId = QString("frame_%1").arg(m_frameCounter);  // e.g., "frame_42"
+        char frameId[32];
+        int frameIdLength = std::snprintf(frameId, sizeof(frameId), "frame_%d", m_frameCounter);  // e.g., "frame_42"
+        m_frameId.resize(0);  // Rewritten in place: keeps the capacity unless QML still shares the old ID
+        m_frameId.append(QLatin1String(frameId, frameIdLength));
 
         // Update last frame time for timeout detection
         m_lastFrameTime = QDateTime::currentMSecsSinceEpoch();
@@ -512,7 +980,18 @@ void VideoStreamReceiver::processNewSample(GstSample *sample)
         // Emit signal to notify QML that a new frame is available
         // QML will call currentFrame() getter, see it changed, and call requestImage()
         // Safe to emit from main thread
+        TRACE_FRAME();
         emit frameChanged();
+
+        if (previous) {
+            destroyPipeline(previous);
+            LOG_DEBUG("VideoStreamReceiver::processNewSample", "Switched to port {} in {} ms", m_active->port, m_lastSwitchMs);
+            setStatus(QString("Streaming on port %1 (switched in %2 ms)")
+                          .arg(m_active->port).arg(m_lastSwitchMs, 0, 'f', 0));
+            emit switchingChanged();
+            emit portChanged();
+            emit switchCompleted(m_active->port, m_lastSwitchMs);
+        }
     }, Qt::QueuedConnection);
     //     ^ IMPORTANT: Queued connection ensures lambda executes on object's thread (main thread)
 }
@@ -521,7 +1000,7 @@ void VideoStreamReceiver::processNewSample(GstSample *sample)
  * @brief Static callback for GStreamer bus messages (errors, warnings, state changes)
  * @param bus The message bus (unused)
  * @param message The message to process
- * @param user_data Pointer to VideoStreamReceiver instance (set in startStream)
+ * @param user_data Pointer to the StreamPipeline the bus belongs to
  * @return TRUE to continue receiving messages, FALSE to stop
  *
  * The GStreamer bus is used for asynchronous event notification.
@@ -532,19 +1011,38 @@ gboolean VideoStreamReceiver::busCallback(GstBus *bus, GstMessage *message, gpoi
 {
     Q_UNUSED(bus)  // We don't need the bus pointer - we just process the message
 
-    // Cast the generic pointer back to our VideoStreamReceiver instance
-    VideoStreamReceiver *receiver = static_cast<VideoStreamReceiver*>(user_data);
+    // Cast the generic pointer back to the pipeline context
+    StreamPipeline *stream = static_cast<StreamPipeline*>(user_data);
 
     // Delegate to member function for actual message handling
-    receiver->handleBusMessage(message);
+    stream->receiver->handleBusMessage(stream, message);
 
     // Return TRUE to keep receiving messages
     // Returning FALSE would stop the bus watch
     return TRUE;
 }
 
+/**
+ * @brief Samples the CPU time of the appsrc's streaming thread on every buffer
+ * @param pad The appsrc source pad (unused)
+ * @param info Probe info (unused - the buffer passes through untouched)
+ * @param user_data Pointer to the StreamPipeline the appsrc belongs to
+ * @return GST_PAD_PROBE_OK to let the buffer through
+ */
+GstPadProbeReturn VideoStreamReceiver::onSourceBuffer(GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+    Q_UNUSED(pad)
+    Q_UNUSED(info)
+
+    StreamPipeline *stream = static_cast<StreamPipeline*>(user_data);
+    stream->sourceThreadCpuNs.store(currentThreadCpuNs(), std::memory_order_relaxed);
+    stream->sourceThreadId.store(currentThreadKey(), std::memory_order_relaxed);
+    return GST_PAD_PROBE_OK;
+}
+
 /**
  * @brief Handles different types of messages from the GStreamer pipeline bus
+ * @param stream Pipeline whose bus delivered the message
  * @param message The GStreamer message to process
  *
  * The bus carries various types of messages:
@@ -554,10 +1052,13 @@ gboolean VideoStreamReceiver::busCallback(GstBus *bus, GstMessage *message, gpoi
  * - STATE_CHANGED: Pipeline state transitions
  * - And many others (INFO, TAG, etc.) that we ignore
  *
- * This method is called from busCallback() when messages arrive.
+ * Errors from a pending switch target don't touch the UI; they are recorded and
+ * checkBusMessages() abandons the switch.
  */
-void VideoStreamReceiver::handleBusMessage(GstMessage *message)
+void VideoStreamReceiver::handleBusMessage(StreamPipeline *stream, GstMessage *message)
 {
+    bool pending = stream == m_pending.get();
+
     // Process different message types using a switch statement
     switch (GST_MESSAGE_TYPE(message)) {
         case GST_MESSAGE_ERROR: {
@@ -570,12 +1071,19 @@ void VideoStreamReceiver::handleBusMessage(GstMessage *message)
 
             // Convert to Qt string for logging and UI display
             QString errorMsg = QString("GStreamer error: %1").arg(err->message);
-            qWarning() << errorMsg;
-            qWarning() << "Debug info:" << debug;  // Usually contains element names, file:line, etc.
-
-            // Update status and notify UI
-            setStatus("Error: " + QString(err->message));
-            emit errorOccurred(errorMsg);  // QML can connect to this signal to show error dialogs
+            LOG_WARN("VideoStreamReceiver::handleBusMessage", "{}", errorMsg);
+            LOG_WARN("VideoStreamReceiver::handleBusMessage", "Debug info: {}", debug);  // Usually contains element names, file:line, etc.
+
+            if (pending) {
+                // Keep the current stream on screen; the switch is abandoned after the bus is drained
+                if (stream->error.isEmpty()) {
+                    stream->error = QString("Switch to port %1 failed: %2").arg(stream->port).arg(err->message);
+                }
+            } else {
+                // Update status and notify UI
+                setStatus("Error: " + QString(err->message));
+                emit errorOccurred(errorMsg);  // QML can connect to this signal to show error dialogs
+            }
 
             // Free GLib-allocated memory
             g_error_free(err);   // Free the error structure
@@ -592,7 +1100,7 @@ void VideoStreamReceiver::handleBusMessage(GstMessage *message)
             gst_message_parse_warning(message, &warn, &debug);
 
             // Log to console - we don't update UI for warnings
-            qWarning() << "GStreamer warning:" << warn->message;
+            LOG_WARN("VideoStreamReceiver::handleBusMessage", "GStreamer warning: {}", warn->message);
 
             // Free GLib-allocated memory
             g_error_free(warn);
@@ -604,14 +1112,16 @@ void VideoStreamReceiver::handleBusMessage(GstMessage *message)
             // End-of-stream message
             // This shouldn't normally happen with a live UDP stream (which has no "end")
             // But could occur if sender disconnects gracefully
-            qDebug() << "End of stream";
-            setStatus("Stream ended");
+            LOG_DEBUG("VideoStreamReceiver::handleBusMessage", "End of stream on port {}", stream->port);
+            if (!pending) {
+                setStatus("Stream ended");
+            }
             break;
 
         case GST_MESSAGE_STATE_CHANGED: {
             // State change notification
             // Many elements send these, but we only care about the pipeline's state
-            if (GST_MESSAGE_SRC(message) == GST_OBJECT(m_pipeline)) {
+            if (GST_MESSAGE_SRC(message) == GST_OBJECT(stream->pipeline)) {
                 GstState oldState, newState, pendingState;
 
                 // Parse state change details
@@ -619,9 +1129,9 @@ void VideoStreamReceiver::handleBusMessage(GstMessage *message)
 
                 // Log state transition for debugging
                 // e.g., "Pipeline state: READY -> PAUSED"
-                qDebug() << "Pipeline state:"
-                         << gst_element_state_get_name(oldState)  // e.g., "READY"
-                         << "->" << gst_element_state_get_name(newState);  // e.g., "PAUSED"
+                LOG_DEBUG("VideoStreamReceiver::handleBusMessage", "Pipeline state (port {}): {} -> {}", stream->port,
+                          gst_element_state_get_name(oldState),   // e.g., "READY"
+                          gst_element_state_get_name(newState));  // e.g., "PAUSED"
             }
             // Ignore state changes from individual elements (udpsrc, jpegdec, etc.)
             break;
@@ -645,6 +1155,7 @@ void VideoStreamReceiver::handleBusMessage(GstMessage *message)
  * - "Ready" - Initial state
  * - "Starting stream..." - During initialization
  * - "Streaming on port 5000" - Active streaming
+ * - "Switching to port 5001..." - Waiting for a new source's first frame
  * - "Error: <message>" - Error occurred
  * - "Stopped" - Stream stopped
  */
@@ -706,21 +1217,35 @@ void VideoStreamReceiver::setHasActiveStream(bool hasActiveStream)
  * Called periodically by QTimer (every 1 second) to detect stream timeout.
  * If no frames have been received for 3 seconds, marks the stream as inactive.
  * This allows the UI to show "No connection" even when the pipeline is running.
+ * Also abandons a switch whose new source hasn't produced a frame in time.
  */
 void VideoStreamReceiver::checkFrameTimeout()
 {
     // Only check if pipeline is running and timer still exists
-    if (!m_isStreaming || !m_pipeline || !m_frameTimeoutTimer) {
+    if (!m_isStreaming || !m_active || !m_frameTimeoutTimer) {
         return;
     }
 
+    // Displayed frame rate over the last tick (exported as driver_video_fps)
+    qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    if (nowMs > m_fpsTickMs) {
+        videoMetrics().fps.set((m_frameCounter - m_fpsTickFrames) * 1000.0 / (nowMs - m_fpsTickMs));
+    }
+    m_fpsTickFrames = m_frameCounter;
+    m_fpsTickMs = nowMs;
+
+    if (m_pending && m_switchClock.elapsed() > SwitchTimeoutMs) {
+        abandonSwitch(QString("No video on port %1 - staying on port %2")
+                          .arg(m_pending->port).arg(m_active->port));
+    }
+
     // If we've never received a frame, check if we should mark it as timeout
     if (m_lastFrameTime == 0) {
         // Pipeline is running but no frames received yet
         if (m_hasActiveStream) {
             setHasActiveStream(false);
             setStatus("Waiting for video stream...");
-            qDebug() << "[VideoStreamReceiver::checkFrameTimeout] No frames received yet";
+            LOG_DEBUG("VideoStreamReceiver::checkFrameTimeout", "No frames received yet");
         }
         return;
     }
@@ -734,8 +1259,7 @@ void VideoStreamReceiver::checkFrameTimeout()
         if (m_hasActiveStream) {
             setHasActiveStream(false);
             setStatus("No video stream (timeout)");
-            qDebug() << "[VideoStreamReceiver::checkFrameTimeout] Stream timeout - last frame received"
-                     << timeSinceLastFrame << "ms ago";
+            LOG_DEBUG("VideoStreamReceiver::checkFrameTimeout", "Stream timeout - last frame received {} ms ago", timeSinceLastFrame);
         }
     }
 }
@@ -746,34 +1270,288 @@ void VideoStreamReceiver::checkFrameTimeout()
  * Called periodically by QTimer to poll the bus for messages.
  * This avoids using GLib's main loop which conflicts with Qt's event loop.
  * We poll the bus using gst_bus_pop() which doesn't require GLib integration.
+ * Both the active and a pending pipeline's bus are drained.
  */
 void VideoStreamReceiver::checkBusMessages()
 {
-    // Check if bus and timer still exist (prevents access during cleanup)
-    if (!m_bus || !m_busTimer || !m_pipeline) {
+    TRACE_SCOPE("checkBusMessages");
+
+    // Check if pipeline and timer still exist (prevents access during cleanup)
+    if (!m_busTimer || !m_active) {
         return;
     }
 
     // Poll for messages without blocking
     // gst_bus_pop() returns nullptr if no messages are available
-    GstMessage *message;
     int messageCount = 0;
-    while ((message = gst_bus_pop(m_bus)) != nullptr) {
-        messageCount++;
-        qDebug() << "[VideoStreamReceiver::checkBusMessages] Message" << messageCount << "received, type:" << GST_MESSAGE_TYPE_NAME(message);
+    auto drain = [this, &messageCount](StreamPipeline *stream) {
+        GstMessage *message;
+        while ((message = gst_bus_pop(stream->bus)) != nullptr) {
+            messageCount++;
+            LOG_TRACE("VideoStreamReceiver::checkBusMessages", "Message {} received, type: {}", messageCount, GST_MESSAGE_TYPE_NAME(message));
 
-        // Process the message
-        handleBusMessage(message);
+            // Process the message
+            handleBusMessage(stream, message);
 
-        // Unref the message after processing
-        gst_message_unref(message);
+            // Unref the message after processing
+            gst_message_unref(message);
+        }
+    };
+
+    drain(m_active.get());
+    if (m_pending) {
+        drain(m_pending.get());
+        // Destroyed only here, never while its bus is being drained
+        if (!m_pending->error.isEmpty()) {
+            abandonSwitch(m_pending->error);
+        }
     }
 
     if (messageCount == 0) {
         // Only log occasionally to avoid spam
         static int noMessageCounter = 0;
         if (++noMessageCounter % 100 == 0) {  // Log every 100 polls (5 seconds at 50ms interval)
-            qDebug() << "[VideoStreamReceiver::checkBusMessages] No messages on bus (polled" << noMessageCounter << "times)";
+            LOG_DEBUG("VideoStreamReceiver::checkBusMessages", "No messages on bus (polled {} times)", noMessageCounter);
+        }
+    }
+}
+/**
+ * @brief Selects the packet ingest path for the next startStream()/switchStream()
+ * @param enabled true for RtpReceiveEngine + appsrc, false for udpsrc
+ */
+void VideoStreamReceiver::setNativeIngest(bool enabled)
+{
+    if (m_nativeIngest != enabled) {
+        m_nativeIngest = enabled;
+        emit nativeIngestChanged();
+    }
+}
+
+/**
+ * @brief Wraps a received RTP packet in a GstBuffer and pushes it into the appsrc
+ * @param stream Pipeline the packet is routed to
+ * @param packet Packet from RtpReceiveEngine (data only valid during this call)
+ *
+ * Runs on the receiving shard's thread (the caller's for external ingest). The
+ * receive timestamp (kernel stamp if the platform provides one) is attached twice:
+ * - as a GstReferenceTimestampMeta with "timestamp/x-unix" caps, for any element
+ *   that wants the absolute time
+ * - as the buffer PTS relative to the pipeline base time; the depayloader and
+ *   decoder carry PTS through to the appsink, where processNewSample() turns it
+ *   back into an absolute time
+ */
+void VideoStreamReceiver::pushPacket(StreamPipeline *stream, const RtpReceiveEngine::Packet &packet)
+{
+    // The depayloader can only reassemble one RTP stream; interleaving a second
+    // sender's packets would corrupt every frame of both. Native ingest gets a single
+    // stream from the router; external ingest is locked onto the first SSRC here and
+    // only follows a new one once the old stream has gone quiet (sender restarted).
+    quint32 ssrc = stream->streamSsrc.load(std::memory_order_relaxed);
+    if (!stream->ingest && ssrc != packet.ssrc) {
+        qint64 silentNs = packet.userRxNs - stream->streamSsrcLastNs.load(std::memory_order_relaxed);
+        if (ssrc != 0 && silentNs < 500000000LL) {
+            if (stream->foreignSsrcPackets.fetch_add(1, std::memory_order_relaxed) == 0) {
+                LOG_WARN("VideoStreamReceiver", "Port {}: dropping packets of RTP stream {}, locked to stream {}",
+                         stream->port, QString::number(packet.ssrc, 16), QString::number(ssrc, 16));
+            }
+            videoMetrics().foreignSsrcPackets.increment();
+            return;
+        }
+        if (ssrc != 0) {
+            LOG_INFO("VideoStreamReceiver", "Port {}: following RTP stream {}", stream->port,
+                     QString::number(packet.ssrc, 16));
         }
+        stream->streamSsrc.store(packet.ssrc, std::memory_order_relaxed);
+    }
+    stream->streamSsrcLastNs.store(packet.userRxNs, std::memory_order_relaxed);
+
+    // External ingest (A/B comparison, replay) may push from other threads than the
+    // GUI reads from, so these counters use a real RMW.
+    // The RTP marker bit (byte 1, top bit) flags the last packet of a JPEG frame.
+    VideoMetrics &metrics = videoMetrics();
+    stream->packets.fetch_add(1, std::memory_order_relaxed);
+    metrics.packets.increment();
+    if (packet.size >= 2 && (static_cast<unsigned char>(packet.data[1]) & 0x80)) {
+        stream->framesIn.fetch_add(1, std::memory_order_relaxed);
+        metrics.framesReceived.increment();
+    }
+    if (packet.kernelRxNs >= 0) {
+        metrics.socketDelay.observeNs(packet.userRxNs - packet.kernelRxNs);
+    }
+
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, static_cast<gsize>(packet.size), nullptr);
+    gst_buffer_fill(buffer, 0, packet.data, static_cast<gsize>(packet.size));
+
+    qint64 rxNs = packet.kernelRxNs >= 0 ? packet.kernelRxNs : packet.userRxNs;
+    gst_buffer_add_reference_timestamp_meta(buffer, m_unixTimestampCaps,
+                                            static_cast<GstClockTime>(rxNs), GST_CLOCK_TIME_NONE);
+
+    // Base time is only known once the pipeline is PLAYING on m_wallClock
+    GstClockTime baseTime = gst_element_get_base_time(stream->pipeline);
+    if (baseTime != 0 && GST_CLOCK_TIME_IS_VALID(baseTime) && static_cast<GstClockTime>(rxNs) > baseTime) {
+        GST_BUFFER_PTS(buffer) = static_cast<GstClockTime>(rxNs) - baseTime;
+    }
+
+    // push_buffer takes ownership of the buffer
+    gst_app_src_push_buffer(GST_APP_SRC(stream->appsrc), buffer);
+}
+
+/**
+ * @brief Adds one latency sample to a sum/max/count accumulator
+ *
+ * Each accumulator has a single writer thread, so load + store is sufficient.
+ */
+void VideoStreamReceiver::accumulateLatency(std::atomic<qint64> &sum, std::atomic<qint64> &max,
+                                            std::atomic<qint64> &count, qint64 valueNs)
+{
+    if (valueNs < 0) {
+        return;  // clock step between the two stamps - ignore
+    }
+    sum.store(sum.load(std::memory_order_relaxed) + valueNs, std::memory_order_relaxed);
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (valueNs > max.load(std::memory_order_relaxed)) {
+        max.store(valueNs, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Returns where frame latency is spent inside this process
+ * @return Map of mean/max latencies in microseconds plus packet counters
+ *
+ * socketDelay: kernel receive -> engine read (scheduler / socket queue delay)
+ * rxToAppsink: kernel receive -> decoded frame in appsink (native ingest only)
+ * appsinkToGui: appsink callback -> GUI thread handling the frame
+ *
+ * All values describe the pipeline on screen and restart after a switch, except
+ * socketDelay, portPackets and shardPackets: those count everything the port's
+ * receive engine read, for all receivers sharing the port.
+ */
+QVariantMap VideoStreamReceiver::latencyBreakdown() const
+{
+    auto meanUs = [](qint64 sumNs, qint64 count) {
+        return count > 0 ? (double(sumNs) / count) / 1000.0 : 0.0;
+    };
+
+    const StreamPipeline *stream = m_active.get();
+    const RtpReceiveEngine *engine = stream && stream->ingest ? &stream->ingest->engine() : nullptr;
+    RtpReceiveEngine::Stats engineStats = engine ? engine->stats() : RtpReceiveEngine::Stats();
+    qint64 rxSumNs = stream ? stream->rxToAppsinkSumNs.load(std::memory_order_relaxed) : 0;
+    qint64 rxMaxNs = stream ? stream->rxToAppsinkMaxNs.load(std::memory_order_relaxed) : 0;
+    qint64 rxCount = stream ? stream->rxToAppsinkCount.load(std::memory_order_relaxed) : 0;
+    qint64 guiCount = m_appsinkToGuiCount.load(std::memory_order_relaxed);
+
+    QVariantMap breakdown;
+    breakdown["nativeIngest"] = stream && stream->appsrc != nullptr;
+    breakdown["kernelTimestamps"] = engine && engine->hasKernelTimestamps();
+    breakdown["packets"] = stream && stream->ingest ? stream->ingest->streamPackets(stream->ingestStream) : 0;
+    breakdown["portPackets"] = engineStats.packets;
+    breakdown["kernelStampedPackets"] = engineStats.kernelStamped;
+    breakdown["socketDelayMeanUs"] = meanUs(engineStats.socketDelaySumNs, engineStats.kernelStamped);
+    breakdown["socketDelayMaxUs"] = engineStats.socketDelayMaxNs / 1000.0;
+    breakdown["rxToAppsinkMeanUs"] = meanUs(rxSumNs, rxCount);
+    breakdown["rxToAppsinkMaxUs"] = rxMaxNs / 1000.0;
+    breakdown["appsinkToGuiMeanUs"] = meanUs(m_appsinkToGuiSumNs.load(std::memory_order_relaxed), guiCount);
+    breakdown["appsinkToGuiMaxUs"] = m_appsinkToGuiMaxNs.load(std::memory_order_relaxed) / 1000.0;
+    breakdown["frames"] = guiCount;
+
+    // Per-shard packet counts show whether the senders on the port spread over the threads
+    QVariantList shardPackets;
+    for (int i = 0; engine && i < engine->shardCount(); ++i) {
+        shardPackets.append(engine->shardStats(i).packets);
+    }
+    breakdown["shardPackets"] = shardPackets;
+    breakdown["ssrc"] = stream && stream->ingest
+        ? QString::number(stream->ingest->streamSsrc(stream->ingestStream), 16) : QString();
+    breakdown["unroutedPackets"] = stream && stream->ingest ? stream->ingest->unroutedPackets() : 0;
+    breakdown["foreignSsrcPackets"] = stream ? stream->foreignSsrcPackets.load(std::memory_order_relaxed) : 0;
+    breakdown["lastSwitchMs"] = m_lastSwitchMs;
+    return breakdown;
+}
+
+/**
+ * @brief Sets how many SO_REUSEPORT sockets/threads native ingest binds (next startStream())
+ * @param shards Shard count, clamped to >= 1
+ */
+void VideoStreamReceiver::setIngestShards(int shards)
+{
+    shards = qMax(1, shards);
+    if (m_ingestShards != shards) {
+        m_ingestShards = shards;
+        emit ingestShardsChanged();
+    }
+}
+
+/**
+ * @brief Enables or disables core pinning of the native ingest threads (next startStream())
+ * @param pin true to give each receive thread a core of its own
+ */
+void VideoStreamReceiver::setPinIngestThreads(bool pin)
+{
+    if (m_pinIngestThreads != pin) {
+        m_pinIngestThreads = pin;
+        emit pinIngestThreadsChanged();
+    }
+}
+
+/**
+ * @brief Sets the depayload/decode chain used by the next pipeline
+ * @param chain gst-launch fragment ending in RGB video, empty for the built-in chain
+ */
+void VideoStreamReceiver::setDecoderChain(const QString &chain)
+{
+    QString trimmed = chain.trimmed();
+    if (m_decoderChain != trimmed) {
+        m_decoderChain = trimmed;
+        emit decoderChainChanged();
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Switches the next pipeline to packets supplied by pushExternalPacket()
+ * @param enabled true to skip udpsrc / the receive engine and measure thread CPU
+ */
+void VideoStreamReceiver::setExternalIngest(bool enabled)
+{
+    m_externalIngest = enabled;
+}
+
+/**
+ * @brief Pushes a packet received elsewhere into the pipeline on screen
+ * @param packet Packet from the feeder (data only valid during this call)
+ */
+void VideoStreamReceiver::pushExternalPacket(const RtpReceiveEngine::Packet &packet)
+{
+    StreamPipeline *stream = m_active.get();
+    if (stream && stream->appsrc) {
+        pushPacket(stream, packet);
+    }
+}
+
+/**
+ * @brief Snapshot of the cumulative counters of the pipeline on screen
+ * @return Counters, all zero when no pipeline is running
+ */
+VideoStreamReceiver::PipelineStats VideoStreamReceiver::pipelineStats() const
+{
+    PipelineStats stats;
+    const StreamPipeline *stream = m_active.get();
+    if (!stream) {
+        return stats;
+    }
+
+    stats.packets = stream->packets.load(std::memory_order_relaxed);
+    stats.framesIn = stream->framesIn.load(std::memory_order_relaxed);
+    stats.framesDecoded = stream->framesDecoded.load(std::memory_order_relaxed);
+    stats.rxToAppsinkSumNs = stream->rxToAppsinkSumNs.load(std::memory_order_relaxed);
+    stats.rxToAppsinkMaxNs = stream->rxToAppsinkMaxNs.load(std::memory_order_relaxed);
+    stats.rxToAppsinkCount = stream->rxToAppsinkCount.load(std::memory_order_relaxed);
+    stats.appsinkToGuiSumNs = m_appsinkToGuiSumNs.load(std::memory_order_relaxed);
+    stats.appsinkToGuiMaxNs = m_appsinkToGuiMaxNs.load(std::memory_order_relaxed);
+    stats.appsinkToGuiCount = m_appsinkToGuiCount.load(std::memory_order_relaxed);
+
+    stats.streamingCpuNs = stream->sinkThreadCpuNs.load(std::memory_order_relaxed);
+    if (stream->sourceThreadId.load(std::memory_order_relaxed) != stream->sinkThreadId.load(std::memory_order_relaxed)) {
+        stats.streamingCpuNs += stream->sourceThreadCpuNs.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
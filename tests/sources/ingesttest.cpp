@@ -0,0 +1,146 @@
+/**
+ * @file ingesttest.cpp
+ * @brief Sharded native ingest: flows spread over shards, streams routed by SSRC
+ *
+ * Sends RTP-sized datagrams over loopback from many source sockets to an engine
+ * on a free port. Sharding needs SO_REUSEPORT, so the shard tests are skipped
+ * on platforms other than Linux.
+ */
+
+#include <QtTest>
+#include <QUdpSocket>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+#include "includes/rtpreceiveengine.hpp"
+#include "includes/rtpstreamrouter.hpp"
+
+namespace {
+constexpr int Shards = 4;
+// Distinct source ports; with 64 flows over 4 shards, all of them landing on one is ~1e-38
+constexpr int Senders = 64;
+constexpr int PacketsPerSender = 10;
+constexpr int WaitMs = 5000;
+
+/**
+ * @brief Sends a minimal RTP header (version 2, payload type 26) with the given SSRC
+ */
+void sendRtp(QUdpSocket &socket, quint16 port, quint32 ssrc)
+{
+    char packet[32] = {};
+    packet[0] = char(0x80);
+    packet[1] = 26;
+    packet[8] = char(ssrc >> 24);
+    packet[9] = char(ssrc >> 16);
+    packet[10] = char(ssrc >> 8);
+    packet[11] = char(ssrc);
+    socket.writeDatagram(packet, sizeof(packet), QHostAddress::LocalHost, port);
+}
+}
+
+class IngestTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void shardsShareFlows();
+    void routerSeparatesStreams();
+};
+
+void IngestTest::shardsShareFlows()
+{
+#ifndef Q_OS_LINUX
+    QSKIP("SO_REUSEPORT sharding needs Linux");
+#endif
+    std::atomic<int> received(0);
+    RtpReceiveEngine engine;
+    RtpReceiveEngine::Config config;
+    config.shards = Shards;
+    config.pinThreads = true;
+    QVERIFY(engine.start(config, [&received](const RtpReceiveEngine::Packet &) { received.fetch_add(1); }));
+    QCOMPARE(engine.shardCount(), Shards);
+    QVERIFY(engine.port() != 0);
+
+    // Each socket gets its own ephemeral source port, i.e. its own flow hash
+    std::vector<std::unique_ptr<QUdpSocket>> senders;
+    for (int i = 0; i < Senders; ++i) {
+        senders.push_back(std::make_unique<QUdpSocket>());
+        for (int k = 0; k < PacketsPerSender; ++k) {
+            sendRtp(*senders.back(), engine.port(), quint32(i + 1));
+        }
+    }
+    QTRY_COMPARE_WITH_TIMEOUT(received.load(), Senders * PacketsPerSender, WaitMs);
+
+    int busyShards = 0;
+    qint64 shardTotal = 0;
+    for (int i = 0; i < engine.shardCount(); ++i) {
+        qint64 packets = engine.shardStats(i).packets;
+        busyShards += packets > 0 ? 1 : 0;
+        shardTotal += packets;
+        // A flow never straddles shards, so every shard holds whole senders
+        QCOMPARE(packets % PacketsPerSender, qint64(0));
+    }
+    QVERIFY2(busyShards > 1, qPrintable(QString("only %1 shard(s) received traffic").arg(busyShards)));
+    QCOMPARE(shardTotal, engine.stats().packets);
+}
+
+void IngestTest::routerSeparatesStreams()
+{
+#ifndef Q_OS_LINUX
+    QSKIP("SO_REUSEPORT sharding needs Linux");
+#endif
+    RtpReceiveEngine::Config config;
+    config.shards = Shards;
+    std::shared_ptr<RtpStreamRouter> router = RtpStreamRouter::acquire(config);
+    QVERIFY(router);
+
+    // A second receiver on the port shares the router and its shards
+    RtpReceiveEngine::Config samePort = config;
+    samePort.port = router->port();
+    QVERIFY(RtpStreamRouter::acquire(samePort) == router);
+
+    std::mutex mutex;
+    std::set<quint32> seenA;
+    std::set<quint32> seenB;
+    int streamA = router->addStream([&](const RtpReceiveEngine::Packet &packet) {
+        std::lock_guard<std::mutex> lock(mutex);
+        seenA.insert(packet.ssrc);
+    });
+    int streamB = router->addStream([&](const RtpReceiveEngine::Packet &packet) {
+        std::lock_guard<std::mutex> lock(mutex);
+        seenB.insert(packet.ssrc);
+    });
+
+    // Two cameras claim the two streams; shards race, so the third starts afterwards
+    QUdpSocket cameraA;
+    QUdpSocket cameraB;
+    for (int k = 0; k < 100; ++k) {
+        sendRtp(cameraA, router->port(), 0xa);
+        sendRtp(cameraB, router->port(), 0xb);
+    }
+    QTRY_COMPARE_WITH_TIMEOUT(router->streamPackets(streamA) + router->streamPackets(streamB), qint64(200), WaitMs);
+
+    // No receiver is free for a third camera
+    QUdpSocket cameraC;
+    for (int k = 0; k < 100; ++k) {
+        sendRtp(cameraC, router->port(), 0xc);
+    }
+    QTRY_COMPARE_WITH_TIMEOUT(router->unroutedPackets(), qint64(100), WaitMs);
+
+    QCOMPARE(router->streamPackets(streamA), qint64(100));
+    QCOMPARE(router->streamPackets(streamB), qint64(100));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        QCOMPARE(seenA.size(), size_t(1));
+        QCOMPARE(seenB.size(), size_t(1));
+        QVERIFY(*seenA.begin() != *seenB.begin());
+        QVERIFY(seenA.count(0xc) == 0 && seenB.count(0xc) == 0);
+    }
+
+    router->removeStream(streamA);
+    router->removeStream(streamB);
+}
+
+QTEST_GUILESS_MAIN(IngestTest)
+#include "ingesttest.moc"
@@ -0,0 +1,91 @@
+/**
+ * @file fakecar.hpp
+ * @brief Loopback stand-in for the car's control endpoint
+ *
+ * Accepts the same control messages as the car (WebSocket on 8765, UDP on 8766),
+ * applies the newest sequence number from whichever path delivers it first and
+ * acknowledges every copy so the client can measure per-path latency.
+ */
+
+#ifndef FAKECAR_H
+#define FAKECAR_H
+
+#include <QObject>
+#include <QHostAddress>
+#include <QUdpSocket>
+#include <QtWebSockets/QWebSocket>
+#include <QtWebSockets/QWebSocketServer>
+#include <QJsonObject>
+#include <QList>
+
+/**
+ * @class FakeCar
+ * @brief Minimal car control server used for hedging and latency experiments
+ *
+ * Messages are JSON objects {"seq": n, "steering": s, "throttle": t}. A message
+ * is applied when its seq is newer than the last applied one; older or duplicate
+ * copies are dropped. Each copy is acked on its own path with
+ * {"ack": n, "path": "ws"|"udp", "first": applied}.
+ */
+class FakeCar : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Path { WebSocket, Udp };
+
+    explicit FakeCar(QObject *parent = nullptr);
+    ~FakeCar();
+
+    /**
+     * @brief Starts listening on the given ports
+     * @return true if both the WebSocket server and the UDP socket are bound
+     */
+    bool listen(const QHostAddress &address = QHostAddress::Any,
+                quint16 wsPort = 8765, quint16 udpPort = 8766);
+
+    qint64 lastAppliedSeq() const { return m_lastAppliedSeq; }
+    double steering() const { return m_steering; }
+    double throttle() const { return m_throttle; }
+
+    qint64 wsReceived() const { return m_wsReceived; }
+    qint64 udpReceived() const { return m_udpReceived; }
+    qint64 wsApplied() const { return m_wsApplied; }
+    qint64 udpApplied() const { return m_udpApplied; }
+    qint64 duplicates() const { return m_duplicates; }
+
+signals:
+    /**
+     * @brief Emitted when a control message is applied (first copy of a new seq)
+     */
+    void controlApplied(qint64 seq, double steering, double throttle, FakeCar::Path path);
+
+private slots:
+    void onNewConnection();
+    void onTextMessageReceived(const QString &message);
+    void onSocketDisconnected();
+    void onUdpReadyRead();
+
+private:
+    /**
+     * @brief Applies a message if it is new and returns the ack to send back
+     * @return Ack object, or an empty object if the message carries no seq
+     */
+    QJsonObject handleControl(const QJsonObject &message, Path path);
+
+    QWebSocketServer *m_wsServer;
+    QUdpSocket *m_udpSocket;
+    QList<QWebSocket *> m_clients;
+
+    qint64 m_lastAppliedSeq;
+    double m_steering;
+    double m_throttle;
+
+    qint64 m_wsReceived;
+    qint64 m_udpReceived;
+    qint64 m_wsApplied;
+    qint64 m_udpApplied;
+    qint64 m_duplicates;
+};
+
+#endif // FAKECAR_H
@@ -0,0 +1,135 @@
+/**
+ * @file fakecar.cpp
+ * @brief Implementation of the loopback car stand-in
+ */
+
+#include "includes/fakecar.hpp"
+#include <QDebug>
+#include <QJsonDocument>
+#include <QNetworkDatagram>
+
+FakeCar::FakeCar(QObject *parent)
+    : QObject(parent)
+    , m_wsServer(new QWebSocketServer(QStringLiteral("FakeCar"), QWebSocketServer::NonSecureMode, this))
+    , m_udpSocket(new QUdpSocket(this))
+    , m_lastAppliedSeq(0)
+    , m_steering(0.0)
+    , m_throttle(0.0)
+    , m_wsReceived(0)
+    , m_udpReceived(0)
+    , m_wsApplied(0)
+    , m_udpApplied(0)
+    , m_duplicates(0)
+{
+    connect(m_wsServer, &QWebSocketServer::newConnection, this, &FakeCar::onNewConnection);
+    connect(m_udpSocket, &QUdpSocket::readyRead, this, &FakeCar::onUdpReadyRead);
+}
+
+FakeCar::~FakeCar()
+{
+    m_wsServer->close();
+    qDeleteAll(m_clients);
+}
+
+bool FakeCar::listen(const QHostAddress &address, quint16 wsPort, quint16 udpPort)
+{
+    if (!m_wsServer->listen(address, wsPort)) {
+        qWarning() << "[FakeCar] WebSocket listen failed:" << m_wsServer->errorString();
+        return false;
+    }
+    if (!m_udpSocket->bind(address, udpPort)) {
+        qWarning() << "[FakeCar] UDP bind failed:" << m_udpSocket->errorString();
+        m_wsServer->close();
+        return false;
+    }
+
+    qDebug() << "[FakeCar] Listening: ws port" << wsPort << "udp port" << udpPort;
+    return true;
+}
+
+void FakeCar::onNewConnection()
+{
+    while (QWebSocket *socket = m_wsServer->nextPendingConnection()) {
+        connect(socket, &QWebSocket::textMessageReceived, this, &FakeCar::onTextMessageReceived);
+        connect(socket, &QWebSocket::disconnected, this, &FakeCar::onSocketDisconnected);
+        m_clients.append(socket);
+        m_lastAppliedSeq = 0;  // a (re)started client numbers from 1 again
+        qDebug() << "[FakeCar] Client connected:" << socket->peerAddress().toString();
+    }
+}
+
+void FakeCar::onSocketDisconnected()
+{
+    QWebSocket *socket = qobject_cast<QWebSocket *>(sender());
+    if (socket) {
+        m_clients.removeAll(socket);
+        socket->deleteLater();
+    }
+}
+
+void FakeCar::onTextMessageReceived(const QString &message)
+{
+    QWebSocket *socket = qobject_cast<QWebSocket *>(sender());
+    QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
+    if (!socket || !doc.isObject()) {
+        return;
+    }
+
+    ++m_wsReceived;
+    QJsonObject ack = handleControl(doc.object(), Path::WebSocket);
+    if (!ack.isEmpty()) {
+        socket->sendTextMessage(QString::fromUtf8(QJsonDocument(ack).toJson(QJsonDocument::Compact)));
+    }
+}
+
+void FakeCar::onUdpReadyRead()
+{
+    while (m_udpSocket->hasPendingDatagrams()) {
+        QNetworkDatagram datagram = m_udpSocket->receiveDatagram();
+        QJsonDocument doc = QJsonDocument::fromJson(datagram.data());
+        if (!doc.isObject()) {
+            continue;
+        }
+
+        ++m_udpReceived;
+        QJsonObject ack = handleControl(doc.object(), Path::Udp);
+        if (!ack.isEmpty()) {
+            m_udpSocket->writeDatagram(QJsonDocument(ack).toJson(QJsonDocument::Compact),
+                                       datagram.senderAddress(),
+                                       static_cast<quint16>(datagram.senderPort()));
+        }
+    }
+}
+
+QJsonObject FakeCar::handleControl(const QJsonObject &message, Path path)
+{
+    qint64 seq = message["seq"].toInteger(-1);
+    bool first = seq < 0 || seq > m_lastAppliedSeq;
+
+    if (first) {
+        m_steering = message["steering"].toDouble();
+        m_throttle = message["throttle"].toDouble();
+        if (seq >= 0) {
+            m_lastAppliedSeq = seq;
+        }
+        if (path == Path::WebSocket) {
+            ++m_wsApplied;
+        } else {
+            ++m_udpApplied;
+        }
+        emit controlApplied(seq, m_steering, m_throttle, path);
+    } else {
+        ++m_duplicates;
+    }
+
+    // Unsequenced (legacy) messages are applied but never acked
+    if (seq < 0) {
+        return QJsonObject();
+    }
+
+    QJsonObject ack;
+    ack["ack"] = seq;
+    ack["path"] = path == Path::WebSocket ? QStringLiteral("ws") : QStringLiteral("udp");
+    ack["first"] = first;
+    return ack;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file main.cpp
+ * @brief Standalone fake car: driver_fakecar [wsPort] [udpPort]
+ *
+ * Prints per-path win counts once per second so hedged delivery can be
+ * observed without the real car.
+ */
+
+#include <QCoreApplication>
+#include <QTimer>
+#include <QDebug>
+#include "includes/fakecar.hpp"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+
+    quint16 wsPort = args.size() > 1 ? args.at(1).toUShort() : 8765;
+    quint16 udpPort = args.size() > 2 ? args.at(2).toUShort() : 8766;
+
+    FakeCar car;
+    if (!car.listen(QHostAddress::Any, wsPort, udpPort)) {
+        return 1;
+    }
+
+    QTimer reportTimer;
+    QObject::connect(&reportTimer, &QTimer::timeout, &car, [&car]() {
+        qint64 applied = car.wsApplied() + car.udpApplied();
+        if (applied == 0) return;
+        qDebug().nospace() << "[FakeCar] seq " << car.lastAppliedSeq()
+                           << " ws wins " << car.wsApplied()
+                           << " udp wins " << car.udpApplied()
+                           << " duplicates " << car.duplicates()
+                           << " steering " << car.steering()
+                           << " throttle " << car.throttle();
+    });
+    reportTimer.start(1000);
+
+    return app.exec();
+}
@@ -0,0 +1,255 @@
+/**
+ * @file harness.hpp
+ * @brief Headless end-to-end latency/throughput harness
+ *
+ * Runs the real SteeringController, SteeringControllerService, VideoStreamReceiver
+ * and Main.qml scene (offscreen platform) against an in-process FakeCar over
+ * loopback, driven by an SDL virtual joystick and a synthetic RTP/JPEG stream.
+ */
+
+#ifndef HARNESS_H
+#define HARNESS_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QPointer>
+#include <QQmlApplicationEngine>
+#include <QStringList>
+#include <QThread>
+#include <QTimer>
+#include <SDL2/SDL.h>
+#include <gst/gst.h>
+#include <memory>
+#include <vector>
+
+#include "includes/fakecar.hpp"
+#include "includes/steeringcontroller.hpp"
+#include "includes/videoscreenreciever.hpp"
+#include "includes/pipelinecomparison.hpp"
+#include "includes/performancestats.hpp"
+#include "includes/renderprofile.hpp"
+#include "includes/presentationmode.hpp"
+#include "includes/framegovernor.hpp"
+#include "includes/pathpredictor.hpp"
+#include "includes/pcapreplaysource.hpp"
+#include "includes/steeringcontrollerservice.hpp"
+
+class QQuickItem;
+class QQuickWindow;
+
+/**
+ * @class E2eHarness
+ * @brief One scripted run: warm-up, measurement window, JSON report
+ *
+ * Measured during the window (after warm-up):
+ * - input -> controller: virtual axis change -> SteeringController::steeringChanged
+ * - input -> car: virtual axis change -> FakeCar applies the message
+ * - arrival -> GUI / render: kernel RX time of the frame's last packet (native
+ *   ingest) -> frameChanged / the first swap showing the loaded image
+ * - rendered fps, frames received / decoded / displayed
+ * - CPU per thread and process RSS (Linux, from /proc)
+ *
+ * Soak mode (Config::soakIntervalS > 0) is meant for runs of hours: every
+ * interval it records RSS, allocator statistics, the receiver's child objects,
+ * the GUI hand-off queue depth and that interval's latency percentiles, and at
+ * the end tests each series for an upward trend (see trendtest.hpp).
+ */
+class E2eHarness : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Config
+    {
+        int durationS = 30;          ///< Measurement window
+        int warmupS = 3;             ///< Discarded start-up period
+        int inputRateHz = 50;        ///< Virtual steering changes per second
+        int videoWidth = 1280;
+        int videoHeight = 720;
+        int videoFps = 30;
+        quint16 wsPort = 8765;
+        quint16 udpPort = 8766;
+        bool hedged = false;         ///< Duplicate control messages over UDP
+        bool nativeIngest = true;    ///< Kernel RX timestamps for arrival latency
+        QString outputPath;          ///< Report file; empty = stdout
+        int soakIntervalS = 0;       ///< > 0: soak mode, one sample per interval
+        int restartEveryS = 0;       ///< > 0: stop/start the video stream periodically
+        QString pcapPath;            ///< Replay this capture instead of the synthetic stream
+        quint16 pcapPort = 0;        ///< Only datagrams to this port from the capture (0 = all UDP)
+        double pcapSpeed = 1.0;      ///< Capture timing scale; 0 = as fast as possible
+    };
+
+    explicit E2eHarness(const Config &config, QObject *parent = nullptr);
+    ~E2eHarness();
+
+    /**
+     * @brief Starts the car, scene, input and video source
+     * @return false if any part could not be set up (reason already logged)
+     */
+    bool start();
+
+    /**
+     * @brief Process exit code once finished(): 0 ok, 2 if nothing was measured,
+     *        3 if a soak series trends upward
+     */
+    int exitCode() const { return m_exitCode; }
+
+signals:
+    void finished();
+
+private slots:
+    void onInjectTimeout();
+    void onSteeringChanged();
+    void onFrameChanged();
+    void onImageStatusChanged();
+    void onFrameSwapped();
+    void onWarmupDone();
+    void onRunDone();
+    void onSoakSample();
+    void onRestartStream();
+
+private:
+    /**
+     * @brief Latency samples of one measurement (ns)
+     */
+    struct Samples
+    {
+        std::vector<qint64> ns;        ///< All samples, or a uniform reservoir of them in soak mode
+        std::vector<qint64> interval;  ///< Since the last soak sample (soak mode only)
+        qint64 seen = 0;
+        size_t reservoirSize = 0;      ///< 0 = keep every sample
+
+        void add(qint64 value);
+        void clear();
+        void useReservoir(size_t size);
+        QJsonObject summary() const;
+    };
+
+    /**
+     * @brief One soak interval (-1 where nothing was measured)
+     */
+    struct SoakSample
+    {
+        double elapsedS = 0.0;
+        double rssMb = -1.0;
+        double heapInUseMb = -1.0;     ///< malloc arenas + mmapped chunks (glibc)
+        double heapFreeMb = -1.0;      ///< Free memory held in the arenas (glibc)
+        double receiverChildren = 0;   ///< QObject children of the video receiver (timers)
+        double handoffQueueDepth = 0;
+        double inputToCarP50Ms = -1.0;
+        double inputToCarP99Ms = -1.0;
+        double arrivalToGuiP50Ms = -1.0;
+        double arrivalToGuiP99Ms = -1.0;
+        double arrivalToRenderP99Ms = -1.0;
+        double renderedFps = 0.0;
+    };
+
+    /**
+     * @brief A frame handed to the GUI, waiting to be rendered
+     */
+    struct FrameTimes
+    {
+        qint64 rxNs = 0;     ///< Kernel RX of the last packet (0 without native ingest)
+        qint64 guiNs = 0;    ///< frameChanged on the GUI thread
+    };
+
+    /**
+     * @brief CPU time of one thread at a point in time
+     */
+    struct ThreadCpu
+    {
+        QString name;
+        qint64 cpuNs = 0;
+    };
+
+    bool startVideoSource();
+    bool attachVirtualJoystick();
+    void attachScene();
+    void recordControlApplied(double steering, qint64 appliedNs);
+    QJsonObject report() const;
+    QJsonObject soakReport() const;
+
+    static QHash<qint64, ThreadCpu> threadCpu();
+    static qint64 processRssKb(const char *field);
+
+    Config m_config;
+    int m_exitCode;
+
+    // The car runs on its own thread so its socket handling is not queued behind rendering
+    FakeCar *m_car;
+    QThread m_carThread;
+
+    // System under test, wired like main.cpp
+    SteeringController m_controller;
+    SteeringControllerService m_service;
+    VideoStreamReceiver m_videoReceiver;
+    PipelineComparison m_pipelineComparison;
+    PerformanceStats m_performanceStats;
+    RenderProfile m_renderProfile;
+    PresentationMode m_presentationMode;  ///< Windowed defaults; Main.qml binds to it
+    FrameGovernor m_frameGovernor;
+    PathPredictor m_pathPredictor;        ///< Overlay drawn as in the app
+    std::unique_ptr<QQmlApplicationEngine> m_engine;
+    QPointer<QQuickWindow> m_window;
+    QPointer<QQuickItem> m_videoImage;
+
+    // Inputs
+    SDL_Joystick *m_virtualJoystick;
+    int m_virtualIndex;
+    GstElement *m_sender;
+    PcapReplaySource m_pcapReplay;   ///< Replaces m_sender with --pcap
+    QTimer m_injectTimer;
+    int m_axisValue;
+    int m_axisStep;
+
+    // Control latency bookkeeping (GUI thread, monotonic clock)
+    QElapsedTimer m_clock;
+    qint64 m_lastInjectNs;
+    bool m_injectPending;
+    QHash<qint64, qint64> m_injectBySteering;  ///< Steering key -> injection time of that value
+
+    // Video latency bookkeeping (wall clock, same as kernel RX timestamps)
+    QHash<QString, FrameTimes> m_frames;       ///< Recent frame id -> times
+    QStringList m_frameOrder;                  ///< Ids in m_frames, oldest first
+    FrameTimes m_loadedFrame;                  ///< Loaded by the Image, not yet swapped
+    bool m_loadedFramePending;
+
+    // Measurement window
+    bool m_measuring;
+    QElapsedTimer m_windowClock;
+    qint64 m_windowNs;
+    qint64 m_injected;
+    qint64 m_applied;
+    qint64 m_framesDisplayed;
+    qint64 m_framesRendered;
+    Samples m_inputToController;
+    Samples m_inputToCar;
+    Samples m_arrivalToGui;
+    Samples m_arrivalToRender;
+    Samples m_guiToRender;
+    Samples m_renderPass;                      ///< beforeRendering -> afterRendering (monotonic clock)
+    qint64 m_renderStartNs;
+    RenderProfile::RepaintStats m_repaintStart;
+    RenderProfile::RepaintStats m_repaintEnd;
+    VideoStreamReceiver::PipelineStats m_videoStart;
+    VideoStreamReceiver::PipelineStats m_videoEnd;
+    QHash<qint64, ThreadCpu> m_cpuStart;
+    QHash<qint64, ThreadCpu> m_cpuEnd;
+    qint64 m_rssStartKb;
+    qint64 m_rssEndKb;
+    qint64 m_rssPeakKb;
+    QJsonObject m_hedgeStats;
+    QJsonObject m_videoBreakdown;
+
+    // Soak mode
+    QTimer m_soakTimer;
+    QTimer m_restartTimer;
+    qint64 m_soakLastNs;
+    qint64 m_soakLastRendered;
+    qint64 m_streamRestarts;
+    std::vector<SoakSample> m_soak;
+};
+
+#endif // HARNESS_H
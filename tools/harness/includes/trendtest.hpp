@@ -0,0 +1,52 @@
+/**
+ * @file trendtest.hpp
+ * @brief Monotonic trend detection for soak series (Mann-Kendall, Theil-Sen)
+ *
+ * Soak series are noisy and rarely normal - GC-like plateaus in RSS, latency
+ * spikes - so the test is rank based: Mann-Kendall decides whether there is an
+ * upward trend at all, Theil-Sen estimates how steep it is. Neither is thrown
+ * off by a few outliers.
+ */
+
+#ifndef TRENDTEST_H
+#define TRENDTEST_H
+
+#include <QJsonObject>
+#include <vector>
+
+namespace TrendTest {
+
+/**
+ * @struct Result
+ * @brief Outcome of trend() for one series
+ */
+struct Result
+{
+    int samples = 0;
+    double kendallS = 0.0;       ///< Mann-Kendall statistic (concordant - discordant pairs)
+    double z = 0.0;              ///< Normal approximation of S (tie corrected)
+    double pValue = 1.0;         ///< One-sided: probability of S this large without an upward trend
+    double slopePerHour = 0.0;   ///< Theil-Sen slope, series units per hour
+    double median = 0.0;         ///< Series median, the level the slope is relative to
+    double relativePerHour = 0.0; ///< slopePerHour relative to the series median (0 if the median is 0)
+    bool increasing = false;     ///< Significant and steeper than the minimum slope
+
+    QJsonObject toJson() const;
+};
+
+/**
+ * @brief Tests @p values (sampled at @p timesS seconds) for an upward trend
+ * @param alpha One-sided significance level
+ * @param minRelativePerHour Trends flatter than this fraction of the median per
+ *        hour are reported but not flagged (e.g. 0.01 = 1 %/h)
+ * @param minAbsolutePerHour Used instead when the median is 0 (e.g. a queue that
+ *        is usually empty), in series units per hour
+ *
+ * Needs at least 8 samples; fewer always yield increasing = false.
+ */
+Result trend(const std::vector<double> &timesS, const std::vector<double> &values,
+             double alpha = 0.01, double minRelativePerHour = 0.01, double minAbsolutePerHour = 1.0);
+
+} // namespace TrendTest
+
+#endif // TRENDTEST_H
@@ -0,0 +1,823 @@
+/**
+ * @file harness.cpp
+ * @brief Implementation of the headless end-to-end harness
+ */
+
+#include "includes/harness.hpp"
+#include "includes/metrics.hpp"
+#include "includes/timestampedudpsocket.hpp"
+#include "includes/tracing.hpp"
+#include "includes/trendtest.hpp"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMetaMethod>
+#include <QQmlContext>
+#include <QQuickItem>
+#include <QQuickWindow>
+#include <QRandomGenerator>
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>     // sysconf(_SC_CLK_TCK)
+#endif
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>     // mallinfo2()
+#define HARNESS_HAVE_MALLINFO2 1
+#endif
+
+namespace {
+// VideoScreen.qml starts the stream on this port
+constexpr quint16 VideoPort = 5000;
+// Triangle sweep of the virtual steering axis; each step is far above the
+// controller's 0.001 change threshold so every injection produces a new value
+constexpr int AxisLimit = 30000;
+constexpr int AxisStep = 1500;
+constexpr int MaxTrackedFrames = 16;
+// Soak mode keeps a uniform sample of each latency series for the whole-run
+// summary; allocated up front so the harness itself shows no growth
+constexpr size_t SoakReservoirSize = 20000;
+
+// Steering values survive the JSON round trip exactly; the key only guards
+// against formatting differences
+qint64 steeringKey(double steering)
+{
+    return qRound64(steering * 1e6);
+}
+
+double percentileMs(const std::vector<qint64> &sorted, double percentile)
+{
+    size_t index = static_cast<size_t>(percentile * (sorted.size() - 1) + 0.5);
+    return sorted[index] / 1e6;
+}
+
+// Sorts @p values in place; -1 when empty
+double intervalPercentileMs(std::vector<qint64> &values, double percentile)
+{
+    if (values.empty()) {
+        return -1.0;
+    }
+    std::sort(values.begin(), values.end());
+    return percentileMs(values, percentile);
+}
+
+QQuickItem *findItem(QQuickItem *item, const QString &objectName)
+{
+    if (!item) {
+        return nullptr;
+    }
+    if (item->objectName() == objectName) {
+        return item;
+    }
+    const QList<QQuickItem *> children = item->childItems();
+    for (QQuickItem *child : children) {
+        if (QQuickItem *found = findItem(child, objectName)) {
+            return found;
+        }
+    }
+    return nullptr;
+}
+}
+
+E2eHarness::E2eHarness(const Config &config, QObject *parent)
+    : QObject(parent)
+    , m_config(config)
+    , m_exitCode(0)
+    , m_car(new FakeCar())
+    , m_service(&m_controller)
+    , m_virtualJoystick(nullptr)
+    , m_virtualIndex(-1)
+    , m_sender(nullptr)
+    , m_axisValue(0)
+    , m_axisStep(AxisStep)
+    , m_lastInjectNs(0)
+    , m_injectPending(false)
+    , m_loadedFramePending(false)
+    , m_measuring(false)
+    , m_windowNs(0)
+    , m_injected(0)
+    , m_applied(0)
+    , m_framesDisplayed(0)
+    , m_framesRendered(0)
+    , m_renderStartNs(-1)
+    , m_rssStartKb(-1)
+    , m_rssEndKb(-1)
+    , m_rssPeakKb(-1)
+    , m_soakLastNs(0)
+    , m_soakLastRendered(0)
+    , m_streamRestarts(0)
+{
+    m_clock.start();
+
+    m_carThread.setObjectName("fakecar");
+    m_car->moveToThread(&m_carThread);
+
+    m_injectTimer.setTimerType(Qt::PreciseTimer);
+    m_injectTimer.setInterval(1000 / qMax(1, m_config.inputRateHz));
+    connect(&m_injectTimer, &QTimer::timeout, this, &E2eHarness::onInjectTimeout);
+
+    m_soakTimer.setInterval(qMax(1, m_config.soakIntervalS) * 1000);
+    connect(&m_soakTimer, &QTimer::timeout, this, &E2eHarness::onSoakSample);
+    m_restartTimer.setInterval(qMax(1, m_config.restartEveryS) * 1000);
+    connect(&m_restartTimer, &QTimer::timeout, this, &E2eHarness::onRestartStream);
+}
+
+E2eHarness::~E2eHarness()
+{
+    m_injectTimer.stop();
+    m_soakTimer.stop();
+    m_restartTimer.stop();
+    m_pcapReplay.stop();
+
+    // Scene first: it references the receivers and the controller
+    m_engine.reset();
+
+    if (m_sender) {
+        gst_element_set_state(m_sender, GST_STATE_NULL);
+        gst_object_unref(m_sender);
+    }
+
+    m_controller.disconnectDevice();
+    if (m_virtualJoystick) {
+        SDL_JoystickClose(m_virtualJoystick);
+    }
+    if (m_virtualIndex >= 0) {
+        SDL_JoystickDetachVirtual(m_virtualIndex);
+    }
+
+    m_service.disconnect();
+    m_carThread.quit();
+    m_carThread.wait();
+    delete m_car;
+}
+
+bool E2eHarness::start()
+{
+    // Car
+    m_carThread.start();
+    bool listening = false;
+    QMetaObject::invokeMethod(m_car, [this, &listening]() {
+        listening = m_car->listen(QHostAddress::LocalHost, m_config.wsPort, m_config.udpPort);
+    }, Qt::BlockingQueuedConnection);
+    if (!listening) {
+        return false;
+    }
+
+    // Timestamp arrivals on the car's thread; matching happens on ours
+    connect(m_car, &FakeCar::controlApplied, this, [this](qint64, double steering, double, FakeCar::Path) {
+        qint64 appliedNs = m_clock.nsecsElapsed();
+        QMetaObject::invokeMethod(this, [this, steering, appliedNs]() {
+            recordControlApplied(steering, appliedNs);
+        }, Qt::QueuedConnection);
+    }, Qt::DirectConnection);
+
+    // Input
+    if (!attachVirtualJoystick()) {
+        return false;
+    }
+    connect(&m_controller, &SteeringController::steeringChanged, this, &E2eHarness::onSteeringChanged);
+
+    m_service.setUdpPort(m_config.udpPort);
+    m_service.setHedgedDelivery(m_config.hedged);
+    m_service.connectToServer(QString("ws://127.0.0.1:%1").arg(m_config.wsPort));
+
+    // Scene, set up like main.cpp
+    m_videoReceiver.setNativeIngest(m_config.nativeIngest);
+    connect(&m_videoReceiver, &VideoStreamReceiver::frameChanged, this, &E2eHarness::onFrameChanged);
+    m_pathPredictor.setReceiver(&m_videoReceiver);
+    connect(&m_service, &SteeringControllerService::controlSent, &m_pathPredictor, &PathPredictor::recordCommand);
+
+    m_engine = std::make_unique<QQmlApplicationEngine>();
+    m_engine->addImageProvider("videostream", new VideoImageProvider(&m_videoReceiver));
+    m_engine->addImageProvider("videostream_a", new VideoImageProvider(m_pipelineComparison.receiverA()));
+    m_engine->addImageProvider("videostream_b", new VideoImageProvider(m_pipelineComparison.receiverB()));
+    m_engine->rootContext()->setContextProperty("steeringController", &m_controller);
+    m_engine->rootContext()->setContextProperty("steeringControllerService", &m_service);
+    m_engine->rootContext()->setContextProperty("videoReceiver", &m_videoReceiver);
+    m_engine->rootContext()->setContextProperty("pipelineComparison", &m_pipelineComparison);
+    m_engine->rootContext()->setContextProperty("tracing", Tracer::instance());
+    m_engine->rootContext()->setContextProperty("performanceStats", &m_performanceStats);
+    m_engine->rootContext()->setContextProperty("renderProfile", &m_renderProfile);
+    m_engine->rootContext()->setContextProperty("presentationMode", &m_presentationMode);
+    m_engine->rootContext()->setContextProperty("frameGovernor", &m_frameGovernor);
+    m_engine->rootContext()->setContextProperty("pathPredictor", &m_pathPredictor);
+    m_engine->loadFromModule("Driver", "Main");
+
+    m_window = m_engine->rootObjects().isEmpty()
+        ? nullptr : qobject_cast<QQuickWindow *>(m_engine->rootObjects().constFirst());
+    if (!m_window) {
+        qWarning() << "[E2eHarness::start] Main.qml did not load";
+        return false;
+    }
+    // Basic/software render loop: emitted on this thread
+    connect(m_window, &QQuickWindow::frameSwapped, this, &E2eHarness::onFrameSwapped, Qt::DirectConnection);
+    connect(m_window, &QQuickWindow::beforeRendering, this, [this]() {
+        m_renderStartNs = m_measuring ? m_clock.nsecsElapsed() : -1;
+    }, Qt::DirectConnection);
+    connect(m_window, &QQuickWindow::afterRendering, this, [this]() {
+        if (m_renderStartNs >= 0) {
+            m_renderPass.add(m_clock.nsecsElapsed() - m_renderStartNs);
+            m_renderStartNs = -1;
+        }
+    }, Qt::DirectConnection);
+    m_renderProfile.trackWindow(m_window);
+    m_frameGovernor.trackWindow(m_window);
+
+    // Video
+    if (!startVideoSource()) {
+        return false;
+    }
+
+    m_injectTimer.start();
+    QTimer::singleShot(m_config.warmupS * 1000, this, &E2eHarness::onWarmupDone);
+
+    qInfo().nospace() << "[E2eHarness] Running: " << m_config.warmupS << " s warm-up, "
+                      << m_config.durationS << " s measurement";
+    return true;
+}
+
+bool E2eHarness::attachVirtualJoystick()
+{
+    // SDL's joystick subsystem is initialized lazily (see SteeringController::initializeAsync());
+    // it has to be up before a virtual device can be attached.
+    // Axis 0 is steering, axis 2 throttle (left centered -> constant 0.5)
+    m_controller.ensureInitialized();
+    m_virtualIndex = SDL_JoystickAttachVirtual(SDL_JOYSTICK_TYPE_WHEEL, 3, 0, 0);
+    if (m_virtualIndex < 0) {
+        qWarning() << "[E2eHarness::attachVirtualJoystick] Cannot attach virtual joystick:" << SDL_GetError();
+        return false;
+    }
+    m_virtualJoystick = SDL_JoystickOpen(m_virtualIndex);
+    if (!m_virtualJoystick) {
+        qWarning() << "[E2eHarness::attachVirtualJoystick] Cannot open virtual joystick:" << SDL_GetError();
+        return false;
+    }
+
+    // Real devices may be present too - the virtual one is enumerated last
+    m_controller.refreshDevices();
+    QString name = QString::fromUtf8(SDL_JoystickNameForIndex(m_virtualIndex));
+    m_controller.connectDevice(m_controller.availableDevices().lastIndexOf(name));
+    if (!m_controller.connected()) {
+        qWarning() << "[E2eHarness::attachVirtualJoystick] SteeringController did not connect to" << name;
+        return false;
+    }
+    return true;
+}
+
+bool E2eHarness::startVideoSource()
+{
+    // A field capture, looped for the whole run, through the same loopback ingest
+    if (!m_config.pcapPath.isEmpty()) {
+        PcapReplaySource::Config replay;
+        replay.path = m_config.pcapPath;
+        replay.udpPort = m_config.pcapPort;
+        replay.speed = m_config.pcapSpeed;
+        replay.loops = 0;
+        QString error;
+        if (!m_pcapReplay.load(replay, &error)) {
+            qWarning() << "[E2eHarness::startVideoSource]" << error;
+            return false;
+        }
+        return m_pcapReplay.startLoopback(VideoPort);
+    }
+
+    QString description = QString(
+        "videotestsrc is-live=true pattern=ball ! "
+        "video/x-raw,width=%1,height=%2,framerate=%3/1 ! "
+        "jpegenc quality=85 ! rtpjpegpay ! "
+        "udpsink host=127.0.0.1 port=%4 sync=false async=false")
+        .arg(m_config.videoWidth).arg(m_config.videoHeight).arg(m_config.videoFps).arg(VideoPort);
+
+    // gst_init() is deferred to the receiver's first stream, which starts later from QML
+    m_videoReceiver.ensureInitialized();
+
+    GError *error = nullptr;
+    m_sender = gst_parse_launch(description.toUtf8().constData(), &error);
+    if (!m_sender) {
+        qWarning() << "[E2eHarness::startVideoSource] Cannot create sender:"
+                   << (error ? error->message : "unknown error");
+        g_clear_error(&error);
+        return false;
+    }
+    g_clear_error(&error);
+
+    if (gst_element_set_state(m_sender, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+        qWarning() << "[E2eHarness::startVideoSource] Sender failed to start";
+        return false;
+    }
+    return true;
+}
+
+void E2eHarness::attachScene()
+{
+    if (!m_window) {
+        return;
+    }
+    m_videoImage = findItem(m_window->contentItem(), "videoImage");
+    if (!m_videoImage) {
+        return;
+    }
+
+    // QQuickImage is private API - connect to its status notifier by meta-object
+    const QMetaObject *imageMeta = m_videoImage->metaObject();
+    QMetaMethod statusChanged = imageMeta->property(imageMeta->indexOfProperty("status")).notifySignal();
+    QMetaMethod slot = metaObject()->method(metaObject()->indexOfSlot("onImageStatusChanged()"));
+    connect(m_videoImage, statusChanged, this, slot);
+}
+
+void E2eHarness::onInjectTimeout()
+{
+    m_axisValue += m_axisStep;
+    if (qAbs(m_axisValue) > AxisLimit) {
+        m_axisStep = -m_axisStep;
+        m_axisValue += 2 * m_axisStep;
+    }
+
+    SDL_JoystickSetVirtualAxis(m_virtualJoystick, 0, static_cast<Sint16>(m_axisValue));
+    m_lastInjectNs = m_clock.nsecsElapsed();
+    m_injectPending = true;
+    if (m_measuring) {
+        ++m_injected;
+    }
+}
+
+void E2eHarness::onSteeringChanged()
+{
+    // Also emitted on (dis)connect - only changes caused by an injection count
+    if (!m_injectPending) {
+        return;
+    }
+    m_injectPending = false;
+
+    // The service has already sent this value (it is connected first)
+    m_injectBySteering.insert(steeringKey(m_controller.steering()), m_lastInjectNs);
+    if (m_measuring) {
+        m_inputToController.add(m_clock.nsecsElapsed() - m_lastInjectNs);
+    }
+}
+
+void E2eHarness::recordControlApplied(double steering, qint64 appliedNs)
+{
+    auto it = m_injectBySteering.find(steeringKey(steering));
+    if (it == m_injectBySteering.end()) {
+        return;  // Initial state or a throttle-only update
+    }
+    qint64 injectNs = it.value();
+    m_injectBySteering.erase(it);
+
+    if (m_measuring) {
+        ++m_applied;
+        m_inputToCar.add(appliedNs - injectNs);
+    }
+}
+
+void E2eHarness::onFrameChanged()
+{
+    if (!m_videoImage) {
+        attachScene();
+    }
+
+    FrameTimes times;
+    times.rxNs = m_videoReceiver.currentFrameRxNs();
+    times.guiNs = TimestampedUdpSocket::wallClockNs();
+
+    QString frameId = m_videoReceiver.currentFrame();
+    m_frames.insert(frameId, times);
+    m_frameOrder.append(frameId);
+    while (m_frameOrder.size() > MaxTrackedFrames) {
+        m_frames.remove(m_frameOrder.takeFirst());
+    }
+
+    if (m_measuring) {
+        ++m_framesDisplayed;
+        if (times.rxNs > 0) {
+            m_arrivalToGui.add(times.guiNs - times.rxNs);
+        }
+    }
+}
+
+void E2eHarness::onImageStatusChanged()
+{
+    // Image.Ready: the asynchronous load finished, the next swap shows it
+    if (!m_videoImage || m_videoImage->property("status").toInt() != 1) {
+        return;
+    }
+
+    QString frameId = m_videoImage->property("source").toUrl().toString().section('/', -1);
+    auto it = m_frames.constFind(frameId);
+    if (it == m_frames.constEnd()) {
+        return;
+    }
+    m_loadedFrame = it.value();
+    m_loadedFramePending = true;
+}
+
+void E2eHarness::onFrameSwapped()
+{
+    if (!m_loadedFramePending) {
+        return;
+    }
+    m_loadedFramePending = false;
+    if (!m_measuring) {
+        return;
+    }
+
+    qint64 nowNs = TimestampedUdpSocket::wallClockNs();
+    ++m_framesRendered;
+    m_guiToRender.add(nowNs - m_loadedFrame.guiNs);
+    if (m_loadedFrame.rxNs > 0) {
+        m_arrivalToRender.add(nowNs - m_loadedFrame.rxNs);
+    }
+}
+
+void E2eHarness::onWarmupDone()
+{
+    m_injected = 0;
+    m_applied = 0;
+    m_framesDisplayed = 0;
+    m_framesRendered = 0;
+    for (Samples *samples : { &m_inputToController, &m_inputToCar, &m_arrivalToGui,
+                              &m_arrivalToRender, &m_guiToRender, &m_renderPass }) {
+        samples->clear();
+        if (m_config.soakIntervalS > 0) {
+            samples->useReservoir(SoakReservoirSize);
+        }
+    }
+    m_service.resetHedgeStatistics();
+
+    m_videoStart = m_videoReceiver.pipelineStats();
+    m_repaintStart = m_renderProfile.repaintStats();
+    m_cpuStart = threadCpu();
+    m_rssStartKb = processRssKb("VmRSS:");
+    m_windowClock.start();
+    m_measuring = true;
+
+    if (m_config.soakIntervalS > 0) {
+        m_soak.clear();
+        m_soakLastNs = 0;
+        m_soakLastRendered = 0;
+        m_soakTimer.start();
+    }
+    if (m_config.restartEveryS > 0) {
+        m_restartTimer.start();
+    }
+    QTimer::singleShot(m_config.durationS * 1000, this, &E2eHarness::onRunDone);
+}
+
+void E2eHarness::onRunDone()
+{
+    m_measuring = false;
+    m_windowNs = m_windowClock.nsecsElapsed();
+    m_injectTimer.stop();
+    m_soakTimer.stop();
+    m_restartTimer.stop();
+
+    m_videoEnd = m_videoReceiver.pipelineStats();
+    m_repaintEnd = m_renderProfile.repaintStats();
+    m_cpuEnd = threadCpu();
+    m_rssEndKb = processRssKb("VmRSS:");
+    m_rssPeakKb = processRssKb("VmHWM:");
+    m_hedgeStats = QJsonObject::fromVariantMap(m_service.hedgeStatistics());
+    m_videoBreakdown = QJsonObject::fromVariantMap(m_videoReceiver.latencyBreakdown());
+
+    QJsonObject root = report();
+    QByteArray json = QJsonDocument(root).toJson();
+    if (m_config.outputPath.isEmpty()) {
+        QFile out;
+        if (out.open(stdout, QIODevice::WriteOnly)) {
+            out.write(json);
+        }
+    } else {
+        QFile out(m_config.outputPath);
+        if (out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            out.write(json);
+        } else {
+            qWarning() << "[E2eHarness::onRunDone] Cannot write" << m_config.outputPath << ":" << out.errorString();
+        }
+    }
+
+    // A run that measured nothing is a broken setup, not a fast system
+    if (m_inputToCar.ns.empty() || m_framesRendered == 0) {
+        qWarning() << "[E2eHarness::onRunDone] No samples - control applied:" << m_inputToCar.ns.size()
+                   << "frames rendered:" << m_framesRendered;
+        m_exitCode = 2;
+    } else if (!root["soak"].toObject()["trending"].toArray().isEmpty()) {
+        qWarning() << "[E2eHarness::onRunDone] Upward trend in:"
+                   << root["soak"].toObject()["trending"].toArray().toVariantList();
+        m_exitCode = 3;
+    }
+    emit finished();
+}
+
+void E2eHarness::onSoakSample()
+{
+    qint64 nowNs = m_windowClock.nsecsElapsed();
+    SoakSample sample;
+    sample.elapsedS = nowNs / 1e9;
+
+    qint64 rssKb = processRssKb("VmRSS:");
+    sample.rssMb = rssKb >= 0 ? rssKb / 1024.0 : -1.0;
+#ifdef HARNESS_HAVE_MALLINFO2
+    struct mallinfo2 heap = mallinfo2();
+    sample.heapInUseMb = (heap.uordblks + heap.hblkhd) / (1024.0 * 1024.0);
+    sample.heapFreeMb = heap.fordblks / (1024.0 * 1024.0);
+#endif
+    // stopStream() hands its timers to deleteLater(); a count that keeps rising
+    // means they are never deleted
+    sample.receiverChildren = m_videoReceiver.children().size();
+    if (const MetricGauge *depth = MetricsRegistry::instance().findGauge("driver_video_handoff_queue_depth")) {
+        sample.handoffQueueDepth = depth->value();
+    }
+
+    sample.inputToCarP50Ms = intervalPercentileMs(m_inputToCar.interval, 0.50);
+    sample.inputToCarP99Ms = intervalPercentileMs(m_inputToCar.interval, 0.99);
+    sample.arrivalToGuiP50Ms = intervalPercentileMs(m_arrivalToGui.interval, 0.50);
+    sample.arrivalToGuiP99Ms = intervalPercentileMs(m_arrivalToGui.interval, 0.99);
+    sample.arrivalToRenderP99Ms = intervalPercentileMs(m_arrivalToRender.interval, 0.99);
+    double intervalS = (nowNs - m_soakLastNs) / 1e9;
+    sample.renderedFps = intervalS > 0.0 ? (m_framesRendered - m_soakLastRendered) / intervalS : 0.0;
+    m_soakLastNs = nowNs;
+    m_soakLastRendered = m_framesRendered;
+
+    for (Samples *samples : { &m_inputToController, &m_inputToCar, &m_arrivalToGui,
+                              &m_arrivalToRender, &m_guiToRender, &m_renderPass }) {
+        samples->interval.clear();
+    }
+    m_soak.push_back(sample);
+
+    qInfo().nospace() << "[E2eHarness] soak " << qRound(sample.elapsedS) << " s: rss " << sample.rssMb
+                      << " MB, heap " << sample.heapInUseMb << " MB, input->car p99 " << sample.inputToCarP99Ms
+                      << " ms, arrival->gui p99 " << sample.arrivalToGuiP99Ms << " ms, " << sample.renderedFps << " fps";
+}
+
+void E2eHarness::onRestartStream()
+{
+    // Exercises the teardown path (timers, pipelines, engine threads) over and over
+    m_videoReceiver.stopStream();
+    m_videoReceiver.startStream(VideoPort);
+    ++m_streamRestarts;
+}
+
+void E2eHarness::Samples::add(qint64 value)
+{
+    ++seen;
+    if (reservoirSize > 0) {
+        interval.push_back(value);
+        // Reservoir sampling: every value seen so far is kept with equal probability
+        if (ns.size() < reservoirSize) {
+            ns.push_back(value);
+        } else {
+            quint64 slot = QRandomGenerator::global()->generate64() % quint64(seen);
+            if (slot < reservoirSize) {
+                ns[slot] = value;
+            }
+        }
+        return;
+    }
+    ns.push_back(value);
+}
+
+void E2eHarness::Samples::clear()
+{
+    ns.clear();
+    interval.clear();
+    seen = 0;
+}
+
+void E2eHarness::Samples::useReservoir(size_t size)
+{
+    reservoirSize = size;
+    // Touch the memory now: pages faulted in mid-run would read as growth
+    ns.assign(size, 0);
+    ns.clear();
+    interval.assign(size, 0);
+    interval.clear();
+}
+
+QJsonObject E2eHarness::Samples::summary() const
+{
+    QJsonObject summary;
+    summary["count"] = seen;
+    if (ns.empty()) {
+        return summary;
+    }
+
+    std::vector<qint64> sorted = ns;
+    std::sort(sorted.begin(), sorted.end());
+    qint64 sum = 0;
+    for (qint64 value : sorted) {
+        sum += value;
+    }
+    summary["meanMs"] = (double(sum) / sorted.size()) / 1e6;
+    summary["p50Ms"] = percentileMs(sorted, 0.50);
+    summary["p95Ms"] = percentileMs(sorted, 0.95);
+    summary["p99Ms"] = percentileMs(sorted, 0.99);
+    summary["maxMs"] = sorted.back() / 1e6;
+    return summary;
+}
+
+QJsonObject E2eHarness::report() const
+{
+    double windowS = m_windowNs / 1e9;
+
+    QJsonObject config;
+    config["durationS"] = m_config.durationS;
+    config["warmupS"] = m_config.warmupS;
+    config["inputRateHz"] = m_config.inputRateHz;
+    config["video"] = QString("%1x%2@%3").arg(m_config.videoWidth).arg(m_config.videoHeight).arg(m_config.videoFps);
+    config["hedged"] = m_config.hedged;
+    config["nativeIngest"] = m_config.nativeIngest;
+    config["qpa"] = qEnvironmentVariable("QT_QPA_PLATFORM");
+    config["quickBackend"] = qEnvironmentVariable("QT_QUICK_BACKEND");
+    config["uiProfile"] = m_renderProfile.name();
+    config["frameGovernor"] = m_frameGovernor.isEnabled();
+    config["soakIntervalS"] = m_config.soakIntervalS;
+    if (!m_config.pcapPath.isEmpty()) {
+        config["video"] = QString("pcap %1 @%2x").arg(m_config.pcapPath).arg(m_config.pcapSpeed);
+        config["pcapPacketsReplayed"] = m_pcapReplay.stats().packets;
+        config["pcapMaxLateMs"] = m_pcapReplay.stats().maxLateNs / 1e6;
+    }
+
+    QJsonObject control;
+    control["injected"] = m_injected;
+    control["applied"] = m_applied;
+    control["inputToControllerMs"] = m_inputToController.summary();
+    control["inputToCarMs"] = m_inputToCar.summary();
+    if (m_config.hedged) {
+        control["hedge"] = m_hedgeStats;
+    }
+
+    QJsonObject video;
+    video["framesIn"] = m_videoEnd.framesIn - m_videoStart.framesIn;
+    video["framesDecoded"] = m_videoEnd.framesDecoded - m_videoStart.framesDecoded;
+    video["framesDisplayed"] = m_framesDisplayed;
+    video["framesRendered"] = m_framesRendered;
+    video["renderedFps"] = windowS > 0.0 ? m_framesRendered / windowS : 0.0;
+    video["arrivalToGuiMs"] = m_arrivalToGui.summary();
+    video["arrivalToRenderMs"] = m_arrivalToRender.summary();
+    video["guiToRenderMs"] = m_guiToRender.summary();
+    video["pipeline"] = m_videoBreakdown;
+
+    // Same run with --ui-profile default and software gives the frame time comparison
+    QJsonObject render;
+    render["renderPassMs"] = m_renderPass.summary();
+    render["uiLevelAtEnd"] = m_frameGovernor.levelName();
+    if (m_renderProfile.isSoftware()) {
+        qint64 regionFrames = m_repaintEnd.frames - m_repaintStart.frames;
+        render["framesWithRegion"] = regionFrames;
+        render["dirtyPercent"] = regionFrames > 0
+            ? (m_repaintEnd.dirtyShareSum - m_repaintStart.dirtyShareSum) / regionFrames * 100.0 : -1.0;
+        render["fullRepaints"] = m_repaintEnd.fullRepaints - m_repaintStart.fullRepaints;
+    }
+
+    // Threads that exited during the window are not listed
+    QJsonArray threads;
+    qint64 totalCpuNs = 0;
+    QList<qint64> tids = m_cpuEnd.keys();
+    std::sort(tids.begin(), tids.end(), [this](qint64 a, qint64 b) {
+        return m_cpuEnd[a].cpuNs - m_cpuStart.value(a).cpuNs > m_cpuEnd[b].cpuNs - m_cpuStart.value(b).cpuNs;
+    });
+    for (qint64 tid : tids) {
+        qint64 cpuNs = m_cpuEnd[tid].cpuNs - m_cpuStart.value(tid).cpuNs;
+        totalCpuNs += cpuNs;
+        QJsonObject thread;
+        thread["tid"] = tid;
+        thread["name"] = m_cpuEnd[tid].name;
+        thread["cpuMs"] = cpuNs / 1e6;
+        thread["cpuPercent"] = windowS > 0.0 ? cpuNs / (windowS * 1e9) * 100.0 : 0.0;
+        threads.append(thread);
+    }
+
+    QJsonObject process;
+    process["cpuPercent"] = windowS > 0.0 ? totalCpuNs / (windowS * 1e9) * 100.0 : 0.0;
+    process["rssStartMb"] = m_rssStartKb / 1024.0;
+    process["rssEndMb"] = m_rssEndKb / 1024.0;
+    process["peakRssMb"] = m_rssPeakKb / 1024.0;
+
+    QJsonObject root;
+    root["config"] = config;
+    root["windowS"] = windowS;
+    root["control"] = control;
+    root["video"] = video;
+    root["render"] = render;
+    root["threads"] = threads;
+    root["process"] = process;
+    if (m_config.soakIntervalS > 0) {
+        root["soak"] = soakReport();
+    }
+    return root;
+}
+
+QJsonObject E2eHarness::soakReport() const
+{
+    // Series tested for an upward trend; latencies are the per-interval percentiles
+    struct Series
+    {
+        const char *name;
+        double SoakSample::*field;
+    };
+    static const Series series[] = {
+        { "rssMb", &SoakSample::rssMb },
+        { "heapInUseMb", &SoakSample::heapInUseMb },
+        { "receiverChildren", &SoakSample::receiverChildren },
+        { "handoffQueueDepth", &SoakSample::handoffQueueDepth },
+        { "inputToCarP50Ms", &SoakSample::inputToCarP50Ms },
+        { "inputToCarP99Ms", &SoakSample::inputToCarP99Ms },
+        { "arrivalToGuiP50Ms", &SoakSample::arrivalToGuiP50Ms },
+        { "arrivalToGuiP99Ms", &SoakSample::arrivalToGuiP99Ms },
+        { "arrivalToRenderP99Ms", &SoakSample::arrivalToRenderP99Ms },
+    };
+
+    QJsonArray samples;
+    for (const SoakSample &sample : m_soak) {
+        QJsonObject entry;
+        entry["elapsedS"] = sample.elapsedS;
+        for (const Series &s : series) {
+            entry[s.name] = sample.*s.field;
+        }
+        entry["heapFreeMb"] = sample.heapFreeMb;
+        entry["renderedFps"] = sample.renderedFps;
+        samples.append(entry);
+    }
+
+    QJsonObject trends;
+    QJsonArray trending;
+    for (const Series &s : series) {
+        std::vector<double> times;
+        std::vector<double> values;
+        for (const SoakSample &sample : m_soak) {
+            if (sample.*s.field >= 0.0) {  // -1: nothing measured in that interval
+                times.push_back(sample.elapsedS);
+                values.push_back(sample.*s.field);
+            }
+        }
+        TrendTest::Result result = TrendTest::trend(times, values);
+        trends[s.name] = result.toJson();
+        if (result.increasing) {
+            trending.append(QString::fromUtf8(s.name));
+        }
+    }
+
+    QJsonObject soak;
+    soak["intervalS"] = m_config.soakIntervalS;
+    soak["restartEveryS"] = m_config.restartEveryS;
+    soak["streamRestarts"] = m_streamRestarts;
+    soak["samples"] = samples;
+    soak["trends"] = trends;
+    soak["trending"] = trending;
+    return soak;
+}
+
+QHash<qint64, E2eHarness::ThreadCpu> E2eHarness::threadCpu()
+{
+    QHash<qint64, ThreadCpu> threads;
+#ifdef Q_OS_LINUX
+    const qint64 nsPerTick = 1000000000LL / sysconf(_SC_CLK_TCK);
+    const QStringList tids = QDir("/proc/self/task").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &tid : tids) {
+        QFile statFile(QString("/proc/self/task/%1/stat").arg(tid));
+        if (!statFile.open(QIODevice::ReadOnly)) {
+            continue;  // Exited since the directory listing
+        }
+
+        // "tid (comm) state ..." - comm may itself contain spaces and parentheses
+        QByteArray stat = statFile.readAll();
+        int open = stat.indexOf('(');
+        int close = stat.lastIndexOf(')');
+        if (open < 0 || close < open) {
+            continue;
+        }
+        // Fields after comm start at field 3 (state); utime and stime are fields 14 and 15
+        QList<QByteArray> fields = stat.mid(close + 2).split(' ');
+        if (fields.size() < 13) {
+            continue;
+        }
+
+        ThreadCpu cpu;
+        cpu.name = QString::fromUtf8(stat.mid(open + 1, close - open - 1));
+        cpu.cpuNs = (fields[11].toLongLong() + fields[12].toLongLong()) * nsPerTick;
+        threads.insert(tid.toLongLong(), cpu);
+    }
+#endif
+    return threads;
+}
+
+qint64 E2eHarness::processRssKb(const char *field)
+{
+#ifdef Q_OS_LINUX
+    QFile status("/proc/self/status");
+    if (status.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> lines = status.readAll().split('\n');
+        for (const QByteArray &line : lines) {
+            if (line.startsWith(field)) {
+                return line.mid(static_cast<int>(qstrlen(field))).trimmed().split(' ').first().toLongLong();
+            }
+        }
+    }
+#else
+    Q_UNUSED(field)
+#endif
+    return -1;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file main.cpp
+ * @brief Headless end-to-end run: driver_harness [options]
+ *
+ * Prints (or writes with --output) a JSON report and exits with 0, 1 when the
+ * setup failed, 2 when the run measured nothing, or 3 when a soak run (--soak)
+ * found an upward trend in memory or latency.
+ */
+
+#include <QCommandLineParser>
+#include <QGuiApplication>
+#include <QQuickStyle>
+#include <QDebug>
+#include "includes/harness.hpp"
+#include "includes/renderprofile.hpp"
+
+int main(int argc, char *argv[])
+{
+    // Headless by default; the software backend also keeps frameSwapped on the GUI thread
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    if (!qEnvironmentVariableIsSet("QT_QUICK_BACKEND")) {
+        qputenv("QT_QUICK_BACKEND", "software");
+    }
+    if (!qEnvironmentVariableIsSet("QSG_RENDER_LOOP")) {
+        qputenv("QSG_RENDER_LOOP", "basic");
+    }
+
+    QGuiApplication app(argc, argv);
+    QQuickStyle::setStyle("Basic");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless end-to-end latency/throughput run of the driver app");
+    parser.addHelpOption();
+    QCommandLineOption durationOption("duration", "Measurement window in seconds (default 30).", "s", "30");
+    QCommandLineOption warmupOption("warmup", "Warm-up before measuring in seconds (default 3).", "s", "3");
+    QCommandLineOption inputRateOption("input-rate", "Virtual steering changes per second (default 50).", "hz", "50");
+    QCommandLineOption videoOption("video", "Synthetic stream size (default 1280x720).", "WxH", "1280x720");
+    QCommandLineOption fpsOption("fps", "Synthetic stream frame rate (default 30).", "fps", "30");
+    QCommandLineOption wsPortOption("ws-port", "Fake car WebSocket port (default 8765).", "port", "8765");
+    QCommandLineOption udpPortOption("udp-port", "Fake car UDP port (default 8766).", "port", "8766");
+    QCommandLineOption hedgedOption("hedged", "Send control over WebSocket and UDP.");
+    QCommandLineOption udpsrcOption("udpsrc", "Receive video with udpsrc (no kernel RX timestamps).");
+    QCommandLineOption outputOption("output", "Write the JSON report to a file instead of stdout.", "file");
+    QCommandLineOption soakOption("soak", "Soak mode: sample memory and latency every s seconds and test for trends.", "s");
+    QCommandLineOption restartOption("restart-every", "Stop and restart the video stream every s seconds.", "s");
+    QCommandLineOption pcapOption("pcap", "Replay the UDP payloads of a pcap/pcapng capture (looped) instead of the synthetic stream.", "file");
+    QCommandLineOption pcapPortOption("pcap-port", "Only replay datagrams sent to this port in the capture.", "port", "0");
+    QCommandLineOption pcapSpeedOption("pcap-speed", "Replay speed factor; 0 = as fast as possible (default 1).", "x", "1");
+    QCommandLineOption uiProfileOption("ui-profile", "UI profile: software, default (the scene as on a GPU) or auto (DRIVER_UI_PROFILE / backend).", "profile", "auto");
+    parser.addOptions({ durationOption, warmupOption, inputRateOption, videoOption, fpsOption,
+                        wsPortOption, udpPortOption, hedgedOption, udpsrcOption, outputOption,
+                        soakOption, restartOption, pcapOption, pcapPortOption, pcapSpeedOption,
+                        uiProfileOption });
+    parser.process(app);
+
+    // Before the scene's window exists
+    QString uiProfile = parser.value(uiProfileOption);
+    if (uiProfile != "auto") {
+        if (uiProfile != "software" && uiProfile != "default") {
+            qCritical() << "Invalid --ui-profile:" << uiProfile;
+            return 1;
+        }
+        qputenv("DRIVER_UI_PROFILE", uiProfile.toLatin1());
+    }
+    RenderProfile::configure();
+
+    E2eHarness::Config config;
+    config.durationS = qMax(1, parser.value(durationOption).toInt());
+    config.warmupS = qMax(0, parser.value(warmupOption).toInt());
+    config.inputRateHz = qBound(1, parser.value(inputRateOption).toInt(), 1000);
+    QStringList size = parser.value(videoOption).split('x');
+    if (size.size() != 2 || size[0].toInt() <= 0 || size[1].toInt() <= 0) {
+        qCritical() << "Invalid --video size:" << parser.value(videoOption);
+        return 1;
+    }
+    config.videoWidth = size[0].toInt();
+    config.videoHeight = size[1].toInt();
+    config.videoFps = qMax(1, parser.value(fpsOption).toInt());
+    config.wsPort = parser.value(wsPortOption).toUShort();
+    config.udpPort = parser.value(udpPortOption).toUShort();
+    config.hedged = parser.isSet(hedgedOption);
+    config.nativeIngest = !parser.isSet(udpsrcOption);
+    config.outputPath = parser.value(outputOption);
+    config.soakIntervalS = qMax(0, parser.value(soakOption).toInt());
+    config.restartEveryS = qMax(0, parser.value(restartOption).toInt());
+    config.pcapPath = parser.value(pcapOption);
+    config.pcapPort = parser.value(pcapPortOption).toUShort();
+    config.pcapSpeed = qMax(0.0, parser.value(pcapSpeedOption).toDouble());
+
+    E2eHarness harness(config);
+    QObject::connect(&harness, &E2eHarness::finished, &app, [&app, &harness]() {
+        app.exit(harness.exitCode());
+    }, Qt::QueuedConnection);
+
+    if (!harness.start()) {
+        return 1;
+    }
+    return app.exec();
+}
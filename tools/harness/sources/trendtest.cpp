@@ -0,0 +1,112 @@
+/**
+ * @file trendtest.cpp
+ * @brief Implementation of the Mann-Kendall test and Theil-Sen slope
+ */
+
+#include "includes/trendtest.hpp"
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace {
+constexpr int MinSamples = 8;
+
+double median(std::vector<double> values)
+{
+    if (values.empty()) {
+        return 0.0;
+    }
+    size_t middle = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + middle, values.end());
+    double upper = values[middle];
+    if (values.size() % 2 != 0) {
+        return upper;
+    }
+    double lower = *std::max_element(values.begin(), values.begin() + middle);
+    return (lower + upper) / 2.0;
+}
+
+int sign(double value)
+{
+    return (value > 0.0) - (value < 0.0);
+}
+}
+
+namespace TrendTest {
+
+QJsonObject Result::toJson() const
+{
+    QJsonObject json;
+    json["samples"] = samples;
+    json["kendallS"] = kendallS;
+    json["z"] = z;
+    json["pValue"] = pValue;
+    json["slopePerHour"] = slopePerHour;
+    json["median"] = median;
+    json["relativePerHour"] = relativePerHour;
+    json["increasing"] = increasing;
+    return json;
+}
+
+Result trend(const std::vector<double> &timesS, const std::vector<double> &values,
+             double alpha, double minRelativePerHour, double minAbsolutePerHour)
+{
+    Result result;
+    size_t n = qMin(timesS.size(), values.size());
+    result.samples = static_cast<int>(n);
+    if (n < MinSamples) {
+        return result;
+    }
+
+    // S and the Theil-Sen pairwise slopes come from the same O(n^2) pass; soak
+    // runs have hundreds of samples, not millions
+    double s = 0.0;
+    std::vector<double> slopes;
+    slopes.reserve(n * (n - 1) / 2);
+    for (size_t i = 0; i + 1 < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            s += sign(values[j] - values[i]);
+            double dt = timesS[j] - timesS[i];
+            if (dt > 0.0) {
+                slopes.push_back((values[j] - values[i]) / dt);
+            }
+        }
+    }
+
+    // Variance of S with the correction for groups of tied values
+    std::map<double, int> ties;
+    for (size_t i = 0; i < n; ++i) {
+        ++ties[values[i]];
+    }
+    double nd = static_cast<double>(n);
+    double variance = nd * (nd - 1) * (2 * nd + 5);
+    for (const auto &group : ties) {
+        double t = group.second;
+        variance -= t * (t - 1) * (2 * t + 5);
+    }
+    variance /= 18.0;
+
+    result.kendallS = s;
+    if (variance > 0.0) {
+        // Continuity correction: S moves in steps of 2
+        double corrected = s > 0 ? s - 1 : (s < 0 ? s + 1 : 0.0);
+        result.z = corrected / std::sqrt(variance);
+        result.pValue = 0.5 * std::erfc(result.z / std::sqrt(2.0));
+    }
+
+    result.slopePerHour = median(std::move(slopes)) * 3600.0;
+    result.median = median(std::vector<double>(values.begin(), values.begin() + n));
+
+    // A series that sits at 0 (an empty queue) has no level to be relative to
+    bool steep;
+    if (result.median != 0.0) {
+        result.relativePerHour = result.slopePerHour / std::fabs(result.median);
+        steep = result.relativePerHour >= minRelativePerHour;
+    } else {
+        steep = result.slopePerHour >= minAbsolutePerHour;
+    }
+    result.increasing = result.pValue < alpha && result.slopePerHour > 0.0 && steep;
+    return result;
+}
+
+} // namespace TrendTest